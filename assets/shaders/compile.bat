@@ -1,3 +0,0 @@
-C:/VulkanSDK/1.3.261.1/Bin/glslangValidator.exe -V shader.vert -o shader.vert.spv
-C:/VulkanSDK/1.3.261.1/Bin/glslangValidator.exe -V shader.frag -o shader.frag.spv
-pause
\ No newline at end of file
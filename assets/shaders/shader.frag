@@ -1,13 +1,41 @@
 #version 450
 
+#define MAX_BINDLESS_TEXTURES 256
+
 layout (location = 0) in vec3 fragColor;
 layout (location = 1) in vec2 fragTexCoord;
 
 layout (location = 0) out vec4 outColor;
 
+struct Material
+{
+    vec4 baseColor;
+    uint textureIndex;
+};
+
+#if defined(BINDLESS)
+layout (binding = 1) uniform texture2D textures[MAX_BINDLESS_TEXTURES];
+layout (binding = 3) uniform sampler texSampler;
+#else
 layout (binding = 1) uniform sampler2D texSampler;
+#endif
+
+layout (std430, binding = 2) readonly buffer MaterialBuffer
+{
+    Material materials[];
+};
+
+layout (push_constant) uniform MaterialPushConstant
+{
+    uint materialIndex;
+};
 
 void main()
 {
-    outColor = texture(texSampler, fragTexCoord);
+    Material material = materials[materialIndex];
+#if defined(BINDLESS)
+    outColor = texture(sampler2D(textures[material.textureIndex], texSampler), fragTexCoord) * material.baseColor;
+#else
+    outColor = texture(texSampler, fragTexCoord) * material.baseColor;
+#endif
 }
\ No newline at end of file
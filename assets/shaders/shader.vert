@@ -1,22 +1,51 @@
 #version 450
 
+#if defined(VERTEX_LAYOUT_QUANTIZED)
+layout (location = 0) in vec4 positionOS;
+layout (location = 1) in vec2 texCoord;
+#elif defined(VERTEX_LAYOUT_COMPACT)
+layout (location = 0) in vec3 positionOS;
+layout (location = 1) in vec2 texCoord;
+#else
 layout (location = 0) in vec3 positionOS;
 layout (location = 1) in vec3 color;
 layout (location = 2) in vec2 texCoord;
+#endif
 
 layout (location = 0) out vec3 fragColor;
 layout (location = 1) out vec2 fragTexCoord;
 
 layout (binding = 0) uniform UniformBufferObject
 {
-    mat4 model;
     mat4 view;
     mat4 proj;
+    mat4 dequantization;
 } ubo;
 
+layout (std430, set = 1, binding = 0) readonly buffer Instances
+{
+    mat4 instanceModels[];
+};
+
+layout (std430, set = 1, binding = 1) readonly buffer VisibleInstances
+{
+    uint visibleInstances[];
+};
+
 void main()
 {
-    gl_Position = ubo.proj * ubo.view * ubo.model * vec4(positionOS, 1.0);
+    mat4 instanceModel = instanceModels[visibleInstances[gl_InstanceIndex]];
+
+#if defined(VERTEX_LAYOUT_QUANTIZED)
+    gl_Position = ubo.proj * ubo.view * instanceModel * ubo.dequantization * vec4(positionOS.xyz, 1.0);
+#else
+    gl_Position = ubo.proj * ubo.view * instanceModel * vec4(positionOS, 1.0);
+#endif
+
+#if defined(VERTEX_LAYOUT_QUANTIZED) || defined(VERTEX_LAYOUT_COMPACT)
+    fragColor = vec3(1.0);
+#else
     fragColor = color;
+#endif
     fragTexCoord = texCoord;
 }
\ No newline at end of file
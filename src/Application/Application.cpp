@@ -1,27 +1,34 @@
-#include <stb_image.h>
-#include <tiny_obj_loader.h>
+#include <stb_image_write.h>
 
 #include "Application.h"
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include "ObjLoader.h"
+#include "ParallelFor.h"
 
 const std::string MODEL_PATH = ASSET_INCLUDE_PATH + std::string("models/ganyu/ganyu.obj");
 const std::string MTL_PATH = ASSET_INCLUDE_PATH + std::string("models/ganyu");
 // const std::string MODEL_PATH = ASSET_INCLUDE_PATH + std::string("obj/viking_room.obj");
 const std::string TEXTURE_PATH = ASSET_INCLUDE_PATH + std::string("Textures/viking_room.png");
 
-namespace std
+bool QueueFamilyIndices::isComplete()
 {
-    template<> struct hash<Vertex>
-    {
-        size_t operator()(Vertex const& _vertex) const
-        {
-            return ((hash<glm::vec3>()(_vertex.positionOS) ^ (hash<glm::vec3>()(_vertex.color) << 1)) >> 1) ^ (hash<glm::vec2>()(_vertex.texCoord) << 1);
-        }
-    };
+    return graphicsFamily.has_value() && presentFamily.has_value();
 }
 
-bool QueueFamilyIndices::isComplete()
+const char* getPresentModeName(VkPresentModeKHR _presentMode)
 {
-    return graphicsFamily.has_value() && presentFamily.has_value();
+    switch (_presentMode)
+    {
+    case VK_PRESENT_MODE_IMMEDIATE_KHR:
+        return "IMMEDIATE";
+    case VK_PRESENT_MODE_MAILBOX_KHR:
+        return "MAILBOX";
+    case VK_PRESENT_MODE_FIFO_RELAXED_KHR:
+        return "FIFO_RELAXED";
+    default:
+        return "FIFO";
+    }
 }
 
 #ifndef NDEBUG
@@ -30,12 +37,111 @@ bool QueueFamilyIndices::isComplete()
 
 const std::vector<const char*> deviceExtensions{ VK_KHR_SWAPCHAIN_EXTENSION_NAME };
 
-const int MAX_FRAMES_IN_FLIGHT = 2;
-
-Application::Application(const int _width, const int _height, const std::string& _name)
+// ֡ޣʵ֡ģʽ --frames-in-flight 
+const uint32_t MAX_FRAMES_IN_FLIGHT = 3;
+//  shader.frag е MAX_BINDLESS_TEXTURES һ
+const uint32_t MAX_BINDLESS_TEXTURES = 256;
+// ʱϴõĻݴ滺СĻݷֿϴ
+const VkDeviceSize UPLOAD_RING_SIZE = 16 * 1024 * 1024;
+// ÿ֡õĶ̬ uniform ռ䣬㹻ǧҪеĳ
+const VkDeviceSize UNIFORM_RING_FRAME_SIZE = 1024 * 1024;
+// ɺд GPU ڴͳ
+const std::string MEMORY_STATISTICS_PATH = "gpu_memory.json";
+// ˳ʱ桢´ʱصĹ߻棬豸仯ʱؽ
+const std::string PIPELINE_CACHE_PATH = "pipeline_cache.bin";
+// ʵ尴Ԥÿʵһ mat4
+const uint32_t MAX_INSTANCE_COUNT = 65536;
+// ʵ XZ ƽϵļ
+const float INSTANCE_SPACING = 12.0f;
+// --benchmark βʵÿԤټʱ
+const std::array<uint32_t, 7> BENCHMARK_INSTANCE_COUNTS{ 1, 16, 256, 1024, 4096, 16384, 65536 };
+const uint32_t BENCHMARK_WARMUP_FRAMES = 30;
+const uint32_t BENCHMARK_MEASURED_FRAMES = 120;
+const std::string BENCHMARK_RESULT_PATH = "instance_benchmark.csv";
+// ÿ¼ٷֵĻ̫ʱֱ¼
+const uint32_t MIN_DRAWS_PER_RECORD_TASK = 256;
+const uint32_t MAX_RECORD_THREAD_COUNT = 64;
+// ¼ƻ׼ԵĻÿȡλ
+const std::array<uint32_t, 3> RECORD_BENCHMARK_DRAW_COUNTS{ 10000, 30000, 100000 };
+const uint32_t RECORD_BENCHMARK_ITERATIONS = 20;
+const std::string RECORD_BENCHMARK_RESULT_PATH = "record_benchmark.csv";
+// ʵ任 LOD ѡÿٴʵʱֱ߳Ӽ
+const uint32_t MIN_INSTANCES_PER_JOB = 4096;
+//  cull.comp  local_size_x һ
+const uint32_t CULLING_GROUP_SIZE = 64;
+// ͶӰĻϲʱʹøֵ LOD
+const float LOD_PIXEL_THRESHOLD = 1.0f;
+// ÿ֡д GPU ʱ忪ʼ޳ͨȾͨʱ֮Ϊһ
+const uint32_t GPU_TIMESTAMP_COUNT = 3;
+const std::array<const char*, GPU_TIMESTAMP_COUNT - 1> GPU_TIMESTAMP_SCOPE_NAMES{ "culling", "render pass" };
+// ޴ģʽûָ֡ʱȾ֡
+const uint32_t DEFAULT_HEADLESS_FRAME_COUNT = 300;
+// ȴ֡դʱÿ 1 룬ʱʾۼƳΪ GPU 
+const uint64_t FENCE_WAIT_TIMEOUT_NANOSECONDS = 1000000000;
+const uint32_t MAX_FENCE_WAIT_TIMEOUTS = 10;
+
+Application::Application(const int _width, const int _height, const std::string& _name, const ApplicationOptions& _options)
+    : m_options(_options)
 {
+    // طȾʵͷֱɽű
+    if (!m_options.replayScriptPath.empty())
+    {
+        std::string error;
+        if (!loadReplayScript(m_options.replayScriptPath, m_replayScript, error))
+        {
+            throw std::runtime_error(setFontColor("Failed to load replay script " + m_options.replayScriptPath + ": " + error, FontColor::Red));
+        }
+        m_options.headless = true;
+        m_options.instanceCount = m_replayScript.instanceCount;
+    }
+    if (m_options.instanceCount == 0 || m_options.instanceCount > MAX_INSTANCE_COUNT)
+    {
+        throw std::runtime_error(setFontColor("Instance count must be between 1 and " + std::to_string(MAX_INSTANCE_COUNT), FontColor::Red));
+    }
+    if (m_options.recordThreadCount > MAX_RECORD_THREAD_COUNT)
+    {
+        throw std::runtime_error(setFontColor("Record thread count must be at most " + std::to_string(MAX_RECORD_THREAD_COUNT), FontColor::Red));
+    }
+    // طźͻ׼ҪģȾ֡棬ſɸ
+    if (m_options.pipelined && (!m_options.replayScriptPath.empty() || m_options.benchmark || m_options.recordBenchmark))
+    {
+        throw std::runtime_error(setFontColor("Pipelined mode cannot be combined with replay or benchmarks", FontColor::Red));
+    }
+    // ӳģʽڲǰȴһ֡ɣˮģʽĻܱģһ֡ߵĿ෴
+    if (m_options.pipelined && m_options.pacing == FramePacingMode::Latency)
+    {
+        throw std::runtime_error(setFontColor("Latency pacing cannot be combined with pipelined mode", FontColor::Red));
+    }
+    m_framesInFlight = m_options.framesInFlight != 0 ? m_options.framesInFlight : getDefaultFramesInFlight(m_options.pacing);
+    if (m_framesInFlight > MAX_FRAMES_IN_FLIGHT)
+    {
+        throw std::runtime_error(setFontColor("Frames in flight must be between 1 and " + std::to_string(MAX_FRAMES_IN_FLIGHT), FontColor::Red));
+    }
+    m_frameRateLimiter.setFramesPerSecond(m_options.frameRateCap);
+
+    // ͼֱӸƳͼһ֧ΪԴ
+    if (!m_options.frameDumpDirectory.empty() && !m_options.headless)
+    {
+        throw std::runtime_error(setFontColor("Dumping frames requires headless mode", FontColor::Red));
+    }
+    m_profiler.setTraceEnabled(!m_options.tracePath.empty());
+
     std::cout << setFontColor("Application is created", FontColor::Green) << std::endl;
-    initWindow(_width, _height, _name);
+    if (m_options.headless)
+    {
+        // ޴ģʽʼ GLFWȾ봰ͬСͼ
+        m_headlessExtent = m_replayScript.width != 0
+            ? VkExtent2D{ m_replayScript.width, m_replayScript.height }
+            : VkExtent2D{ static_cast<uint32_t>(_width), static_cast<uint32_t>(_height) };
+        if (m_options.frameCount == 0)
+        {
+            m_options.frameCount = DEFAULT_HEADLESS_FRAME_COUNT;
+        }
+    }
+    else
+    {
+        initWindow(_width, _height, _name);
+    }
 }
 
 Application::~Application()
@@ -43,11 +149,12 @@ Application::~Application()
     std::cout << setFontColor("Application is released", FontColor::Indigo) << std::endl;
 }
 
-void Application::run()
+int Application::run()
 {
     initVulkan();
     mainLoop();
     cleanup();
+    return m_exitCode;
 }
 
 void Application::initWindow(const int _width, const int _height, const std::string& _name)
@@ -64,50 +171,576 @@ void Application::initWindow(const int _width, const int _height, const std::str
 
     glfwSetWindowUserPointer(m_window, this);
     glfwSetFramebufferSizeCallback(m_window, framebufferResizeCallback);
+
+    int width = 0, height = 0;
+    glfwGetFramebufferSize(m_window, &width, &height);
+    m_framebufferWidth = width;
+    m_framebufferHeight = height;
 }
 
 void Application::initVulkan()
 {
-    createInstance();
+    // 谴ͼִ̳߳Уģֻ CPU Ͻ봴豸ͬʱУ豸
+    // ߡԴ֡ԴȴϴصĲͬһа˳ִ
+    m_startupTime = std::chrono::steady_clock::now();
+    TaskGraph graph;
+    const TaskGraph::TaskId model = graph.addTask("model", [this]()
+    {
+        loadModel();
+        createDrawList();
+    });
+    const TaskGraph::TaskId device = graph.addTask("device", [this]()
+    {
+        createInstance();
 
-    #ifndef NDEBUG
-        setupDebugMessenger();
-    #endif
+        #ifndef NDEBUG
+            setupDebugMessenger();
+        #endif
 
-    createSurface();
-    pickPhysicalDevice();
-    createLogicalDevice();
-    createSwapchain();
-    createImageViews();
-    createRenderPass();
-    createDescriptorSetLayout();
-    createGraphicsPipeline();
-    createCommandPool();
-    createColorResource();
-    createDepthResource();
-    createFramebuffers();
-    createTextureImage();
-    createTextureImageView();
-    createTextureSampler();
-    loadModel();
-    createVertexBuffer();
-    createVertexIndicesBuffer();
-    createUniformBuffers();
-    createDescriptorPool();
-    createDescriptorSets();
-    createCommandBuffers();
-    createSyncObjects();
+        if (!m_options.headless)
+        {
+            createSurface();
+        }
+        pickPhysicalDevice();
+        createLogicalDevice();
+        createMemoryAllocator();
+    });
+    // ĴСͨ glfwGetFramebufferSize ѯ̵ֻ߳
+    const TaskGraph::TaskId renderTargets = graph.addTask("render targets", [this]()
+    {
+        if (m_options.headless)
+        {
+            createOffscreenTargets();
+        }
+        else
+        {
+            createSwapchain();
+        }
+        createImageViews();
+        createRenderPass();
+    }, { device }, TaskAffinity::MainThread);
+    graph.addTask("attachments", [this]()
+    {
+        createColorResource();
+        createDepthResource();
+        createFramebuffers();
+    }, { renderTargets });
+    // ȡģ͵ͼ
+    const TaskGraph::TaskId descriptorSetLayout = graph.addTask("descriptor set layout", [this]() { createDescriptorSetLayout(); }, { device, model });
+    // ڸԵб룬ͬһ߻ (ڲͬ)
+    const TaskGraph::TaskId pipelineCache = graph.addTask("pipeline cache", [this]() { createPipelineCache(); }, { device });
+    graph.addTask("graphics pipeline", [this]() { createGraphicsPipeline(); }, { renderTargets, descriptorSetLayout, pipelineCache });
+    const TaskGraph::TaskId cullingPipeline = graph.addTask("culling pipeline", [this]() { createCullingPipeline(); }, { pipelineCache });
+    const TaskGraph::TaskId textureSampler = graph.addTask("texture sampler", [this]() { createTextureSampler(); }, { device });
+    graph.addTask("record command pools", [this]() { createRecordCommandPools(); }, { device });
+    graph.addTask("sync objects", [this]()
+    {
+        createSyncObjects();
+        createTimestampQueryPool();
+    }, { device });
+    const TaskGraph::TaskId frameRings = graph.addTask("frame rings", [this]()
+    {
+        createUniformRing();
+        createInstanceRing();
+    }, { device });
+    const TaskGraph::TaskId meshResources = graph.addTask("mesh resources", [this]()
+    {
+        createCommandPool();
+        createUploadBatcher();
+        createTextureImage();
+        createTextureImageView();
+        createVertexBuffer();
+        createVertexIndicesBuffer();
+        createMaterialBuffer();
+        createCullingBuffers();
+        flushUploads();
+        createCommandBuffers();
+    }, { device, model });
+    graph.addTask("descriptor sets", [this]()
+    {
+        createCullingDescriptorSets();
+        createDescriptorPool();
+        createDescriptorSets();
+    }, { descriptorSetLayout, cullingPipeline, textureSampler, frameRings, meshResources });
+    graph.run();
+    reportMemoryStatistics();
+    std::cout << setFontColor(
+        "Pipeline creation (" + std::string(m_pipelineCache == nullptr ? "no cache" : m_pipelineCacheLoaded ? "warm cache" : "cold cache") + "): graphics "
+        + std::to_string(m_graphicsPipelineMilliseconds) + " ms, culling " + std::to_string(m_cullingPipelineMilliseconds) + " ms",
+        FontColor::Green) << std::endl;
+
+    // ؼ·ϵ * ǣǵĺʱ֮;˵һ֮֡ǰҪȶ
+    const std::vector<std::string> report = graph.getReport();
+    std::string startupReport = "Startup: " + report.front();
+    for (size_t i = 1; i < report.size(); ++i)
+    {
+        startupReport += "\n\t" + report[i];
+    }
+    std::cout << setFontColor(startupReport, FontColor::Green) << std::endl;
+    for (TaskGraph::TaskId task = 0; task < graph.getTaskCount(); ++task)
+    {
+        m_startupPhases.emplace_back(graph.getName(task), graph.getTiming(task).getDuration());
+    }
 }
 
 void Application::mainLoop()
 {
-    while (!glfwWindowShouldClose(m_window))
+    if (!m_options.replayScriptPath.empty())
+    {
+        runReplay();
+    }
+    else if (m_options.benchmark)
+    {
+        runInstanceBenchmark();
+    }
+    else if (m_options.recordBenchmark)
+    {
+        runRecordBenchmark();
+    }
+    else
+    {
+        // ָ֡ʱ (޴ģʽָ) ȾЩ֡˳д PNG ʱ䲻
+        std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+        uint32_t frameCount = 0;
+        if (m_options.pipelined)
+        {
+            frameCount = runPipelinedLoop();
+        }
+        else
+        {
+            for (; m_options.frameCount == 0 || frameCount < m_options.frameCount; ++frameCount)
+            {
+                // ֡޺͵ӳģʽĵȴڴ¼֮ǰȴʱ䲻뵽ֵӳ
+                m_frameRateLimiter.wait();
+                if (m_options.pacing == FramePacingMode::Latency)
+                {
+                    waitForFrame(m_currentFrame);
+                }
+                if (!pollWindowEvents())
+                {
+                    break;
+                }
+                drawFrame();
+            }
+        }
+        if (m_options.frameCount != 0)
+        {
+            vkDeviceWaitIdle(m_device);
+            const double totalMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count() - m_frameDumpMilliseconds;
+            std::cout << setFontColor(
+                "Rendered " + std::to_string(frameCount) + " frames at " + std::to_string(m_swapchainExtent.width) + "x" + std::to_string(m_swapchainExtent.height)
+                + (m_options.headless ? " (headless)" : "") + (m_options.pipelined ? " (pipelined)" : "") + " in " + std::to_string(totalMilliseconds) + " ms: "
+                + std::to_string(frameCount * 1000.0 / totalMilliseconds)
+                + " fps, " + std::to_string(totalMilliseconds / std::max(1u, frameCount)) + " ms per frame",
+                FontColor::Green) << std::endl;
+        }
+        reportFramePacing();
+    }
+
+    if (m_options.verifyCulling)
+    {
+        std::cout << setFontColor(
+            "Culling verification: " + std::to_string(m_cullingVerifiedFrames) + " frames, " + std::to_string(m_cullingMismatchFrames) + " mismatched",
+            m_cullingMismatchFrames == 0 ? FontColor::Green : FontColor::Yellow) << std::endl;
+    }
+
+    vkDeviceWaitIdle(m_device);
+
+    // 豸кȡ֡ʱͻ
+    for (uint32_t i = 0; i < m_framesInFlight; ++i)
+    {
+        readTimestamps((m_currentFrame + i) % m_framesInFlight);
+        writeFrameDump((m_currentFrame + i) % m_framesInFlight);
+    }
+    reportProfile();
+}
+
+uint32_t Application::runPipelinedLoop()
+{
+    // Ⱦ߳¼Ʋύµ֡ݰ̴߳¼ģһ֡صִУģһ֡
+    // ̵߳һݰȡߺſʼģ⣬Ⱦֻ߳ȾµݰÿģĽǡȾһΡ
+    // ݰͨػ彻ӣȴԷʱ߶ռϵͳҪĺ
+    std::atomic<uint32_t> renderedCount{ 0 };
+    std::exception_ptr renderException;
+    m_pipelineStopping = false;
+    std::thread renderThread([this, &renderedCount, &renderException]()
+    {
+        try
+        {
+            while (!m_pipelineStopping && (m_options.frameCount == 0 || renderedCount < m_options.frameCount))
+            {
+                {
+                    std::unique_lock<std::mutex> lock(m_framePacketMutex);
+                    m_framePacketCondition.wait(lock, [this]() { return m_pipelineStopping || m_framePackets.hasPending(); });
+                }
+                if (m_pipelineStopping)
+                {
+                    break;
+                }
+                drawFrame();
+                ++renderedCount;
+            }
+        }
+        catch (...)
+        {
+            renderException = std::current_exception();
+        }
+        m_pipelineStopping = true;
+        notifyFramePacketState();
+    });
+
+    try
+    {
+        while (!m_pipelineStopping && pollWindowEvents())
+        {
+            if (m_framePackets.hasPending())
+            {
+                waitForFramePacketConsumed();
+                continue;
+            }
+            // ֡ģһЧȴ֮´¼ģʹµ
+            if (m_frameRateLimiter.isEnabled())
+            {
+                m_frameRateLimiter.wait();
+                if (!pollWindowEvents())
+                {
+                    break;
+                }
+            }
+            simulateFrame();
+        }
+    }
+    catch (...)
+    {
+        m_pipelineStopping = true;
+        notifyFramePacketState();
+        renderThread.join();
+        throw;
+    }
+    m_pipelineStopping = true;
+    notifyFramePacketState();
+    renderThread.join();
+
+    if (renderException)
+    {
+        std::rethrow_exception(renderException);
+    }
+    return renderedCount;
+}
+
+void Application::waitForFramePacketConsumed()
+{
+    // дʱ glfwWaitEvents У¼Ⱦ̷߳Ŀ¼ܻѣ¼ڶУȷҲᶪʧ
+    if (!m_options.headless)
+    {
+        glfwWaitEvents();
+        return;
+    }
+    std::unique_lock<std::mutex> lock(m_framePacketMutex);
+    m_framePacketCondition.wait(lock, [this]() { return m_pipelineStopping || !m_framePackets.hasPending(); });
+}
+
+void Application::notifyFramePacketState()
+{
+    // Ȼȡһ֪ͨȴڳʱ֪ͨڼͿʼȴ֮
+    {
+        std::lock_guard<std::mutex> lock(m_framePacketMutex);
+    }
+    m_framePacketCondition.notify_all();
+    if (!m_options.headless)
+    {
+        glfwPostEmptyEvent();
+    }
+}
+
+void Application::reportProfile()
+{
+    std::cout << setFontColor("Frame profile (last " + std::to_string(FrameProfiler::HISTOGRAM_WINDOW) + " samples per scope):", FontColor::Green) << std::endl;
+    for (const std::string& line : m_profiler.getReport())
+    {
+        std::cout << setFontColor("\t" + line, FontColor::Green) << std::endl;
+    }
+
+    if (!m_profiler.isTraceEnabled())
+    {
+        return;
+    }
+    if (!m_profiler.writeChromeTrace(m_options.tracePath))
+    {
+        std::cout << setFontColor("Failed to write frame trace: " + m_options.tracePath, FontColor::Yellow) << std::endl;
+        return;
+    }
+    std::cout << setFontColor("Frame trace: " + m_options.tracePath + " (" + std::to_string(m_profiler.getEvents().size()) + " events)", FontColor::Green) << std::endl;
+    if (m_profiler.getDroppedEventCount() > 0)
+    {
+        std::cout << setFontColor("Frame trace is full, " + std::to_string(m_profiler.getDroppedEventCount()) + " later events were dropped", FontColor::Yellow) << std::endl;
+    }
+}
+
+void Application::reportFramePacing()
+{
+    std::string configuration = std::string("Frame pacing: ") + getFramePacingModeName(m_options.pacing) + ", " + std::to_string(m_framesInFlight) + " frames in flight";
+    if (!m_options.headless)
+    {
+        configuration += std::string(", present mode ") + getPresentModeName(m_presentMode);
+    }
+    if (m_frameRateLimiter.isEnabled())
+    {
+        configuration += ", capped at " + std::to_string(m_frameRateLimiter.getFramesPerSecond()) + " fps";
+    }
+    std::cout << setFontColor(configuration, FontColor::Green) << std::endl;
+    std::cout << setFontColor(
+        "\tframe interval: mean " + std::to_string(m_frameIntervals.getMean()) + " ms, p50 " + std::to_string(m_frameIntervals.getPercentile(50.0)) + " ms, p99 "
+        + std::to_string(m_frameIntervals.getPercentile(99.0)) + " ms, jitter (std dev) " + std::to_string(m_frameIntervals.getStandardDeviation()) + " ms",
+        FontColor::Green) << std::endl;
+    std::cout << setFontColor(
+        "\tinput to present: p50 " + std::to_string(m_inputLatencies.getPercentile(50.0)) + " ms, p95 " + std::to_string(m_inputLatencies.getPercentile(95.0)) + " ms, p99 "
+        + std::to_string(m_inputLatencies.getPercentile(99.0)) + " ms (" + std::to_string(m_inputLatencies.getCount()) + " frames, measured until the GPU finishes the frame)",
+        FontColor::Green) << std::endl;
+}
+
+void Application::runReplay()
+{
+    // ͼȫٿʼ̶ƽÿеĻ涼ͬ
+    waitForTextureStreaming();
+    for (uint32_t i = 0; i < m_replayScript.warmupFrames; ++i)
+    {
+        drawFrame();
+    }
+    m_profiler.resetStatistics();
+
+    RollingHistogram frameTimes(m_replayScript.measuredFrames);
+    double totalMilliseconds = 0.0;
+    for (uint32_t i = 0; i < m_replayScript.measuredFrames; ++i)
     {
-        glfwPollEvents();
+        std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
         drawFrame();
+        const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+        frameTimes.add(milliseconds);
+        totalMilliseconds += milliseconds;
+    }
+    vkDeviceWaitIdle(m_device);
+
+    // һ֡һ֡ͼ
+    std::vector<unsigned char> pixels;
+    captureFrame((m_currentFrame + m_framesInFlight - 1) % m_framesInFlight, pixels);
+    const int width = static_cast<int>(m_swapchainExtent.width);
+    const int height = static_cast<int>(m_swapchainExtent.height);
+    if (!m_replayScript.outputImagePath.empty() && stbi_write_png(m_replayScript.outputImagePath.c_str(), width, height, 4, pixels.data(), width * 4) == 0)
+    {
+        std::cout << setFontColor("Failed to write replay output: " + m_replayScript.outputImagePath, FontColor::Yellow) << std::endl;
+    }
+
+    // ûָ׼ͼʱֻ
+    std::string goldenStatus = "none";
+    ImageDifference difference;
+    if (!m_replayScript.goldenImagePath.empty())
+    {
+        DecodedTexture golden = decodeTexture(m_replayScript.goldenImagePath);
+        if (golden.pixels == nullptr)
+        {
+            goldenStatus = "missing";
+        }
+        else if (golden.width != width || golden.height != height)
+        {
+            goldenStatus = "size mismatch";
+        }
+        else
+        {
+            difference = compareImages(golden.pixels.get(), pixels.data(), pixels.size() / 4, m_replayScript.channelTolerance);
+            goldenStatus = difference.differingPixelCount * 100.0 <= m_replayScript.differingPixelPercent * difference.pixelCount ? "passed" : "failed";
+        }
+    }
+
+    writeReplayReport(frameTimes, totalMilliseconds, goldenStatus, difference);
+    std::cout << setFontColor(
+        "Replay: " + std::to_string(m_replayScript.measuredFrames) + " frames, " + std::to_string(m_replayScript.measuredFrames * 1000.0 / totalMilliseconds) + " fps, frame p50 "
+        + std::to_string(frameTimes.getPercentile(50.0)) + " ms, p95 " + std::to_string(frameTimes.getPercentile(95.0)) + " ms, p99 " + std::to_string(frameTimes.getPercentile(99.0))
+        + " ms, report: " + m_replayScript.reportPath,
+        FontColor::Green) << std::endl;
+    if (goldenStatus != "none" && goldenStatus != "passed")
+    {
+        std::cout << setFontColor(
+            "Replay golden image " + goldenStatus + ": " + m_replayScript.goldenImagePath + ", " + std::to_string(difference.differingPixelCount) + " differing pixels, max channel difference "
+            + std::to_string(difference.maxChannelDifference),
+            FontColor::Red) << std::endl;
+        m_exitCode = 1;
+    }
+    else if (goldenStatus == "passed")
+    {
+        std::cout << setFontColor(
+            "Replay golden image passed: " + std::to_string(difference.differingPixelCount) + " differing pixels, mean channel difference " + std::to_string(difference.meanChannelDifference),
+            FontColor::Green) << std::endl;
+    }
+}
+
+void Application::writeReplayReport(const RollingHistogram& _frameTimes, double _totalMilliseconds, const std::string& _goldenStatus, const ImageDifference& _difference)
+{
+    std::ofstream file(m_replayScript.reportPath);
+    if (!file)
+    {
+        std::cout << setFontColor("Failed to write replay report: " + m_replayScript.reportPath, FontColor::Yellow) << std::endl;
+        return;
+    }
+
+    // ·еķбܺҪת
+    auto jsonString = [](const std::string& _string)
+    {
+        std::string escaped = "\"";
+        for (char c : _string)
+        {
+            escaped += (c == '\\' || c == '"') ? std::string{ '\\', c } : std::string(1, c);
+        }
+        return escaped + "\"";
+    };
+
+    const uint32_t frameCount = m_replayScript.measuredFrames;
+    file << std::fixed << std::setprecision(4);
+    file << "{\n";
+    file << "  \"script\": " << jsonString(m_options.replayScriptPath) << ",\n";
+    file << "  \"resolution\": [" << m_swapchainExtent.width << ", " << m_swapchainExtent.height << "],\n";
+    file << "  \"instances\": " << m_instanceTransforms.getCount() << ",\n";
+    file << "  \"warmupFrames\": " << m_replayScript.warmupFrames << ",\n";
+    file << "  \"measuredFrames\": " << frameCount << ",\n";
+    file << "  \"frameMilliseconds\": { \"mean\": " << _totalMilliseconds / frameCount << ", \"p50\": " << _frameTimes.getPercentile(50.0)
+        << ", \"p95\": " << _frameTimes.getPercentile(95.0) << ", \"p99\": " << _frameTimes.getPercentile(99.0) << " },\n";
+
+    file << "  \"scopes\": [";
+    const std::vector<ProfileScopeSummary> summaries = m_profiler.getSummaries();
+    for (size_t i = 0; i < summaries.size(); ++i)
+    {
+        file << (i == 0 ? "\n" : ",\n") << "    { \"track\": \"" << getProfileTrackName(summaries[i].track) << "\", \"name\": " << jsonString(summaries[i].name)
+            << ", \"p50\": " << summaries[i].p50Milliseconds << ", \"p95\": " << summaries[i].p95Milliseconds << ", \"p99\": " << summaries[i].p99Milliseconds << " }";
+    }
+    file << "\n  ],\n";
+
+    file << "  \"startupMilliseconds\": {";
+    for (size_t i = 0; i < m_startupPhases.size(); ++i)
+    {
+        file << (i == 0 ? " " : ", ") << jsonString(m_startupPhases[i].first) << ": " << m_startupPhases[i].second;
+    }
+    file << " },\n";
+
+    // ѷĿͶֽԼбԴռõֽ
+    GpuMemoryStatistics statistics = m_memoryAllocator.getStatistics();
+    VkDeviceSize allocatedBytes = 0;
+    VkDeviceSize usedBytes = 0;
+    for (const GpuMemoryTypeStatistics& memoryType : statistics.memoryTypes)
+    {
+        allocatedBytes += memoryType.blockBytes + memoryType.dedicatedBytes;
+        usedBytes += memoryType.usedBytes;
+    }
+    file << "  \"memory\": { \"allocatedBytes\": " << allocatedBytes << ", \"usedBytes\": " << usedBytes << ", \"deviceMemoryCount\": " << statistics.deviceMemoryCount
+        << ", \"allocationCount\": " << statistics.allocationCount << " },\n";
+
+    file << "  \"golden\": { \"path\": " << jsonString(m_replayScript.goldenImagePath) << ", \"status\": " << jsonString(_goldenStatus)
+        << ", \"differingPixels\": " << _difference.differingPixelCount << ", \"maxChannelDifference\": " << _difference.maxChannelDifference
+        << ", \"meanChannelDifference\": " << _difference.meanChannelDifference << " }\n";
+    file << "}\n";
+}
+
+void Application::waitForTextureStreaming()
+{
+    while (m_textureStreamer.getPendingCount() > 0 || !m_textureUploads.empty())
+    {
+        updateTextureStreaming();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void Application::runInstanceBenchmark()
+{
+    // ֡ʱܽģʽƣFIFO »ᱻֱͬǯסʱºʱܷӳ CPU 
+    std::ofstream file(BENCHMARK_RESULT_PATH);
+    if (!file)
+    {
+        std::cout << setFontColor("Failed to write instance benchmark: " + BENCHMARK_RESULT_PATH, FontColor::Yellow) << std::endl;
+    }
+    file << "instances,frame_ms,update_ms,visible_draws\n";
+
+    for (uint32_t instanceCount : BENCHMARK_INSTANCE_COUNTS)
+    {
+        m_instanceTransforms.init(instanceCount, INSTANCE_SPACING);
+        for (uint32_t i = 0; i < BENCHMARK_WARMUP_FRAMES && pollWindowEvents(); ++i)
+        {
+            drawFrame();
+        }
+
+        double updateMilliseconds = 0.0;
+        uint64_t visibleDrawCount = 0;
+        uint32_t frameCount = 0;
+        std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+        for (; frameCount < BENCHMARK_MEASURED_FRAMES && pollWindowEvents(); ++frameCount)
+        {
+            drawFrame();
+            updateMilliseconds += m_instanceUpdateMilliseconds;
+            visibleDrawCount += m_visibleDrawCount;
+        }
+        const double totalMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+        if (frameCount < BENCHMARK_MEASURED_FRAMES)
+        {
+            std::cout << setFontColor("Instance benchmark interrupted", FontColor::Yellow) << std::endl;
+            return;
+        }
+
+        const double frameAverage = totalMilliseconds / frameCount;
+        const double updateAverage = updateMilliseconds / frameCount;
+        const uint64_t visibleAverage = visibleDrawCount / frameCount;
+        std::cout << setFontColor(
+            "Instance benchmark: " + std::to_string(instanceCount) + " instances, frame " + std::to_string(frameAverage) + " ms, update " + std::to_string(updateAverage)
+            + " ms, visible draws " + std::to_string(visibleAverage),
+            FontColor::Green) << std::endl;
+        file << instanceCount << "," << frameAverage << "," << updateAverage << "," << visibleAverage << "\n";
     }
 
+    std::cout << setFontColor("Instance benchmark results: " + BENCHMARK_RESULT_PATH, FontColor::Green) << std::endl;
+}
+
+void Application::runRecordBenchmark()
+{
+    // ֻ¼ƶ岻ύͬĻڲͬ߳µ¼ƺʱ
     vkDeviceWaitIdle(m_device);
+    std::ofstream file(RECORD_BENCHMARK_RESULT_PATH);
+    if (!file)
+    {
+        std::cout << setFontColor("Failed to write record benchmark: " + RECORD_BENCHMARK_RESULT_PATH, FontColor::Yellow) << std::endl;
+    }
+    file << "draws,threads,record_ms,speedup\n";
+
+    std::vector<uint32_t> threadCounts;
+    for (uint32_t threadCount = 1; threadCount < m_recordThreadCount; threadCount *= 2)
+    {
+        threadCounts.push_back(threadCount);
+    }
+    threadCounts.push_back(m_recordThreadCount);
+
+    for (uint32_t drawCount : RECORD_BENCHMARK_DRAW_COUNTS)
+    {
+        double singleThreadMilliseconds = 0.0;
+        for (uint32_t threadCount : threadCounts)
+        {
+            RollingHistogram recordTimes(RECORD_BENCHMARK_ITERATIONS);
+            for (uint32_t i = 0; i < RECORD_BENCHMARK_ITERATIONS; ++i)
+            {
+                std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+                recordSecondaryCommandBuffers(0, drawCount, threadCount);
+                recordTimes.add(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count());
+            }
+            const double milliseconds = recordTimes.getPercentile(50.0);
+            if (threadCount == 1)
+            {
+                singleThreadMilliseconds = milliseconds;
+            }
+            const double speedup = singleThreadMilliseconds / milliseconds;
+            std::cout << setFontColor(
+                "Record benchmark: " + std::to_string(drawCount) + " draws, " + std::to_string(threadCount) + " threads, " + std::to_string(milliseconds) + " ms ("
+                + std::to_string(speedup) + "x)",
+                FontColor::Green) << std::endl;
+            file << drawCount << "," << threadCount << "," << milliseconds << "," << speedup << "\n";
+        }
+    }
+
+    std::cout << setFontColor("Record benchmark results: " + RECORD_BENCHMARK_RESULT_PATH, FontColor::Green) << std::endl;
 }
 
 void Application::cleanup()
@@ -118,37 +751,84 @@ void Application::cleanup()
     vkDestroyPipelineLayout(m_device, m_pipelineLayout, nullptr);
     vkDestroyRenderPass(m_device, m_renderPass, nullptr);
 
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+    vkDestroyPipeline(m_device, m_cullingPipeline, nullptr);
+    vkDestroyPipelineLayout(m_device, m_cullingPipelineLayout, nullptr);
+    savePipelineCache();
+    vkDestroyPipelineCache(m_device, m_pipelineCache, nullptr);
+    vkDestroyDescriptorPool(m_device, m_cullingDescriptorPool, nullptr);
+    vkDestroyDescriptorSetLayout(m_device, m_cullingDescriptorSetLayout, nullptr);
+    vkDestroyDescriptorSetLayout(m_device, m_instanceDescriptorSetLayout, nullptr);
+    for (size_t i = 0; i < m_framesInFlight; ++i)
     {
-        vkDestroyBuffer(m_device, m_uniformBuffers[i], nullptr);
-        vkFreeMemory(m_device, m_uniformBuffersMemory[i], nullptr);
+        vkDestroyBuffer(m_device, m_indirectCommandBuffers[i], nullptr);
+        m_memoryAllocator.free(m_indirectCommandBufferAllocations[i]);
+        vkDestroyBuffer(m_device, m_visibleInstanceBuffers[i], nullptr);
+        m_memoryAllocator.free(m_visibleInstanceBufferAllocations[i]);
     }
+    vkDestroyBuffer(m_device, m_cullingDrawItemBuffer, nullptr);
+    m_memoryAllocator.free(m_cullingDrawItemBufferAllocation);
+
+    vkDestroyBuffer(m_device, m_uniformRingBuffer, nullptr);
+    m_memoryAllocator.free(m_uniformRingAllocation);
+    vkDestroyBuffer(m_device, m_instanceRingBuffer, nullptr);
+    m_memoryAllocator.free(m_instanceRingAllocation);
 
     vkDestroyDescriptorPool(m_device, m_descriptorPool, nullptr);
 
-    vkDestroySampler(m_device, m_textureSampler, nullptr);
-    vkDestroyImageView(m_device, m_textureImageView, nullptr);
+    // ϴͼֻͷԴһ
+    m_textureStreamer.stop();
+    for (TextureUpload& textureUpload : m_textureUploads)
+    {
+        vkDestroyBuffer(m_device, textureUpload.stagingBuffer, nullptr);
+        m_memoryAllocator.free(textureUpload.stagingBufferAllocation);
+        vkDestroyImage(m_device, textureUpload.texture.image, nullptr);
+        m_memoryAllocator.free(textureUpload.texture.imageAllocation);
+    }
+    m_textureUploads.clear();
 
-    vkDestroyImage(m_device, m_textureImage, nullptr);
-    vkFreeMemory(m_device, m_textureImageMemory, nullptr);
+    vkDestroySampler(m_device, m_textureSampler, nullptr);
+    for (TextureResource& texture : m_textures)
+    {
+        vkDestroyImageView(m_device, texture.imageView, nullptr);
+        vkDestroyImage(m_device, texture.image, nullptr);
+        m_memoryAllocator.free(texture.imageAllocation);
+    }
+    vkDestroyImageView(m_device, m_placeholderTexture.imageView, nullptr);
+    vkDestroyImage(m_device, m_placeholderTexture.image, nullptr);
+    m_memoryAllocator.free(m_placeholderTexture.imageAllocation);
 
     vkDestroyDescriptorSetLayout(m_device, m_descriptorSetLayout, nullptr);
 
+    vkDestroyBuffer(m_device, m_materialBuffer, nullptr);
+    m_memoryAllocator.free(m_materialBufferAllocation);
+
     vkDestroyBuffer(m_device, m_vertexIndicesBuffer, nullptr);
-    vkFreeMemory(m_device, m_vertexIndicesBufferMemory, nullptr);
+    m_memoryAllocator.free(m_vertexIndicesBufferAllocation);
 
     vkDestroyBuffer(m_device, m_vertexBuffer, nullptr);
-    vkFreeMemory(m_device, m_vertexBufferMemory, nullptr);
+    m_memoryAllocator.free(m_vertexBufferAllocation);
 
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+    for (size_t i = 0; i < m_framesInFlight; ++i)
     {
         vkDestroySemaphore(m_device, m_imageAvailableSemaphores[i], nullptr);
         vkDestroySemaphore(m_device, m_renderFinishedSemaphores[i], nullptr);
         vkDestroyFence(m_device, m_flightFences[i], nullptr);
     }
-
+    vkDestroySemaphore(m_device, m_textureTransferSemaphore, nullptr);
+    vkDestroySemaphore(m_device, m_textureGraphicsSemaphore, nullptr);
+    vkDestroyQueryPool(m_device, m_timestampQueryPool, nullptr);
+
+    m_uploadBatcher.destroy();
+    vkDestroyBuffer(m_device, m_uploadRingBuffer, nullptr);
+    m_memoryAllocator.free(m_uploadRingAllocation);
+    vkDestroyCommandPool(m_device, m_transferCommandPool, nullptr);
     vkDestroyCommandPool(m_device, m_commandPool, nullptr);
+    for (VkCommandPool commandPool : m_recordCommandPools)
+    {
+        vkDestroyCommandPool(m_device, commandPool, nullptr);
+    }
 
+    m_memoryAllocator.destroy();
     vkDestroyDevice(m_device, nullptr);
 
     #ifndef NDEBUG
@@ -158,9 +838,11 @@ void Application::cleanup()
     vkDestroySurfaceKHR(m_instance, m_surface, nullptr);
     vkDestroyInstance(m_instance, nullptr);
 
-    glfwDestroyWindow(m_window);
-
-    glfwTerminate();
+    if (!m_options.headless)
+    {
+        glfwDestroyWindow(m_window);
+        glfwTerminate();
+    }
 }
 
 void Application::createInstance()
@@ -180,7 +862,7 @@ void Application::createInstance()
         VK_MAKE_VERSION(1, 0, 0),               // applicationVersion
         "No Engine",                            // pEngineName
         VK_MAKE_VERSION(1, 0, 0),               // engineVersion
-        VK_API_VERSION_1_0                      // apiVersion
+        VK_API_VERSION_1_2                      // apiVersion
     };
 
     std::vector<const char*>&& extensions = getRequiredExtensions();
@@ -304,9 +986,14 @@ void Application::destroyDebugUtilsMessengerEXT(VkInstance _instance, VkDebugUti
 
 std::vector<const char*> Application::getRequiredExtensions()
 {
-    uint32_t glfwExtensionCount = 0;
-    const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
-    std::vector<const char*> extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
+    // ޴ģʽ棬Ҫ GLFW Ҫıչ
+    std::vector<const char*> extensions;
+    if (!m_options.headless)
+    {
+        uint32_t glfwExtensionCount = 0;
+        const char** glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+        extensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+    }
     #ifndef NDEBUG
         extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
     #endif
@@ -332,6 +1019,7 @@ void Application::pickPhysicalDevice()
         {
             m_physicalDevice = physicalDevice;
             m_massSamples = getMaxUsableSampleCount();
+            m_bindlessEnabled = checkBindlessSupport(physicalDevice);
             break;
         }
     }
@@ -348,10 +1036,11 @@ bool Application::isSuitableDevice(const VkPhysicalDevice _physicalDevice)
 {
     QueueFamilyIndices indices = findQueueFamilies(_physicalDevice);
 
-    bool extensionsSupport = checkDeviceExtensionSupport(_physicalDevice);
+    // ޴ģʽҪչͱ֧
+    bool extensionsSupport = m_options.headless || checkDeviceExtensionSupport(_physicalDevice);
 
-    bool swapchainAdequate = false;
-    if (extensionsSupport)
+    bool swapchainAdequate = m_options.headless;
+    if (!m_options.headless && extensionsSupport)
     {
         SwapChainSupportDetails swapchainSupportDetails = querySwapchainSupport(_physicalDevice);
         swapchainAdequate = !swapchainSupportDetails.formats.empty() && !swapchainSupportDetails.presentModes.empty();
@@ -360,15 +1049,58 @@ bool Application::isSuitableDevice(const VkPhysicalDevice _physicalDevice)
     VkPhysicalDeviceFeatures physicalDeviceFeatures;
     vkGetPhysicalDeviceFeatures(_physicalDevice, &physicalDeviceFeatures);
 
-    return indices.isComplete() && extensionsSupport && swapchainAdequate && physicalDeviceFeatures.samplerAnisotropy;
+    // ͼʽϴʱź֪ͨɣҪ Vulkan 1.2
+    VkPhysicalDeviceProperties physicalDeviceProperties{ };
+    vkGetPhysicalDeviceProperties(_physicalDevice, &physicalDeviceProperties);
+    VkPhysicalDeviceVulkan12Features vulkan12Features{ };
+    vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    if (physicalDeviceProperties.apiVersion >= VK_API_VERSION_1_2)
+    {
+        VkPhysicalDeviceFeatures2 physicalDeviceFeatures2{ };
+        physicalDeviceFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        physicalDeviceFeatures2.pNext = &vulkan12Features;
+        vkGetPhysicalDeviceFeatures2(_physicalDevice, &physicalDeviceFeatures2);
+    }
+
+    //  firstInstance ָʵһεύ
+    return indices.isComplete() && extensionsSupport && swapchainAdequate && physicalDeviceFeatures.samplerAnisotropy
+        && physicalDeviceFeatures.multiDrawIndirect && physicalDeviceFeatures.drawIndirectFirstInstance
+        && vulkan12Features.timelineSemaphore;
 }
 
-long long int Application::rateDeviceSuitability(const VkPhysicalDevice _physicalDevice)
+bool Application::checkBindlessSupport(const VkPhysicalDevice _physicalDevice)
 {
-    VkPhysicalDeviceProperties physicalDeviceProperties;
-    vkGetPhysicalDeviceProperties(_physicalDevice, &physicalDeviceProperties);
-    VkPhysicalDeviceFeatures physicalDeviceFeatures;
-    vkGetPhysicalDeviceFeatures(_physicalDevice, &physicalDeviceFeatures);
+    //  GQY_DISABLE_BINDLESS ʱǿʹͼ֧ bindless 豸ϲԻ·
+    if (std::getenv("GQY_DISABLE_BINDLESS") != nullptr)
+    {
+        return false;
+    }
+
+    VkPhysicalDeviceProperties physicalDeviceProperties{ };
+    vkGetPhysicalDeviceProperties(_physicalDevice, &physicalDeviceProperties);
+    if (physicalDeviceProperties.apiVersion < VK_API_VERSION_1_2
+        || physicalDeviceProperties.limits.maxPerStageDescriptorSampledImages < MAX_BINDLESS_TEXTURES
+        || physicalDeviceProperties.limits.maxDescriptorSetSampledImages < MAX_BINDLESS_TEXTURES)
+    {
+        return false;
+    }
+
+    VkPhysicalDeviceDescriptorIndexingFeatures descriptorIndexingFeatures{ };
+    descriptorIndexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+    VkPhysicalDeviceFeatures2 physicalDeviceFeatures2{ };
+    physicalDeviceFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    physicalDeviceFeatures2.pNext = &descriptorIndexingFeatures;
+    vkGetPhysicalDeviceFeatures2(_physicalDevice, &physicalDeviceFeatures2);
+
+    return descriptorIndexingFeatures.descriptorBindingPartiallyBound && physicalDeviceFeatures2.features.shaderSampledImageArrayDynamicIndexing;
+}
+
+long long int Application::rateDeviceSuitability(const VkPhysicalDevice _physicalDevice)
+{
+    VkPhysicalDeviceProperties physicalDeviceProperties;
+    vkGetPhysicalDeviceProperties(_physicalDevice, &physicalDeviceProperties);
+    VkPhysicalDeviceFeatures physicalDeviceFeatures;
+    vkGetPhysicalDeviceFeatures(_physicalDevice, &physicalDeviceFeatures);
 
     if (!physicalDeviceFeatures.geometryShader)
     {
@@ -613,34 +1345,52 @@ QueueFamilyIndices Application::findQueueFamilies(VkPhysicalDevice _physicalDevi
     int i = 0;
     for (const VkQueueFamilyProperties& queueFamilyProperty : queueFamilyProperties)
     {
-        if (queueFamilyProperty.queueFlags & VK_QUEUE_GRAPHICS_BIT)
+        // ޳ͨͻ¼ͬһУͼζҲҪּ֧
+        const VkQueueFlags graphicsFlags = VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT;
+        if ((queueFamilyProperty.queueFlags & graphicsFlags) == graphicsFlags && !indices.graphicsFamily.has_value())
         {
             indices.graphicsFamily = i;
         }
         VkBool32 presentSupport = VK_FALSE;
-        vkGetPhysicalDeviceSurfaceSupportKHR(_physicalDevice, i, m_surface, &presentSupport);
-        if (presentSupport)
+        if (m_surface != nullptr)
+        {
+            vkGetPhysicalDeviceSurfaceSupportKHR(_physicalDevice, i, m_surface, &presentSupport);
+        }
+        if (presentSupport && !indices.presentFamily.has_value())
         {
             indices.presentFamily = i;
         }
-
-        if (indices.isComplete())
+        // ִֻ֧ĶһӦ DMA 棬ͼϴռͼζ
+        if ((queueFamilyProperty.queueFlags & VK_QUEUE_TRANSFER_BIT) && !(queueFamilyProperty.queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT))
+            && !indices.transferFamily.has_value())
         {
-            break;
+            indices.transferFamily = i;
         }
 
         ++i;
     }
 
+    // ûרôʱͼζй
+    if (!indices.transferFamily.has_value())
+    {
+        indices.transferFamily = indices.graphicsFamily;
+    }
+    // ޴ģʽֱֶ֣ȡͼζУ豸ʱͲҪ
+    if (m_options.headless)
+    {
+        indices.presentFamily = indices.graphicsFamily;
+    }
+
     return indices;
 }
 
 void Application::createLogicalDevice()
 {
     QueueFamilyIndices indices = findQueueFamilies(m_physicalDevice);
+    m_queueFamilyIndices = indices;
 
     std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
-    std::set<uint32_t> uniqueQueueFamilies{ indices.graphicsFamily.value(), indices.presentFamily.value() };
+    std::set<uint32_t> uniqueQueueFamilies{ indices.graphicsFamily.value(), indices.presentFamily.value(), indices.transferFamily.value() };
     float queuePriorities = 1.0f;
 
     for (uint32_t queueFamily : uniqueQueueFamilies)
@@ -660,18 +1410,30 @@ void Application::createLogicalDevice()
     VkPhysicalDeviceFeatures deviceFeatures{ };
     deviceFeatures.samplerAnisotropy = VK_TRUE;
     deviceFeatures.sampleRateShading = VK_TRUE;
+    deviceFeatures.shaderSampledImageArrayDynamicIndexing = m_bindlessEnabled ? VK_TRUE : VK_FALSE;
+    deviceFeatures.multiDrawIndirect = VK_TRUE;
+    deviceFeatures.drawIndirectFirstInstance = VK_TRUE;
+
+    // 1.2 Ĺͳһͨ VkPhysicalDeviceVulkan12Features ӵĹܽṹ塣
+    // bindless ͼûͼԪرδ
+    VkPhysicalDeviceVulkan12Features vulkan12Features{ };
+    vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    vulkan12Features.descriptorBindingPartiallyBound = m_bindlessEnabled ? VK_TRUE : VK_FALSE;
+    vulkan12Features.timelineSemaphore = VK_TRUE;
+    const void* deviceFeaturesNext = &vulkan12Features;
+    const uint32_t deviceExtensionCount = m_options.headless ? 0 : static_cast<uint32_t>(deviceExtensions.size());
 
     #ifndef NDEBUG
         VkDeviceCreateInfo createInfo
         {
             VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,           // sType
-            nullptr,                                        // pNext
+            deviceFeaturesNext,                             // pNext
             VK_FALSE,                                       // flags
             static_cast<uint32_t>(queueCreateInfos.size()), // queueCreateInfoCount
             queueCreateInfos.data(),                        // pQueueCreateInfos
             static_cast<uint32_t>(validationLayers.size()), // enabledLayerCount
             validationLayers.data(),                        // ppEnabledLayerNames
-            static_cast<uint32_t>(deviceExtensions.size()), // enabledExtensionCount
+            deviceExtensionCount,                           // enabledExtensionCount
             deviceExtensions.data(),                        // ppEnabledExtensionNames
             &deviceFeatures                                 // pEnabledFeatures
         };
@@ -679,13 +1441,13 @@ void Application::createLogicalDevice()
         VkDeviceCreateInfo createInfo
         {
             VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,           // sType
-            nullptr,                                        // pNext
+            deviceFeaturesNext,                             // pNext
             VK_FALSE,                                       // flags
             static_cast<uint32_t>(queueCreateInfos.size()), // queueCreateInfoCount
             queueCreateInfos.data(),                        // pQueueCreateInfos
             0,                                              // enabledLayerCount
             nullptr,                                        // ppEnabledLayerNames
-            static_cast<uint32_t>(deviceExtensions.size()), // enabledExtensionCount
+            deviceExtensionCount,                           // enabledExtensionCount
             deviceExtensions.data(),                        // ppEnabledExtensionNames
             &deviceFeatures                                 // pEnabledFeatures
         };
@@ -698,6 +1460,7 @@ void Application::createLogicalDevice()
 
     vkGetDeviceQueue(m_device, indices.graphicsFamily.value(), 0, &m_graphicsQueue);
     vkGetDeviceQueue(m_device, indices.presentFamily.value(), 0, &m_presentQueue);
+    vkGetDeviceQueue(m_device, indices.transferFamily.value(), 0, &m_transferQueue);
 }
 
 void Application::createSurface()
@@ -764,11 +1527,17 @@ VkSurfaceFormatKHR Application::chooseSwapSurfaceFormat(const std::vector<VkSurf
 
 VkPresentModeKHR Application::chooseSwapPresentMode(const std::vector<VkPresentModeKHR>& _availablePresentModes)
 {
-    for (const VkPresentModeKHR& availablePresentMode : _availablePresentModes)
+    // ģʽȴֱͬû MAILBOX ʱ˵˺ѵ IMMEDIATEģʽ˺ѡFIFO ǿ
+    std::vector<VkPresentModeKHR> preferredPresentModes{ VK_PRESENT_MODE_MAILBOX_KHR };
+    if (m_options.pacing == FramePacingMode::Throughput)
     {
-        if (availablePresentMode == VK_PRESENT_MODE_MAILBOX_KHR)
+        preferredPresentModes.push_back(VK_PRESENT_MODE_IMMEDIATE_KHR);
+    }
+    for (VkPresentModeKHR preferredPresentMode : preferredPresentModes)
+    {
+        if (std::find(_availablePresentModes.begin(), _availablePresentModes.end(), preferredPresentMode) != _availablePresentModes.end())
         {
-            return availablePresentMode;
+            return preferredPresentMode;
         }
     }
     return VK_PRESENT_MODE_FIFO_KHR;
@@ -781,12 +1550,10 @@ VkExtent2D Application::chooseSwapExtent(const VkSurfaceCapabilitiesKHR& _capabi
         return _capabilities.currentExtent;
     }
 
-    int width, height;
-    glfwGetFramebufferSize(m_window, &width, &height);
     VkExtent2D actualExtent
     {
-        static_cast<uint32_t>(width),
-        static_cast<uint32_t>(height)
+        static_cast<uint32_t>(m_framebufferWidth.load()),
+        static_cast<uint32_t>(m_framebufferHeight.load())
     };
     actualExtent.width = std::clamp(actualExtent.width, _capabilities.minImageExtent.width, _capabilities.maxImageExtent.width);
     actualExtent.height = std::clamp(actualExtent.height, _capabilities.minImageExtent.height, _capabilities.maxImageExtent.height);
@@ -800,7 +1567,8 @@ void Application::createSwapchain()
     VkPresentModeKHR presentMode = chooseSwapPresentMode(swapchainSupport.presentModes);
     VkExtent2D extent = chooseSwapExtent(swapchainSupport.capabilities);
 
-    uint32_t imageCount = swapchainSupport.capabilities.minImageCount + 1;
+    // ģʽ 3 ֡Ҫһͼ񣬻ȡͼʱصȴͷ
+    uint32_t imageCount = swapchainSupport.capabilities.minImageCount + (m_options.pacing == FramePacingMode::Throughput ? 2 : 1);
     if (swapchainSupport.capabilities.maxImageCount > 0 && imageCount > swapchainSupport.capabilities.maxImageCount)
     {
         imageCount = swapchainSupport.capabilities.maxImageCount;
@@ -841,6 +1609,46 @@ void Application::createSwapchain()
 
     m_swapchainImageFormat = surfaceFormat.format;
     m_swapchainExtent = extent;
+    m_presentMode = presentMode;
+    m_viewportWidth = extent.width;
+    m_viewportHeight = extent.height;
+}
+
+void Application::createOffscreenTargets()
+{
+    // ͨͼ潻ͼÿ֡һšRGBA ֽ˳ֱд PNGʽ֧Ϊɫ
+    m_swapchainImageFormat = VK_FORMAT_R8G8B8A8_SRGB;
+    m_swapchainExtent = m_headlessExtent;
+    m_viewportWidth = m_headlessExtent.width;
+    m_viewportHeight = m_headlessExtent.height;
+    m_swapchainImages.resize(m_framesInFlight);
+    m_offscreenImageAllocations.resize(m_framesInFlight);
+    for (size_t i = 0; i < m_framesInFlight; ++i)
+    {
+        createImage(m_swapchainExtent.width, m_swapchainExtent.height, 1, VK_SAMPLE_COUNT_1_BIT, m_swapchainImageFormat, VK_IMAGE_TILING_OPTIMAL,
+            VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_swapchainImages[i], m_offscreenImageAllocations[i]);
+    }
+
+    if (m_options.frameDumpDirectory.empty() && m_options.replayScriptPath.empty())
+    {
+        return;
+    }
+
+    // дÿһ֡ʱȾѻ渴ƵɼĻУ´εȴͬһդ֮дطֻһ
+    std::error_code errorCode;
+    if (!m_options.frameDumpDirectory.empty() && (std::filesystem::create_directories(m_options.frameDumpDirectory, errorCode), errorCode))
+    {
+        throw std::runtime_error(setFontColor("Failed to create frame dump directory: " + m_options.frameDumpDirectory, FontColor::Red));
+    }
+    const VkDeviceSize readbackSize = static_cast<VkDeviceSize>(m_swapchainExtent.width) * m_swapchainExtent.height * 4;
+    m_frameReadbackBuffers.resize(m_framesInFlight);
+    m_frameReadbackAllocations.resize(m_framesInFlight);
+    m_frameReadbackFrames.assign(m_framesInFlight, 0);
+    for (size_t i = 0; i < m_framesInFlight; ++i)
+    {
+        createBuffer(readbackSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            m_frameReadbackBuffers[i], m_frameReadbackAllocations[i]);
+    }
 }
 
 void Application::createImageViews()
@@ -876,7 +1684,7 @@ void Application::createRenderPass()
     colorAttachmentResolve.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     colorAttachmentResolve.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
     colorAttachmentResolve.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    colorAttachmentResolve.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    colorAttachmentResolve.finalLayout = m_options.headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
     VkAttachmentDescription depthAttachment
     {
         VK_FALSE,                                           // flags
@@ -951,45 +1759,189 @@ void Application::createRenderPass()
 
 void Application::createDescriptorSetLayout()
 {
+    // 񻺴еͼһĬͼ bindless 鳤ʱͼ
+    const size_t textureSlotCount = m_meshCache.getTextures().size() + 1;
+    if (m_bindlessEnabled && textureSlotCount > MAX_BINDLESS_TEXTURES)
+    {
+        m_bindlessEnabled = false;
+    }
+    // bindless ƬԪɫɹɣȱʱͬͼ
+    if (m_bindlessEnabled && !std::filesystem::exists(SHADER_INCLUDE_PATH + std::string("shader_bindless.frag.spv")))
+    {
+        std::cout << setFontColor("Bindless fragment shader not found, falling back to per texture descriptor sets", FontColor::Yellow) << std::endl;
+        m_bindlessEnabled = false;
+    }
+    std::cout << setFontColor(
+        std::string("Descriptor binding: ") + (m_bindlessEnabled ? "bindless" : "per texture") + ", " + std::to_string(textureSlotCount) + " texture slots",
+        FontColor::Green) << std::endl;
+
     VkDescriptorSetLayoutBinding descriptorSetLayoutBinding
     {
         0,                                                      // binding
-        VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,                      // descriptorType
+        VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,              // descriptorType
         1,                                                      // descriptorCount
         VK_SHADER_STAGE_VERTEX_BIT,                             // stageFlags
         nullptr                                                 // pImmutableSamplers
     };
 
+    // bindless ʱ binding 1 ͼ飬 binding 3
     VkDescriptorSetLayoutBinding samplerLayoutBinding
     {
         1,                                                  // binding
-        VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,          // descriptorType
+        m_bindlessEnabled ? VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE : VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, // descriptorType
+        m_bindlessEnabled ? MAX_BINDLESS_TEXTURES : 1,      // descriptorCount
+        VK_SHADER_STAGE_FRAGMENT_BIT,                       // stageFlags
+        nullptr                                             // pImmutableSamplers
+    };
+
+    VkDescriptorSetLayoutBinding materialLayoutBinding
+    {
+        2,                                                  // binding
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,                  // descriptorType
+        1,                                                  // descriptorCount
+        VK_SHADER_STAGE_FRAGMENT_BIT,                       // stageFlags
+        nullptr                                             // pImmutableSamplers
+    };
+
+    VkDescriptorSetLayoutBinding textureSamplerLayoutBinding
+    {
+        3,                                                  // binding
+        VK_DESCRIPTOR_TYPE_SAMPLER,                         // descriptorType
         1,                                                  // descriptorCount
         VK_SHADER_STAGE_FRAGMENT_BIT,                       // stageFlags
         nullptr                                             // pImmutableSamplers
     };
 
-    std::array<VkDescriptorSetLayoutBinding, 2> bindings{ descriptorSetLayoutBinding, samplerLayoutBinding };
+    std::array<VkDescriptorSetLayoutBinding, 4> bindings{ descriptorSetLayoutBinding, samplerLayoutBinding, materialLayoutBinding, textureSamplerLayoutBinding };
+    std::array<VkDescriptorBindingFlags, 4> bindingFlags{ 0, VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT, 0, 0 };
+    const uint32_t bindingCount = m_bindlessEnabled ? 4 : 3;
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsCreateInfo
+    {
+        VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO, // sType
+        nullptr,                                                // pNext
+        bindingCount,                                           // bindingCount
+        bindingFlags.data()                                     // pBindingFlags
+    };
 
     VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo
     {
         VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,    // sType
-        nullptr,                                                // pNext
+        m_bindlessEnabled ? &bindingFlagsCreateInfo : nullptr,  // pNext
         VK_FALSE,                                               // flags
-        static_cast<uint32_t>(bindings.size()),                 // bindingCount
+        bindingCount,                                           // bindingCount
         bindings.data()                                         // pBindings
     };
     if (vkCreateDescriptorSetLayout(m_device, &descriptorSetLayoutCreateInfo, nullptr, &m_descriptorSetLayout) != VK_SUCCESS)
     {
         throw std::runtime_error(setFontColor("Failed to create descriptor set layout", FontColor::Red));
     }
+
+    // set 1 Ϊɫȡʵݣbinding 0 Ϊ֡ʵ (̬ƫ)1 Ϊ޳ͨдĿɼʵ
+    std::array<VkDescriptorSetLayoutBinding, 2> instanceBindings{ };
+    for (uint32_t i = 0; i < instanceBindings.size(); ++i)
+    {
+        instanceBindings[i] = VkDescriptorSetLayoutBinding
+        {
+            i,                                                                                  // binding
+            i == 0 ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, // descriptorType
+            1,                                                                                  // descriptorCount
+            VK_SHADER_STAGE_VERTEX_BIT,                                                         // stageFlags
+            nullptr                                                                             // pImmutableSamplers
+        };
+    }
+    VkDescriptorSetLayoutCreateInfo instanceDescriptorSetLayoutCreateInfo
+    {
+        VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,    // sType
+        nullptr,                                                // pNext
+        VK_FALSE,                                               // flags
+        static_cast<uint32_t>(instanceBindings.size()),         // bindingCount
+        instanceBindings.data()                                 // pBindings
+    };
+    if (vkCreateDescriptorSetLayout(m_device, &instanceDescriptorSetLayoutCreateInfo, nullptr, &m_instanceDescriptorSetLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error(setFontColor("Failed to create instance descriptor set layout", FontColor::Red));
+    }
+}
+
+void Application::createPipelineCache()
+{
+    if (!m_options.pipelineCache)
+    {
+        return;
+    }
+
+    // ļʱӿջ濪ʼ豸ֱӶ
+    std::vector<char> cacheData;
+    if (loadPipelineCacheFile(PIPELINE_CACHE_PATH, cacheData))
+    {
+        VkPhysicalDeviceProperties physicalDeviceProperties;
+        vkGetPhysicalDeviceProperties(m_physicalDevice, &physicalDeviceProperties);
+        std::string error;
+        if (validatePipelineCacheData(cacheData, physicalDeviceProperties.vendorID, physicalDeviceProperties.deviceID, physicalDeviceProperties.pipelineCacheUUID, error))
+        {
+            m_pipelineCacheLoaded = true;
+        }
+        else
+        {
+            std::cout << setFontColor("Discard pipeline cache " + PIPELINE_CACHE_PATH + ": " + error, FontColor::Yellow) << std::endl;
+            cacheData.clear();
+        }
+    }
+
+    VkPipelineCacheCreateInfo pipelineCacheCreateInfo
+    {
+        VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,   // sType
+        nullptr,                                        // pNext
+        VK_FALSE,                                       // flags
+        cacheData.size(),                               // initialDataSize
+        cacheData.empty() ? nullptr : cacheData.data()  // pInitialData
+    };
+    if (vkCreatePipelineCache(m_device, &pipelineCacheCreateInfo, nullptr, &m_pipelineCache) != VK_SUCCESS)
+    {
+        throw std::runtime_error(setFontColor("Failed to create pipeline cache", FontColor::Red));
+    }
+    if (m_pipelineCacheLoaded)
+    {
+        std::cout << setFontColor("Load pipeline cache: " + PIPELINE_CACHE_PATH + ", " + std::to_string(cacheData.size()) + " bytes", FontColor::Green) << std::endl;
+    }
+}
+
+void Application::savePipelineCache()
+{
+    if (m_pipelineCache == nullptr)
+    {
+        return;
+    }
+
+    // βѯ֮仺ܱ󣬷 VK_INCOMPLETE ʱ²ѯСʵдֽܱȲѯ٣صĴСض
+    size_t cacheSize = 0;
+    std::vector<char> cacheData;
+    VkResult result = VK_INCOMPLETE;
+    while (result == VK_INCOMPLETE)
+    {
+        result = vkGetPipelineCacheData(m_device, m_pipelineCache, &cacheSize, nullptr);
+        if (result != VK_SUCCESS)
+        {
+            break;
+        }
+        cacheData.resize(cacheSize);
+        result = vkGetPipelineCacheData(m_device, m_pipelineCache, &cacheSize, cacheData.data());
+    }
+    cacheData.resize(result == VK_SUCCESS ? cacheSize : 0);
+    if (cacheData.empty() || !savePipelineCacheFile(PIPELINE_CACHE_PATH, cacheData))
+    {
+        std::cout << setFontColor("Failed to write pipeline cache: " + PIPELINE_CACHE_PATH, FontColor::Yellow) << std::endl;
+        return;
+    }
+    std::cout << setFontColor("Save pipeline cache: " + PIPELINE_CACHE_PATH + ", " + std::to_string(cacheSize) + " bytes", FontColor::Green) << std::endl;
 }
 
 void Application::createGraphicsPipeline()
 {
-    std::string vertexShaderFilePath(ASSET_INCLUDE_PATH + std::string("shaders/shader.vert.spv"));
+    std::string vertexShaderFilePath(SHADER_INCLUDE_PATH + std::string(GpuVertexLayout::SHADER_NAME));
     std::vector<char> vertexShaderCode = readFile(vertexShaderFilePath);
-    std::string fragmentShaderFilePath(ASSET_INCLUDE_PATH + std::string("shaders/shader.frag.spv"));
+    std::string fragmentShaderFilePath(SHADER_INCLUDE_PATH + std::string(m_bindlessEnabled ? "shader_bindless.frag.spv" : "shader.frag.spv"));
     std::vector<char> fragmentShaderCode = readFile(fragmentShaderFilePath);
 
     VkShaderModule vertexShaderModule = createShaderModule(vertexShaderCode);
@@ -1019,15 +1971,16 @@ void Application::createGraphicsPipeline()
     VkPipelineShaderStageCreateInfo shaderStageCreateInfos[]{ vertexShaderStageCreateInfo, fragmentShaderStageCreateInfo };
 
     // 
-    VkVertexInputBindingDescription vertexInputBindingDescription = Vertex::getBindingDescription();
-    std::array<VkVertexInputAttributeDescription, 3> vertexInputAttributeDescriptions = Vertex::getAttributeDescriptions();
+    // ֻжһ󶨣ģ;ɶɫͨɼʵŴӴ洢жȡ
+    constexpr VkVertexInputBindingDescription vertexInputBindingDescription = VertexLayoutTraits<GpuVertexLayout>::getBindingDescription();
+    constexpr std::array<VkVertexInputAttributeDescription, VertexLayoutTraits<GpuVertexLayout>::ATTRIBUTE_COUNT> vertexInputAttributeDescriptions = VertexLayoutTraits<GpuVertexLayout>::getAttributeDescriptions();
     VkPipelineVertexInputStateCreateInfo vertexInputStateCreateInfo
     {
         VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,          // sType
         nullptr,                                                            // pNext
         VK_FALSE,                                                           // flags
         1,                                                                  // vertexBindingDescriptionCount
-        & vertexInputBindingDescription,                                    // pVertexBindingDescriptions
+        &vertexInputBindingDescription,                                     // pVertexBindingDescriptions
         static_cast<uint32_t>(vertexInputAttributeDescriptions.size()),     // vertexAttributeDescriptionCount
         vertexInputAttributeDescriptions.data()                             // pVertexAttributeDescriptions
     };
@@ -1143,16 +2096,23 @@ void Application::createGraphicsPipeline()
         dynamicStates.data()                                        // pDynamicStates
     };
 
-    // ߲
+    // ߲֣ÿλͨͳָʱţset 0 ͼлset 1 ʵÿ֡һ
+    VkPushConstantRange pushConstantRange
+    {
+        VK_SHADER_STAGE_FRAGMENT_BIT,                               // stageFlags
+        0,                                                          // offset
+        sizeof(MaterialPushConstant)                                // size
+    };
+    const std::array<VkDescriptorSetLayout, 2> setLayouts{ m_descriptorSetLayout, m_instanceDescriptorSetLayout };
     VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo
     {
         VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,              // sType
         nullptr,                                                    // pNext
         VK_FALSE,                                                   // flags
-        1,                                                          // setLayoutCount
-        &m_descriptorSetLayout,                                     // pSetLayouts
-        0,                                                          // pushConstantRangeCount
-        nullptr                                                     // pPushConstantRanges
+        static_cast<uint32_t>(setLayouts.size()),                   // setLayoutCount
+        setLayouts.data(),                                          // pSetLayouts
+        1,                                                          // pushConstantRangeCount
+        &pushConstantRange                                          // pPushConstantRanges
     };
     if (vkCreatePipelineLayout(m_device, &pipelineLayoutCreateInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS)
     {
@@ -1181,15 +2141,97 @@ void Application::createGraphicsPipeline()
         nullptr,                                                    // basePipelineHandle
         0                                                           // basePipelineIndex
     };
-    if (vkCreateGraphicsPipelines(m_device, nullptr, 1, &graphicsPipelineCreateInfo, nullptr, &m_graphicsPipeline) != VK_SUCCESS)
+    const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    if (vkCreateGraphicsPipelines(m_device, m_pipelineCache, 1, &graphicsPipelineCreateInfo, nullptr, &m_graphicsPipeline) != VK_SUCCESS)
     {
         throw std::runtime_error(setFontColor("Failed to create graphics pipeline", FontColor::Red));
     }
+    m_graphicsPipelineMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
 
     vkDestroyShaderModule(m_device, vertexShaderModule, nullptr);
     vkDestroyShaderModule(m_device, fragmentShaderModule, nullptr);
 }
 
+void Application::createCullingPipeline()
+{
+    // binding 0 Ϊ֡ʵ (̬ƫ)1 ΪΧ23 ΪۼӿɼļĿɼʵţ4 Ϊ֡ÿʵ LOD (̬ƫ)
+    std::array<VkDescriptorSetLayoutBinding, 5> bindings{ };
+    for (uint32_t i = 0; i < bindings.size(); ++i)
+    {
+        bindings[i] = VkDescriptorSetLayoutBinding
+        {
+            i,                                                                                  // binding
+            i == 0 || i == 4 ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, // descriptorType
+            1,                                                                                  // descriptorCount
+            VK_SHADER_STAGE_COMPUTE_BIT,                                                        // stageFlags
+            nullptr                                                                             // pImmutableSamplers
+        };
+    }
+    VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo
+    {
+        VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,    // sType
+        nullptr,                                                // pNext
+        VK_FALSE,                                               // flags
+        static_cast<uint32_t>(bindings.size()),                 // bindingCount
+        bindings.data()                                         // pBindings
+    };
+    if (vkCreateDescriptorSetLayout(m_device, &descriptorSetLayoutCreateInfo, nullptr, &m_cullingDescriptorSetLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error(setFontColor("Failed to create culling descriptor set layout", FontColor::Red));
+    }
+
+    // ׶ƽͨͳ
+    VkPushConstantRange pushConstantRange
+    {
+        VK_SHADER_STAGE_COMPUTE_BIT,                                // stageFlags
+        0,                                                          // offset
+        sizeof(CullingPushConstant)                                 // size
+    };
+    VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo
+    {
+        VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,              // sType
+        nullptr,                                                    // pNext
+        VK_FALSE,                                                   // flags
+        1,                                                          // setLayoutCount
+        &m_cullingDescriptorSetLayout,                              // pSetLayouts
+        1,                                                          // pushConstantRangeCount
+        &pushConstantRange                                          // pPushConstantRanges
+    };
+    if (vkCreatePipelineLayout(m_device, &pipelineLayoutCreateInfo, nullptr, &m_cullingPipelineLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error(setFontColor("Failed to create culling pipeline layout", FontColor::Red));
+    }
+
+    std::vector<char> computeShaderCode = readFile(SHADER_INCLUDE_PATH + std::string("cull.comp.spv"));
+    VkShaderModule computeShaderModule = createShaderModule(computeShaderCode);
+    VkComputePipelineCreateInfo computePipelineCreateInfo
+    {
+        VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,             // sType
+        nullptr,                                                    // pNext
+        VK_FALSE,                                                   // flags
+        {
+            VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,    // sType
+            nullptr,                                                // pNext
+            VK_FALSE,                                               // flags
+            VK_SHADER_STAGE_COMPUTE_BIT,                            // stage
+            computeShaderModule,                                    // module
+            "main",                                                 // pName
+            nullptr                                                 // pSpecializationInfo
+        },                                                          // stage
+        m_cullingPipelineLayout,                                    // layout
+        nullptr,                                                    // basePipelineHandle
+        0                                                           // basePipelineIndex
+    };
+    const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    if (vkCreateComputePipelines(m_device, m_pipelineCache, 1, &computePipelineCreateInfo, nullptr, &m_cullingPipeline) != VK_SUCCESS)
+    {
+        throw std::runtime_error(setFontColor("Failed to create culling pipeline", FontColor::Red));
+    }
+    m_cullingPipelineMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+    vkDestroyShaderModule(m_device, computeShaderModule, nullptr);
+}
+
 VkShaderModule Application::createShaderModule(const std::vector<char>& _code)
 {
     VkShaderModuleCreateInfo createInfo
@@ -1252,9 +2294,77 @@ void Application::createCommandPool()
     {
         throw std::runtime_error(setFontColor("Failed to create command pool", FontColor::Red));
     }
+
+    // ͼϴ壬ÿϴɺͷ
+    VkCommandPoolCreateInfo transferCommandPoolCreateInfo
+    {
+        VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,         // sType
+        nullptr,                                            // pNext
+        VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,               // flags
+        queueFamilyIndices.transferFamily.value()           // queueFamilyIndex
+    };
+    if (vkCreateCommandPool(m_device, &transferCommandPoolCreateInfo, nullptr, &m_transferCommandPool) != VK_SUCCESS)
+    {
+        throw std::runtime_error(setFontColor("Failed to create transfer command pool", FontColor::Red));
+    }
+}
+
+void Application::createMemoryAllocator()
+{
+    // ڴͱֻѯһΣ֮ԴӷĿӷ
+    VkPhysicalDeviceMemoryProperties memoryProperties;
+    vkGetPhysicalDeviceMemoryProperties(m_physicalDevice, &memoryProperties);
+    VkPhysicalDeviceProperties physicalDeviceProperties;
+    vkGetPhysicalDeviceProperties(m_physicalDevice, &physicalDeviceProperties);
+
+    GpuMemoryCallbacks callbacks;
+    callbacks.allocate = [this](uint32_t _memoryTypeIndex, VkDeviceSize _size) -> VkDeviceMemory
+    {
+        VkMemoryAllocateInfo memoryAllocateInfo
+        {
+            VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,     // sType
+            nullptr,                                    // pNext
+            _size,                                      // allocationSize
+            _memoryTypeIndex                            // memoryTypeIndex
+        };
+        VkDeviceMemory memory = nullptr;
+        if (vkAllocateMemory(m_device, &memoryAllocateInfo, nullptr, &memory) != VK_SUCCESS)
+        {
+            return nullptr;
+        }
+        return memory;
+    };
+    callbacks.free = [this](VkDeviceMemory _memory)
+    {
+        vkFreeMemory(m_device, _memory, nullptr);
+    };
+    callbacks.map = [this](VkDeviceMemory _memory, VkDeviceSize _size) -> void*
+    {
+        void* data = nullptr;
+        vkMapMemory(m_device, _memory, 0, _size, 0, &data);
+        return data;
+    };
+
+    m_memoryAllocator.init(memoryProperties, physicalDeviceProperties.limits.bufferImageGranularity, callbacks);
+}
+
+void Application::reportMemoryStatistics()
+{
+    GpuMemoryStatistics statistics = m_memoryAllocator.getStatistics();
+    std::cout << setFontColor(
+        "GPU memory: " + std::to_string(statistics.allocationCount) + " allocations in " + std::to_string(statistics.deviceMemoryCount) + " device memory objects, statistics: " + MEMORY_STATISTICS_PATH,
+        FontColor::Green) << std::endl;
+
+    std::ofstream file(MEMORY_STATISTICS_PATH);
+    if (!file)
+    {
+        std::cout << setFontColor("Failed to write GPU memory statistics: " + MEMORY_STATISTICS_PATH, FontColor::Yellow) << std::endl;
+        return;
+    }
+    file << m_memoryAllocator.getStatisticsJson();
 }
 
-void Application::createBuffer(VkDeviceSize _size, VkBufferUsageFlags _usageFlags, VkMemoryPropertyFlags _propertyFlags, VkBuffer& _buffer, VkDeviceMemory& _deviceMemory)
+void Application::createBuffer(VkDeviceSize _size, VkBufferUsageFlags _usageFlags, VkMemoryPropertyFlags _propertyFlags, VkBuffer& _buffer, GpuAllocation& _allocation)
 {
     VkBufferCreateInfo bufferCreateInfo
     {
@@ -1275,40 +2385,38 @@ void Application::createBuffer(VkDeviceSize _size, VkBufferUsageFlags _usageFlag
     VkMemoryRequirements memoryRequirements;
     vkGetBufferMemoryRequirements(m_device, _buffer, &memoryRequirements);
 
-    VkMemoryAllocateInfo memoryAllocateInfo
-    {
-        VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,                                 // sType
-        nullptr,                                                                // pNext
-        memoryRequirements.size,                                                // allocationSize
-        findMemoryType(memoryRequirements.memoryTypeBits, _propertyFlags)       // memoryTypeIndex
-    };
-    if (vkAllocateMemory(m_device, &memoryAllocateInfo, nullptr, &_deviceMemory) != VK_SUCCESS)
+    // ʱͬʱԴ
     {
-        throw std::runtime_error(setFontColor("Failed to allocate buffer memory", FontColor::Red));
+        std::lock_guard<std::mutex> lock(m_memoryAllocatorMutex);
+        _allocation = m_memoryAllocator.allocate(memoryRequirements, _propertyFlags, GpuResourceKind::Linear);
     }
-
-    vkBindBufferMemory(m_device, _buffer, _deviceMemory, 0);
+    vkBindBufferMemory(m_device, _buffer, _allocation.memory, _allocation.offset);
 }
 
-void Application::copyBuffer(VkBuffer _srcBuffer, VkBuffer _dstBuffer, VkDeviceSize _size)
+void Application::createUploadBatcher()
 {
-    VkCommandBuffer commandBuffer = beginSingleTimeCommands();
-
-    VkBufferCopy copyRegion
-    {
-        0,                          // srcOffset
-        0,                          // dstOffset
-        _size                       // size
-    };
-    vkCmdCopyBuffer(commandBuffer, _srcBuffer, _dstBuffer, 1, &copyRegion);
+    createBuffer(UPLOAD_RING_SIZE, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_uploadRingBuffer, m_uploadRingAllocation);
+    m_uploadBatcher.init(m_device, m_graphicsQueue, m_commandPool, m_uploadRingBuffer, m_uploadRingAllocation.mapped, UPLOAD_RING_SIZE);
+}
 
-    endSingleTimeCommands(commandBuffer);
+void Application::flushUploads()
+{
+    m_uploadBatcher.flush();
+
+    const UploadStatistics& statistics = m_uploadBatcher.getStatistics();
+    std::cout << setFontColor(
+        "Upload batcher:\n"
+        "\tcopies: " + std::to_string(statistics.copyCount) + "\n"
+        + "\tbytes: " + std::to_string(statistics.bytesUploaded) + "\n"
+        + "\tsubmits: " + std::to_string(statistics.submitCount) + "\n"
+        + "\tflush: " + std::to_string(statistics.flushMilliseconds) + " ms",
+        FontColor::Green) << std::endl;
 }
 
 void Application::createDepthResource()
 {
     VkFormat depthFormat = findDepthFormat();
-    createImage(m_swapchainExtent.width, m_swapchainExtent.height, 1, m_massSamples, depthFormat, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_depthImage, m_depthImageMemory);
+    createImage(m_swapchainExtent.width, m_swapchainExtent.height, 1, m_massSamples, depthFormat, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_depthImage, m_depthImageAllocation);
     m_depthImageView = createImageView(m_depthImage, depthFormat, VK_IMAGE_ASPECT_DEPTH_BIT, 1);
 }
 
@@ -1316,7 +2424,7 @@ void Application::createColorResource()
 {
     VkFormat format = m_swapchainImageFormat;
 
-    createImage(m_swapchainExtent.width, m_swapchainExtent.height, 1, m_massSamples, format, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_colorImage, m_colorImageMemory);
+    createImage(m_swapchainExtent.width, m_swapchainExtent.height, 1, m_massSamples, format, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_colorImage, m_colorImageAllocation);
     m_colorImageView = createImageView(m_colorImage, format, VK_IMAGE_ASPECT_COLOR_BIT, 1);
 }
 
@@ -1354,7 +2462,7 @@ bool Application::hasStencilComponent(VkFormat _format)
     return _format == VK_FORMAT_D32_SFLOAT_S8_UINT || _format == VK_FORMAT_D24_UNORM_S8_UINT;
 }
 
-void Application::generateMipmaps(VkImage _image, VkFormat _format, int32_t _textureWidth, int32_t _textureHeight, uint32_t _mipLevels)
+void Application::generateMipmaps(VkCommandBuffer _commandBuffer, VkImage _image, VkFormat _format, int32_t _textureWidth, int32_t _textureHeight, uint32_t _mipLevels)
 {
     VkFormatProperties formatProperties;
     vkGetPhysicalDeviceFormatProperties(m_physicalDevice, _format, &formatProperties);
@@ -1363,8 +2471,6 @@ void Application::generateMipmaps(VkImage _image, VkFormat _format, int32_t _tex
         throw std::runtime_error(setFontColor("Texture image format does not support linear blitting", FontColor::Red));
     }
 
-    VkCommandBuffer commandBuffer = beginSingleTimeCommands();
-
     VkImageMemoryBarrier imageMemoryBarrier{ };
     imageMemoryBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
     imageMemoryBarrier.image = _image;
@@ -1385,7 +2491,7 @@ void Application::generateMipmaps(VkImage _image, VkFormat _format, int32_t _tex
         imageMemoryBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
         imageMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
         imageMemoryBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
+        vkCmdPipelineBarrier(_commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
 
         VkImageBlit imageBlit{ };
         imageBlit.srcOffsets[0] = { 0, 0, 0 };
@@ -1400,13 +2506,13 @@ void Application::generateMipmaps(VkImage _image, VkFormat _format, int32_t _tex
         imageBlit.dstSubresource.mipLevel = i;
         imageBlit.dstSubresource.baseArrayLayer = 0;
         imageBlit.dstSubresource.layerCount = 1;
-        vkCmdBlitImage(commandBuffer, _image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, _image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &imageBlit, VK_FILTER_LINEAR);
+        vkCmdBlitImage(_commandBuffer, _image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, _image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &imageBlit, VK_FILTER_LINEAR);
 
         imageMemoryBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
         imageMemoryBarrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
         imageMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
         imageMemoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
+        vkCmdPipelineBarrier(_commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
 
         if (mipWidth > 1) mipWidth /= 2;
         if (mipHeight > 1) mipHeight /= 2;
@@ -1417,107 +2523,346 @@ void Application::generateMipmaps(VkImage _image, VkFormat _format, int32_t _tex
     imageMemoryBarrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
     imageMemoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
     imageMemoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
-
-    endSingleTimeCommands(commandBuffer);
+    vkCmdPipelineBarrier(_commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
 }
 
 void Application::createTextureImage()
 {
-    int textureWidth, textureHeight, textureChannels;
-    stbi_uc* pixels = stbi_load(TEXTURE_PATH.c_str(), &textureWidth, &textureHeight, &textureChannels, STBI_rgb_alpha);
-    VkDeviceSize imageSize = textureWidth * textureHeight * 4;
-    m_mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(textureWidth, textureHeight)))) + 1;
-
-    if (!pixels)
+    // 񻺴еͼռǰĲλһλûͼʹá
+    // ͼڹ߳н룬ǰλʹռλͼһ֡ȴͼȡ
+    const size_t separator = MODEL_PATH.find_last_of("/\\");
+    const std::string modelDirectory = separator == std::string::npos ? std::string() : MODEL_PATH.substr(0, separator + 1);
+    const std::vector<std::string>& textures = m_meshCache.getTextures();
+
+    createPlaceholderTexture();
+
+    m_textures.assign(textures.size() + 1, TextureResource{ });
+    m_textureDescriptorDirtyFrames.assign(m_textures.size(), 0);
+    m_textureStreamingStartTime = std::chrono::steady_clock::now();
+    // ռọ́߳߳ÿ֡Ĳܱ̼߳ʱִ
+    const uint32_t threadCount = getJobSystem().getThreadCount();
+    m_textureStreamer.start(static_cast<uint32_t>(std::min<size_t>(std::max(1u, threadCount - 1), m_textures.size())));
+    for (size_t i = 0; i < m_textures.size(); ++i)
     {
-        throw std::runtime_error(setFontColor("Failed to load texture image", FontColor::Red));
+        m_textureStreamer.request(static_cast<uint32_t>(i), i < textures.size() ? modelDirectory + textures[i] : TEXTURE_PATH);
     }
+}
 
-    VkBuffer stagingBuffer;
-    VkDeviceMemory stagingBufferMemory;
-    createBuffer(imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory);
-
-    void* data;
-    vkMapMemory(m_device, stagingBufferMemory, 0, imageSize, 0, &data);
-    std::memcpy(data, pixels, static_cast<size_t>(imageSize));
-    vkUnmapMemory(m_device, stagingBufferMemory);
-
-    stbi_image_free(pixels);
-
-    createImage(textureWidth, textureHeight, m_mipLevels, VK_SAMPLE_COUNT_1_BIT, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_textureImage, m_textureImageMemory);
-
-    transitionImageLayout(m_textureImage, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, m_mipLevels);
-    copyBufferToImage(stagingBuffer, m_textureImage, static_cast<uint32_t>(textureWidth), static_cast<uint32_t>(textureHeight));
-    // transitionImageLayout(m_textureImage, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, m_mipLevels);
+void Application::createPlaceholderTexture()
+{
+    // 1x1 Ļɫͼ񻺳һʱϴ
+    const uint8_t pixel[4]{ 128, 128, 128, 255 };
 
-    vkDestroyBuffer(m_device, stagingBuffer, nullptr);
-    vkFreeMemory(m_device, stagingBufferMemory, nullptr);
+    m_placeholderTexture.mipLevels = 1;
+    createImage(1, 1, 1, VK_SAMPLE_COUNT_1_BIT, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_placeholderTexture.image, m_placeholderTexture.imageAllocation);
 
-    generateMipmaps(m_textureImage, VK_FORMAT_R8G8B8A8_SRGB, textureWidth, textureHeight, m_mipLevels);
+    transitionImageLayout(m_uploadBatcher.getCommandBuffer(), m_placeholderTexture.image, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1);
+    m_uploadBatcher.uploadImage(m_placeholderTexture.image, 1, 1, pixel, sizeof(pixel));
+    transitionImageLayout(m_uploadBatcher.getCommandBuffer(), m_placeholderTexture.image, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, 1);
 }
 
-void Application::createTextureImageView()
+void Application::uploadTexture(DecodedTexture& _decodedTexture)
 {
-    m_textureImageView = createImageView(m_textureImage, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_ASPECT_COLOR_BIT, m_mipLevels);
-}
+    if (!_decodedTexture.pixels)
+    {
+        throw std::runtime_error(setFontColor("Failed to load texture image: " + _decodedTexture.filename, FontColor::Red));
+    }
 
-void Application::createTextureSampler()
-{
-    VkSamplerCreateInfo samplerCreateInfo{ };
-    samplerCreateInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
-    samplerCreateInfo.magFilter = VK_FILTER_LINEAR;
-    samplerCreateInfo.minFilter = VK_FILTER_LINEAR;
-    samplerCreateInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-    samplerCreateInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-    samplerCreateInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    TextureUpload textureUpload;
+    textureUpload.slot = _decodedTexture.slot;
+    textureUpload.filename = _decodedTexture.filename;
+    TextureResource& texture = textureUpload.texture;
 
-    samplerCreateInfo.anisotropyEnable = VK_TRUE;
-    VkPhysicalDeviceProperties physicalDeviceProperties{ };
-    vkGetPhysicalDeviceProperties(m_physicalDevice, &physicalDeviceProperties);
-    samplerCreateInfo.maxAnisotropy = physicalDeviceProperties.limits.maxSamplerAnisotropy;
-    // samplerCreateInfo.anisotropyEnable = VK_FALSE;
-    // samplerCreateInfo.maxAnisotropy = physicalDeviceProperties.limits.maxSamplerAnisotropy;
+    const int32_t textureWidth = _decodedTexture.width;
+    const int32_t textureHeight = _decodedTexture.height;
+    VkDeviceSize imageSize = static_cast<VkDeviceSize>(textureWidth) * textureHeight * 4;
+    texture.mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(textureWidth, textureHeight)))) + 1;
 
-    samplerCreateInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
-    samplerCreateInfo.unnormalizedCoordinates = VK_FALSE;
-    samplerCreateInfo.compareEnable = VK_FALSE;
-    samplerCreateInfo.compareOp = VK_COMPARE_OP_ALWAYS;
-    samplerCreateInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
-    samplerCreateInfo.minLod = static_cast<float>(m_mipLevels / 2);
-    samplerCreateInfo.maxLod = static_cast<float>(m_mipLevels);
-    samplerCreateInfo.mipLodBias = 0.0f;
-    if (vkCreateSampler(m_device, &samplerCreateInfo, nullptr, &m_textureSampler) != VK_SUCCESS)
-    {
-        throw std::runtime_error(setFontColor("Failed to create texture sampler", FontColor::Red));
-    }
-}
+    createBuffer(imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, textureUpload.stagingBuffer, textureUpload.stagingBufferAllocation);
 
-VkImageView Application::createImageView(VkImage _image, VkFormat _format, VkImageAspectFlags _imageAspectFlags, uint32_t _mipLevels)
-{
-    VkImageViewCreateInfo imageViewCreateInfo
+    std::memcpy(textureUpload.stagingBufferAllocation.mapped, _decodedTexture.pixels.get(), static_cast<size_t>(imageSize));
+    _decodedTexture.pixels.reset();
+
+    createImage(textureWidth, textureHeight, texture.mipLevels, VK_SAMPLE_COUNT_1_BIT, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, texture.image, texture.imageAllocation);
+
+    // в blitֻѵ 0 Ƶͼ񣻶岻ͬʱͷͼȨ
+    const uint32_t graphicsFamily = m_queueFamilyIndices.graphicsFamily.value();
+    const uint32_t transferFamily = m_queueFamilyIndices.transferFamily.value();
+    VkImageMemoryBarrier ownershipBarrier
     {
-        VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,               // sType
+        VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,                 // sType
         nullptr,                                                // pNext
-        VK_FALSE,                                               // flags
-        _image,                                                 // image
-        VK_IMAGE_VIEW_TYPE_2D,                                  // viewType
-        _format,                                                // format
-        {
-            VK_COMPONENT_SWIZZLE_IDENTITY,
-            VK_COMPONENT_SWIZZLE_IDENTITY,
-            VK_COMPONENT_SWIZZLE_IDENTITY,
-            VK_COMPONENT_SWIZZLE_IDENTITY
-        },                                                      // components
+        VK_ACCESS_TRANSFER_WRITE_BIT,                           // srcAccessMask
+        0,                                                      // dstAccessMask
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,                   // oldLayout
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,                   // newLayout
+        transferFamily,                                         // srcQueueFamilyIndex
+        graphicsFamily,                                         // dstQueueFamilyIndex
+        texture.image,                                          // image
         {
-            _imageAspectFlags,
+            VK_IMAGE_ASPECT_COLOR_BIT,
             0,
-            _mipLevels,
+            texture.mipLevels,
             0,
             1
         }                                                       // subresourceRange
     };
-    VkImageView imageView;
+
+    textureUpload.transferCommandBuffer = beginCommandBuffer(m_transferCommandPool);
+    transitionImageLayout(textureUpload.transferCommandBuffer, texture.image, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, texture.mipLevels);
+    copyBufferToImage(textureUpload.transferCommandBuffer, textureUpload.stagingBuffer, texture.image, static_cast<uint32_t>(textureWidth), static_cast<uint32_t>(textureHeight));
+    if (transferFamily != graphicsFamily)
+    {
+        vkCmdPipelineBarrier(textureUpload.transferCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &ownershipBarrier);
+    }
+    vkEndCommandBuffer(textureUpload.transferCommandBuffer);
+
+    // иԵԼʱź֮ύûȺ˳򣬹һźʱύֵȷź
+    const uint64_t transferValue = ++m_textureTransferValue;
+    VkTimelineSemaphoreSubmitInfo transferTimelineSubmitInfo
+    {
+        VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,       // sType
+        nullptr,                                                // pNext
+        0,                                                      // waitSemaphoreValueCount
+        nullptr,                                                // pWaitSemaphoreValues
+        1,                                                      // signalSemaphoreValueCount
+        &transferValue                                          // pSignalSemaphoreValues
+    };
+    VkSubmitInfo transferSubmitInfo
+    {
+        VK_STRUCTURE_TYPE_SUBMIT_INFO,                          // sType
+        &transferTimelineSubmitInfo,                            // pNext
+        0,                                                      // waitSemaphoreCount
+        nullptr,                                                // pWaitSemaphores
+        nullptr,                                                // pWaitDstStageMask
+        1,                                                      // commandBufferCount
+        &textureUpload.transferCommandBuffer,                   // pCommandBuffers
+        1,                                                      // signalSemaphoreCount
+        &m_textureTransferSemaphore                             // pSignalSemaphores
+    };
+    if (vkQueueSubmit(m_transferQueue, 1, &transferSubmitInfo, nullptr) != VK_SUCCESS)
+    {
+        throw std::runtime_error(setFontColor("Failed to submit texture upload: " + textureUpload.filename, FontColor::Red));
+    }
+
+    // ͼζеȴɣȡȨ mip ʱͼ SHADER_READ_ONLY_OPTIMAL
+    textureUpload.graphicsCommandBuffer = beginCommandBuffer(m_commandPool);
+    if (transferFamily != graphicsFamily)
+    {
+        ownershipBarrier.srcAccessMask = 0;
+        ownershipBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+        vkCmdPipelineBarrier(textureUpload.graphicsCommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &ownershipBarrier);
+    }
+    generateMipmaps(textureUpload.graphicsCommandBuffer, texture.image, VK_FORMAT_R8G8B8A8_SRGB, textureWidth, textureHeight, texture.mipLevels);
+    vkEndCommandBuffer(textureUpload.graphicsCommandBuffer);
+
+    textureUpload.readyValue = ++m_textureGraphicsValue;
+    VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    VkTimelineSemaphoreSubmitInfo graphicsTimelineSubmitInfo
+    {
+        VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,       // sType
+        nullptr,                                                // pNext
+        1,                                                      // waitSemaphoreValueCount
+        &transferValue,                                         // pWaitSemaphoreValues
+        1,                                                      // signalSemaphoreValueCount
+        &textureUpload.readyValue                               // pSignalSemaphoreValues
+    };
+    VkSubmitInfo graphicsSubmitInfo
+    {
+        VK_STRUCTURE_TYPE_SUBMIT_INFO,                          // sType
+        &graphicsTimelineSubmitInfo,                            // pNext
+        1,                                                      // waitSemaphoreCount
+        &m_textureTransferSemaphore,                            // pWaitSemaphores
+        &waitStage,                                             // pWaitDstStageMask
+        1,                                                      // commandBufferCount
+        &textureUpload.graphicsCommandBuffer,                   // pCommandBuffers
+        1,                                                      // signalSemaphoreCount
+        &m_textureGraphicsSemaphore                             // pSignalSemaphores
+    };
+    if (vkQueueSubmit(m_graphicsQueue, 1, &graphicsSubmitInfo, nullptr) != VK_SUCCESS)
+    {
+        throw std::runtime_error(setFontColor("Failed to submit texture mipmap generation: " + textureUpload.filename, FontColor::Red));
+    }
+
+    m_textureUploads.push_back(std::move(textureUpload));
+}
+
+void Application::finishTextureUpload(TextureUpload& _textureUpload)
+{
+    vkFreeCommandBuffers(m_device, m_transferCommandPool, 1, &_textureUpload.transferCommandBuffer);
+    vkFreeCommandBuffers(m_device, m_commandPool, 1, &_textureUpload.graphicsCommandBuffer);
+    vkDestroyBuffer(m_device, _textureUpload.stagingBuffer, nullptr);
+    m_memoryAllocator.free(_textureUpload.stagingBufferAllocation);
+
+    TextureResource& texture = _textureUpload.texture;
+    texture.imageView = createImageView(texture.image, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_ASPECT_COLOR_BIT, texture.mipLevels);
+    m_textures[_textureUpload.slot] = texture;
+    m_textureDescriptorDirtyFrames[_textureUpload.slot] = (1u << m_framesInFlight) - 1;
+}
+
+void Application::updateTextureStreaming()
+{
+    // ϵͳֻ߳ʱûִ߳нÿ֡߳̽һ
+    if (getJobSystem().getThreadCount() == 1)
+    {
+        getJobSystem().runPendingJob();
+    }
+
+    // ɵͼύϴȴ GPU
+    std::vector<DecodedTexture> decodedTextures;
+    m_textureStreamer.takeDecoded(decodedTextures);
+    for (DecodedTexture& decodedTexture : decodedTextures)
+    {
+        uploadTexture(decodedTexture);
+    }
+
+    if (!m_textureUploads.empty())
+    {
+        uint64_t completedValue = 0;
+        // mip ɲפֻͼζеź
+        vkGetSemaphoreCounterValue(m_device, m_textureGraphicsSemaphore, &completedValue);
+
+        size_t uploadCount = 0;
+        for (size_t i = 0; i < m_textureUploads.size(); ++i)
+        {
+            if (m_textureUploads[i].readyValue <= completedValue)
+            {
+                finishTextureUpload(m_textureUploads[i]);
+            }
+            else
+            {
+                if (uploadCount != i)
+                {
+                    m_textureUploads[uploadCount] = std::move(m_textureUploads[i]);
+                }
+                ++uploadCount;
+            }
+        }
+        m_textureUploads.resize(uploadCount);
+
+        if (m_textureUploads.empty() && m_textureStreamer.getPendingCount() == 0)
+        {
+            double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_textureStreamingStartTime).count();
+            std::cout << setFontColor(
+                "Texture streaming: " + std::to_string(m_textures.size()) + " textures resident after " + std::to_string(milliseconds) + " ms",
+                FontColor::Green) << std::endl;
+        }
+    }
+
+    // ǰ֡դѾȴٱ GPU ʹã԰ռλͼѾͼ
+    for (uint32_t slot = 0; slot < m_textureDescriptorDirtyFrames.size(); ++slot)
+    {
+        const uint32_t frameBit = 1u << m_currentFrame;
+        if (m_textureDescriptorDirtyFrames[slot] & frameBit)
+        {
+            writeTextureDescriptor(m_currentFrame, slot);
+            m_textureDescriptorDirtyFrames[slot] &= ~frameBit;
+        }
+    }
+}
+
+void Application::writeTextureDescriptor(uint32_t _frame, uint32_t _slot)
+{
+    VkDescriptorImageInfo descriptorImageInfo
+    {
+        m_bindlessEnabled ? nullptr : m_textureSampler,         // sampler
+        getTextureImageView(_slot),                             // imageView
+        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL                // imageLayout
+    };
+
+    VkWriteDescriptorSet writeDescriptorSet{ };
+    writeDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    writeDescriptorSet.dstBinding = 1;
+    writeDescriptorSet.descriptorCount = 1;
+    writeDescriptorSet.pImageInfo = &descriptorImageInfo;
+    if (m_bindlessEnabled)
+    {
+        writeDescriptorSet.dstSet = m_descriptorSets[_frame];
+        writeDescriptorSet.dstArrayElement = _slot;
+        writeDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+    }
+    else
+    {
+        writeDescriptorSet.dstSet = m_descriptorSets[_frame * m_textures.size() + _slot];
+        writeDescriptorSet.dstArrayElement = 0;
+        writeDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    }
+    vkUpdateDescriptorSets(m_device, 1, &writeDescriptorSet, 0, nullptr);
+}
+
+uint32_t Application::getTextureSlot(uint32_t _textureIndex) const
+{
+    return _textureIndex == Submesh::NO_TEXTURE ? static_cast<uint32_t>(m_textures.size() - 1) : _textureIndex;
+}
+
+VkImageView Application::getTextureImageView(uint32_t _slot) const
+{
+    return m_textures[_slot].imageView != nullptr ? m_textures[_slot].imageView : m_placeholderTexture.imageView;
+}
+
+void Application::createTextureImageView()
+{
+    // ʽϴͼϴʱͼ
+    m_placeholderTexture.imageView = createImageView(m_placeholderTexture.image, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_ASPECT_COLOR_BIT, m_placeholderTexture.mipLevels);
+}
+
+void Application::createTextureSampler()
+{
+    VkSamplerCreateInfo samplerCreateInfo{ };
+    samplerCreateInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerCreateInfo.magFilter = VK_FILTER_LINEAR;
+    samplerCreateInfo.minFilter = VK_FILTER_LINEAR;
+    samplerCreateInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    samplerCreateInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    samplerCreateInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+
+    samplerCreateInfo.anisotropyEnable = VK_TRUE;
+    VkPhysicalDeviceProperties physicalDeviceProperties{ };
+    vkGetPhysicalDeviceProperties(m_physicalDevice, &physicalDeviceProperties);
+    samplerCreateInfo.maxAnisotropy = physicalDeviceProperties.limits.maxSamplerAnisotropy;
+    // samplerCreateInfo.anisotropyEnable = VK_FALSE;
+    // samplerCreateInfo.maxAnisotropy = physicalDeviceProperties.limits.maxSamplerAnisotropy;
+
+    samplerCreateInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+    samplerCreateInfo.unnormalizedCoordinates = VK_FALSE;
+    samplerCreateInfo.compareEnable = VK_FALSE;
+    samplerCreateInfo.compareOp = VK_COMPARE_OP_ALWAYS;
+    samplerCreateInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+    // ͼ mip ҪȽ֪ LOD Χ
+    samplerCreateInfo.minLod = 0.0f;
+    samplerCreateInfo.maxLod = VK_LOD_CLAMP_NONE;
+    samplerCreateInfo.mipLodBias = 0.0f;
+    if (vkCreateSampler(m_device, &samplerCreateInfo, nullptr, &m_textureSampler) != VK_SUCCESS)
+    {
+        throw std::runtime_error(setFontColor("Failed to create texture sampler", FontColor::Red));
+    }
+}
+
+VkImageView Application::createImageView(VkImage _image, VkFormat _format, VkImageAspectFlags _imageAspectFlags, uint32_t _mipLevels)
+{
+    VkImageViewCreateInfo imageViewCreateInfo
+    {
+        VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,               // sType
+        nullptr,                                                // pNext
+        VK_FALSE,                                               // flags
+        _image,                                                 // image
+        VK_IMAGE_VIEW_TYPE_2D,                                  // viewType
+        _format,                                                // format
+        {
+            VK_COMPONENT_SWIZZLE_IDENTITY,
+            VK_COMPONENT_SWIZZLE_IDENTITY,
+            VK_COMPONENT_SWIZZLE_IDENTITY,
+            VK_COMPONENT_SWIZZLE_IDENTITY
+        },                                                      // components
+        {
+            _imageAspectFlags,
+            0,
+            _mipLevels,
+            0,
+            1
+        }                                                       // subresourceRange
+    };
+    VkImageView imageView;
     if (vkCreateImageView(m_device, &imageViewCreateInfo, nullptr, &imageView) != VK_SUCCESS)
     {
         throw std::runtime_error(setFontColor("Failed to create texture image view", FontColor::Red));
@@ -1525,7 +2870,7 @@ VkImageView Application::createImageView(VkImage _image, VkFormat _format, VkIma
     return imageView;
 }
 
-void Application::createImage(uint32_t _width, uint32_t _height, uint32_t _mipLevels, VkSampleCountFlagBits _sampleCountFlagBits, VkFormat _format, VkImageTiling _imageTiling, VkImageUsageFlags _imageUsageFlags, VkMemoryPropertyFlags _memoryPropertyFlags, VkImage& _image, VkDeviceMemory& _imageMemory)
+void Application::createImage(uint32_t _width, uint32_t _height, uint32_t _mipLevels, VkSampleCountFlagBits _sampleCountFlagBits, VkFormat _format, VkImageTiling _imageTiling, VkImageUsageFlags _imageUsageFlags, VkMemoryPropertyFlags _memoryPropertyFlags, VkImage& _image, GpuAllocation& _imageAllocation)
 {
     VkImageCreateInfo imageCreateInfo
     {
@@ -1557,28 +2902,23 @@ void Application::createImage(uint32_t _width, uint32_t _height, uint32_t _mipLe
     VkMemoryRequirements memoryRequirements;
     vkGetImageMemoryRequirements(m_device, _image, &memoryRequirements);
 
-    VkMemoryAllocateInfo memoryAllocateInfo
-    {
-        VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,                                                     // sType
-        nullptr,                                                                                    // pNext
-        memoryRequirements.size,                                                                    // allocationSize
-        findMemoryType(memoryRequirements.memoryTypeBits, _memoryPropertyFlags)      // memoryTypeIndex
-    };
-    if (vkAllocateMemory(m_device, &memoryAllocateInfo, nullptr, &_imageMemory) != VK_SUCCESS)
+    // ɫȸ潻ؽʹö䣬ڿ´Ƭն
+    const bool dedicated = (_imageUsageFlags & (VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT)) != 0;
+    const GpuResourceKind kind = _imageTiling == VK_IMAGE_TILING_OPTIMAL ? GpuResourceKind::Optimal : GpuResourceKind::Linear;
     {
-        throw std::runtime_error(setFontColor("Failed to allocate image memory", FontColor::Red));
+        std::lock_guard<std::mutex> lock(m_memoryAllocatorMutex);
+        _imageAllocation = m_memoryAllocator.allocate(memoryRequirements, _memoryPropertyFlags, kind, dedicated);
     }
-
-    vkBindImageMemory(m_device, _image, _imageMemory, 0);
+    vkBindImageMemory(m_device, _image, _imageAllocation.memory, _imageAllocation.offset);
 }
 
-VkCommandBuffer Application::beginSingleTimeCommands()
+VkCommandBuffer Application::beginCommandBuffer(VkCommandPool _commandPool)
 {
     VkCommandBufferAllocateInfo commandBufferAllocateInfo
     {
         VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,             // sType
         nullptr,                                                    // pNext
-        m_commandPool,                                              // commandPool
+        _commandPool,                                               // commandPool
         VK_COMMAND_BUFFER_LEVEL_PRIMARY,                            // level
         1                                                           // commandBufferCount
     };
@@ -1598,33 +2938,8 @@ VkCommandBuffer Application::beginSingleTimeCommands()
     return commandBuffer;
 }
 
-void Application::endSingleTimeCommands(VkCommandBuffer _commandBuffer)
-{
-    vkEndCommandBuffer(_commandBuffer);
-
-    VkSubmitInfo submitInfo
-    {
-        VK_STRUCTURE_TYPE_SUBMIT_INFO,                  // sType
-        nullptr,                                        // pNext
-        0,                                              // waitSemaphoreCount
-        nullptr,                                        // pWaitSemaphores
-        nullptr,                                        // pWaitDstStageMask
-        1,                                              // commandBufferCount
-        &_commandBuffer,                                // pCommandBuffers
-        0,                                              // signalSemaphoreCount
-        nullptr                                         // pSignalSemaphores
-    };
-
-    vkQueueSubmit(m_graphicsQueue, 1, &submitInfo, nullptr);
-    vkQueueWaitIdle(m_graphicsQueue);
-
-    vkFreeCommandBuffers(m_device, m_commandPool, 1, &_commandBuffer);
-}
-
-void Application::transitionImageLayout(VkImage _image, VkFormat _format, VkImageLayout _oldImageLayout, VkImageLayout _newImageLayout, uint32_t _mipLevels)
+void Application::transitionImageLayout(VkCommandBuffer _commandBuffer, VkImage _image, VkFormat _format, VkImageLayout _oldImageLayout, VkImageLayout _newImageLayout, uint32_t _mipLevels)
 {
-    VkCommandBuffer commandBuffer = beginSingleTimeCommands();
-
     VkImageMemoryBarrier imageMemoryBarrier
     {
         VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,                 // sType
@@ -1668,15 +2983,11 @@ void Application::transitionImageLayout(VkImage _image, VkFormat _format, VkImag
         throw std::invalid_argument(setFontColor("Unsupported layout transition", FontColor::Red));
     }
 
-    vkCmdPipelineBarrier(commandBuffer, sourceStage, destinationStage, 0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
-
-    endSingleTimeCommands(commandBuffer);
+    vkCmdPipelineBarrier(_commandBuffer, sourceStage, destinationStage, 0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
 }
 
-void Application::copyBufferToImage(VkBuffer _buffer, VkImage _image, uint32_t _width, uint32_t _height)
+void Application::copyBufferToImage(VkCommandBuffer _commandBuffer, VkBuffer _buffer, VkImage _image, uint32_t _width, uint32_t _height)
 {
-    VkCommandBuffer commandBuffer = beginSingleTimeCommands();
-
     VkBufferImageCopy bufferImageCopyRegion
     {
         0,                                              // bufferOffset
@@ -1696,121 +3007,419 @@ void Application::copyBufferToImage(VkBuffer _buffer, VkImage _image, uint32_t _
         }                                               // imageExtent
     };
 
-    vkCmdCopyBufferToImage(commandBuffer, _buffer, _image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &bufferImageCopyRegion);
-
-    endSingleTimeCommands(commandBuffer);
+    vkCmdCopyBufferToImage(_commandBuffer, _buffer, _image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &bufferImageCopyRegion);
 }
 
 void Application::loadModel()
 {
-    tinyobj::attrib_t attrib;
-    std::vector<tinyobj::shape_t> shapes;
-    std::vector<tinyobj::material_t> materials;
-    std::string warn, err;
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    const std::string meshCachePath = MeshCache::getCacheFilename(MODEL_PATH);
+    const uint64_t sourceHash = MeshCache::computeSourceHash(MODEL_PATH);
 
-    if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, MODEL_PATH.c_str(), MTL_PATH.c_str()))
+    // лʱֱʹӳĶݣٽ obj
+    if (m_meshCache.open(meshCachePath, sourceHash))
     {
-        throw std::runtime_error(setFontColor(warn + err, FontColor::Red));
+        double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+        const MeshletStatistics meshletStatistics = analyzeMeshlets(m_meshCache.getMeshlets(), m_meshCache.getMeshletCount());
+        std::cout << setFontColor(
+            "Load mesh cache: " + meshCachePath + "\n"
+            + "\ttriangles: " + std::to_string(m_meshCache.getLods()[0].indexCount / 3) + "\n"
+            + "\tvertices: " + std::to_string(m_meshCache.getVertexCount()) + "\n"
+            + "\tindices: " + std::to_string(m_meshCache.getVertexIndexSize() * 8) + " bit, " + std::to_string(m_meshCache.getIndexRangeCount()) + " ranges\n"
+            + "\tmeshlets: " + std::to_string(meshletStatistics.meshletCount) + " (average " + std::to_string(meshletStatistics.averageVertexCount) + " vertices, "
+            + std::to_string(meshletStatistics.averageTriangleCount) + " triangles)\n"
+            + "\tLODs: " + std::to_string(m_meshCache.getLodCount()) + "\n"
+            + "\ttotal: " + std::to_string(milliseconds) + " ms",
+            FontColor::Green) << std::endl;
+        return;
     }
 
-    std::unordered_map<Vertex, uint32_t> uniqueVertices{ };
-    for (const tinyobj::shape_t& shape : shapes)
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> vertexIndices;
+    ObjLoader objLoader;
+    objLoader.load(MODEL_PATH, vertices, vertexIndices);
+
+    // ʰη񣬹ͼĲ
+    std::vector<std::string> textures;
+    std::vector<MeshMaterial> materials;
+    std::vector<Submesh> submeshes = groupTrianglesByMaterial(vertexIndices, objLoader.getTriangleMaterials(), objLoader.getMaterials(),
+        textures, materials);
+    optimizeModel(vertices, vertexIndices, submeshes);
+
+    VertexLayoutReport layoutReport = measureVertexLayout<GpuVertexLayout>(vertices);
+    std::cout << setFontColor(
+        std::string("Vertex layout: ") + GpuVertexLayout::NAME + "\n"
+        + "\tmax position error: " + std::to_string(layoutReport.maxPositionError) + "\n"
+        + "\tmax texCoord error: " + std::to_string(layoutReport.maxTexCoordError) + "\n"
+        + "\tvertex memory: " + std::to_string(layoutReport.layoutBytes) + " bytes (saved " + std::to_string(layoutReport.fullBytes - layoutReport.layoutBytes) + " bytes)",
+        FontColor::Green) << std::endl;
+
+    m_meshCache.build(sourceHash, vertices, vertexIndices, submeshes, materials, textures);
+    if (!m_meshCache.save(meshCachePath))
     {
-        for (const tinyobj::index_t& index : shape.mesh.indices)
-        {
-            Vertex vertex{ };
-            vertex.positionOS =
-            {
-                attrib.vertices[3 * index.vertex_index + 0],
-                attrib.vertices[3 * index.vertex_index + 1],
-                attrib.vertices[3 * index.vertex_index + 2]
-            };
-            vertex.texCoord =
-            {
-                attrib.texcoords[2 * index.texcoord_index + 0],
-                1.0f - attrib.texcoords[2 * index.texcoord_index + 1]
-            };
-            vertex.color = { 1.0f, 1.0f, 1.0f };
+        std::cout << setFontColor("Failed to write mesh cache: " + meshCachePath, FontColor::Yellow) << std::endl;
+    }
+    std::cout << setFontColor(
+        "Vertex indices: " + std::to_string(m_meshCache.getVertexIndexSize() * 8) + " bit, " + std::to_string(m_meshCache.getIndexRangeCount()) + " ranges, "
+        + std::to_string(m_meshCache.getVertexIndexSize() * m_meshCache.getVertexIndexCount()) + " bytes",
+        FontColor::Green) << std::endl;
+    const MeshletStatistics meshletStatistics = analyzeMeshlets(m_meshCache.getMeshlets(), m_meshCache.getMeshletCount());
+    std::cout << setFontColor(
+        "Meshlets: " + std::to_string(meshletStatistics.meshletCount) + ", average " + std::to_string(meshletStatistics.averageVertexCount) + " vertices ("
+        + std::to_string(meshletStatistics.vertexFill * 100.0f) + "%), " + std::to_string(meshletStatistics.averageTriangleCount) + " triangles ("
+        + std::to_string(meshletStatistics.triangleFill * 100.0f) + "%)",
+        FontColor::Green) << std::endl;
+
+    std::string lodReport = "LOD chain:";
+    for (size_t i = 0; i < m_meshCache.getLodCount(); ++i)
+    {
+        const MeshLod& lod = m_meshCache.getLods()[i];
+        lodReport += "\n\tLOD " + std::to_string(i) + ": " + std::to_string(lod.indexCount / 3) + " triangles, error " + std::to_string(lod.error);
+    }
+    std::cout << setFontColor(lodReport, FontColor::Green) << std::endl;
+
+    const ObjLoadStatistics& statistics = objLoader.getStatistics();
+    std::cout << setFontColor(
+        "Load model: " + MODEL_PATH + "\n"
+        + "\tthreads: " + std::to_string(statistics.threadCount) + "\n"
+        + "\ttriangles: " + std::to_string(statistics.triangleCount) + "\n"
+        + "\tvertices: " + std::to_string(vertices.size()) + "\n"
+        + "\tmaterials: " + std::to_string(statistics.materialCount) + " (" + std::to_string(submeshes.size()) + " submeshes, " + std::to_string(textures.size()) + " textures)\n"
+        + "\tmap: " + std::to_string(statistics.mapMilliseconds) + " ms\n"
+        + "\tparse: " + std::to_string(statistics.parseMilliseconds) + " ms\n"
+        + "\ttriangulate: " + std::to_string(statistics.triangulateMilliseconds) + " ms\n"
+        + "\tweld: " + std::to_string(statistics.weldMilliseconds) + " ms\n"
+        + "\ttotal: " + std::to_string(statistics.totalMilliseconds()) + " ms",
+        FontColor::Green) << std::endl;
+}
 
-            if (uniqueVertices.count(vertex) == 0)
-            {
-                uniqueVertices[vertex] = static_cast<uint32_t>(m_vertices.size());
-                m_vertices.push_back(vertex);
-            }
-            m_vertexIndices.push_back(uniqueVertices[vertex]);
-        }
+void Application::optimizeModel(std::vector<Vertex>& _vertices, std::vector<uint32_t>& _vertexIndices, const std::vector<Submesh>& _submeshes)
+{
+    // Ż񻺴һ𱣴棬лʱִ
+    VertexCacheStatistics before = analyzeVertexCache(_vertexIndices, _vertices.size());
+
+    optimizeMesh(_vertices, _vertexIndices, _submeshes);
+
+    VertexCacheStatistics after = analyzeVertexCache(_vertexIndices, _vertices.size());
+    std::cout << setFontColor(
+        "Optimize model (FIFO " + std::to_string(after.cacheSize) + "):\n"
+        + "\tACMR: " + std::to_string(before.acmr) + " -> " + std::to_string(after.acmr) + "\n"
+        + "\tATVR: " + std::to_string(before.atvr) + " -> " + std::to_string(after.atvr),
+        FontColor::Green) << std::endl;
+}
+
+void Application::createDrawList()
+{
+    m_drawList.build(m_meshCache.getSubmeshes(), m_meshCache.getSubmeshCount(), m_meshCache.getMaterials(),
+        m_meshCache.getIndexRanges(), m_meshCache.getIndexRangeCount());
+
+    std::string error;
+    if (!m_drawList.validate(m_meshCache.getSubmeshes(), m_meshCache.getSubmeshCount(), m_meshCache.getMaterials(),
+        m_meshCache.getMaterialCount(), m_meshCache.getVertexIndexCount(), error))
+    {
+        throw std::runtime_error(setFontColor("Invalid draw list: " + error, FontColor::Red));
     }
+
+    const DrawListStatistics& statistics = m_drawList.getStatistics();
+    std::cout << setFontColor(
+        "Draw list:\n"
+        "\tsubmeshes: " + std::to_string(statistics.submeshCount) + "\n"
+        + "\tindex ranges: " + std::to_string(statistics.indexRangeCount) + "\n"
+        + "\tdraws: " + std::to_string(statistics.drawCount) + "\n"
+        + "\ttexture binds: " + std::to_string(statistics.textureBindCount),
+        FontColor::Green) << std::endl;
 }
 
 void Application::createVertexBuffer()
 {
-    VkDeviceSize vertexBufferSize = sizeof(m_vertices[0]) * m_vertices.size();
+    VkDeviceSize vertexBufferSize = sizeof(GpuVertex) * m_meshCache.getVertexCount();
 
-    VkBuffer stagingBuffer;
-    VkDeviceMemory stagingBufferMemory;
-    createBuffer(vertexBufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory);
+    createBuffer(vertexBufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_vertexBuffer, m_vertexBufferAllocation);
+    m_uploadBatcher.uploadBuffer(m_vertexBuffer, 0, m_meshCache.getVertices(), vertexBufferSize);
+}
 
-    void* data = nullptr;
-    vkMapMemory(m_device, stagingBufferMemory, 0, vertexBufferSize, 0, &data);
-    std::memcpy(data, m_vertices.data(), static_cast<size_t>(vertexBufferSize));
-    vkUnmapMemory(m_device, stagingBufferMemory);
+void Application::createVertexIndicesBuffer()
+{
+    VkDeviceSize vertexIndicesBufferSize = static_cast<VkDeviceSize>(m_meshCache.getVertexIndexSize()) * m_meshCache.getVertexIndexCount();
 
-    createBuffer(vertexBufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_vertexBuffer, m_vertexBufferMemory);
-    copyBuffer(stagingBuffer, m_vertexBuffer, vertexBufferSize);
+    createBuffer(vertexIndicesBufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_vertexIndicesBuffer, m_vertexIndicesBufferAllocation);
+    m_uploadBatcher.uploadBuffer(m_vertexIndicesBuffer, 0, m_meshCache.getVertexIndexData(), vertexIndicesBufferSize);
+}
+
+void Application::createMaterialBuffer()
+{
+    // ʼ¼еͼŻͼλûͼĲʹĬͼ
+    std::vector<MeshMaterial> materials(m_meshCache.getMaterials(), m_meshCache.getMaterials() + m_meshCache.getMaterialCount());
+    for (MeshMaterial& material : materials)
+    {
+        material.textureIndex = getTextureSlot(material.textureIndex);
+    }
+    VkDeviceSize materialBufferSize = sizeof(MeshMaterial) * materials.size();
 
-    vkDestroyBuffer(m_device, stagingBuffer, nullptr);
-    vkFreeMemory(m_device, stagingBufferMemory, nullptr);
+    createBuffer(materialBufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_materialBuffer, m_materialBufferAllocation);
+    m_uploadBatcher.uploadBuffer(m_materialBuffer, 0, materials.data(), materialBufferSize);
 }
 
-void Application::createVertexIndicesBuffer()
+void Application::createCullingBuffers()
 {
-    VkDeviceSize vertexIndicesBufferSize = sizeof(m_vertexIndices[0]) * m_vertexIndices.size();
+    // ÿİΧõĶ㣬ĶȽģͿռ
+    const GpuVertex* vertices = m_meshCache.getVertices();
+    const VertexQuantization& quantization = m_meshCache.getVertexQuantization();
+    const void* vertexIndexData = m_meshCache.getVertexIndexData();
+    const bool shortIndices = m_meshCache.getVertexIndexSize() == sizeof(uint16_t);
+    std::vector<float> positions;
+    std::vector<float> meshPositions;
+    m_cullingDrawItems.clear();
+    for (const DrawItem& drawItem : m_drawList.getDrawItems())
+    {
+        positions.clear();
+        for (uint32_t i = drawItem.firstIndex; i < drawItem.firstIndex + drawItem.indexCount; ++i)
+        {
+            const uint32_t vertexIndex = shortIndices ? static_cast<const uint16_t*>(vertexIndexData)[i] : static_cast<const uint32_t*>(vertexIndexData)[i];
+            const Vertex vertex = GpuVertexLayout::decode(vertices[vertexIndex + drawItem.vertexOffset], quantization);
+            positions.insert(positions.end(), { vertex.positionOS.x, vertex.positionOS.y, vertex.positionOS.z });
+        }
+        meshPositions.insert(meshPositions.end(), positions.begin(), positions.end());
+
+        CullingDrawItem cullingDrawItem{ };
+        computeBoundingSphere(positions.data(), positions.size() / 3, cullingDrawItem.center, cullingDrawItem.radius);
+        cullingDrawItem.indexCount = drawItem.indexCount;
+        cullingDrawItem.firstIndex = drawItem.firstIndex;
+        cullingDrawItem.vertexOffset = drawItem.vertexOffset;
+        m_cullingDrawItems.push_back(cullingDrawItem);
+    }
+    m_cullingDrawItemCount = static_cast<uint32_t>(m_cullingDrawItems.size());
+    computeBoundingSphere(meshPositions.data(), meshPositions.size() / 3, m_lodBoundsCenter, m_lodBoundsRadius);
+
+    //  LOD Ļں档ϲǵ 0 βӵ䣬һһӦͬ˳У
+    // ͬһÿһҲβӣΧõ 0 ģ򻯺ĶԭӼ
+    const IndexRange* indexRanges = m_meshCache.getIndexRanges();
+    const size_t indexRangeCount = m_meshCache.getIndexRangeCount();
+    m_lodErrors.clear();
+    for (size_t lod = 0; lod < m_meshCache.getLodCount(); ++lod)
+    {
+        m_lodErrors.push_back(m_meshCache.getLods()[lod].error);
+        if (lod == 0)
+        {
+            continue;
+        }
+        const IndexRange* lodRanges = m_meshCache.getLodIndexRanges(lod);
+        for (uint32_t d = 0; d < m_cullingDrawItemCount; ++d)
+        {
+            CullingDrawItem cullingDrawItem = m_cullingDrawItems[d];
+            cullingDrawItem.indexCount = 0;
+            bool first = true;
+            for (size_t r = 0; r < indexRangeCount; ++r)
+            {
+                if (indexRanges[r].firstIndex >= m_cullingDrawItems[d].firstIndex
+                    && indexRanges[r].firstIndex + indexRanges[r].indexCount <= m_cullingDrawItems[d].firstIndex + m_cullingDrawItems[d].indexCount)
+                {
+                    cullingDrawItem.firstIndex = first ? lodRanges[r].firstIndex : cullingDrawItem.firstIndex;
+                    cullingDrawItem.indexCount += lodRanges[r].indexCount;
+                    first = false;
+                }
+            }
+            m_cullingDrawItems.push_back(cullingDrawItem);
+        }
+    }
 
-    VkBuffer stagingBuffer;
-    VkDeviceMemory stagingBufferMemory;
-    createBuffer(vertexIndicesBufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory);
+    // ÿ̴߳һ (, ʵ) ϣʵ LOD ɫѡӦĻ
+    m_visibleInstanceCapacity = getInstanceCapacity();
+    const uint64_t groupCount = (static_cast<uint64_t>(m_visibleInstanceCapacity) * m_cullingDrawItemCount + CULLING_GROUP_SIZE - 1) / CULLING_GROUP_SIZE;
+    VkPhysicalDeviceProperties physicalDeviceProperties;
+    vkGetPhysicalDeviceProperties(m_physicalDevice, &physicalDeviceProperties);
+    if (groupCount > physicalDeviceProperties.limits.maxComputeWorkGroupCount[0])
+    {
+        throw std::runtime_error(setFontColor("Too many draw items for GPU culling: " + std::to_string(m_cullingDrawItemCount), FontColor::Red));
+    }
 
-    void* data;
-    vkMapMemory(m_device, stagingBufferMemory, 0, vertexIndicesBufferSize, 0, &data);
-    std::memcpy(data, m_vertexIndices.data(), static_cast<size_t>(vertexIndicesBufferSize));
-    vkUnmapMemory(m_device, stagingBufferMemory);
+    const VkDeviceSize drawItemBufferSize = sizeof(CullingDrawItem) * m_cullingDrawItems.size();
+    createBuffer(drawItemBufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_cullingDrawItemBuffer, m_cullingDrawItemBufferAllocation);
+    m_uploadBatcher.uploadBuffer(m_cullingDrawItemBuffer, 0, m_cullingDrawItems.data(), drawItemBufferSize);
+
+    // ÿ (, LOD) һÿ֡дΧ firstInstance޳ͨۼ instanceCount
+    // ɼڴУդźźֱӶؿɼÿΪÿʵԤһɼʵţ LOD зֶ
+    const uint32_t lodCount = static_cast<uint32_t>(m_lodErrors.size());
+    const VkDeviceSize commandBufferSize = sizeof(IndirectDrawCommand) * m_cullingDrawItemCount * lodCount;
+    const VkDeviceSize visibleInstanceBufferSize = sizeof(uint32_t) * m_visibleInstanceCapacity * m_cullingDrawItemCount;
+    m_indirectCommandBuffers.resize(m_framesInFlight);
+    m_indirectCommandBufferAllocations.resize(m_framesInFlight);
+    m_visibleInstanceBuffers.resize(m_framesInFlight);
+    m_visibleInstanceBufferAllocations.resize(m_framesInFlight);
+    for (size_t i = 0; i < m_framesInFlight; ++i)
+    {
+        createBuffer(commandBufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_indirectCommandBuffers[i], m_indirectCommandBufferAllocations[i]);
+        std::memset(m_indirectCommandBufferAllocations[i].mapped, 0, commandBufferSize);
+        createBuffer(visibleInstanceBufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_visibleInstanceBuffers[i], m_visibleInstanceBufferAllocations[i]);
+    }
+    m_expectedCullingCommands.assign(m_framesInFlight, std::vector<IndirectDrawCommand>());
 
-    createBuffer(vertexIndicesBufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_vertexIndicesBuffer, m_vertexIndicesBufferMemory);
-    copyBuffer(stagingBuffer, m_vertexIndicesBuffer, vertexIndicesBufferSize);
+    std::cout << setFontColor(
+        "GPU culling: " + std::to_string(m_cullingDrawItemCount) + " draw items x " + std::to_string(lodCount) + " LODs x " + std::to_string(m_visibleInstanceCapacity) + " instances, "
+        + std::to_string(commandBufferSize) + " bytes of commands and " + std::to_string(visibleInstanceBufferSize) + " bytes of visible instances per frame",
+        FontColor::Green) << std::endl;
+}
 
-    vkDestroyBuffer(m_device, stagingBuffer, nullptr);
-    vkFreeMemory(m_device, stagingBufferMemory, nullptr);
+void Application::createUniformRing()
+{
+    // з֡һ־ӳĻ壬ÿ֡Լķа minUniformBufferOffsetAlignment Ƭ
+    // ̬ͨƫư󶨣ÿ֡ٴӳκλ
+    VkPhysicalDeviceProperties physicalDeviceProperties;
+    vkGetPhysicalDeviceProperties(m_physicalDevice, &physicalDeviceProperties);
+    const VkDeviceSize alignment = physicalDeviceProperties.limits.minUniformBufferOffsetAlignment;
+    const VkDeviceSize uniformRingSize = FrameRingAllocator::getBufferSize(UNIFORM_RING_FRAME_SIZE, m_framesInFlight, alignment);
+
+    createBuffer(uniformRingSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_uniformRingBuffer, m_uniformRingAllocation);
+    m_uniformRing.init(m_uniformRingAllocation.mapped, UNIFORM_RING_FRAME_SIZE, m_framesInFlight, alignment);
+
+    std::cout << setFontColor(
+        "Uniform ring: " + std::to_string(m_framesInFlight) + " x " + std::to_string(m_uniformRing.getFrameSize()) + " bytes, alignment " + std::to_string(alignment),
+        FontColor::Green) << std::endl;
 }
 
-void Application::createUniformBuffers()
+void Application::createInstanceRing()
 {
-    VkDeviceSize uniformBufferSize = sizeof(UniformBufferObject);
+    // ʵÿ֡ CPU д uniform һڳ־ӳĻλУ޳ͨͶɫΪ洢ȡ
+    m_instanceTransforms.init(m_options.instanceCount, INSTANCE_SPACING);
+    m_lastInstanceUpdateTime = std::chrono::steady_clock::now();
 
-    m_uniformBuffers.resize(MAX_FRAMES_IN_FLIGHT);
-    m_uniformBuffersMemory.resize(MAX_FRAMES_IN_FLIGHT);
-    m_uniformBuffersMapped.resize(MAX_FRAMES_IN_FLIGHT);
+    // 洢Ķ̬ƫҪ minStorageBufferOffsetAlignment
+    VkPhysicalDeviceProperties physicalDeviceProperties;
+    vkGetPhysicalDeviceProperties(m_physicalDevice, &physicalDeviceProperties);
+    const VkDeviceSize alignment = std::max<VkDeviceSize>(sizeof(glm::vec4), physicalDeviceProperties.limits.minStorageBufferOffsetAlignment);
+    // ÿ֡дʵٰͬĶдÿʵѡе LOD
+    const VkDeviceSize instanceFrameSize = sizeof(glm::mat4) * getInstanceCapacity() + alignment + sizeof(uint32_t) * getInstanceCapacity();
+    const VkDeviceSize instanceRingSize = FrameRingAllocator::getBufferSize(instanceFrameSize, m_framesInFlight, alignment);
+
+    createBuffer(instanceRingSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_instanceRingBuffer, m_instanceRingAllocation);
+    m_instanceRing.init(m_instanceRingAllocation.mapped, instanceFrameSize, m_framesInFlight, alignment);
+
+    std::cout << setFontColor(
+        "Instancing: " + std::to_string(m_instanceTransforms.getCount()) + " instances, " + (InstanceTransforms::isSimdEnabled() ? "SSE2" : "scalar") + " update",
+        FontColor::Green) << std::endl;
+}
 
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+uint32_t Application::getInstanceCapacity() const
+{
+    // ׼Իлʵ˰Ԥ
+    return m_options.benchmark ? MAX_INSTANCE_COUNT : m_options.instanceCount;
+}
+
+void Application::createCullingDescriptorSets()
+{
+    // ÿ֡һ޳ټһɫȡʵݵ
+    std::array<VkDescriptorPoolSize, 2> descriptorPoolSizes{ };
+    descriptorPoolSizes[0].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    descriptorPoolSizes[0].descriptorCount = m_framesInFlight * 3;
+    descriptorPoolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    descriptorPoolSizes[1].descriptorCount = m_framesInFlight * 4;
+    VkDescriptorPoolCreateInfo descriptorPoolCreateInfo
+    {
+        VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,      // sType
+        nullptr,                                            // pNext
+        VK_FALSE,                                           // flags
+        m_framesInFlight * 2,                               // maxSets
+        static_cast<uint32_t>(descriptorPoolSizes.size()),  // poolSizeCount
+        descriptorPoolSizes.data()                          // pPoolSizes
+    };
+    if (vkCreateDescriptorPool(m_device, &descriptorPoolCreateInfo, nullptr, &m_cullingDescriptorPool) != VK_SUCCESS)
+    {
+        throw std::runtime_error(setFontColor("Failed to create culling descriptor pool", FontColor::Red));
+    }
+
+    std::vector<VkDescriptorSetLayout> descriptorSetLayouts(m_framesInFlight, m_cullingDescriptorSetLayout);
+    VkDescriptorSetAllocateInfo descriptorSetAllocateInfo
+    {
+        VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,             // sType
+        nullptr,                                                    // pNext
+        m_cullingDescriptorPool,                                    // descriptorPool
+        m_framesInFlight,                                       // descriptorSetCount
+        descriptorSetLayouts.data()                                 // pSetLayouts
+    };
+    m_cullingDescriptorSets.resize(m_framesInFlight);
+    if (vkAllocateDescriptorSets(m_device, &descriptorSetAllocateInfo, m_cullingDescriptorSets.data()) != VK_SUCCESS)
     {
-        createBuffer(uniformBufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_uniformBuffers[i], m_uniformBuffersMemory[i]);
-        vkMapMemory(m_device, m_uniformBuffersMemory[i], 0, uniformBufferSize, 0, &m_uniformBuffersMapped[i]);
+        throw std::runtime_error(setFontColor("Failed to allocate culling descriptor sets", FontColor::Red));
+    }
+
+    std::vector<VkDescriptorSetLayout> instanceDescriptorSetLayouts(m_framesInFlight, m_instanceDescriptorSetLayout);
+    VkDescriptorSetAllocateInfo instanceDescriptorSetAllocateInfo
+    {
+        VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,             // sType
+        nullptr,                                                    // pNext
+        m_cullingDescriptorPool,                                    // descriptorPool
+        m_framesInFlight,                                           // descriptorSetCount
+        instanceDescriptorSetLayouts.data()                         // pSetLayouts
+    };
+    m_instanceDescriptorSets.resize(m_framesInFlight);
+    if (vkAllocateDescriptorSets(m_device, &instanceDescriptorSetAllocateInfo, m_instanceDescriptorSets.data()) != VK_SUCCESS)
+    {
+        throw std::runtime_error(setFontColor("Failed to allocate instance descriptor sets", FontColor::Red));
+    }
+
+    for (size_t i = 0; i < m_framesInFlight; ++i)
+    {
+        // ʵ LOD ʵƫڰʱ̬ͨƫָ
+        std::array<VkDescriptorBufferInfo, 5> bufferInfos
+        {
+            VkDescriptorBufferInfo{ m_instanceRingBuffer, 0, sizeof(glm::mat4) * getInstanceCapacity() },
+            VkDescriptorBufferInfo{ m_cullingDrawItemBuffer, 0, VK_WHOLE_SIZE },
+            VkDescriptorBufferInfo{ m_indirectCommandBuffers[i], 0, VK_WHOLE_SIZE },
+            VkDescriptorBufferInfo{ m_visibleInstanceBuffers[i], 0, VK_WHOLE_SIZE },
+            VkDescriptorBufferInfo{ m_instanceRingBuffer, 0, sizeof(uint32_t) * getInstanceCapacity() }
+        };
+
+        std::array<VkWriteDescriptorSet, 5> writeDescriptorSets{ };
+        for (uint32_t binding = 0; binding < writeDescriptorSets.size(); ++binding)
+        {
+            writeDescriptorSets[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writeDescriptorSets[binding].dstSet = m_cullingDescriptorSets[i];
+            writeDescriptorSets[binding].dstBinding = binding;
+            writeDescriptorSets[binding].dstArrayElement = 0;
+            writeDescriptorSets[binding].descriptorType = binding == 0 || binding == 4 ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            writeDescriptorSets[binding].descriptorCount = 1;
+            writeDescriptorSets[binding].pBufferInfo = &bufferInfos[binding];
+        }
+        vkUpdateDescriptorSets(m_device, static_cast<uint32_t>(writeDescriptorSets.size()), writeDescriptorSets.data(), 0, nullptr);
+
+        // ɫȡͬʵͱ֡Ŀɼʵ
+        std::array<VkWriteDescriptorSet, 2> instanceWriteDescriptorSets{ };
+        for (uint32_t binding = 0; binding < instanceWriteDescriptorSets.size(); ++binding)
+        {
+            instanceWriteDescriptorSets[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            instanceWriteDescriptorSets[binding].dstSet = m_instanceDescriptorSets[i];
+            instanceWriteDescriptorSets[binding].dstBinding = binding;
+            instanceWriteDescriptorSets[binding].dstArrayElement = 0;
+            instanceWriteDescriptorSets[binding].descriptorType = binding == 0 ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            instanceWriteDescriptorSets[binding].descriptorCount = 1;
+            instanceWriteDescriptorSets[binding].pBufferInfo = &bufferInfos[binding == 0 ? 0 : 3];
+        }
+        vkUpdateDescriptorSets(m_device, static_cast<uint32_t>(instanceWriteDescriptorSets.size()), instanceWriteDescriptorSets.data(), 0, nullptr);
     }
 }
 
 void Application::createDescriptorPool()
 {
-    std::array<VkDescriptorPoolSize, 2> descriptorPoolSizes{ };
-    descriptorPoolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    descriptorPoolSizes[0].descriptorCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT);
-    descriptorPoolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    descriptorPoolSizes[1].descriptorCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT);
+    // bindless ʱÿ֡һÿ֡Ϊÿͼ׼һ
+    const uint32_t descriptorSetCount = static_cast<uint32_t>(m_bindlessEnabled ? m_framesInFlight : m_framesInFlight * m_textures.size());
+
+    std::array<VkDescriptorPoolSize, 4> descriptorPoolSizes{ };
+    descriptorPoolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    descriptorPoolSizes[0].descriptorCount = descriptorSetCount;
+    descriptorPoolSizes[1].type = m_bindlessEnabled ? VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE : VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    descriptorPoolSizes[1].descriptorCount = descriptorSetCount * (m_bindlessEnabled ? MAX_BINDLESS_TEXTURES : 1);
+    descriptorPoolSizes[2].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    descriptorPoolSizes[2].descriptorCount = descriptorSetCount;
+    descriptorPoolSizes[3].type = VK_DESCRIPTOR_TYPE_SAMPLER;
+    descriptorPoolSizes[3].descriptorCount = descriptorSetCount;
 
     VkDescriptorPoolCreateInfo descriptorPoolCreateInfo
     {
         VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,      // sType
         nullptr,                                            // pNext
         VK_FALSE,                                           // flags
-        static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT),        // maxSets
+        descriptorSetCount,                                 // maxSets
         static_cast<uint32_t>(descriptorPoolSizes.size()),  // poolSizeCount
         descriptorPoolSizes.data()                          // pPoolSizes
     };
@@ -1822,44 +3431,67 @@ void Application::createDescriptorPool()
 
 void Application::createDescriptorSets()
 {
-    std::vector<VkDescriptorSetLayout> descriptorSetLayout(MAX_FRAMES_IN_FLIGHT, m_descriptorSetLayout);
+    // bindless ʱÿ֡һ frame ֡ slot ͼλ frame * ͼ + slot
+    const size_t textureCount = m_textures.size();
+    const size_t frameDescriptorSetCount = m_bindlessEnabled ? 1 : textureCount;
+    const size_t descriptorSetCount = m_framesInFlight * frameDescriptorSetCount;
+    std::vector<VkDescriptorSetLayout> descriptorSetLayout(descriptorSetCount, m_descriptorSetLayout);
     VkDescriptorSetAllocateInfo descriptorSetAllocateInfo
     {
         VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,             // sType
         nullptr,                                                    // pNext
         m_descriptorPool,                                           // descriptorPool
-        static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT),                // descriptorSetCount
+        static_cast<uint32_t>(descriptorSetCount),                  // descriptorSetCount
         descriptorSetLayout.data()                                  // pSetLayouts
     };
 
-    m_descriptorSets.resize(MAX_FRAMES_IN_FLIGHT);
+    m_descriptorSets.resize(descriptorSetCount);
     if (vkAllocateDescriptorSets(m_device, &descriptorSetAllocateInfo, m_descriptorSets.data()) != VK_SUCCESS)
     {
         throw std::runtime_error(setFontColor("Failed to allocate descriptor sets", FontColor::Red));
     }
 
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+    VkDescriptorBufferInfo materialBufferInfo
     {
+        m_materialBuffer,                               // buffer
+        0,                                              // offset
+        VK_WHOLE_SIZE                                   // range
+    };
+
+    // bindless ͼֻдǰ textureCount Ԫأౣδ󶨣ûϴɵͼռλͼ
+    std::vector<VkDescriptorImageInfo> textureImageInfos;
+    for (uint32_t slot = 0; slot < textureCount; ++slot)
+    {
+        textureImageInfos.push_back(VkDescriptorImageInfo
+        {
+            m_bindlessEnabled ? nullptr : m_textureSampler,     // sampler
+            getTextureImageView(slot),                          // imageView
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL            // imageLayout
+        });
+    }
+    VkDescriptorImageInfo samplerImageInfo
+    {
+        m_textureSampler,                                       // sampler
+        nullptr,                                                // imageView
+        VK_IMAGE_LAYOUT_UNDEFINED                               // imageLayout
+    };
+
+    for (size_t i = 0; i < descriptorSetCount; ++i)
+    {
+        // ʵƫڰʱ̬ͨƫָ
         VkDescriptorBufferInfo descriptorBufferInfo
         {
-            m_uniformBuffers[i],                        // buffer
+            m_uniformRingBuffer,                        // buffer
             0,                                          // offset
             sizeof(UniformBufferObject)                 // range
         };
 
-        VkDescriptorImageInfo descriptorImageInfo
-        {
-            m_textureSampler,                                   // sampler
-            m_textureImageView,                                 // imageView
-            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL            // imageLayout
-        };
-
-        std::array<VkWriteDescriptorSet, 2> writeDescriptorSets{ };
+        std::array<VkWriteDescriptorSet, 4> writeDescriptorSets{ };
         writeDescriptorSets[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
         writeDescriptorSets[0].dstSet = m_descriptorSets[i];
         writeDescriptorSets[0].dstBinding = 0;
         writeDescriptorSets[0].dstArrayElement = 0;
-        writeDescriptorSets[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        writeDescriptorSets[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
         writeDescriptorSets[0].descriptorCount = 1;
         writeDescriptorSets[0].pBufferInfo = &descriptorBufferInfo;
 
@@ -1867,32 +3499,43 @@ void Application::createDescriptorSets()
         writeDescriptorSets[1].dstSet = m_descriptorSets[i];
         writeDescriptorSets[1].dstBinding = 1;
         writeDescriptorSets[1].dstArrayElement = 0;
-        writeDescriptorSets[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        writeDescriptorSets[1].descriptorCount = 1;
-        writeDescriptorSets[1].pImageInfo = &descriptorImageInfo;
-
-        vkUpdateDescriptorSets(m_device, static_cast<uint32_t>(writeDescriptorSets.size()), writeDescriptorSets.data(), 0, nullptr);
-    }
-}
-
-uint32_t Application::findMemoryType(uint32_t _typeFilter, VkMemoryPropertyFlags _properties)
-{
-    VkPhysicalDeviceMemoryProperties physicalDeviceMemoryProperties;
-    vkGetPhysicalDeviceMemoryProperties(m_physicalDevice, &physicalDeviceMemoryProperties);
-    for (uint32_t i = 0; i < physicalDeviceMemoryProperties.memoryTypeCount; ++i)
-    {
-        if ((_typeFilter & (1 << i)) && ((physicalDeviceMemoryProperties.memoryTypes[i].propertyFlags & _properties) == _properties))
+        if (m_bindlessEnabled)
         {
-            return i;
+            writeDescriptorSets[1].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+            writeDescriptorSets[1].descriptorCount = static_cast<uint32_t>(textureCount);
+            writeDescriptorSets[1].pImageInfo = textureImageInfos.data();
+        }
+        else
+        {
+            writeDescriptorSets[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            writeDescriptorSets[1].descriptorCount = 1;
+            writeDescriptorSets[1].pImageInfo = &textureImageInfos[i % textureCount];
         }
-    }
 
-    throw std::runtime_error(setFontColor("Failed to find suitable memory type", FontColor::Red));
+        writeDescriptorSets[2].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writeDescriptorSets[2].dstSet = m_descriptorSets[i];
+        writeDescriptorSets[2].dstBinding = 2;
+        writeDescriptorSets[2].dstArrayElement = 0;
+        writeDescriptorSets[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writeDescriptorSets[2].descriptorCount = 1;
+        writeDescriptorSets[2].pBufferInfo = &materialBufferInfo;
+
+        writeDescriptorSets[3].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writeDescriptorSets[3].dstSet = m_descriptorSets[i];
+        writeDescriptorSets[3].dstBinding = 3;
+        writeDescriptorSets[3].dstArrayElement = 0;
+        writeDescriptorSets[3].descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER;
+        writeDescriptorSets[3].descriptorCount = 1;
+        writeDescriptorSets[3].pImageInfo = &samplerImageInfo;
+
+        const uint32_t writeCount = m_bindlessEnabled ? 4 : 3;
+        vkUpdateDescriptorSets(m_device, writeCount, writeDescriptorSets.data(), 0, nullptr);
+    }
 }
 
 void Application::createCommandBuffers()
 {
-    m_commandBuffers.resize(MAX_FRAMES_IN_FLIGHT);
+    m_commandBuffers.resize(m_framesInFlight);
 
     VkCommandBufferAllocateInfo commandBufferAllocateInfo
     {
@@ -1908,11 +3551,53 @@ void Application::createCommandBuffers()
     }
 }
 
+void Application::createRecordCommandPools()
+{
+    // 0 ʾӲ߳ÿ֡ÿ¼߳һأһ
+    m_recordThreadCount = m_options.recordThreadCount != 0 ? m_options.recordThreadCount : std::min(getJobSystem().getThreadCount(), MAX_RECORD_THREAD_COUNT);
+    m_recordCommandPools.resize(m_framesInFlight * m_recordThreadCount);
+    m_secondaryCommandBuffers.resize(m_recordCommandPools.size());
+
+    VkCommandPoolCreateInfo commandPoolCreateInfo
+    {
+        VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,         // sType
+        nullptr,                                            // pNext
+        VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,               // flags
+        m_queueFamilyIndices.graphicsFamily.value()         // queueFamilyIndex
+    };
+    for (size_t i = 0; i < m_recordCommandPools.size(); ++i)
+    {
+        if (vkCreateCommandPool(m_device, &commandPoolCreateInfo, nullptr, &m_recordCommandPools[i]) != VK_SUCCESS)
+        {
+            throw std::runtime_error(setFontColor("Failed to create record command pool", FontColor::Red));
+        }
+
+        VkCommandBufferAllocateInfo commandBufferAllocateInfo
+        {
+            VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,     // sType
+            nullptr,                                            // pNext
+            m_recordCommandPools[i],                            // commandPool
+            VK_COMMAND_BUFFER_LEVEL_SECONDARY,                  // level
+            1                                                   // commandBufferCount
+        };
+        if (vkAllocateCommandBuffers(m_device, &commandBufferAllocateInfo, &m_secondaryCommandBuffers[i]) != VK_SUCCESS)
+        {
+            throw std::runtime_error(setFontColor("Failed to allocate secondary command buffers", FontColor::Red));
+        }
+    }
+
+    std::cout << setFontColor(
+        "Command recording: " + std::to_string(m_recordThreadCount) + " threads, at least " + std::to_string(MIN_DRAWS_PER_RECORD_TASK) + " draws per secondary command buffer",
+        FontColor::Green) << std::endl;
+}
+
 void Application::createSyncObjects()
 {
-    m_imageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-    m_renderFinishedSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-    m_flightFences.resize(MAX_FRAMES_IN_FLIGHT);
+    m_imageAvailableSemaphores.resize(m_framesInFlight);
+    m_renderFinishedSemaphores.resize(m_framesInFlight);
+    m_flightFences.resize(m_framesInFlight);
+    m_frameInputTimes.resize(m_framesInFlight);
+    m_frameLatencyPending.assign(m_framesInFlight, false);
 
     VkSemaphoreCreateInfo semaphoreCreateInfo
     {
@@ -1926,7 +3611,7 @@ void Application::createSyncObjects()
         nullptr,                                        // pNext
         VK_FENCE_CREATE_SIGNALED_BIT                    // flags
     };
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
+    for (size_t i = 0; i < m_framesInFlight; ++i)
     {
         if (vkCreateSemaphore(m_device, &semaphoreCreateInfo, nullptr, &m_imageAvailableSemaphores[i]) != VK_SUCCESS
             || vkCreateSemaphore(m_device, &semaphoreCreateInfo, nullptr, &m_renderFinishedSemaphores[i]) != VK_SUCCESS
@@ -1935,6 +3620,64 @@ void Application::createSyncObjects()
             throw std::runtime_error(setFontColor("Failed to create synchronization objects " + std::to_string(i) + " for a frame", FontColor::Red));
         }
     }
+
+    // ͼϴʱźÿһͼѵһһͼζÿһ mip ѵڶһ
+    VkSemaphoreTypeCreateInfo semaphoreTypeCreateInfo
+    {
+        VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,   // sType
+        nullptr,                                        // pNext
+        VK_SEMAPHORE_TYPE_TIMELINE,                     // semaphoreType
+        0                                               // initialValue
+    };
+    VkSemaphoreCreateInfo timelineSemaphoreCreateInfo
+    {
+        VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,        // sType
+        &semaphoreTypeCreateInfo,                       // pNext
+        VK_FALSE                                        // flags
+    };
+    m_textureTransferValue = 0;
+    m_textureGraphicsValue = 0;
+    if (vkCreateSemaphore(m_device, &timelineSemaphoreCreateInfo, nullptr, &m_textureTransferSemaphore) != VK_SUCCESS
+        || vkCreateSemaphore(m_device, &timelineSemaphoreCreateInfo, nullptr, &m_textureGraphicsSemaphore) != VK_SUCCESS)
+    {
+        throw std::runtime_error(setFontColor("Failed to create texture timeline semaphores", FontColor::Red));
+    }
+}
+
+void Application::createTimestampQueryPool()
+{
+    m_timestampFrames.assign(m_framesInFlight, 0);
+    m_timestampSubmitTimes.resize(m_framesInFlight);
+
+    // ʱдͼζϣЧλΪ 0 ʱöв֧ʱ
+    VkPhysicalDeviceProperties physicalDeviceProperties;
+    vkGetPhysicalDeviceProperties(m_physicalDevice, &physicalDeviceProperties);
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(m_physicalDevice, &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilyProperties(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(m_physicalDevice, &queueFamilyCount, queueFamilyProperties.data());
+    const uint32_t timestampValidBits = queueFamilyProperties[m_queueFamilyIndices.graphicsFamily.value()].timestampValidBits;
+    if (timestampValidBits == 0 || physicalDeviceProperties.limits.timestampPeriod == 0.0f)
+    {
+        std::cout << setFontColor("GPU timestamps are not supported on the graphics queue, only CPU scopes are profiled", FontColor::Yellow) << std::endl;
+        return;
+    }
+    m_timestampPeriod = physicalDeviceProperties.limits.timestampPeriod;
+    m_timestampMask = timestampValidBits >= 64 ? UINT64_MAX : (uint64_t(1) << timestampValidBits) - 1;
+
+    VkQueryPoolCreateInfo queryPoolCreateInfo
+    {
+        VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,       // sType
+        nullptr,                                        // pNext
+        0,                                              // flags
+        VK_QUERY_TYPE_TIMESTAMP,                        // queryType
+        m_framesInFlight * GPU_TIMESTAMP_COUNT,     // queryCount
+        0                                               // pipelineStatistics
+    };
+    if (vkCreateQueryPool(m_device, &queryPoolCreateInfo, nullptr, &m_timestampQueryPool) != VK_SUCCESS)
+    {
+        throw std::runtime_error(setFontColor("Failed to create timestamp query pool", FontColor::Red));
+    }
 }
 
 VkSampleCountFlagBits Application::getMaxUsableSampleCount()
@@ -1951,15 +3694,89 @@ VkSampleCountFlagBits Application::getMaxUsableSampleCount()
     if (sampleCountFlags & VK_SAMPLE_COUNT_4_BIT) return VK_SAMPLE_COUNT_4_BIT;
     if (sampleCountFlags & VK_SAMPLE_COUNT_2_BIT) return VK_SAMPLE_COUNT_2_BIT;
 
-    return VK_SAMPLE_COUNT_1_BIT;
+    return VK_SAMPLE_COUNT_1_BIT;
+}
+
+bool Application::pollWindowEvents()
+{
+    if (m_options.headless)
+    {
+        m_inputTime = std::chrono::steady_clock::now();
+        return true;
+    }
+    glfwPollEvents();
+    m_inputTime = std::chrono::steady_clock::now();
+    return !glfwWindowShouldClose(m_window);
+}
+
+void Application::waitForFrame(uint32_t _currentFrame)
+{
+    VkResult result = VK_TIMEOUT;
+    for (uint32_t timeoutCount = 0; result == VK_TIMEOUT; ++timeoutCount)
+    {
+        if (timeoutCount == MAX_FENCE_WAIT_TIMEOUTS)
+        {
+            throw std::runtime_error(setFontColor("Frame " + std::to_string(_currentFrame) + " did not finish within " + std::to_string(MAX_FENCE_WAIT_TIMEOUTS) + " s", FontColor::Red));
+        }
+        if (timeoutCount > 0)
+        {
+            std::cout << setFontColor("Still waiting for frame " + std::to_string(_currentFrame) + " after " + std::to_string(timeoutCount) + " s", FontColor::Yellow) << std::endl;
+        }
+        result = vkWaitForFences(m_device, 1, &m_flightFences[_currentFrame], VK_TRUE, FENCE_WAIT_TIMEOUT_NANOSECONDS);
+    }
+    if (result != VK_SUCCESS)
+    {
+        throw std::runtime_error(setFontColor("Failed to wait for frame fence", FontColor::Red));
+    }
+    recordFrameLatencies();
+}
+
+void Application::recordFrameLatencies()
+{
+    // ûгּʱչʱ޷֪ʾʱ̣뵽ֵӳٰ뵽۲쵽֡դźż㣬
+    // ϳʾӳ١ÿεȴз֡դԼΪһ֡
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < m_framesInFlight; ++i)
+    {
+        if (m_frameLatencyPending[i] && vkGetFenceStatus(m_device, m_flightFences[i]) == VK_SUCCESS)
+        {
+            m_inputLatencies.add(std::chrono::duration<double, std::milli>(now - m_frameInputTimes[i]).count());
+            m_frameLatencyPending[i] = false;
+        }
+    }
 }
 
 void Application::drawFrame()
 {
-    vkWaitForFences(m_device, 1, &m_flightFences[m_currentFrame], VK_TRUE, std::numeric_limits<uint64_t>::max());
+    // ֡ʼļ֡޺͵ӳģʽĵȴ
+    const std::chrono::steady_clock::time_point frameStartTime = std::chrono::steady_clock::now();
+    if (m_lastFrameStartTime != std::chrono::steady_clock::time_point{ })
+    {
+        m_frameIntervals.add(std::chrono::duration<double, std::milli>(frameStartTime - m_lastFrameStartTime).count());
+    }
+    m_lastFrameStartTime = frameStartTime;
+
+    m_profiler.beginFrame();
+    {
+        ProfileScope scope(m_profiler, "wait for fence");
+        waitForFrame(m_currentFrame);
+    }
+    readTimestamps(m_currentFrame);
+    writeFrameDump(m_currentFrame);
+    {
+        ProfileScope scope(m_profiler, "texture streaming");
+        updateTextureStreaming();
+    }
+    readCullingResults(m_currentFrame);
 
-    uint32_t imageIndex;
-    VkResult result = vkAcquireNextImageKHR(m_device, m_swapchain, std::numeric_limits<uint64_t>::max(), m_imageAvailableSemaphores[m_currentFrame], nullptr, &imageIndex);
+    // ޴ģʽÿ̶֡ʹһͼ
+    uint32_t imageIndex = m_currentFrame;
+    VkResult result = VK_SUCCESS;
+    if (!m_options.headless)
+    {
+        ProfileScope scope(m_profiler, "acquire image");
+        result = vkAcquireNextImageKHR(m_device, m_swapchain, std::numeric_limits<uint64_t>::max(), m_imageAvailableSemaphores[m_currentFrame], nullptr, &imageIndex);
+    }
     if (result == VK_ERROR_OUT_OF_DATE_KHR)
     {
         recreateSwapchain();
@@ -1969,31 +3786,72 @@ void Application::drawFrame()
         throw std::runtime_error(setFontColor("Failed to acquire swap chain image", FontColor::Red));
     }
 
-    updateUniformBuffer(m_currentFrame);
+    // ˮģʽݰ߳ģ⣬uploadFramePacket вģĺʱ
+    if (!m_options.pipelined)
+    {
+        ProfileScope scope(m_profiler, "simulate");
+        simulateFrame();
+    }
+    {
+        ProfileScope scope(m_profiler, "upload frame packet");
+        uploadFramePacket(m_currentFrame);
+    }
 
     vkResetFences(m_device, 1, &m_flightFences[m_currentFrame]);
 
-    vkResetCommandBuffer(m_commandBuffers[m_currentFrame], 0);
-    recordCommandBuffer(m_commandBuffers[m_currentFrame], imageIndex);
+    {
+        ProfileScope scope(m_profiler, "record command buffer");
+        vkResetCommandBuffer(m_commandBuffers[m_currentFrame], 0);
+        recordCommandBuffer(m_commandBuffers[m_currentFrame], imageIndex);
+    }
 
+    // ޴ģʽûлȡͳ֣ύʱҪȴ򷢳ź
     VkSemaphore waitSemaphores[]{ m_imageAvailableSemaphores[m_currentFrame]};
     VkPipelineStageFlags waitStages[]{ VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
     VkSemaphore signalSemaphores[]{ m_renderFinishedSemaphores[m_currentFrame]};
+    const uint32_t semaphoreCount = m_options.headless ? 0 : 1;
     VkSubmitInfo submitInfo
     {
         VK_STRUCTURE_TYPE_SUBMIT_INFO,                  // sType
         nullptr,                                        // pNext
-        1,                                              // waitSemaphoreCount
+        semaphoreCount,                                 // waitSemaphoreCount
         waitSemaphores,                                 // pWaitSemaphores
         waitStages,                                     // pWaitDstStageMask
         1,                                              // commandBufferCount
         &m_commandBuffers[m_currentFrame],              // pCommandBuffers
-        1,                                              // signalSemaphoreCount
+        semaphoreCount,                                 // signalSemaphoreCount
         signalSemaphores                                // pSignalSemaphores
     };
-    if (vkQueueSubmit(m_graphicsQueue, 1, &submitInfo, m_flightFences[m_currentFrame]) != VK_SUCCESS)
     {
-        throw std::runtime_error(setFontColor("Failed to submit draw command buffer", FontColor::Red));
+        ProfileScope scope(m_profiler, "submit");
+        if (vkQueueSubmit(m_graphicsQueue, 1, &submitInfo, m_flightFences[m_currentFrame]) != VK_SUCCESS)
+        {
+            throw std::runtime_error(setFontColor("Failed to submit draw command buffer", FontColor::Red));
+        }
+    }
+    m_frameLatencyPending[m_currentFrame] = true;
+    if (m_profiler.getFrameIndex() == 1)
+    {
+        std::cout << setFontColor(
+            "Time to first frame: " + std::to_string(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_startupTime).count()) + " ms",
+            FontColor::Green) << std::endl;
+    }
+    // ֡ʱ´εȴͬһդ֮ȡGPU ύʱΪ
+    if (m_timestampQueryPool != nullptr)
+    {
+        m_timestampFrames[m_currentFrame] = m_profiler.getFrameIndex();
+        m_timestampSubmitTimes[m_currentFrame] = FrameProfiler::Clock::now();
+    }
+    if (!m_options.frameDumpDirectory.empty())
+    {
+        m_frameReadbackFrames[m_currentFrame] = m_profiler.getFrameIndex();
+    }
+
+    if (m_options.headless)
+    {
+        m_currentFrame = (m_currentFrame + 1) % m_framesInFlight;
+        m_profiler.endFrame();
+        return;
     }
 
     VkSwapchainKHR swapchains[]{ m_swapchain };
@@ -2008,7 +3866,10 @@ void Application::drawFrame()
         &imageIndex,                                // pImageIndices
         nullptr                                     // pResults
     };
-    result = vkQueuePresentKHR(m_presentQueue, &presentInfoKHR);
+    {
+        ProfileScope scope(m_profiler, "present");
+        result = vkQueuePresentKHR(m_presentQueue, &presentInfoKHR);
+    }
     if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || m_framebufferResized)
     {
         m_framebufferResized = false;
@@ -2019,23 +3880,376 @@ void Application::drawFrame()
         throw std::runtime_error(setFontColor("Failed to present swap chain image", FontColor::Red));
     }
 
-    m_currentFrame = (m_currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+    m_currentFrame = (m_currentFrame + 1) % m_framesInFlight;
+    m_profiler.endFrame();
 }
 
-void Application::updateUniformBuffer(uint32_t _currentFrame)
+void Application::simulateFrame()
 {
-    static std::chrono::steady_clock::time_point startTime = std::chrono::high_resolution_clock::now();
+    // ģдػֻģһݰ drawFrame ȡ
+    FramePacket& packet = m_framePackets.getWriteBuffer();
+    packet.simulateStartTime = std::chrono::steady_clock::now();
+    packet.index = ++m_simulatedFrameCount;
+    packet.inputTime = m_inputTime;
+    updateCamera(packet);
+    updateInstances(packet);
+
+    // ÿתģʱϷ߼ˮģʽ
+    while (std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - packet.simulateStartTime).count() < m_options.simulationLoadMilliseconds)
+    {
+    }
+    packet.simulateEndTime = std::chrono::steady_clock::now();
+    m_framePackets.publish();
+    if (m_options.pipelined)
+    {
+        notifyFramePacketState();
+    }
+}
 
-    std::chrono::steady_clock::time_point currentTime = std::chrono::high_resolution_clock::now();
-    float deltaTime = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - startTime).count();
+void Application::updateCamera(FramePacket& _packet)
+{
+    // ʵĴС̧ߣֻһʵʱԭӽͬ
+    const float extent = m_instanceTransforms.getExtent();
+
+    glm::vec3 eye(0.0f, 10.0f + extent, 20.0f + 1.5f * extent);
+    glm::vec3 target(0.0f, 10.0f, 0.0f);
+    float fovDegrees = 60.0f;
+    // طʱؽűеĹؼ֡ƶ
+    if (!m_options.replayScriptPath.empty())
+    {
+        const CameraKeyframe camera = sampleCamera(m_replayScript, m_replayTime);
+        eye = glm::vec3(camera.eye[0], camera.eye[1], camera.eye[2]);
+        target = glm::vec3(camera.target[0], camera.target[1], camera.target[2]);
+        fovDegrees = camera.fovDegrees;
+    }
 
-    UniformBufferObject uniformBufferObject{ };
-    uniformBufferObject.model = glm::rotate(glm::mat4(1.0f), deltaTime * glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-    uniformBufferObject.view = glm::lookAt(glm::vec3(0.0f, 10.0f, 20.0f), glm::vec3(0.0f, 10.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-    uniformBufferObject.proj = glm::perspective(glm::radians(60.0f), static_cast<float>(m_swapchainExtent.width) / m_swapchainExtent.height, 0.1f, 100.0f);
+    // Ⱦ߳ؽȡؽʱµĴС
+    const uint32_t viewportWidth = m_viewportWidth;
+    const uint32_t viewportHeight = m_viewportHeight;
+    UniformBufferObject& uniformBufferObject = _packet.uniformBufferObject;
+    uniformBufferObject.view = glm::lookAt(eye, target, glm::vec3(0.0f, 1.0f, 0.0f));
+    uniformBufferObject.proj = glm::perspective(glm::radians(fovDegrees), static_cast<float>(viewportWidth) / viewportHeight, 0.1f, 100.0f + 4.0f * extent);
     uniformBufferObject.proj[1][1] *= -1.0f;
+    const glm::mat4 viewProjection = uniformBufferObject.proj * uniformBufferObject.view;
+    _packet.cullingFrustum = extractFrustumPlanes(&viewProjection[0][0]);
+    _packet.lodCamera = makeLodCamera(&uniformBufferObject.view[0][0], &uniformBufferObject.proj[0][0], viewportHeight);
+    uniformBufferObject.dequantization = m_meshCache.getVertexQuantization().getDequantizationMatrix();
+}
+
+void Application::updateInstances(FramePacket& _packet)
+{
+    std::chrono::steady_clock::time_point currentTime = std::chrono::steady_clock::now();
+    float deltaTime = std::chrono::duration<float>(currentTime - m_lastInstanceUpdateTime).count();
+    m_lastInstanceUpdateTime = currentTime;
+    // طʱ̶ƽʵ֡ʱ޹
+    if (!m_options.replayScriptPath.empty())
+    {
+        deltaTime = m_replayScript.timeStep;
+        m_replayTime += m_replayScript.timeStep;
+    }
+
+    // LOD ѡҪؾӳڴдϲģȡдݰȾʱ忽֡Ļη
+    const uint32_t instanceCount = m_instanceTransforms.getCount();
+    _packet.instanceMatrices.resize(static_cast<size_t>(InstanceTransforms::MATRIX_FLOAT_COUNT) * instanceCount);
+    _packet.instanceLods.resize(instanceCount);
+    // ʵ֮以 4 һֶϵͳϲи£ֶα߽ SIMD 
+    const uint32_t instanceTaskCount = std::min(getJobSystem().getThreadCount(), std::max(1u, instanceCount / MIN_INSTANCES_PER_JOB));
+    parallelFor((instanceCount + 3) / 4, instanceTaskCount, [&](size_t _begin, size_t _end, uint32_t)
+    {
+        m_instanceTransforms.update(deltaTime, _packet.instanceMatrices.data(), static_cast<uint32_t>(_begin * 4), std::min(static_cast<uint32_t>(_end * 4), instanceCount));
+    });
+
+    // ֡ʵΪÿʵѡ LOD޳ͨݴѡ
+    parallelFor(instanceCount, instanceTaskCount, [&](size_t _begin, size_t _end, uint32_t)
+    {
+        selectLods(_packet.lodCamera, _packet.instanceMatrices.data() + _begin * InstanceTransforms::MATRIX_FLOAT_COUNT, static_cast<uint32_t>(_end - _begin),
+            m_lodBoundsCenter, m_lodBoundsRadius, m_lodErrors.data(), static_cast<uint32_t>(m_lodErrors.size()), LOD_PIXEL_THRESHOLD, _packet.instanceLods.data() + _begin);
+    });
+
+    m_instanceUpdateMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - currentTime).count();
+}
+
+void Application::uploadFramePacket(uint32_t _currentFrame)
+{
+    // ȡµݰģ⻹ûзݰʱһ
+    m_framePackets.acquire();
+    if (m_options.pipelined)
+    {
+        notifyFramePacketState();
+    }
+    const FramePacket& packet = m_framePackets.getReadBuffer();
+    if (m_options.pipelined)
+    {
+        m_profiler.addCpuScope("simulate", packet.simulateStartTime, packet.simulateEndTime);
+    }
+    m_frameInputTimes[_currentFrame] = packet.inputTime;
+
+    m_uniformRing.beginFrame(_currentFrame);
+    FrameRingAllocation uniformAllocation = m_uniformRing.allocate(sizeof(UniformBufferObject));
+    std::memcpy(uniformAllocation.mapped, &packet.uniformBufferObject, sizeof(UniformBufferObject));
+    m_uniformBufferOffset = uniformAllocation.offset;
+    m_cullingFrustum = packet.cullingFrustum;
+
+    const uint32_t instanceCount = static_cast<uint32_t>(packet.instanceLods.size());
+    m_instanceRing.beginFrame(_currentFrame);
+    FrameRingAllocation instanceAllocation = m_instanceRing.allocate(sizeof(glm::mat4) * instanceCount);
+    std::memcpy(instanceAllocation.mapped, packet.instanceMatrices.data(), sizeof(glm::mat4) * instanceCount);
+    m_instanceBufferOffset = instanceAllocation.offset;
+    FrameRingAllocation lodAllocation = m_instanceRing.allocate(sizeof(uint32_t) * instanceCount);
+    std::memcpy(lodAllocation.mapped, packet.instanceLods.data(), sizeof(uint32_t) * instanceCount);
+    m_instanceLodOffset = lodAllocation.offset;
+
+    // ֡ʵ LOD ֿɼʵбдü޳ֻͨۼе instanceCount
+    const uint32_t lodCount = static_cast<uint32_t>(m_lodErrors.size());
+    initCullingCommands(packet.instanceLods.data(), instanceCount, m_visibleInstanceCapacity, m_cullingDrawItems.data(), m_cullingDrawItemCount, lodCount,
+        static_cast<IndirectDrawCommand*>(m_indirectCommandBufferAllocations[_currentFrame].mapped));
+
+    //  CPU οʵ޳ͬһݾ󣬶 GPU ʱȽϿɼ
+    if (m_options.verifyCulling)
+    {
+        std::vector<IndirectDrawCommand>& expectedCommands = m_expectedCullingCommands[_currentFrame];
+        expectedCommands.resize(static_cast<size_t>(m_cullingDrawItemCount) * lodCount);
+        initCullingCommands(packet.instanceLods.data(), instanceCount, m_visibleInstanceCapacity, m_cullingDrawItems.data(), m_cullingDrawItemCount, lodCount, expectedCommands.data());
+        cullDrawItems(m_cullingFrustum, packet.instanceMatrices.data(), instanceCount, packet.instanceLods.data(),
+            m_cullingDrawItems.data(), m_cullingDrawItemCount, lodCount, expectedCommands.data(), nullptr);
+    }
+}
+
+void Application::readCullingResults(uint32_t _currentFrame)
+{
+    // ֡դѾźţrecordCullingPass еϱ֤ۼӵʵɼ
+    const IndirectDrawCommand* commands = static_cast<const IndirectDrawCommand*>(m_indirectCommandBufferAllocations[_currentFrame].mapped);
+    const size_t lodCount = m_lodErrors.size();
+    m_visibleDrawCount = 0;
+    for (size_t i = 0; i < m_cullingDrawItemCount * lodCount; ++i)
+    {
+        m_visibleDrawCount += commands[i].instanceCount;
+    }
+
+    std::vector<IndirectDrawCommand>& expectedCommands = m_expectedCullingCommands[_currentFrame];
+    if (expectedCommands.empty())
+    {
+        return;
+    }
+
+    ++m_cullingVerifiedFrames;
+    for (size_t i = 0; i < expectedCommands.size(); ++i)
+    {
+        if (commands[i].instanceCount != expectedCommands[i].instanceCount)
+        {
+            // ֻӡһβһ£ֻ֮
+            if (m_cullingMismatchFrames == 0)
+            {
+                std::cout << setFontColor(
+                    "Culling mismatch: draw item " + std::to_string(i / lodCount) + " LOD " + std::to_string(i % lodCount) + ", GPU " + std::to_string(commands[i].instanceCount)
+                    + ", CPU " + std::to_string(expectedCommands[i].instanceCount),
+                    FontColor::Yellow) << std::endl;
+            }
+            ++m_cullingMismatchFrames;
+            break;
+        }
+    }
+    expectedCommands.clear();
+}
+
+void Application::readTimestamps(uint32_t _currentFrame)
+{
+    if (m_timestampQueryPool == nullptr || m_timestampFrames[_currentFrame] == 0)
+    {
+        return;
+    }
+
+    // ǰѾȴ֡դѾã WAIT ־ȡ
+    const uint64_t frame = m_timestampFrames[_currentFrame];
+    m_timestampFrames[_currentFrame] = 0;
+    std::array<uint64_t, GPU_TIMESTAMP_COUNT> timestamps{ };
+    if (vkGetQueryPoolResults(m_device, m_timestampQueryPool, _currentFrame * GPU_TIMESTAMP_COUNT, GPU_TIMESTAMP_COUNT, sizeof(timestamps), timestamps.data(),
+        sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) != VK_SUCCESS)
+    {
+        return;
+    }
+
+    // ֻе timestampValidBits λЧֵ봦
+    std::array<double, GPU_TIMESTAMP_COUNT> offsets{ };
+    for (uint32_t i = 0; i < GPU_TIMESTAMP_COUNT; ++i)
+    {
+        offsets[i] = static_cast<double>((timestamps[i] - timestamps[0]) & m_timestampMask) * m_timestampPeriod / 1000.0;
+    }
+    m_profiler.addGpuFrame(frame, m_timestampSubmitTimes[_currentFrame], GPU_TIMESTAMP_SCOPE_NAMES.data(), offsets.data(), GPU_TIMESTAMP_COUNT);
+}
+
+void Application::recordFrameReadback(VkCommandBuffer _commandBuffer, uint32_t _imageIndex)
+{
+    // Ⱦͨʱͼת TRANSFER_SRC_OPTIMALֻȴɫд
+    VkImageMemoryBarrier imageMemoryBarrier
+    {
+        VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,                 // sType
+        nullptr,                                                // pNext
+        VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,                   // srcAccessMask
+        VK_ACCESS_TRANSFER_READ_BIT,                            // dstAccessMask
+        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,                   // oldLayout
+        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,                   // newLayout
+        VK_QUEUE_FAMILY_IGNORED,                                // srcQueueFamilyIndex
+        VK_QUEUE_FAMILY_IGNORED,                                // dstQueueFamilyIndex
+        m_swapchainImages[_imageIndex],                         // image
+        {
+            VK_IMAGE_ASPECT_COLOR_BIT,
+            0,
+            1,
+            0,
+            1
+        }                                                       // subresourceRange
+    };
+    vkCmdPipelineBarrier(_commandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
+
+    VkBufferImageCopy bufferImageCopyRegion
+    {
+        0,                                              // bufferOffset
+        0,                                              // bufferRowLength
+        0,                                              // bufferImageHeight
+        {
+            VK_IMAGE_ASPECT_COLOR_BIT,
+            0,
+            0,
+            1
+        },                                              // imageSubresource
+        { 0, 0, 0 },                                    // imageOffset
+        {
+            m_swapchainExtent.width,
+            m_swapchainExtent.height,
+            1
+        }                                               // imageExtent
+    };
+    vkCmdCopyImageToBuffer(_commandBuffer, m_swapchainImages[_imageIndex], VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, m_frameReadbackBuffers[m_currentFrame], 1, &bufferImageCopyRegion);
+
+    VkBufferMemoryBarrier bufferMemoryBarrier
+    {
+        VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,                    // sType
+        nullptr,                                                    // pNext
+        VK_ACCESS_TRANSFER_WRITE_BIT,                               // srcAccessMask
+        VK_ACCESS_HOST_READ_BIT,                                    // dstAccessMask
+        VK_QUEUE_FAMILY_IGNORED,                                    // srcQueueFamilyIndex
+        VK_QUEUE_FAMILY_IGNORED,                                    // dstQueueFamilyIndex
+        m_frameReadbackBuffers[m_currentFrame],                     // buffer
+        0,                                                          // offset
+        VK_WHOLE_SIZE                                               // size
+    };
+    vkCmdPipelineBarrier(_commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 0, nullptr, 1, &bufferMemoryBarrier, 0, nullptr);
+}
+
+void Application::writeFrameDump(uint32_t _currentFrame)
+{
+    if (m_frameReadbackFrames.empty() || m_frameReadbackFrames[_currentFrame] == 0)
+    {
+        return;
+    }
+
+    ProfileScope scope(m_profiler, "dump frame");
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    const uint64_t frame = m_frameReadbackFrames[_currentFrame];
+    m_frameReadbackFrames[_currentFrame] = 0;
+
+    std::vector<unsigned char> pixels;
+    readFramePixels(_currentFrame, pixels);
+
+    std::string filename = std::to_string(frame);
+    filename = m_options.frameDumpDirectory + "/frame_" + std::string(filename.size() < 5 ? 5 - filename.size() : 0, '0') + filename + ".png";
+    if (stbi_write_png(filename.c_str(), static_cast<int>(m_swapchainExtent.width), static_cast<int>(m_swapchainExtent.height), 4, pixels.data(),
+        static_cast<int>(m_swapchainExtent.width * 4)) == 0)
+    {
+        std::cout << setFontColor("Failed to write frame: " + filename, FontColor::Yellow) << std::endl;
+    }
+    m_frameDumpMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void Application::readFramePixels(uint32_t _currentFrame, std::vector<unsigned char>& _pixels)
+{
+    // ʱ͸ϳɣ alphaͬΪ͸
+    const size_t pixelCount = static_cast<size_t>(m_swapchainExtent.width) * m_swapchainExtent.height;
+    _pixels.resize(pixelCount * 4);
+    std::memcpy(_pixels.data(), m_frameReadbackAllocations[_currentFrame].mapped, _pixels.size());
+    for (size_t i = 0; i < pixelCount; ++i)
+    {
+        _pixels[i * 4 + 3] = 255;
+    }
+}
+
+void Application::captureFrame(uint32_t _imageIndex, std::vector<unsigned char>& _pixels)
+{
+    // ǰ豸ѿУõǰ֡Ļض¼һԵĸƲȴ
+    VkCommandBuffer commandBuffer = beginCommandBuffer(m_commandPool);
+    recordFrameReadback(commandBuffer, _imageIndex);
+    vkEndCommandBuffer(commandBuffer);
+    VkSubmitInfo submitInfo
+    {
+        VK_STRUCTURE_TYPE_SUBMIT_INFO,                  // sType
+        nullptr,                                        // pNext
+        0,                                              // waitSemaphoreCount
+        nullptr,                                        // pWaitSemaphores
+        nullptr,                                        // pWaitDstStageMask
+        1,                                              // commandBufferCount
+        &commandBuffer,                                 // pCommandBuffers
+        0,                                              // signalSemaphoreCount
+        nullptr                                         // pSignalSemaphores
+    };
+    if (vkQueueSubmit(m_graphicsQueue, 1, &submitInfo, nullptr) != VK_SUCCESS)
+    {
+        throw std::runtime_error(setFontColor("Failed to submit frame capture", FontColor::Red));
+    }
+    vkQueueWaitIdle(m_graphicsQueue);
+    vkFreeCommandBuffers(m_device, m_commandPool, 1, &commandBuffer);
+
+    readFramePixels(m_currentFrame, _pixels);
+}
 
-    std::memcpy(m_uniformBuffersMapped[_currentFrame], &uniformBufferObject, sizeof(uniformBufferObject));
+void Application::recordCullingPass(VkCommandBuffer _commandBuffer)
+{
+    //  uploadFramePacket д (ύʱ豸ɼ)ÿ߳޳һ (, ʵ) ϣ
+    // ɼʱԭӵۼӶӦ (, LOD) ʵʵдĿɼʵ
+    CullingPushConstant pushConstant{ };
+    std::memcpy(pushConstant.frustumPlanes, m_cullingFrustum.planes, sizeof(pushConstant.frustumPlanes));
+    pushConstant.instanceCount = m_instanceTransforms.getCount();
+    pushConstant.drawItemCount = m_cullingDrawItemCount;
+    pushConstant.lodCount = static_cast<uint32_t>(m_lodErrors.size());
+
+    // ̬ƫư binding ˳
+    const std::array<uint32_t, 2> dynamicOffsets{ static_cast<uint32_t>(m_instanceBufferOffset), static_cast<uint32_t>(m_instanceLodOffset) };
+    vkCmdBindPipeline(_commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_cullingPipeline);
+    vkCmdBindDescriptorSets(_commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_cullingPipelineLayout, 0, 1, &m_cullingDescriptorSets[m_currentFrame],
+        static_cast<uint32_t>(dynamicOffsets.size()), dynamicOffsets.data());
+    vkCmdPushConstants(_commandBuffer, m_cullingPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pushConstant), &pushConstant);
+    vkCmdDispatch(_commandBuffer, (pushConstant.instanceCount * pushConstant.drawItemCount + CULLING_GROUP_SIZE - 1) / CULLING_GROUP_SIZE, 1, 1);
+
+    // ڻʱΪӲȡʵդ֮أɼʵɶɫȡ
+    std::array<VkBufferMemoryBarrier, 2> cullingBarriers
+    {
+        VkBufferMemoryBarrier
+        {
+            VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,                // sType
+            nullptr,                                                // pNext
+            VK_ACCESS_SHADER_WRITE_BIT,                             // srcAccessMask
+            VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_HOST_READ_BIT, // dstAccessMask
+            VK_QUEUE_FAMILY_IGNORED,                                // srcQueueFamilyIndex
+            VK_QUEUE_FAMILY_IGNORED,                                // dstQueueFamilyIndex
+            m_indirectCommandBuffers[m_currentFrame],               // buffer
+            0,                                                      // offset
+            VK_WHOLE_SIZE                                           // size
+        },
+        VkBufferMemoryBarrier
+        {
+            VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,                // sType
+            nullptr,                                                // pNext
+            VK_ACCESS_SHADER_WRITE_BIT,                             // srcAccessMask
+            VK_ACCESS_SHADER_READ_BIT,                              // dstAccessMask
+            VK_QUEUE_FAMILY_IGNORED,                                // srcQueueFamilyIndex
+            VK_QUEUE_FAMILY_IGNORED,                                // dstQueueFamilyIndex
+            m_visibleInstanceBuffers[m_currentFrame],               // buffer
+            0,                                                      // offset
+            VK_WHOLE_SIZE                                           // size
+        }
+    };
+    vkCmdPipelineBarrier(_commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_HOST_BIT, 0,
+        0, nullptr, static_cast<uint32_t>(cullingBarriers.size()), cullingBarriers.data(), 0, nullptr);
 }
 
 void Application::recordCommandBuffer(VkCommandBuffer _commandBuffer, uint32_t _imageIndex)
@@ -2052,6 +4266,19 @@ void Application::recordCommandBuffer(VkCommandBuffer _commandBuffer, uint32_t _
         throw std::runtime_error(setFontColor("Failed to begin recording command buffer " + std::to_string(_imageIndex), FontColor::Red));
     }
 
+    const uint32_t firstTimestamp = m_currentFrame * GPU_TIMESTAMP_COUNT;
+    if (m_timestampQueryPool != nullptr)
+    {
+        vkCmdResetQueryPool(_commandBuffer, m_timestampQueryPool, firstTimestamp, GPU_TIMESTAMP_COUNT);
+        vkCmdWriteTimestamp(_commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_timestampQueryPool, firstTimestamp);
+    }
+
+    recordCullingPass(_commandBuffer);
+    if (m_timestampQueryPool != nullptr)
+    {
+        vkCmdWriteTimestamp(_commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_timestampQueryPool, firstTimestamp + 1);
+    }
+
     std::array<VkClearValue, 2> clearValues{ };
     clearValues[0].color = { { 0.0f, 0.0f, 0.0f, 1.0f } };
     clearValues[1].depthStencil = { 1.0f, 0 };
@@ -2068,7 +4295,38 @@ void Application::recordCommandBuffer(VkCommandBuffer _commandBuffer, uint32_t _
         static_cast<uint32_t>(clearValues.size()),          // clearValueCount
         clearValues.data()                                  // pClearValues
     };
-    vkCmdBeginRenderPass(_commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+    // 㹻ʱֶβ¼Ƶ̵߳Ķ壬ִֻǣֱ¼
+    const uint32_t drawCount = static_cast<uint32_t>(m_drawList.getDrawItems().size());
+    const uint32_t recordTaskCount = getRecordTaskCount(drawCount);
+    if (recordTaskCount > 1)
+    {
+        recordSecondaryCommandBuffers(_imageIndex, drawCount, recordTaskCount);
+        vkCmdBeginRenderPass(_commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+        vkCmdExecuteCommands(_commandBuffer, recordTaskCount, &m_secondaryCommandBuffers[m_currentFrame * m_recordThreadCount]);
+    }
+    else
+    {
+        vkCmdBeginRenderPass(_commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+        recordDrawState(_commandBuffer);
+        recordDraws(_commandBuffer, 0, drawCount);
+    }
+    vkCmdEndRenderPass(_commandBuffer);
+    if (m_timestampQueryPool != nullptr)
+    {
+        vkCmdWriteTimestamp(_commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_timestampQueryPool, firstTimestamp + 2);
+    }
+    if (!m_options.frameDumpDirectory.empty())
+    {
+        recordFrameReadback(_commandBuffer, _imageIndex);
+    }
+    if (vkEndCommandBuffer(_commandBuffer) != VK_SUCCESS)
+    {
+        throw std::runtime_error(setFontColor("Failed to record command buffer " + std::to_string(_imageIndex), FontColor::Red));
+    }
+}
+
+void Application::recordDrawState(VkCommandBuffer _commandBuffer)
+{
     vkCmdBindPipeline(_commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_graphicsPipeline);
 
     // ӿںͲü
@@ -2091,28 +4349,115 @@ void Application::recordCommandBuffer(VkCommandBuffer _commandBuffer, uint32_t _
     };
     vkCmdSetScissor(_commandBuffer, 0, 1, &scissor);
 
-    VkBuffer vertexBuffers[]{ m_vertexBuffer };
-    VkDeviceSize offsets[]{ 0 };
-    vkCmdBindVertexBuffers(_commandBuffer, 0, 1, vertexBuffers, offsets);
-    vkCmdBindIndexBuffer(_commandBuffer, m_vertexIndicesBuffer, 0, VK_INDEX_TYPE_UINT32);
+    VkDeviceSize vertexBufferOffset = 0;
+    vkCmdBindVertexBuffers(_commandBuffer, 0, 1, &m_vertexBuffer, &vertexBufferOffset);
+    VkIndexType indexType = m_meshCache.getVertexIndexSize() == sizeof(uint16_t) ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+    vkCmdBindIndexBuffer(_commandBuffer, m_vertexIndicesBuffer, 0, indexType);
 
-    vkCmdBindDescriptorSets(_commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout, 0, 1, &m_descriptorSets[m_currentFrame], 0, nullptr);
+    // ʵÿֻ֡һΣ֮лͼʱ° set 0 Ӱ
+    const uint32_t instanceBufferOffset = static_cast<uint32_t>(m_instanceBufferOffset);
+    vkCmdBindDescriptorSets(_commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout, 1, 1, &m_instanceDescriptorSets[m_currentFrame], 1, &instanceBufferOffset);
 
-    vkCmdDrawIndexed(_commandBuffer, static_cast<uint32_t>(m_vertexIndices.size()), 1, 0, 0, 0);
-    vkCmdEndRenderPass(_commandBuffer);
-    if (vkEndCommandBuffer(_commandBuffer) != VK_SUCCESS)
+    // bindless ʱÿֻ֡һͼɲʼ¼ɫѡ
+    if (m_bindlessEnabled)
     {
-        throw std::runtime_error(setFontColor("Failed to record command buffer " + std::to_string(_imageIndex), FontColor::Red));
+        vkCmdBindDescriptorSets(_commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout, 0, 1, &m_descriptorSets[m_currentFrame], 1, &m_uniformBufferOffset);
+    }
+}
+
+void Application::recordDraws(VkCommandBuffer _commandBuffer, uint32_t _begin, uint32_t _end)
+{
+    //  bindless ʱбѰͼֻͼ仯ʱ°
+    // ʱͨͳݣ 16 λΧ񱻲ɶΣÿ vertexOffset ָ׼㡣
+    // ÿĸ LOD һʵ޳ͨۼӣûпɼʵơ
+    // ¼ƻ׼ԵĻбʱѭʹû
+    uint32_t boundTextureSlot = UINT32_MAX;
+    uint32_t pushedMaterialIndex = UINT32_MAX;
+    const uint32_t lodCount = static_cast<uint32_t>(m_lodErrors.size());
+    const std::vector<DrawItem>& drawItems = m_drawList.getDrawItems();
+    for (uint32_t i = _begin; i < _end; ++i)
+    {
+        const uint32_t drawItemIndex = i % static_cast<uint32_t>(drawItems.size());
+        const DrawItem& drawItem = drawItems[drawItemIndex];
+        const uint32_t textureSlot = getTextureSlot(drawItem.textureIndex);
+        if (!m_bindlessEnabled && textureSlot != boundTextureSlot)
+        {
+            VkDescriptorSet descriptorSet = m_descriptorSets[m_currentFrame * m_textures.size() + textureSlot];
+            vkCmdBindDescriptorSets(_commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout, 0, 1, &descriptorSet, 1, &m_uniformBufferOffset);
+            boundTextureSlot = textureSlot;
+        }
+        if (drawItem.materialIndex != pushedMaterialIndex)
+        {
+            MaterialPushConstant pushConstant{ drawItem.materialIndex };
+            vkCmdPushConstants(_commandBuffer, m_pipelineLayout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(pushConstant), &pushConstant);
+            pushedMaterialIndex = drawItem.materialIndex;
+        }
+        vkCmdDrawIndexedIndirect(_commandBuffer, m_indirectCommandBuffers[m_currentFrame], sizeof(IndirectDrawCommand) * lodCount * drawItemIndex, lodCount, sizeof(IndirectDrawCommand));
     }
 }
 
+uint32_t Application::getRecordTaskCount(uint32_t _drawCount) const
+{
+    return std::min(m_recordThreadCount, std::max(1u, _drawCount / MIN_DRAWS_PER_RECORD_TASK));
+}
+
+void Application::recordSecondaryCommandBuffers(uint32_t _imageIndex, uint32_t _drawCount, uint32_t _taskCount)
+{
+    VkCommandBufferInheritanceInfo commandBufferInheritanceInfo
+    {
+        VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,  // sType
+        nullptr,                                            // pNext
+        m_renderPass,                                       // renderPass
+        0,                                                  // subpass
+        m_swapchainFramebuffers[_imageIndex],               // framebuffer
+        VK_FALSE,                                           // occlusionQueryEnable
+        0,                                                  // queryFlags
+        0                                                   // pipelineStatistics
+    };
+    VkCommandBufferBeginInfo commandBufferBeginInfo
+    {
+        VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,                                                // sType
+        nullptr,                                                                                    // pNext
+        VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, // flags
+        &commandBufferInheritanceInfo                                                               // pInheritanceInfo
+    };
+
+    // ÿ֡ÿ¼߳Լأȴ֡դã֮߳䲻Ҫͬ
+    const uint32_t firstCommandBuffer = m_currentFrame * m_recordThreadCount;
+    parallelFor(_drawCount, _taskCount, [&](size_t _begin, size_t _end, uint32_t _taskIndex)
+    {
+        vkResetCommandPool(m_device, m_recordCommandPools[firstCommandBuffer + _taskIndex], 0);
+        VkCommandBuffer commandBuffer = m_secondaryCommandBuffers[firstCommandBuffer + _taskIndex];
+        if (vkBeginCommandBuffer(commandBuffer, &commandBufferBeginInfo) != VK_SUCCESS)
+        {
+            throw std::runtime_error(setFontColor("Failed to begin recording secondary command buffer " + std::to_string(_taskIndex), FontColor::Red));
+        }
+        recordDrawState(commandBuffer);
+        recordDraws(commandBuffer, static_cast<uint32_t>(_begin), static_cast<uint32_t>(_end));
+        if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+        {
+            throw std::runtime_error(setFontColor("Failed to record secondary command buffer " + std::to_string(_taskIndex), FontColor::Red));
+        }
+    });
+}
+
 void Application::recreateSwapchain()
 {
-    int width = 0, height = 0;
-    while (width == 0 || height == 0)
+    // СʱСΪ 0ȴڻָؽˮģʽ´¼̴߳Ⱦֻ߳ܵȴ
+    while (m_framebufferWidth == 0 || m_framebufferHeight == 0)
     {
-        glfwGetFramebufferSize(m_window, &width, &height);
-        glfwWaitEvents();
+        if (!m_options.pipelined)
+        {
+            glfwWaitEvents();
+        }
+        else if (m_pipelineStopping)
+        {
+            return;
+        }
+        else
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
     }
 
     vkDeviceWaitIdle(m_device);
@@ -2130,11 +4475,11 @@ void Application::cleanupSwapchain()
 {
     vkDestroyImageView(m_device, m_colorImageView, nullptr);
     vkDestroyImage(m_device, m_colorImage, nullptr);
-    vkFreeMemory(m_device, m_colorImageMemory, nullptr);
+    m_memoryAllocator.free(m_colorImageAllocation);
 
     vkDestroyImageView(m_device, m_depthImageView, nullptr);
     vkDestroyImage(m_device, m_depthImage, nullptr);
-    vkFreeMemory(m_device, m_depthImageMemory, nullptr);
+    m_memoryAllocator.free(m_depthImageAllocation);
 
     for (VkFramebuffer swapchainFramebuffer : m_swapchainFramebuffers)
     {
@@ -2146,7 +4491,21 @@ void Application::cleanupSwapchain()
         vkDestroyImageView(m_device, swapchainImageView, nullptr);
     }
 
-    vkDestroySwapchainKHR(m_device, m_swapchain, nullptr);
+    if (!m_options.headless)
+    {
+        vkDestroySwapchainKHR(m_device, m_swapchain, nullptr);
+        return;
+    }
+    for (size_t i = 0; i < m_swapchainImages.size(); ++i)
+    {
+        vkDestroyImage(m_device, m_swapchainImages[i], nullptr);
+        m_memoryAllocator.free(m_offscreenImageAllocations[i]);
+    }
+    for (size_t i = 0; i < m_frameReadbackBuffers.size(); ++i)
+    {
+        vkDestroyBuffer(m_device, m_frameReadbackBuffers[i], nullptr);
+        m_memoryAllocator.free(m_frameReadbackAllocations[i]);
+    }
 }
 
 VKAPI_ATTR VkBool32 VKAPI_CALL Application::debugCallback(VkDebugUtilsMessageSeverityFlagBitsEXT _messageSeverity, VkDebugUtilsMessageTypeFlagsEXT _messageType, const VkDebugUtilsMessengerCallbackDataEXT* _pCallbackData, void* _pUserData)
@@ -2188,43 +4547,8 @@ std::vector<char> Application::readFile(const std::string& _filename)
 void Application::framebufferResizeCallback(GLFWwindow* _window, int _width, int _height)
 {
     auto app = reinterpret_cast<Application*>(glfwGetWindowUserPointer(_window));
+    app->m_framebufferWidth = _width;
+    app->m_framebufferHeight = _height;
     app->m_framebufferResized = true;
     std::cout << setFontColor("Resize window:\n\twidth: " + std::to_string(_width) + "\n\theight: " + std::to_string(_height), FontColor::Purple) << std::endl;
 }
-
-VkVertexInputBindingDescription Vertex::getBindingDescription()
-{
-    VkVertexInputBindingDescription vertexInputBindingDescription
-    {
-        0,                                      // binding
-        sizeof(Vertex),                         // stride
-        VK_VERTEX_INPUT_RATE_VERTEX             // inputRate
-    };
-    return vertexInputBindingDescription;
-}
-
-std::array<VkVertexInputAttributeDescription, 3> Vertex::getAttributeDescriptions()
-{
-    std::array<VkVertexInputAttributeDescription, 3> vertexInputAttributeDescriptions;
-    vertexInputAttributeDescriptions[0].location = 0;
-    vertexInputAttributeDescriptions[0].binding = 0;
-    vertexInputAttributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
-    vertexInputAttributeDescriptions[0].offset = offsetof(Vertex, positionOS);
-
-    vertexInputAttributeDescriptions[1].location = 1;
-    vertexInputAttributeDescriptions[1].binding = 0;
-    vertexInputAttributeDescriptions[1].format = VK_FORMAT_R32G32B32_SFLOAT;
-    vertexInputAttributeDescriptions[1].offset = offsetof(Vertex, color);
-
-    vertexInputAttributeDescriptions[2].location = 2;
-    vertexInputAttributeDescriptions[2].binding = 0;
-    vertexInputAttributeDescriptions[2].format = VK_FORMAT_R32G32_SFLOAT;
-    vertexInputAttributeDescriptions[2].offset = offsetof(Vertex, texCoord);
-
-    return vertexInputAttributeDescriptions;
-}
-
-bool Vertex::operator == (const Vertex& _vertex) const
-{
-    return positionOS == _vertex.positionOS && color == _vertex.color && texCoord == _vertex.texCoord;
-}
@@ -10,45 +10,124 @@
 #include <exception>
 #include <vector>
 #include <cstring>
+#include <cstdlib>
 #include <map>
 #include <unordered_map>
 #include <optional>
 #include <set>
 #include <limits>
 #include <fstream>
+#include <filesystem>
 #include <array>
 #include <chrono>
 #include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
 
 #include "common.h"
+#include "Vertex.h"
+#include "MeshCache.h"
+#include "DrawList.h"
+#include "FrameProfiler.h"
+#include "FramePacing.h"
+#include "PipelineCacheFile.h"
+#include "FrustumCulling.h"
+#include "ImageCompare.h"
+#include "LodSelection.h"
+#include "ReplayScript.h"
+#include "TaskGraph.h"
+#include "FrameRingAllocator.h"
+#include "GpuMemoryAllocator.h"
+#include "InstanceTransforms.h"
+#include "TextureStreamer.h"
+#include "TripleBuffer.h"
+#include "UploadBatcher.h"
 
-struct Vertex
+struct UniformBufferObject
 {
-    glm::vec3 positionOS;
-    glm::vec3 color;
-    glm::vec2 texCoord;
+    alignas(16) glm::mat4 view;
+    alignas(16) glm::mat4 proj;
+    alignas(16) glm::mat4 dequantization;
+};
 
-    static VkVertexInputBindingDescription getBindingDescription();
-    static std::array<VkVertexInputAttributeDescription, 3> getAttributeDescriptions();
+struct FramePacket
+{
+    uint64_t index = 0;
+    UniformBufferObject uniformBufferObject{ };
+    FrustumPlanes cullingFrustum{ };
+    LodCamera lodCamera{ };
+    std::vector<float> instanceMatrices;
+    std::vector<uint32_t> instanceLods;
+    std::chrono::steady_clock::time_point inputTime;
+    std::chrono::steady_clock::time_point simulateStartTime;
+    std::chrono::steady_clock::time_point simulateEndTime;
+};
 
-    bool operator == (const Vertex& _vertex) const;
+struct MaterialPushConstant
+{
+    uint32_t materialIndex;
 };
 
-struct UniformBufferObject
+struct CullingPushConstant
 {
-    alignas(16) glm::mat4 model;
-    alignas(16) glm::mat4 view;
-    alignas(16) glm::mat4 proj;
+    float frustumPlanes[6][4];
+    uint32_t instanceCount;
+    uint32_t drawItemCount;
+    uint32_t lodCount;
+};
+
+struct TextureResource
+{
+    VkImage image = nullptr;
+    GpuAllocation imageAllocation;
+    VkImageView imageView = nullptr;
+    uint32_t mipLevels = 0;
+};
+
+struct TextureUpload
+{
+    uint32_t slot = 0;
+    std::string filename;
+    TextureResource texture;
+    VkBuffer stagingBuffer = nullptr;
+    GpuAllocation stagingBufferAllocation;
+    VkCommandBuffer transferCommandBuffer = nullptr;
+    VkCommandBuffer graphicsCommandBuffer = nullptr;
+    uint64_t readyValue = 0;
 };
 
 struct QueueFamilyIndices
 {
     std::optional<uint32_t> graphicsFamily;
     std::optional<uint32_t> presentFamily;
+    std::optional<uint32_t> transferFamily;
 
     bool isComplete();
 };
 
+struct ApplicationOptions
+{
+    uint32_t instanceCount = 1;
+    bool benchmark = false;
+    bool verifyCulling = false;
+    std::string tracePath;
+    bool headless = false;
+    uint32_t frameCount = 0;
+    std::string frameDumpDirectory;
+    std::string replayScriptPath;
+    uint32_t recordThreadCount = 0;
+    bool recordBenchmark = false;
+    bool pipelined = false;
+    double simulationLoadMilliseconds = 0.0;
+    FramePacingMode pacing = FramePacingMode::Balanced;
+    uint32_t framesInFlight = 0;
+    double frameRateCap = 0.0;
+    bool pipelineCache = true;
+};
+
 struct SwapChainSupportDetails
 {
     VkSurfaceCapabilitiesKHR capabilities{ };
@@ -59,18 +138,26 @@ struct SwapChainSupportDetails
 class Application
 {
 public:
-    Application(const int _width, const int _height, const std::string& _name);
+    Application(const int _width, const int _height, const std::string& _name, const ApplicationOptions& _options = ApplicationOptions{ });
     Application(const Application& _application) = delete;
     ~Application();
 
     Application& operator = (const Application& _application) = delete;
 
-    void run();
+    int run();
 
 private:
     void initWindow(const int _width, const int _height, const std::string& _name);
     void initVulkan();
     void mainLoop();
+    uint32_t runPipelinedLoop();
+    void waitForFramePacketConsumed();
+    void notifyFramePacketState();
+    void runInstanceBenchmark();
+    void runRecordBenchmark();
+    void runReplay();
+    void writeReplayReport(const RollingHistogram& _frameTimes, double _totalMilliseconds, const std::string& _goldenStatus, const ImageDifference& _difference);
+    void waitForTextureStreaming();
     void cleanup();
 
     /*****************************************initVulkan******************************************/
@@ -88,11 +175,14 @@ private:
 
     void pickPhysicalDevice();
     bool isSuitableDevice(const VkPhysicalDevice _physicalDevice);
+    bool checkBindlessSupport(const VkPhysicalDevice _physicalDevice);
     long long int rateDeviceSuitability(const VkPhysicalDevice _physicalDevice);
     void printPhysicalDeviceFeature(const VkPhysicalDevice _physicalDevice);
     void printPhysicalDeviceProperties(const VkPhysicalDevice _physicalDevice);
     QueueFamilyIndices findQueueFamilies(VkPhysicalDevice _physicalDevice);
     void createLogicalDevice();
+    void createMemoryAllocator();
+    void reportMemoryStatistics();
     void createSurface();
     bool checkDeviceExtensionSupport(VkPhysicalDevice _physicalDevice);
     SwapChainSupportDetails querySwapchainSupport(VkPhysicalDevice _physicalDevice);
@@ -100,46 +190,84 @@ private:
     VkPresentModeKHR chooseSwapPresentMode(const std::vector<VkPresentModeKHR>& _availablePresentModes);
     VkExtent2D chooseSwapExtent(const VkSurfaceCapabilitiesKHR& _capabilities);
     void createSwapchain();
+    void createOffscreenTargets();
     void createImageViews();
     void createRenderPass();
     void createDescriptorSetLayout();
+    void createPipelineCache();
+    void savePipelineCache();
     void createGraphicsPipeline();
     VkShaderModule createShaderModule(const std::vector<char>& _code);
     void createFramebuffers();
     void createCommandPool();
-    void createBuffer(VkDeviceSize _size, VkBufferUsageFlags _usageFlags, VkMemoryPropertyFlags _propertyFlags, VkBuffer& _buffer, VkDeviceMemory& _deviceMemory);
-    void copyBuffer(VkBuffer _srcBuffer, VkBuffer _dstBuffer, VkDeviceSize _size);
+    void createBuffer(VkDeviceSize _size, VkBufferUsageFlags _usageFlags, VkMemoryPropertyFlags _propertyFlags, VkBuffer& _buffer, GpuAllocation& _allocation);
+    void createUploadBatcher();
+    void flushUploads();
     void createDepthResource();
     void createColorResource();
     VkFormat findSupportedFormat(const std::vector<VkFormat>& _candidates, VkImageTiling _imageTiling, VkFormatFeatureFlags _formatFeatureFlags);
     VkFormat findDepthFormat();
     bool hasStencilComponent(VkFormat _format);
-    void generateMipmaps(VkImage _image, VkFormat _format, int32_t _textureWidth, int32_t _textureHeight, uint32_t _mipLevels);
+    void generateMipmaps(VkCommandBuffer _commandBuffer, VkImage _image, VkFormat _format, int32_t _textureWidth, int32_t _textureHeight, uint32_t _mipLevels);
     void createTextureImage();
+    void createPlaceholderTexture();
+    void uploadTexture(DecodedTexture& _decodedTexture);
+    void finishTextureUpload(TextureUpload& _textureUpload);
+    void updateTextureStreaming();
+    void writeTextureDescriptor(uint32_t _frame, uint32_t _slot);
+    uint32_t getTextureSlot(uint32_t _textureIndex) const;
+    VkImageView getTextureImageView(uint32_t _slot) const;
     void createTextureImageView();
     void createTextureSampler();
     VkImageView createImageView(VkImage _image, VkFormat _format, VkImageAspectFlags _imageAspectFlags, uint32_t _mipLevels);
-    void createImage(uint32_t _width, uint32_t _height, uint32_t _mipLevels, VkSampleCountFlagBits _sampleCountFlagBits, VkFormat _format, VkImageTiling _imageTiling, VkImageUsageFlags _imageUsageFlags, VkMemoryPropertyFlags _memoryPropertyFlags, VkImage& _image, VkDeviceMemory& _imageMemory);
-    VkCommandBuffer beginSingleTimeCommands();
-    void endSingleTimeCommands(VkCommandBuffer _commandBuffer);
-    void transitionImageLayout(VkImage _image, VkFormat _format, VkImageLayout _oldImageLayout, VkImageLayout _newImageLayout, uint32_t _mipLevels);
-    void copyBufferToImage(VkBuffer _buffer, VkImage _image, uint32_t _width, uint32_t _height);
+    void createImage(uint32_t _width, uint32_t _height, uint32_t _mipLevels, VkSampleCountFlagBits _sampleCountFlagBits, VkFormat _format, VkImageTiling _imageTiling, VkImageUsageFlags _imageUsageFlags, VkMemoryPropertyFlags _memoryPropertyFlags, VkImage& _image, GpuAllocation& _imageAllocation);
+    VkCommandBuffer beginCommandBuffer(VkCommandPool _commandPool);
+    void transitionImageLayout(VkCommandBuffer _commandBuffer, VkImage _image, VkFormat _format, VkImageLayout _oldImageLayout, VkImageLayout _newImageLayout, uint32_t _mipLevels);
+    void copyBufferToImage(VkCommandBuffer _commandBuffer, VkBuffer _buffer, VkImage _image, uint32_t _width, uint32_t _height);
     void loadModel();
+    void optimizeModel(std::vector<Vertex>& _vertices, std::vector<uint32_t>& _vertexIndices, const std::vector<Submesh>& _submeshes);
+    void createDrawList();
     void createVertexBuffer();
     void createVertexIndicesBuffer();
-    void createUniformBuffers();
+    void createMaterialBuffer();
+    void createCullingBuffers();
+    void createCullingPipeline();
+    void createCullingDescriptorSets();
+    void createUniformRing();
+    void createInstanceRing();
+    uint32_t getInstanceCapacity() const;
     void createDescriptorPool();
     void createDescriptorSets();
-    uint32_t findMemoryType(uint32_t _typeFilter, VkMemoryPropertyFlags _properties);
     void createCommandBuffers();
+    void createRecordCommandPools();
     void createSyncObjects();
+    void createTimestampQueryPool();
     VkSampleCountFlagBits getMaxUsableSampleCount();
     /*********************************************************************************************/
 
     /******************************************mainLoop*******************************************/
+    bool pollWindowEvents();
+    void waitForFrame(uint32_t _currentFrame);
+    void recordFrameLatencies();
     void drawFrame();
-    void updateUniformBuffer(uint32_t _currentFrame);
+    void simulateFrame();
+    void updateCamera(FramePacket& _packet);
+    void updateInstances(FramePacket& _packet);
+    void uploadFramePacket(uint32_t _currentFrame);
+    void readCullingResults(uint32_t _currentFrame);
+    void readTimestamps(uint32_t _currentFrame);
+    void recordFrameReadback(VkCommandBuffer _commandBuffer, uint32_t _imageIndex);
+    void writeFrameDump(uint32_t _currentFrame);
+    void readFramePixels(uint32_t _currentFrame, std::vector<unsigned char>& _pixels);
+    void captureFrame(uint32_t _imageIndex, std::vector<unsigned char>& _pixels);
+    void reportProfile();
+    void reportFramePacing();
+    void recordCullingPass(VkCommandBuffer _commandBuffer);
     void recordCommandBuffer(VkCommandBuffer _commandBuffer, uint32_t _imageIndex);
+    void recordDrawState(VkCommandBuffer _commandBuffer);
+    void recordDraws(VkCommandBuffer _commandBuffer, uint32_t _begin, uint32_t _end);
+    uint32_t getRecordTaskCount(uint32_t _drawCount) const;
+    void recordSecondaryCommandBuffers(uint32_t _imageIndex, uint32_t _drawCount, uint32_t _taskCount);
     void recreateSwapchain();
     void cleanupSwapchain();
     /*********************************************************************************************/
@@ -167,9 +295,14 @@ private:
 
     VkPhysicalDevice m_physicalDevice = nullptr;
     VkDevice m_device = nullptr;
+    GpuMemoryAllocator m_memoryAllocator;
+    std::mutex m_memoryAllocatorMutex;
+    bool m_bindlessEnabled = false;
 
+    QueueFamilyIndices m_queueFamilyIndices;
     VkQueue m_graphicsQueue = nullptr;
     VkQueue m_presentQueue = nullptr;
+    VkQueue m_transferQueue = nullptr;
 
     VkSwapchainKHR m_swapchain = nullptr;
     std::vector<VkImage> m_swapchainImages;
@@ -178,39 +311,107 @@ private:
     std::vector<VkImageView> m_swapchainImageViews;
     std::vector<VkFramebuffer> m_swapchainFramebuffers;
 
+    VkExtent2D m_headlessExtent{ };
+    std::vector<GpuAllocation> m_offscreenImageAllocations;
+    std::vector<VkBuffer> m_frameReadbackBuffers;
+    std::vector<GpuAllocation> m_frameReadbackAllocations;
+    std::vector<uint64_t> m_frameReadbackFrames;
+    double m_frameDumpMilliseconds = 0.0;
+
+    ReplayScript m_replayScript;
+    float m_replayTime = 0.0f;
+    std::chrono::steady_clock::time_point m_startupTime;
+    std::vector<std::pair<std::string, double>> m_startupPhases;
+    int m_exitCode = 0;
+
     VkRenderPass m_renderPass = nullptr;
     VkDescriptorSetLayout m_descriptorSetLayout = nullptr;
     VkPipelineLayout m_pipelineLayout = nullptr;
     VkPipeline m_graphicsPipeline = nullptr;
+    VkPipelineCache m_pipelineCache = nullptr;
+    bool m_pipelineCacheLoaded = false;
+    double m_graphicsPipelineMilliseconds = 0.0;
+    double m_cullingPipelineMilliseconds = 0.0;
 
     VkCommandPool m_commandPool = nullptr;
+    VkCommandPool m_transferCommandPool = nullptr;
     std::vector<VkCommandBuffer> m_commandBuffers;
-
-    uint32_t m_mipLevels = 0;
-    VkImage m_textureImage = nullptr;
-    VkDeviceMemory m_textureImageMemory = nullptr;
-    VkImageView m_textureImageView = nullptr;
+    uint32_t m_recordThreadCount = 1;
+    std::vector<VkCommandPool> m_recordCommandPools;
+    std::vector<VkCommandBuffer> m_secondaryCommandBuffers;
+    UploadBatcher m_uploadBatcher;
+    VkBuffer m_uploadRingBuffer = nullptr;
+    GpuAllocation m_uploadRingAllocation;
+
+    std::vector<TextureResource> m_textures;
+    TextureResource m_placeholderTexture;
     VkSampler m_textureSampler = nullptr;
-
-    std::vector<Vertex> m_vertices;
-    std::vector<uint32_t> m_vertexIndices;
+    TextureStreamer m_textureStreamer;
+    std::vector<TextureUpload> m_textureUploads;
+    std::vector<uint32_t> m_textureDescriptorDirtyFrames;
+    VkSemaphore m_textureTransferSemaphore = nullptr;
+    uint64_t m_textureTransferValue = 0;
+    VkSemaphore m_textureGraphicsSemaphore = nullptr;
+    uint64_t m_textureGraphicsValue = 0;
+    std::chrono::steady_clock::time_point m_textureStreamingStartTime;
+
+    MeshCache m_meshCache;
+    DrawList m_drawList;
     VkBuffer m_vertexBuffer = nullptr;
-    VkDeviceMemory m_vertexBufferMemory = nullptr;
+    GpuAllocation m_vertexBufferAllocation;
     VkBuffer m_vertexIndicesBuffer = nullptr;
-    VkDeviceMemory m_vertexIndicesBufferMemory = nullptr;
+    GpuAllocation m_vertexIndicesBufferAllocation;
+    VkBuffer m_materialBuffer = nullptr;
+    GpuAllocation m_materialBufferAllocation;
 
     VkImage m_depthImage = nullptr;
-    VkDeviceMemory m_depthImageMemory = nullptr;
+    GpuAllocation m_depthImageAllocation;
     VkImageView m_depthImageView = nullptr;
 
     VkSampleCountFlagBits m_massSamples = VK_SAMPLE_COUNT_1_BIT;
     VkImage m_colorImage = nullptr;
-    VkDeviceMemory m_colorImageMemory = nullptr;
+    GpuAllocation m_colorImageAllocation;
     VkImageView m_colorImageView = nullptr;
 
-    std::vector<VkBuffer> m_uniformBuffers;
-    std::vector<VkDeviceMemory> m_uniformBuffersMemory;
-    std::vector<void*> m_uniformBuffersMapped;
+    VkBuffer m_uniformRingBuffer = nullptr;
+    GpuAllocation m_uniformRingAllocation;
+    FrameRingAllocator m_uniformRing;
+    uint32_t m_uniformBufferOffset = 0;
+
+    ApplicationOptions m_options;
+    InstanceTransforms m_instanceTransforms;
+    VkBuffer m_instanceRingBuffer = nullptr;
+    GpuAllocation m_instanceRingAllocation;
+    FrameRingAllocator m_instanceRing;
+    VkDeviceSize m_instanceBufferOffset = 0;
+    VkDeviceSize m_instanceLodOffset = 0;
+    double m_instanceUpdateMilliseconds = 0.0;
+    std::chrono::steady_clock::time_point m_lastInstanceUpdateTime;
+
+    std::vector<CullingDrawItem> m_cullingDrawItems;
+    uint32_t m_cullingDrawItemCount = 0;
+    FrustumPlanes m_cullingFrustum{ };
+    std::vector<float> m_lodErrors;
+    float m_lodBoundsCenter[3]{ };
+    float m_lodBoundsRadius = 0.0f;
+    VkBuffer m_cullingDrawItemBuffer = nullptr;
+    GpuAllocation m_cullingDrawItemBufferAllocation;
+    uint32_t m_visibleInstanceCapacity = 0;
+    std::vector<VkBuffer> m_indirectCommandBuffers;
+    std::vector<GpuAllocation> m_indirectCommandBufferAllocations;
+    std::vector<VkBuffer> m_visibleInstanceBuffers;
+    std::vector<GpuAllocation> m_visibleInstanceBufferAllocations;
+    VkDescriptorSetLayout m_cullingDescriptorSetLayout = nullptr;
+    VkPipelineLayout m_cullingPipelineLayout = nullptr;
+    VkPipeline m_cullingPipeline = nullptr;
+    VkDescriptorPool m_cullingDescriptorPool = nullptr;
+    std::vector<VkDescriptorSet> m_cullingDescriptorSets;
+    VkDescriptorSetLayout m_instanceDescriptorSetLayout = nullptr;
+    std::vector<VkDescriptorSet> m_instanceDescriptorSets;
+    std::vector<std::vector<IndirectDrawCommand>> m_expectedCullingCommands;
+    uint32_t m_visibleDrawCount = 0;
+    uint32_t m_cullingVerifiedFrames = 0;
+    uint32_t m_cullingMismatchFrames = 0;
 
     VkDescriptorPool m_descriptorPool;
     std::vector<VkDescriptorSet> m_descriptorSets;
@@ -218,9 +419,35 @@ private:
     std::vector<VkSemaphore> m_imageAvailableSemaphores;
     std::vector<VkSemaphore> m_renderFinishedSemaphores;
     std::vector<VkFence> m_flightFences;
-    bool m_framebufferResized = false;
-
+    std::atomic<bool> m_framebufferResized{ false };
+    std::atomic<int> m_framebufferWidth{ 0 };
+    std::atomic<int> m_framebufferHeight{ 0 };
+    std::atomic<uint32_t> m_viewportWidth{ 0 };
+    std::atomic<uint32_t> m_viewportHeight{ 0 };
+
+    TripleBuffer<FramePacket> m_framePackets;
+    uint64_t m_simulatedFrameCount = 0;
+    std::atomic<bool> m_pipelineStopping{ false };
+    std::mutex m_framePacketMutex;
+    std::condition_variable m_framePacketCondition;
+
+    FrameProfiler m_profiler;
+    VkQueryPool m_timestampQueryPool = nullptr;
+    float m_timestampPeriod = 0.0f;
+    uint64_t m_timestampMask = 0;
+    std::vector<uint64_t> m_timestampFrames;
+    std::vector<FrameProfiler::Clock::time_point> m_timestampSubmitTimes;
+
+    uint32_t m_framesInFlight = 0;
     uint32_t m_currentFrame = 0;
+    VkPresentModeKHR m_presentMode = VK_PRESENT_MODE_FIFO_KHR;
+    FrameRateLimiter m_frameRateLimiter;
+    std::chrono::steady_clock::time_point m_inputTime;
+    std::vector<std::chrono::steady_clock::time_point> m_frameInputTimes;
+    std::vector<bool> m_frameLatencyPending;
+    std::chrono::steady_clock::time_point m_lastFrameStartTime;
+    RollingHistogram m_frameIntervals;
+    RollingHistogram m_inputLatencies;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include <stb_image.h>
+
+#include "TextureStreamer.h"
+
+#include <chrono>
+
+void TexturePixelsDeleter::operator()(unsigned char* _pixels) const
+{
+    stbi_image_free(_pixels);
+}
+
+DecodedTexture decodeTexture(const std::string& _filename)
+{
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    DecodedTexture texture;
+    texture.filename = _filename;
+    int channels = 0;
+    texture.pixels.reset(stbi_load(texture.filename.c_str(), &texture.width, &texture.height, &channels, STBI_rgb_alpha));
+    texture.decodeMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    return texture;
+}
+
+TextureStreamer::~TextureStreamer()
+{
+    stop();
+}
+
+void TextureStreamer::start(uint32_t _maxJobCount)
+{
+    stop();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopping = false;
+    m_maxJobCount = _maxJobCount;
+}
+
+void TextureStreamer::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        m_pendingCount -= m_requests.size();
+        m_requests.clear();
+    }
+    getJobSystem().wait(m_jobCounter);
+}
+
+void TextureStreamer::request(uint32_t _slot, const std::string& _filename)
+{
+    bool spawnJob = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_requests.push_back(Request{ _slot, _filename });
+        ++m_pendingCount;
+        if (!m_stopping && m_activeJobCount < m_maxJobCount)
+        {
+            ++m_activeJobCount;
+            spawnJob = true;
+        }
+    }
+    if (spawnJob)
+    {
+        getJobSystem().spawn([this]() { decodeNext(); }, &m_jobCounter);
+    }
+}
+
+size_t TextureStreamer::takeDecoded(std::vector<DecodedTexture>& _textures)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const size_t count = m_decoded.size();
+    for (DecodedTexture& texture : m_decoded)
+    {
+        _textures.push_back(std::move(texture));
+    }
+    m_decoded.clear();
+    m_pendingCount -= count;
+    return count;
+}
+
+size_t TextureStreamer::getPendingCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_pendingCount;
+}
+
+void TextureStreamer::decodeNext()
+{
+    Request request;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping || m_requests.empty())
+        {
+            --m_activeJobCount;
+            return;
+        }
+        request = std::move(m_requests.front());
+        m_requests.pop_front();
+    }
+
+    DecodedTexture texture = decodeTexture(request.filename);
+    texture.slot = request.slot;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_decoded.push_back(std::move(texture));
+    }
+
+    // ÿֻһͼύµһţȴаæִ߳ÿֻռһͼʱ
+    getJobSystem().spawn([this]() { decodeNext(); }, &m_jobCounter);
+}
@@ -0,0 +1,74 @@
+#ifndef GQY_TEXTURE_STREAMER_H
+#define GQY_TEXTURE_STREAMER_H
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "JobSystem.h"
+
+// stb_image ݣ stbi_image_free ͷ
+struct TexturePixelsDeleter
+{
+    void operator()(unsigned char* _pixels) const;
+};
+
+// õͼΪ RGBA8ʧʱ pixels Ϊ
+struct DecodedTexture
+{
+    uint32_t slot = 0;
+    std::string filename;
+    int width = 0;
+    int height = 0;
+    std::unique_ptr<unsigned char, TexturePixelsDeleter> pixels;
+    double decodeMilliseconds = 0.0;
+};
+
+// ڵǰ߳ͬһͼslot Ϊ 0
+DecodedTexture decodeTexture(const std::string& _filename);
+
+// ڹϵͳжȡͼļ߳ÿ֡ȡɵͼϴ GPU
+// ʱͬʱ start ָĽ񣻽񲻵κ Vulkan 
+class TextureStreamer
+{
+public:
+    TextureStreamer() = default;
+    TextureStreamer(const TextureStreamer& _textureStreamer) = delete;
+    ~TextureStreamer();
+
+    TextureStreamer& operator = (const TextureStreamer& _textureStreamer) = delete;
+
+    void start(uint32_t _maxJobCount);
+    // û󲢵ȴ
+    void stop();
+
+    void request(uint32_t _slot, const std::string& _filename);
+    // ѽͼ׷ӵ _texturesȡ
+    size_t takeDecoded(std::vector<DecodedTexture>& _textures);
+    // 󵫻û takeDecoded ȡߵͼ
+    size_t getPendingCount() const;
+
+private:
+    void decodeNext();
+
+private:
+    struct Request
+    {
+        uint32_t slot;
+        std::string filename;
+    };
+
+    mutable std::mutex m_mutex;
+    std::deque<Request> m_requests;
+    std::vector<DecodedTexture> m_decoded;
+    size_t m_pendingCount = 0;
+    uint32_t m_maxJobCount = 0;
+    uint32_t m_activeJobCount = 0;
+    bool m_stopping = false;
+    JobCounter m_jobCounter;
+};
+
+#endif
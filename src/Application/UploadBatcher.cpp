@@ -0,0 +1,190 @@
+#include "UploadBatcher.h"
+#include "common.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+//  vkCmdCopyBufferToImage  bufferOffset ĶҪ
+const VkDeviceSize STAGING_ALIGNMENT = 16;
+
+void UploadBatcher::init(VkDevice _device, VkQueue _queue, VkCommandPool _commandPool, VkBuffer _stagingBuffer, void* _stagingData, VkDeviceSize _capacity)
+{
+    m_device = _device;
+    m_queue = _queue;
+    m_commandPool = _commandPool;
+    m_stagingBuffer = _stagingBuffer;
+    m_stagingData = static_cast<unsigned char*>(_stagingData);
+    m_capacity = _capacity;
+    m_head = 0;
+    m_statistics = UploadStatistics{ };
+
+    VkCommandBufferAllocateInfo commandBufferAllocateInfo
+    {
+        VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,             // sType
+        nullptr,                                                    // pNext
+        m_commandPool,                                              // commandPool
+        VK_COMMAND_BUFFER_LEVEL_PRIMARY,                            // level
+        1                                                           // commandBufferCount
+    };
+    if (vkAllocateCommandBuffers(m_device, &commandBufferAllocateInfo, &m_commandBuffer) != VK_SUCCESS)
+    {
+        throw std::runtime_error(setFontColor("Failed to allocate upload command buffer", FontColor::Red));
+    }
+
+    VkFenceCreateInfo fenceCreateInfo
+    {
+        VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,            // sType
+        nullptr,                                        // pNext
+        VK_FALSE                                        // flags
+    };
+    if (vkCreateFence(m_device, &fenceCreateInfo, nullptr, &m_fence) != VK_SUCCESS)
+    {
+        throw std::runtime_error(setFontColor("Failed to create upload fence", FontColor::Red));
+    }
+}
+
+void UploadBatcher::destroy()
+{
+    if (m_device == nullptr)
+    {
+        return;
+    }
+
+    flush();
+
+    vkDestroyFence(m_device, m_fence, nullptr);
+    vkFreeCommandBuffers(m_device, m_commandPool, 1, &m_commandBuffer);
+
+    m_fence = nullptr;
+    m_commandBuffer = nullptr;
+    m_stagingData = nullptr;
+    m_stagingBuffer = nullptr;
+    m_device = nullptr;
+}
+
+void UploadBatcher::uploadBuffer(VkBuffer _buffer, VkDeviceSize _offset, const void* _data, VkDeviceSize _size)
+{
+    const unsigned char* data = static_cast<const unsigned char*>(_data);
+    while (_size > 0)
+    {
+        VkDeviceSize stagingOffset = stage(data, _size, 1);
+        VkDeviceSize copySize = m_head - stagingOffset;
+
+        VkBufferCopy copyRegion
+        {
+            stagingOffset,              // srcOffset
+            _offset,                    // dstOffset
+            copySize                    // size
+        };
+        vkCmdCopyBuffer(getCommandBuffer(), m_stagingBuffer, _buffer, 1, &copyRegion);
+        ++m_statistics.copyCount;
+
+        data += copySize;
+        _offset += copySize;
+        _size -= copySize;
+    }
+}
+
+void UploadBatcher::uploadImage(VkImage _image, uint32_t _width, uint32_t _height, const void* _data, VkDeviceSize _size)
+{
+    if (_size > m_capacity)
+    {
+        throw std::runtime_error(setFontColor("Image upload of " + std::to_string(_size) + " bytes exceeds the staging ring", FontColor::Red));
+    }
+    VkDeviceSize stagingOffset = stage(_data, _size, _size);
+
+    VkBufferImageCopy bufferImageCopyRegion
+    {
+        stagingOffset,                      // bufferOffset
+        0,                                  // bufferRowLength
+        0,                                  // bufferImageHeight
+        {
+            VK_IMAGE_ASPECT_COLOR_BIT,
+            0,
+            0,
+            1
+        },                                  // imageSubresource
+        { 0, 0, 0 },                        // imageOffset
+        { _width, _height, 1 }              // imageExtent
+    };
+    vkCmdCopyBufferToImage(getCommandBuffer(), m_stagingBuffer, _image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &bufferImageCopyRegion);
+    ++m_statistics.copyCount;
+}
+
+VkCommandBuffer UploadBatcher::getCommandBuffer()
+{
+    if (!m_recording)
+    {
+        VkCommandBufferBeginInfo commandBufferBeginInfo
+        {
+            VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,            // sType
+            nullptr,                                                // pNext
+            VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,            // flags
+            nullptr                                                 // pInheritanceInfo
+        };
+        vkBeginCommandBuffer(m_commandBuffer, &commandBufferBeginInfo);
+        m_recording = true;
+    }
+    return m_commandBuffer;
+}
+
+void UploadBatcher::flush()
+{
+    if (!m_recording)
+    {
+        return;
+    }
+
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    vkEndCommandBuffer(m_commandBuffer);
+
+    VkSubmitInfo submitInfo
+    {
+        VK_STRUCTURE_TYPE_SUBMIT_INFO,                  // sType
+        nullptr,                                        // pNext
+        0,                                              // waitSemaphoreCount
+        nullptr,                                        // pWaitSemaphores
+        nullptr,                                        // pWaitDstStageMask
+        1,                                              // commandBufferCount
+        &m_commandBuffer,                               // pCommandBuffers
+        0,                                              // signalSemaphoreCount
+        nullptr                                         // pSignalSemaphores
+    };
+    if (vkQueueSubmit(m_queue, 1, &submitInfo, m_fence) != VK_SUCCESS)
+    {
+        throw std::runtime_error(setFontColor("Failed to submit upload batch", FontColor::Red));
+    }
+    vkWaitForFences(m_device, 1, &m_fence, VK_TRUE, std::numeric_limits<uint64_t>::max());
+    vkResetFences(m_device, 1, &m_fence);
+    vkResetCommandBuffer(m_commandBuffer, 0);
+
+    m_recording = false;
+    m_head = 0;
+    ++m_statistics.submitCount;
+    m_statistics.flushMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+const UploadStatistics& UploadBatcher::getStatistics() const
+{
+    return m_statistics;
+}
+
+VkDeviceSize UploadBatcher::stage(const void* _data, VkDeviceSize _size, VkDeviceSize _minimumSize)
+{
+    // ʣռŲ _minimumSize ʱύǰΣGPU ֮ݴ滺ͷʼ
+    VkDeviceSize stagingOffset = (m_head + STAGING_ALIGNMENT - 1) / STAGING_ALIGNMENT * STAGING_ALIGNMENT;
+    if (stagingOffset >= m_capacity || m_capacity - stagingOffset < _minimumSize)
+    {
+        flush();
+        stagingOffset = 0;
+    }
+
+    VkDeviceSize stagingSize = std::min(_size, m_capacity - stagingOffset);
+    std::memcpy(m_stagingData + stagingOffset, _data, static_cast<size_t>(stagingSize));
+    m_head = stagingOffset + stagingSize;
+    m_statistics.bytesUploaded += stagingSize;
+    return stagingOffset;
+}
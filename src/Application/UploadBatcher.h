@@ -0,0 +1,60 @@
+#ifndef GQY_UPLOAD_BATCHER_H
+#define GQY_UPLOAD_BATCHER_H
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+
+struct UploadStatistics
+{
+    uint64_t bytesUploaded = 0;
+    uint32_t copyCount = 0;
+    uint32_t submitCount = 0;
+    double flushMilliseconds = 0.0;
+};
+
+// ʱĻͼϴ¼Ƶͬһflush ʱֻύһβȴһդ
+// д볣פӳĻݴ滺壬дʱԶ flush ͷʼ
+class UploadBatcher
+{
+public:
+    UploadBatcher() = default;
+    UploadBatcher(const UploadBatcher& _uploadBatcher) = delete;
+
+    UploadBatcher& operator = (const UploadBatcher& _uploadBatcher) = delete;
+
+    // ݴ滺ɵ÷٣_stagingData ־ӳ HOST_COHERENT ڴ
+    void init(VkDevice _device, VkQueue _queue, VkCommandPool _commandPool, VkBuffer _stagingBuffer, void* _stagingData, VkDeviceSize _capacity);
+    void destroy();
+
+    // ݴ滺ݷֿ鸴
+    void uploadBuffer(VkBuffer _buffer, VkDeviceSize _offset, const void* _data, VkDeviceSize _size);
+    // Ƶͼ 0 ͼת TRANSFER_DST_OPTIMALݱݴ滺
+    void uploadImage(VkImage _image, uint32_t _width, uint32_t _height, const void* _data, VkDeviceSize _size);
+    // ǰε壬¼Ʋתϣݴռ䲻ʱ flush֮Ҫ»ȡ
+    VkCommandBuffer getCommandBuffer();
+    // ύǰβȴɣû¼κʱʲôҲ
+    void flush();
+
+    const UploadStatistics& getStatistics() const;
+
+private:
+    VkDeviceSize stage(const void* _data, VkDeviceSize _size, VkDeviceSize _minimumSize);
+
+private:
+    VkDevice m_device = nullptr;
+    VkQueue m_queue = nullptr;
+    VkCommandPool m_commandPool = nullptr;
+    VkCommandBuffer m_commandBuffer = nullptr;
+    VkFence m_fence = nullptr;
+    bool m_recording = false;
+
+    VkBuffer m_stagingBuffer = nullptr;
+    unsigned char* m_stagingData = nullptr;
+    VkDeviceSize m_capacity = 0;
+    VkDeviceSize m_head = 0;
+
+    UploadStatistics m_statistics;
+};
+
+#endif
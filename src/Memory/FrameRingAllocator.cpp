@@ -0,0 +1,68 @@
+#include "FrameRingAllocator.h"
+#include "common.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+    uint64_t alignUp(uint64_t _value, uint64_t _alignment)
+    {
+        return (_value + _alignment - 1) & ~(_alignment - 1);
+    }
+}
+
+void FrameRingAllocator::init(void* _mapped, uint64_t _frameSize, uint32_t _frameCount, uint64_t _alignment)
+{
+    m_mapped = static_cast<unsigned char*>(_mapped);
+    m_alignment = std::max<uint64_t>(_alignment, 1);
+    m_frameSize = alignUp(_frameSize, m_alignment);
+    m_frameCount = _frameCount;
+    m_frameBegin = 0;
+    m_head = 0;
+    m_peakFrameUsedBytes = 0;
+}
+
+uint64_t FrameRingAllocator::getBufferSize(uint64_t _frameSize, uint32_t _frameCount, uint64_t _alignment)
+{
+    return alignUp(_frameSize, std::max<uint64_t>(_alignment, 1)) * _frameCount;
+}
+
+void FrameRingAllocator::beginFrame(uint32_t _frame)
+{
+    m_frameBegin = m_frameSize * (_frame % m_frameCount);
+    m_head = m_frameBegin;
+}
+
+FrameRingAllocation FrameRingAllocator::allocate(uint64_t _size)
+{
+    uint64_t offset = alignUp(m_head, m_alignment);
+    if (offset + _size > m_frameBegin + m_frameSize)
+    {
+        throw std::runtime_error(setFontColor("Frame ring allocator out of space: " + std::to_string(_size) + " bytes requested, "
+            + std::to_string(m_frameBegin + m_frameSize - std::min(offset, m_frameBegin + m_frameSize)) + " bytes left", FontColor::Red));
+    }
+
+    m_head = offset + _size;
+    m_peakFrameUsedBytes = std::max(m_peakFrameUsedBytes, m_head - m_frameBegin);
+
+    FrameRingAllocation allocation;
+    allocation.offset = static_cast<uint32_t>(offset);
+    allocation.mapped = m_mapped + offset;
+    return allocation;
+}
+
+uint64_t FrameRingAllocator::getFrameSize() const
+{
+    return m_frameSize;
+}
+
+uint64_t FrameRingAllocator::getFrameUsedBytes() const
+{
+    return m_head - m_frameBegin;
+}
+
+uint64_t FrameRingAllocator::getPeakFrameUsedBytes() const
+{
+    return m_peakFrameUsedBytes;
+}
@@ -0,0 +1,41 @@
+#ifndef GQY_FRAME_RING_ALLOCATOR_H
+#define GQY_FRAME_RING_ALLOCATOR_H
+
+#include <cstdint>
+
+struct FrameRingAllocation
+{
+    // ƫƣֱΪ̬ƫ
+    uint32_t offset = 0;
+    void* mapped = nullptr;
+};
+
+// ־ӳĻ尴֡ȷ֣ÿ֡ԼķԷ䣬֡ʼʱա
+// ֡դȴ֮ GPU ٶȡ÷˲Ҫͷ
+class FrameRingAllocator
+{
+public:
+    // _mapped ָ getBufferSize() ֽڵӳڴ棬_alignment  2 
+    void init(void* _mapped, uint64_t _frameSize, uint32_t _frameCount, uint64_t _alignment);
+
+    static uint64_t getBufferSize(uint64_t _frameSize, uint32_t _frameCount, uint64_t _alignment);
+
+    void beginFrame(uint32_t _frame);
+    // ǰ֡ķŲʱ׳쳣
+    FrameRingAllocation allocate(uint64_t _size);
+
+    uint64_t getFrameSize() const;
+    uint64_t getFrameUsedBytes() const;
+    uint64_t getPeakFrameUsedBytes() const;
+
+private:
+    unsigned char* m_mapped = nullptr;
+    uint64_t m_frameSize = 0;
+    uint32_t m_frameCount = 0;
+    uint64_t m_alignment = 1;
+    uint64_t m_frameBegin = 0;
+    uint64_t m_head = 0;
+    uint64_t m_peakFrameUsedBytes = 0;
+};
+
+#endif
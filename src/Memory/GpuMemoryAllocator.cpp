@@ -0,0 +1,272 @@
+#include "GpuMemoryAllocator.h"
+#include "common.h"
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+void GpuMemoryAllocator::init(const VkPhysicalDeviceMemoryProperties& _memoryProperties, VkDeviceSize _bufferImageGranularity,
+    const GpuMemoryCallbacks& _callbacks, VkDeviceSize _blockSize)
+{
+    m_memoryProperties = _memoryProperties;
+    m_callbacks = _callbacks;
+    m_separateKinds = _bufferImageGranularity > 1;
+    m_deviceMemoryCount = 0;
+    m_peakDeviceMemoryCount = 0;
+    m_allocationCount = 0;
+
+    // ÿڴأԴ֣СϵĿ鲻ѴС 1/8
+    m_pools.clear();
+    m_pools.resize(m_memoryProperties.memoryTypeCount * 2);
+    for (uint32_t i = 0; i < m_pools.size(); ++i)
+    {
+        uint32_t memoryTypeIndex = i / 2;
+        VkDeviceSize heapSize = m_memoryProperties.memoryHeaps[m_memoryProperties.memoryTypes[memoryTypeIndex].heapIndex].size;
+        m_pools[i].memoryTypeIndex = memoryTypeIndex;
+        m_pools[i].blockSize = std::max<VkDeviceSize>(std::min(_blockSize, heapSize / 8), 1);
+    }
+    m_dedicatedCounts.assign(m_memoryProperties.memoryTypeCount, 0);
+    m_dedicatedBytes.assign(m_memoryProperties.memoryTypeCount, 0);
+}
+
+void GpuMemoryAllocator::destroy()
+{
+    if (m_allocationCount != 0)
+    {
+        std::cout << setFontColor("GPU memory allocator destroyed with " + std::to_string(m_allocationCount) + " live allocations", FontColor::Yellow) << std::endl;
+    }
+
+    for (Pool& pool : m_pools)
+    {
+        for (std::unique_ptr<Block>& block : pool.blocks)
+        {
+            freeDeviceMemory(block->memory);
+        }
+        pool.blocks.clear();
+    }
+    m_allocationCount = 0;
+}
+
+uint32_t GpuMemoryAllocator::findMemoryType(uint32_t _typeFilter, VkMemoryPropertyFlags _properties) const
+{
+    for (uint32_t i = 0; i < m_memoryProperties.memoryTypeCount; ++i)
+    {
+        if ((_typeFilter & (1u << i)) && (m_memoryProperties.memoryTypes[i].propertyFlags & _properties) == _properties)
+        {
+            return i;
+        }
+    }
+
+    throw std::runtime_error(setFontColor("Failed to find suitable memory type", FontColor::Red));
+}
+
+GpuAllocation GpuMemoryAllocator::allocate(const VkMemoryRequirements& _memoryRequirements, VkMemoryPropertyFlags _properties,
+    GpuResourceKind _kind, bool _dedicated)
+{
+    GpuAllocation allocation;
+    allocation.memoryTypeIndex = findMemoryType(_memoryRequirements.memoryTypeBits, _properties);
+    allocation.size = _memoryRequirements.size;
+
+    uint32_t poolIndex = allocation.memoryTypeIndex * 2 + (m_separateKinds && _kind == GpuResourceKind::Optimal ? 1 : 0);
+    if (!_dedicated && _memoryRequirements.size <= m_pools[poolIndex].blockSize / 2 && allocateFromPool(poolIndex, _memoryRequirements, allocation))
+    {
+        ++m_allocationCount;
+        return allocation;
+    }
+
+    // Դռһ豸ڴ棬ѿ޷õƬ
+    allocation.memory = allocateDeviceMemory(allocation.memoryTypeIndex, _memoryRequirements.size, allocation.mapped);
+    if (allocation.memory == nullptr)
+    {
+        throw std::runtime_error(setFontColor("Failed to allocate " + std::to_string(_memoryRequirements.size) + " bytes of device memory", FontColor::Red));
+    }
+    allocation.dedicated = true;
+    ++m_dedicatedCounts[allocation.memoryTypeIndex];
+    m_dedicatedBytes[allocation.memoryTypeIndex] += allocation.size;
+    ++m_allocationCount;
+    return allocation;
+}
+
+void GpuMemoryAllocator::free(GpuAllocation& _allocation)
+{
+    if (_allocation.memory == nullptr)
+    {
+        return;
+    }
+
+    if (_allocation.dedicated)
+    {
+        freeDeviceMemory(_allocation.memory);
+        --m_dedicatedCounts[_allocation.memoryTypeIndex];
+        m_dedicatedBytes[_allocation.memoryTypeIndex] -= _allocation.size;
+    }
+    else
+    {
+        // տ鱣֮ķ临ã destroy ʱͳһͷ
+        m_pools[_allocation.poolIndex].blocks[_allocation.blockIndex]->tlsf.free(_allocation.handle);
+    }
+    --m_allocationCount;
+    _allocation = GpuAllocation{ };
+}
+
+const VkPhysicalDeviceMemoryProperties& GpuMemoryAllocator::getMemoryProperties() const
+{
+    return m_memoryProperties;
+}
+
+GpuMemoryStatistics GpuMemoryAllocator::getStatistics() const
+{
+    GpuMemoryStatistics statistics;
+    statistics.memoryTypes.resize(m_memoryProperties.memoryTypeCount);
+    statistics.deviceMemoryCount = m_deviceMemoryCount;
+    statistics.peakDeviceMemoryCount = m_peakDeviceMemoryCount;
+    statistics.allocationCount = m_allocationCount;
+
+    for (const Pool& pool : m_pools)
+    {
+        GpuMemoryTypeStatistics& memoryType = statistics.memoryTypes[pool.memoryTypeIndex];
+        for (const std::unique_ptr<Block>& block : pool.blocks)
+        {
+            ++memoryType.blockCount;
+            memoryType.blockBytes += block->tlsf.getSize();
+            memoryType.allocationCount += block->tlsf.getAllocationCount();
+            memoryType.usedBytes += block->tlsf.getUsedBytes();
+            memoryType.freeRegionCount += block->tlsf.getFreeRegionCount();
+            memoryType.largestFreeRegion = std::max(memoryType.largestFreeRegion, block->tlsf.getLargestFreeRegion());
+        }
+    }
+    for (uint32_t i = 0; i < m_memoryProperties.memoryTypeCount; ++i)
+    {
+        statistics.memoryTypes[i].dedicatedCount = m_dedicatedCounts[i];
+        statistics.memoryTypes[i].dedicatedBytes = m_dedicatedBytes[i];
+        statistics.memoryTypes[i].allocationCount += m_dedicatedCounts[i];
+        statistics.memoryTypes[i].usedBytes += m_dedicatedBytes[i];
+    }
+    return statistics;
+}
+
+std::string GpuMemoryAllocator::getStatisticsJson() const
+{
+    GpuMemoryStatistics statistics = getStatistics();
+
+    // ֻõڴ
+    std::ostringstream json;
+    json << "{\n"
+        << "  \"deviceMemoryCount\": " << statistics.deviceMemoryCount << ",\n"
+        << "  \"peakDeviceMemoryCount\": " << statistics.peakDeviceMemoryCount << ",\n"
+        << "  \"allocationCount\": " << statistics.allocationCount << ",\n"
+        << "  \"memoryTypes\": [";
+    bool first = true;
+    for (uint32_t i = 0; i < statistics.memoryTypes.size(); ++i)
+    {
+        const GpuMemoryTypeStatistics& memoryType = statistics.memoryTypes[i];
+        if (memoryType.blockCount == 0 && memoryType.dedicatedCount == 0)
+        {
+            continue;
+        }
+
+        const uint32_t heapIndex = m_memoryProperties.memoryTypes[i].heapIndex;
+        json << (first ? "\n" : ",\n")
+            << "    {\n"
+            << "      \"index\": " << i << ",\n"
+            << "      \"heapIndex\": " << heapIndex << ",\n"
+            << "      \"heapSize\": " << m_memoryProperties.memoryHeaps[heapIndex].size << ",\n"
+            << "      \"propertyFlags\": " << m_memoryProperties.memoryTypes[i].propertyFlags << ",\n"
+            << "      \"blockCount\": " << memoryType.blockCount << ",\n"
+            << "      \"blockBytes\": " << memoryType.blockBytes << ",\n"
+            << "      \"dedicatedCount\": " << memoryType.dedicatedCount << ",\n"
+            << "      \"dedicatedBytes\": " << memoryType.dedicatedBytes << ",\n"
+            << "      \"allocationCount\": " << memoryType.allocationCount << ",\n"
+            << "      \"usedBytes\": " << memoryType.usedBytes << ",\n"
+            << "      \"freeRegionCount\": " << memoryType.freeRegionCount << ",\n"
+            << "      \"largestFreeRegion\": " << memoryType.largestFreeRegion << "\n"
+            << "    }";
+        first = false;
+    }
+    json << (first ? "]\n" : "\n  ]\n") << "}\n";
+    return json.str();
+}
+
+bool GpuMemoryAllocator::validate(std::string& _error) const
+{
+    for (uint32_t i = 0; i < m_pools.size(); ++i)
+    {
+        for (uint32_t j = 0; j < m_pools[i].blocks.size(); ++j)
+        {
+            if (!m_pools[i].blocks[j]->tlsf.validate(_error))
+            {
+                _error = "pool " + std::to_string(i) + " block " + std::to_string(j) + ": " + _error;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+VkDeviceMemory GpuMemoryAllocator::allocateDeviceMemory(uint32_t _memoryTypeIndex, VkDeviceSize _size, void*& _mapped)
+{
+    VkDeviceMemory memory = m_callbacks.allocate(_memoryTypeIndex, _size);
+    if (memory == nullptr)
+    {
+        return nullptr;
+    }
+
+    _mapped = nullptr;
+    if (m_memoryProperties.memoryTypes[_memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+    {
+        _mapped = m_callbacks.map(memory, _size);
+    }
+    ++m_deviceMemoryCount;
+    m_peakDeviceMemoryCount = std::max(m_peakDeviceMemoryCount, m_deviceMemoryCount);
+    return memory;
+}
+
+void GpuMemoryAllocator::freeDeviceMemory(VkDeviceMemory _memory)
+{
+    m_callbacks.free(_memory);
+    --m_deviceMemoryCount;
+}
+
+bool GpuMemoryAllocator::allocateFromPool(uint32_t _poolIndex, const VkMemoryRequirements& _memoryRequirements, GpuAllocation& _allocation)
+{
+    Pool& pool = m_pools[_poolIndex];
+    const VkDeviceSize alignment = std::max<VkDeviceSize>(_memoryRequirements.alignment, 1);
+
+    for (uint32_t i = 0; i <= pool.blocks.size(); ++i)
+    {
+        // еĿ鶼Ųʱ¿
+        if (i == pool.blocks.size())
+        {
+            std::unique_ptr<Block> block = std::make_unique<Block>();
+            void* mapped = nullptr;
+            block->memory = allocateDeviceMemory(pool.memoryTypeIndex, pool.blockSize, mapped);
+            if (block->memory == nullptr)
+            {
+                return false;
+            }
+            block->mapped = static_cast<unsigned char*>(mapped);
+            block->tlsf.init(pool.blockSize);
+            pool.blocks.push_back(std::move(block));
+        }
+
+        Block& block = *pool.blocks[i];
+        uint64_t offset = 0;
+        uint32_t handle = block.tlsf.allocate(_memoryRequirements.size, alignment, offset);
+        if (handle != TlsfBlock::INVALID_HANDLE)
+        {
+            _allocation.memory = block.memory;
+            _allocation.offset = offset;
+            _allocation.mapped = block.mapped != nullptr ? block.mapped + offset : nullptr;
+            _allocation.poolIndex = _poolIndex;
+            _allocation.blockIndex = i;
+            _allocation.handle = handle;
+            return true;
+        }
+        if (i + 1 == pool.blocks.size() && block.tlsf.isEmpty())
+        {
+            // տ鶼Ų£Ҫ󣬸ö
+            return false;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,124 @@
+#ifndef GQY_GPU_MEMORY_ALLOCATOR_H
+#define GQY_GPU_MEMORY_ALLOCATOR_H
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "TlsfBlock.h"
+
+// Դ (塢ͼ) ŲͼڲͬĿУ
+// ߲ڣҲͲҪ bufferImageGranularity 
+enum class GpuResourceKind
+{
+    Linear,
+    Optimal
+};
+
+struct GpuAllocation
+{
+    VkDeviceMemory memory = nullptr;
+    VkDeviceSize offset = 0;
+    VkDeviceSize size = 0;
+    // ɼڴڴʱ־ӳ䣬Ǹ÷ʼλõָ
+    void* mapped = nullptr;
+    uint32_t memoryTypeIndex = 0;
+    uint32_t poolIndex = UINT32_MAX;
+    uint32_t blockIndex = UINT32_MAX;
+    uint32_t handle = UINT32_MAX;
+    bool dedicated = false;
+};
+
+// ͨص豸ڴ棬ʱԻɲ Vulkan ģʵ
+struct GpuMemoryCallbacks
+{
+    // ʧʱ nullptr
+    std::function<VkDeviceMemory(uint32_t _memoryTypeIndex, VkDeviceSize _size)> allocate;
+    std::function<void(VkDeviceMemory _memory)> free;
+    std::function<void*(VkDeviceMemory _memory, VkDeviceSize _size)> map;
+};
+
+struct GpuMemoryTypeStatistics
+{
+    uint32_t blockCount = 0;
+    VkDeviceSize blockBytes = 0;
+    uint32_t dedicatedCount = 0;
+    VkDeviceSize dedicatedBytes = 0;
+    uint32_t allocationCount = 0;
+    VkDeviceSize usedBytes = 0;
+    uint32_t freeRegionCount = 0;
+    VkDeviceSize largestFreeRegion = 0;
+};
+
+struct GpuMemoryStatistics
+{
+    std::vector<GpuMemoryTypeStatistics> memoryTypes;
+    // ǰ vkAllocateMemory ʷֵ
+    uint32_t deviceMemoryCount = 0;
+    uint32_t peakDeviceMemoryCount = 0;
+    uint32_t allocationCount = 0;
+};
+
+// ڴ͹豸ڴ棬 TLSF ӷ䣻Դ͵÷ҪԴʹö
+class GpuMemoryAllocator
+{
+public:
+    static const VkDeviceSize DEFAULT_BLOCK_SIZE = 64 * 1024 * 1024;
+
+    GpuMemoryAllocator() = default;
+    GpuMemoryAllocator(const GpuMemoryAllocator& _gpuMemoryAllocator) = delete;
+
+    GpuMemoryAllocator& operator = (const GpuMemoryAllocator& _gpuMemoryAllocator) = delete;
+
+    void init(const VkPhysicalDeviceMemoryProperties& _memoryProperties, VkDeviceSize _bufferImageGranularity,
+        const GpuMemoryCallbacks& _callbacks, VkDeviceSize _blockSize = DEFAULT_BLOCK_SIZE);
+    // ͷп飬δͷŵķᱻ
+    void destroy();
+
+    uint32_t findMemoryType(uint32_t _typeFilter, VkMemoryPropertyFlags _properties) const;
+    GpuAllocation allocate(const VkMemoryRequirements& _memoryRequirements, VkMemoryPropertyFlags _properties,
+        GpuResourceKind _kind, bool _dedicated = false);
+    void free(GpuAllocation& _allocation);
+
+    const VkPhysicalDeviceMemoryProperties& getMemoryProperties() const;
+    GpuMemoryStatistics getStatistics() const;
+    std::string getStatisticsJson() const;
+    // пڲṹڲ
+    bool validate(std::string& _error) const;
+
+private:
+    struct Block
+    {
+        VkDeviceMemory memory = nullptr;
+        unsigned char* mapped = nullptr;
+        TlsfBlock tlsf;
+    };
+
+    struct Pool
+    {
+        uint32_t memoryTypeIndex = 0;
+        VkDeviceSize blockSize = 0;
+        std::vector<std::unique_ptr<Block>> blocks;
+    };
+
+    VkDeviceMemory allocateDeviceMemory(uint32_t _memoryTypeIndex, VkDeviceSize _size, void*& _mapped);
+    void freeDeviceMemory(VkDeviceMemory _memory);
+    bool allocateFromPool(uint32_t _poolIndex, const VkMemoryRequirements& _memoryRequirements, GpuAllocation& _allocation);
+
+private:
+    VkPhysicalDeviceMemoryProperties m_memoryProperties{ };
+    GpuMemoryCallbacks m_callbacks;
+    bool m_separateKinds = false;
+    std::vector<Pool> m_pools;
+    std::vector<uint32_t> m_dedicatedCounts;
+    std::vector<VkDeviceSize> m_dedicatedBytes;
+    uint32_t m_deviceMemoryCount = 0;
+    uint32_t m_peakDeviceMemoryCount = 0;
+    uint32_t m_allocationCount = 0;
+};
+
+#endif
@@ -0,0 +1,405 @@
+#include "TlsfBlock.h"
+
+#include <algorithm>
+
+namespace
+{
+    uint32_t findLastSet(uint64_t _value)
+    {
+        uint32_t bit = 0;
+        while (_value >>= 1)
+        {
+            ++bit;
+        }
+        return bit;
+    }
+
+    uint32_t findFirstSet(uint64_t _value)
+    {
+        uint32_t bit = 0;
+        while ((_value & 1) == 0)
+        {
+            _value >>= 1;
+            ++bit;
+        }
+        return bit;
+    }
+}
+
+void TlsfBlock::init(uint64_t _size)
+{
+    m_nodes.clear();
+    m_unusedNodes.clear();
+    m_flBitmap = 0;
+    for (uint32_t fl = 0; fl < FL_COUNT; ++fl)
+    {
+        m_slBitmaps[fl] = 0;
+        for (uint32_t sl = 0; sl < SL_COUNT; ++sl)
+        {
+            m_freeHeads[fl][sl] = INVALID_HANDLE;
+        }
+    }
+    m_size = _size;
+    m_usedBytes = 0;
+    m_allocationCount = 0;
+    m_freeRegionCount = 0;
+
+    uint32_t handle = createNode();
+    m_nodes[handle].offset = 0;
+    m_nodes[handle].size = _size;
+    insertFreeNode(handle);
+}
+
+uint32_t TlsfBlock::allocate(uint64_t _size, uint64_t _alignment, uint64_t& _offset)
+{
+    if (_size == 0 || _size > m_size)
+    {
+        return INVALID_HANDLE;
+    }
+
+    //  size + alignment - 1 ң֤ҵĿһŵ
+    uint32_t handle = findFreeNode(_size + (_alignment > 1 ? _alignment - 1 : 0));
+    if (handle == INVALID_HANDLE)
+    {
+        return INVALID_HANDLE;
+    }
+    removeFreeNode(handle);
+
+    // һѱռãͷβ䲻Ҫٺϲ
+    uint64_t alignedOffset = (m_nodes[handle].offset + _alignment - 1) / _alignment * _alignment;
+    uint64_t padding = alignedOffset - m_nodes[handle].offset;
+    if (padding > 0)
+    {
+        uint32_t head = createNode();
+        Node& node = m_nodes[handle];
+        m_nodes[head].offset = node.offset;
+        m_nodes[head].size = padding;
+        m_nodes[head].prevPhysical = node.prevPhysical;
+        m_nodes[head].nextPhysical = handle;
+        if (node.prevPhysical != INVALID_HANDLE)
+        {
+            m_nodes[node.prevPhysical].nextPhysical = head;
+        }
+        node.prevPhysical = head;
+        node.offset = alignedOffset;
+        node.size -= padding;
+        insertFreeNode(head);
+    }
+
+    uint64_t remaining = m_nodes[handle].size - _size;
+    if (remaining > 0)
+    {
+        uint32_t tail = createNode();
+        Node& node = m_nodes[handle];
+        m_nodes[tail].offset = node.offset + _size;
+        m_nodes[tail].size = remaining;
+        m_nodes[tail].prevPhysical = handle;
+        m_nodes[tail].nextPhysical = node.nextPhysical;
+        if (node.nextPhysical != INVALID_HANDLE)
+        {
+            m_nodes[node.nextPhysical].prevPhysical = tail;
+        }
+        node.nextPhysical = tail;
+        node.size = _size;
+        insertFreeNode(tail);
+    }
+
+    m_usedBytes += _size;
+    ++m_allocationCount;
+    _offset = m_nodes[handle].offset;
+    return handle;
+}
+
+void TlsfBlock::free(uint32_t _handle)
+{
+    m_usedBytes -= m_nodes[_handle].size;
+    --m_allocationCount;
+
+    // ǰĿϲ֤ڵĿ
+    uint32_t prev = m_nodes[_handle].prevPhysical;
+    if (prev != INVALID_HANDLE && m_nodes[prev].free)
+    {
+        removeFreeNode(prev);
+        m_nodes[_handle].offset = m_nodes[prev].offset;
+        m_nodes[_handle].size += m_nodes[prev].size;
+        m_nodes[_handle].prevPhysical = m_nodes[prev].prevPhysical;
+        if (m_nodes[prev].prevPhysical != INVALID_HANDLE)
+        {
+            m_nodes[m_nodes[prev].prevPhysical].nextPhysical = _handle;
+        }
+        releaseNode(prev);
+    }
+
+    uint32_t next = m_nodes[_handle].nextPhysical;
+    if (next != INVALID_HANDLE && m_nodes[next].free)
+    {
+        removeFreeNode(next);
+        m_nodes[_handle].size += m_nodes[next].size;
+        m_nodes[_handle].nextPhysical = m_nodes[next].nextPhysical;
+        if (m_nodes[next].nextPhysical != INVALID_HANDLE)
+        {
+            m_nodes[m_nodes[next].nextPhysical].prevPhysical = _handle;
+        }
+        releaseNode(next);
+    }
+
+    insertFreeNode(_handle);
+}
+
+uint64_t TlsfBlock::getSize() const
+{
+    return m_size;
+}
+
+uint64_t TlsfBlock::getUsedBytes() const
+{
+    return m_usedBytes;
+}
+
+uint32_t TlsfBlock::getAllocationCount() const
+{
+    return m_allocationCount;
+}
+
+uint32_t TlsfBlock::getFreeRegionCount() const
+{
+    return m_freeRegionCount;
+}
+
+uint64_t TlsfBlock::getLargestFreeRegion() const
+{
+    if (m_flBitmap == 0)
+    {
+        return 0;
+    }
+
+    // ߵķǿһе䲻һҪ
+    uint32_t fl = findLastSet(m_flBitmap);
+    uint32_t sl = findLastSet(m_slBitmaps[fl]);
+    uint64_t largest = 0;
+    for (uint32_t handle = m_freeHeads[fl][sl]; handle != INVALID_HANDLE; handle = m_nodes[handle].nextFree)
+    {
+        largest = std::max(largest, m_nodes[handle].size);
+    }
+    return largest;
+}
+
+bool TlsfBlock::isEmpty() const
+{
+    return m_allocationCount == 0;
+}
+
+bool TlsfBlock::validate(std::string& _error) const
+{
+    // ƫ 0 俪ʼβӲ
+    uint32_t first = INVALID_HANDLE;
+    for (uint32_t i = 0; i < m_nodes.size(); ++i)
+    {
+        if (m_nodes[i].size != 0 && m_nodes[i].prevPhysical == INVALID_HANDLE)
+        {
+            if (first != INVALID_HANDLE)
+            {
+                _error = "multiple first nodes";
+                return false;
+            }
+            first = i;
+        }
+    }
+
+    uint64_t offset = 0;
+    uint64_t usedBytes = 0;
+    uint32_t allocationCount = 0;
+    uint32_t freeRegionCount = 0;
+    bool previousFree = false;
+    for (uint32_t handle = first; handle != INVALID_HANDLE; handle = m_nodes[handle].nextPhysical)
+    {
+        const Node& node = m_nodes[handle];
+        if (node.offset != offset)
+        {
+            _error = "gap or overlap at offset " + std::to_string(offset);
+            return false;
+        }
+        if (node.free && previousFree)
+        {
+            _error = "adjacent free regions at offset " + std::to_string(offset);
+            return false;
+        }
+        if (node.nextPhysical != INVALID_HANDLE && m_nodes[node.nextPhysical].prevPhysical != handle)
+        {
+            _error = "broken physical link at offset " + std::to_string(offset);
+            return false;
+        }
+        if (node.free)
+        {
+            uint32_t fl = 0;
+            uint32_t sl = 0;
+            mapping(node.size, fl, sl);
+            bool listed = false;
+            for (uint32_t i = m_freeHeads[fl][sl]; i != INVALID_HANDLE; i = m_nodes[i].nextFree)
+            {
+                listed |= i == handle;
+            }
+            if (!listed)
+            {
+                _error = "free region at offset " + std::to_string(offset) + " missing from its free list";
+                return false;
+            }
+            ++freeRegionCount;
+        }
+        else
+        {
+            usedBytes += node.size;
+            ++allocationCount;
+        }
+        previousFree = node.free;
+        offset += node.size;
+    }
+
+    if (offset != m_size || usedBytes != m_usedBytes || allocationCount != m_allocationCount || freeRegionCount != m_freeRegionCount)
+    {
+        _error = "block totals do not match";
+        return false;
+    }
+
+    for (uint32_t fl = 0; fl < FL_COUNT; ++fl)
+    {
+        bool flSet = (m_flBitmap >> fl) & 1;
+        if (flSet != (m_slBitmaps[fl] != 0))
+        {
+            _error = "first level bitmap mismatch at " + std::to_string(fl);
+            return false;
+        }
+        for (uint32_t sl = 0; sl < SL_COUNT; ++sl)
+        {
+            if (((m_slBitmaps[fl] >> sl) & 1) != (m_freeHeads[fl][sl] != INVALID_HANDLE))
+            {
+                _error = "second level bitmap mismatch at " + std::to_string(fl) + "/" + std::to_string(sl);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void TlsfBlock::mapping(uint64_t _size, uint32_t& _fl, uint32_t& _sl)
+{
+    // С SL_COUNT ĴСӳ䵽 0 
+    if (_size < SL_COUNT)
+    {
+        _fl = 0;
+        _sl = static_cast<uint32_t>(_size);
+        return;
+    }
+
+    uint32_t msb = findLastSet(_size);
+    _fl = msb - SL_LOG2 + 1;
+    _sl = static_cast<uint32_t>((_size >> (msb - SL_LOG2)) ^ SL_COUNT);
+}
+
+uint32_t TlsfBlock::findFreeNode(uint64_t _size) const
+{
+    // ȡһ㣬估֮п䶼С _size
+    if (_size >= SL_COUNT)
+    {
+        uint64_t round = (uint64_t(1) << (findLastSet(_size) - SL_LOG2)) - 1;
+        if (_size + round < _size)
+        {
+            return INVALID_HANDLE;
+        }
+        _size += round;
+    }
+
+    uint32_t fl = 0;
+    uint32_t sl = 0;
+    mapping(_size, fl, sl);
+    if (fl >= FL_COUNT)
+    {
+        return INVALID_HANDLE;
+    }
+
+    uint32_t slBitmap = m_slBitmaps[fl] & (~0u << sl);
+    if (slBitmap == 0)
+    {
+        uint64_t flBitmap = fl + 1 < FL_COUNT ? m_flBitmap & (~uint64_t(0) << (fl + 1)) : 0;
+        if (flBitmap == 0)
+        {
+            return INVALID_HANDLE;
+        }
+        fl = findFirstSet(flBitmap);
+        slBitmap = m_slBitmaps[fl];
+    }
+    sl = findFirstSet(slBitmap);
+    return m_freeHeads[fl][sl];
+}
+
+uint32_t TlsfBlock::createNode()
+{
+    if (!m_unusedNodes.empty())
+    {
+        uint32_t handle = m_unusedNodes.back();
+        m_unusedNodes.pop_back();
+        m_nodes[handle] = Node{ };
+        return handle;
+    }
+    m_nodes.push_back(Node{ });
+    return static_cast<uint32_t>(m_nodes.size() - 1);
+}
+
+void TlsfBlock::releaseNode(uint32_t _handle)
+{
+    m_nodes[_handle] = Node{ };
+    m_unusedNodes.push_back(_handle);
+}
+
+void TlsfBlock::insertFreeNode(uint32_t _handle)
+{
+    uint32_t fl = 0;
+    uint32_t sl = 0;
+    mapping(m_nodes[_handle].size, fl, sl);
+
+    Node& node = m_nodes[_handle];
+    node.free = true;
+    node.prevFree = INVALID_HANDLE;
+    node.nextFree = m_freeHeads[fl][sl];
+    if (node.nextFree != INVALID_HANDLE)
+    {
+        m_nodes[node.nextFree].prevFree = _handle;
+    }
+    m_freeHeads[fl][sl] = _handle;
+    m_flBitmap |= uint64_t(1) << fl;
+    m_slBitmaps[fl] |= 1u << sl;
+    ++m_freeRegionCount;
+}
+
+void TlsfBlock::removeFreeNode(uint32_t _handle)
+{
+    uint32_t fl = 0;
+    uint32_t sl = 0;
+    mapping(m_nodes[_handle].size, fl, sl);
+
+    Node& node = m_nodes[_handle];
+    if (node.prevFree != INVALID_HANDLE)
+    {
+        m_nodes[node.prevFree].nextFree = node.nextFree;
+    }
+    else
+    {
+        m_freeHeads[fl][sl] = node.nextFree;
+    }
+    if (node.nextFree != INVALID_HANDLE)
+    {
+        m_nodes[node.nextFree].prevFree = node.prevFree;
+    }
+    if (m_freeHeads[fl][sl] == INVALID_HANDLE)
+    {
+        m_slBitmaps[fl] &= ~(1u << sl);
+        if (m_slBitmaps[fl] == 0)
+        {
+            m_flBitmap &= ~(uint64_t(1) << fl);
+        }
+    }
+    node.free = false;
+    node.prevFree = INVALID_HANDLE;
+    node.nextFree = INVALID_HANDLE;
+    --m_freeRegionCount;
+}
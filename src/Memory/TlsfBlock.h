@@ -0,0 +1,66 @@
+#ifndef GQY_TLSF_BLOCK_H
+#define GQY_TLSF_BLOCK_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//  (TLSF) ֻ [0, size) ڵƫƣӴʵڴ档
+// һ 2 ݻִСÿٵȷΪ SL_COUNT ݣͷŶ O(1)
+class TlsfBlock
+{
+public:
+    static const uint32_t INVALID_HANDLE = UINT32_MAX;
+
+    void init(uint64_t _size);
+
+    // ɹʱطռ䲻ʱ INVALID_HANDLE
+    uint32_t allocate(uint64_t _size, uint64_t _alignment, uint64_t& _offset);
+    void free(uint32_t _handle);
+
+    uint64_t getSize() const;
+    uint64_t getUsedBytes() const;
+    uint32_t getAllocationCount() const;
+    uint32_t getFreeRegionCount() const;
+    uint64_t getLargestFreeRegion() const;
+    bool isEmpty() const;
+
+    // ڹϵλͼǷһ£ڲ
+    bool validate(std::string& _error) const;
+
+private:
+    static const uint32_t SL_LOG2 = 4;
+    static const uint32_t SL_COUNT = 1u << SL_LOG2;
+    static const uint32_t FL_COUNT = 64;
+
+    struct Node
+    {
+        uint64_t offset = 0;
+        uint64_t size = 0;
+        uint32_t prevPhysical = INVALID_HANDLE;
+        uint32_t nextPhysical = INVALID_HANDLE;
+        uint32_t prevFree = INVALID_HANDLE;
+        uint32_t nextFree = INVALID_HANDLE;
+        bool free = false;
+    };
+
+    static void mapping(uint64_t _size, uint32_t& _fl, uint32_t& _sl);
+    uint32_t findFreeNode(uint64_t _size) const;
+    uint32_t createNode();
+    void releaseNode(uint32_t _handle);
+    void insertFreeNode(uint32_t _handle);
+    void removeFreeNode(uint32_t _handle);
+
+private:
+    std::vector<Node> m_nodes;
+    std::vector<uint32_t> m_unusedNodes;
+    uint64_t m_flBitmap = 0;
+    uint32_t m_slBitmaps[FL_COUNT]{ };
+    uint32_t m_freeHeads[FL_COUNT][SL_COUNT]{ };
+    uint64_t m_size = 0;
+    uint64_t m_usedBytes = 0;
+    uint32_t m_allocationCount = 0;
+    uint32_t m_freeRegionCount = 0;
+};
+
+#endif
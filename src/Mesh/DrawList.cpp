@@ -0,0 +1,181 @@
+#include "DrawList.h"
+
+#include <algorithm>
+#include <set>
+
+namespace
+{
+    //  firstIndex Уҵ _index 
+    const Submesh* findSubmesh(const Submesh* _submeshes, size_t _submeshCount, uint32_t _index)
+    {
+        const Submesh* end = _submeshes + _submeshCount;
+        const Submesh* submesh = std::upper_bound(_submeshes, end, _index, [](uint32_t _value, const Submesh& _submesh)
+        {
+            return _value < _submesh.firstIndex;
+        });
+        if (submesh == _submeshes)
+        {
+            return nullptr;
+        }
+        --submesh;
+        return _index < submesh->firstIndex + submesh->indexCount ? submesh : nullptr;
+    }
+}
+
+void DrawList::build(const Submesh* _submeshes, size_t _submeshCount, const MeshMaterial* _materials,
+    const IndexRange* _indexRanges, size_t _indexRangeCount)
+{
+    clear();
+    m_statistics.submeshCount = _submeshCount;
+    m_statistics.indexRangeCount = _indexRangeCount;
+
+    m_drawItems.reserve(_indexRangeCount);
+    for (size_t i = 0; i < _indexRangeCount; ++i)
+    {
+        const IndexRange& indexRange = _indexRanges[i];
+        const Submesh* submesh = findSubmesh(_submeshes, _submeshCount, indexRange.firstIndex);
+        m_drawItems.push_back(DrawItem
+        {
+            submesh == nullptr ? Submesh::NO_TEXTURE : submesh->textureIndex,  // textureIndex
+            submesh == nullptr ? 0 : submesh->materialIndex,                    // materialIndex
+            indexRange.firstIndex,                                              // firstIndex
+            indexRange.indexCount,                                              // indexCount
+            indexRange.vertexOffset                                             // vertexOffset
+        });
+    }
+
+    std::stable_sort(m_drawItems.begin(), m_drawItems.end(), [](const DrawItem& _a, const DrawItem& _b)
+    {
+        return _a.textureIndex < _b.textureIndex;
+    });
+
+    size_t drawCount = 0;
+    for (const DrawItem& drawItem : m_drawItems)
+    {
+        if (drawCount != 0)
+        {
+            DrawItem& previous = m_drawItems[drawCount - 1];
+            if (previous.textureIndex == drawItem.textureIndex && previous.vertexOffset == drawItem.vertexOffset
+                && previous.firstIndex + previous.indexCount == drawItem.firstIndex
+                && isSameMaterial(_materials[previous.materialIndex], _materials[drawItem.materialIndex]))
+            {
+                previous.indexCount += drawItem.indexCount;
+                continue;
+            }
+        }
+        m_drawItems[drawCount++] = drawItem;
+    }
+    m_drawItems.resize(drawCount);
+
+    std::set<uint32_t> textures;
+    for (size_t i = 0; i < m_drawItems.size(); ++i)
+    {
+        textures.insert(m_drawItems[i].textureIndex);
+        if (i == 0 || m_drawItems[i].textureIndex != m_drawItems[i - 1].textureIndex)
+        {
+            ++m_statistics.textureBindCount;
+        }
+    }
+    m_statistics.drawCount = m_drawItems.size();
+    m_statistics.textureCount = textures.size();
+}
+
+void DrawList::clear()
+{
+    m_drawItems.clear();
+    m_statistics = DrawListStatistics{ };
+}
+
+bool DrawList::validate(const Submesh* _submeshes, size_t _submeshCount, const MeshMaterial* _materials, size_t _materialCount,
+    size_t _vertexIndexCount, std::string& _error) const
+{
+    for (size_t i = 0; i < _submeshCount; ++i)
+    {
+        if (_submeshes[i].materialIndex >= _materialCount || _materials[_submeshes[i].materialIndex].textureIndex != _submeshes[i].textureIndex)
+        {
+            _error = "submesh " + std::to_string(i) + " has an invalid material";
+            return false;
+        }
+        if (i > 0 && _submeshes[i].firstIndex < _submeshes[i - 1].firstIndex + _submeshes[i - 1].indexCount)
+        {
+            _error = "submesh " + std::to_string(i) + " overlaps the previous submesh";
+            return false;
+        }
+        if (static_cast<size_t>(_submeshes[i].firstIndex) + _submeshes[i].indexCount > _vertexIndexCount)
+        {
+            _error = "submesh " + std::to_string(i) + " is out of the index buffer";
+            return false;
+        }
+    }
+
+    size_t submeshIndexCount = 0;
+    for (size_t i = 0; i < _submeshCount; ++i)
+    {
+        submeshIndexCount += _submeshes[i].indexCount;
+    }
+
+    std::vector<std::pair<uint32_t, uint32_t>> spans;
+    size_t drawIndexCount = 0;
+    for (size_t i = 0; i < m_drawItems.size(); ++i)
+    {
+        const DrawItem& drawItem = m_drawItems[i];
+        const std::string name = "draw " + std::to_string(i);
+        if (i > 0 && drawItem.textureIndex < m_drawItems[i - 1].textureIndex)
+        {
+            _error = name + " is not sorted by texture";
+            return false;
+        }
+        if (drawItem.indexCount == 0 || drawItem.indexCount % 3 != 0 || drawItem.vertexOffset < 0)
+        {
+            _error = name + " has an invalid index count or vertex offset";
+            return false;
+        }
+
+        if (drawItem.materialIndex >= _materialCount)
+        {
+            _error = name + " has an invalid material";
+            return false;
+        }
+
+        // ڵÿ񶼱ʹø󶨵ͼҲʼ¼͵Ĳͬ
+        for (uint32_t index = drawItem.firstIndex; index < drawItem.firstIndex + drawItem.indexCount; )
+        {
+            const Submesh* submesh = findSubmesh(_submeshes, _submeshCount, index);
+            if (submesh == nullptr || submesh->textureIndex != drawItem.textureIndex)
+            {
+                _error = name + " covers indices of another texture";
+                return false;
+            }
+            if (!isSameMaterial(_materials[submesh->materialIndex], _materials[drawItem.materialIndex]))
+            {
+                _error = name + " covers indices of another material";
+                return false;
+            }
+            index = submesh->firstIndex + submesh->indexCount;
+        }
+
+        spans.emplace_back(drawItem.firstIndex, drawItem.indexCount);
+        drawIndexCount += drawItem.indexCount;
+    }
+
+    std::sort(spans.begin(), spans.end());
+    for (size_t i = 1; i < spans.size(); ++i)
+    {
+        if (spans[i].first < spans[i - 1].first + spans[i - 1].second)
+        {
+            _error = "draws overlap at index " + std::to_string(spans[i].first);
+            return false;
+        }
+    }
+    if (drawIndexCount != submeshIndexCount)
+    {
+        _error = "draws cover " + std::to_string(drawIndexCount) + " indices, submeshes " + std::to_string(submeshIndexCount);
+        return false;
+    }
+    if (m_statistics.textureBindCount != m_statistics.textureCount)
+    {
+        _error = std::to_string(m_statistics.textureBindCount) + " texture binds for " + std::to_string(m_statistics.textureCount) + " textures";
+        return false;
+    }
+    return true;
+}
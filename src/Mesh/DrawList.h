@@ -0,0 +1,54 @@
+#ifndef GQY_DRAW_LIST_H
+#define GQY_DRAW_LIST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "IndexRanges.h"
+#include "Submesh.h"
+
+// һ vkCmdDrawIndexed materialIndex Ϊͳ [firstIndex, firstIndex + indexCount)
+// ֧ bindless ʱȰ textureIndex Ӧ
+struct DrawItem
+{
+    uint32_t textureIndex;
+    uint32_t materialIndex;
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    int32_t vertexOffset;
+};
+
+struct DrawListStatistics
+{
+    size_t submeshCount = 0;
+    size_t indexRangeCount = 0;
+    size_t drawCount = 0;
+    // λƵͼͬʱҪ° (һΰҲ)
+    size_t textureBindCount = 0;
+    size_t textureCount = 0;
+};
+
+// ɵĻ˳򣺰ͼȶٺϲʼ¼ͻ׼ͬβӵ
+class DrawList
+{
+public:
+    void build(const Submesh* _submeshes, size_t _submeshCount, const MeshMaterial* _materials,
+        const IndexRange* _indexRanges, size_t _indexRangeCount);
+    void clear();
+
+    //  CPU ϼбͼÿֻǲʼ¼ͬǡøȫͼ󶨴١
+    // ʧʱ false  _error ˵ԭ
+    bool validate(const Submesh* _submeshes, size_t _submeshCount, const MeshMaterial* _materials, size_t _materialCount,
+        size_t _vertexIndexCount, std::string& _error) const;
+
+    const std::vector<DrawItem>& getDrawItems() const { return m_drawItems; }
+    const DrawListStatistics& getStatistics() const { return m_statistics; }
+
+private:
+    std::vector<DrawItem> m_drawItems;
+    DrawListStatistics m_statistics;
+};
+
+#endif
@@ -0,0 +1,60 @@
+#include "IndexRanges.h"
+
+namespace
+{
+    const uint32_t MAX_RANGE_VERTEX_COUNT = 0x10000;
+}
+
+void splitIndexRanges(const std::vector<uint32_t>& _vertexIndices, size_t _firstIndex, size_t _indexCount, size_t _vertexCount,
+    std::vector<uint32_t>& _vertexRemap, std::vector<uint16_t>& _shortIndices, std::vector<IndexRange>& _ranges)
+{
+    const size_t end = _firstIndex + _indexCount;
+    if (_shortIndices.size() < end)
+    {
+        _shortIndices.resize(end);
+    }
+
+    // rangeOfVertex ¼һα䣬ÿ䶼 localIndices
+    std::vector<uint32_t> rangeOfVertex(_vertexCount, UINT32_MAX);
+    std::vector<uint16_t> localIndices(_vertexCount);
+    uint32_t rangeId = 0;
+    uint32_t localVertexCount = 0;
+    IndexRange range{ static_cast<uint32_t>(_firstIndex), 0, static_cast<int32_t>(_vertexRemap.size()) };
+
+    for (size_t i = _firstIndex; i + 2 < end; i += 3)
+    {
+        const uint32_t a = _vertexIndices[i];
+        const uint32_t b = _vertexIndices[i + 1];
+        const uint32_t c = _vertexIndices[i + 2];
+        const uint32_t newVertexCount = (rangeOfVertex[a] != rangeId)
+            + (b != a && rangeOfVertex[b] != rangeId)
+            + (c != a && c != b && rangeOfVertex[c] != rangeId);
+
+        // ǰŲ¸ε¶ʱ
+        if (localVertexCount + newVertexCount > MAX_RANGE_VERTEX_COUNT)
+        {
+            _ranges.push_back(range);
+            ++rangeId;
+            localVertexCount = 0;
+            range = IndexRange{ static_cast<uint32_t>(i), 0, static_cast<int32_t>(_vertexRemap.size()) };
+        }
+
+        for (size_t k = i; k < i + 3; ++k)
+        {
+            const uint32_t vertex = _vertexIndices[k];
+            if (rangeOfVertex[vertex] != rangeId)
+            {
+                rangeOfVertex[vertex] = rangeId;
+                localIndices[vertex] = static_cast<uint16_t>(localVertexCount++);
+                _vertexRemap.push_back(vertex);
+            }
+            _shortIndices[k] = localIndices[vertex];
+        }
+        range.indexCount += 3;
+    }
+
+    if (range.indexCount != 0)
+    {
+        _ranges.push_back(range);
+    }
+}
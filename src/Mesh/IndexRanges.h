@@ -0,0 +1,22 @@
+#ifndef GQY_INDEX_RANGES_H
+#define GQY_INDEX_RANGES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// һ vkCmdDrawIndexed Ƶ䣬vertexOffset Ϊ base vertex ӵÿ
+struct IndexRange
+{
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    int32_t vertexOffset;
+};
+
+// ˳ [_firstIndex, _firstIndex + _indexCount) г䣬ÿһҲ 65536 Ķ㡣
+// ֺĵ i ԭĵ _vertexRemap[i] 㣬֮乲õĶᱻƣ
+// ׷ӵ _vertexRemap  _ranges16 λд _shortIndices ԭͬλ
+void splitIndexRanges(const std::vector<uint32_t>& _vertexIndices, size_t _firstIndex, size_t _indexCount, size_t _vertexCount,
+    std::vector<uint32_t>& _vertexRemap, std::vector<uint16_t>& _shortIndices, std::vector<IndexRange>& _ranges);
+
+#endif
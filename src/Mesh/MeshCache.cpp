@@ -0,0 +1,613 @@
+#include "MeshCache.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#include "AtomicFile.h"
+#include "common.h"
+#include "Hash.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+
+namespace
+{
+    const size_t SECTION_ALIGNMENT = 16;
+
+    // ÿ LOD ĿΪһһ룻ٲ 20% ļû壬ٱ
+    const float LOD_REDUCTION = 0.5f;
+    const float LOD_MIN_REDUCTION = 0.8f;
+    // ڼеȨأλѹһ [0, 1]
+    const float LOD_TEXCOORD_WEIGHT = 1.0f;
+
+    size_t alignUp(size_t _value, size_t _alignment)
+    {
+        return (_value + _alignment - 1) / _alignment * _alignment;
+    }
+
+    std::string getDirectory(const std::string& _filename)
+    {
+        size_t separator = _filename.find_last_of("/\\");
+        return separator == std::string::npos ? std::string() : _filename.substr(0, separator + 1);
+    }
+}
+
+uint64_t MeshCache::computeSourceHash(const std::string& _objFilename)
+{
+    MappedFile objFile;
+    if (!objFile.open(_objFilename))
+    {
+        throw std::runtime_error(setFontColor("Failed to open obj file: " + _objFilename, FontColor::Red));
+    }
+
+    uint64_t hash = hash64(objFile.data(), objFile.size());
+
+    // mtllib һλļͷһݾֹͣ
+    const std::string directory = getDirectory(_objFilename);
+    const char* p = objFile.data();
+    const char* end = p + objFile.size();
+    while (p < end)
+    {
+        const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (lineEnd == nullptr)
+        {
+            lineEnd = end;
+        }
+
+        const char* token = p;
+        while (token < lineEnd && (*token == ' ' || *token == '\t'))
+        {
+            ++token;
+        }
+        p = lineEnd + 1;
+
+        if (token < lineEnd && (*token == 'v' || *token == 'f'))
+        {
+            break;
+        }
+        if (lineEnd - token < 7 || std::strncmp(token, "mtllib", 6) != 0 || (token[6] != ' ' && token[6] != '\t'))
+        {
+            continue;
+        }
+
+        token += 7;
+        while (token < lineEnd)
+        {
+            while (token < lineEnd && (*token == ' ' || *token == '\t' || *token == '\r'))
+            {
+                ++token;
+            }
+            const char* nameEnd = token;
+            while (nameEnd < lineEnd && *nameEnd != ' ' && *nameEnd != '\t' && *nameEnd != '\r')
+            {
+                ++nameEnd;
+            }
+            if (nameEnd == token)
+            {
+                break;
+            }
+
+            const std::string name(token, nameEnd);
+            hash = hash64(name.data(), name.size(), hash);
+
+            MappedFile mtlFile;
+            if (mtlFile.open(directory + name))
+            {
+                hash = hash64(mtlFile.data(), mtlFile.size(), hash);
+            }
+            token = nameEnd;
+        }
+    }
+
+    return hash;
+}
+
+std::string MeshCache::getCacheFilename(const std::string& _objFilename)
+{
+    size_t extension = _objFilename.find_last_of('.');
+    size_t separator = _objFilename.find_last_of("/\\");
+    // ͬʽĻ滥
+    const std::string suffix = std::string(".") + GpuVertexLayout::NAME + ".meshcache";
+    if (extension == std::string::npos || (separator != std::string::npos && extension < separator))
+    {
+        return _objFilename + suffix;
+    }
+    return _objFilename.substr(0, extension) + suffix;
+}
+
+bool MeshCache::open(const std::string& _filename, uint64_t _sourceHash)
+{
+    close();
+
+    if (!m_mappedFile.open(_filename))
+    {
+        return false;
+    }
+    if (!parse(m_mappedFile.data(), m_mappedFile.size(), _sourceHash))
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MeshCache::build(uint64_t _sourceHash, const std::vector<Vertex>& _vertices, const std::vector<uint32_t>& _vertexIndices,
+    const std::vector<Submesh>& _submeshes, const std::vector<MeshMaterial>& _materials, const std::vector<std::string>& _textures)
+{
+    close();
+
+    // ʼ¼ͬϳһÿ䣬ʹʱԺϲ
+    std::vector<std::pair<size_t, size_t>> materialBatches;
+    for (const Submesh& submesh : _submeshes)
+    {
+        if (!materialBatches.empty()
+            && isSameMaterial(_materials[_submeshes[materialBatches.back().first].materialIndex], _materials[submesh.materialIndex]))
+        {
+            materialBatches.back().second += submesh.indexCount;
+        }
+        else
+        {
+            materialBatches.emplace_back(&submesh - _submeshes.data(), submesh.indexCount);
+        }
+    }
+
+    // ָƵĶ 16 λʡֽڻʱ 32 λ
+    std::vector<uint32_t> vertexRemap;
+    std::vector<uint16_t> shortIndices;
+    std::vector<IndexRange> indexRanges;
+    for (const auto& materialBatch : materialBatches)
+    {
+        const size_t firstIndex = _submeshes[materialBatch.first].firstIndex;
+        splitIndexRanges(_vertexIndices, firstIndex, materialBatch.second, _vertices.size(), vertexRemap, shortIndices, indexRanges);
+    }
+    const size_t duplicatedVertexCount = vertexRemap.size() > _vertices.size() ? vertexRemap.size() - _vertices.size() : 0;
+    const bool useShortIndices = duplicatedVertexCount * sizeof(GpuVertex) < (sizeof(uint32_t) - sizeof(uint16_t)) * _vertexIndices.size();
+    if (!useShortIndices)
+    {
+        vertexRemap.resize(_vertices.size());
+        for (size_t i = 0; i < vertexRemap.size(); ++i)
+        {
+            vertexRemap[i] = static_cast<uint32_t>(i);
+        }
+        indexRanges.clear();
+        for (const auto& materialBatch : materialBatches)
+        {
+            indexRanges.push_back(IndexRange{ _submeshes[materialBatch.first].firstIndex, static_cast<uint32_t>(materialBatch.second), 0 });
+        }
+    }
+
+    // ͼ· '\0' ָδ
+    std::string textureNames;
+    for (const std::string& texture : _textures)
+    {
+        textureNames.append(texture).push_back('\0');
+    }
+
+    const VertexQuantization quantization = GpuVertexLayout::computeQuantization(_vertices);
+    std::vector<GpuVertex> gpuVertices(vertexRemap.size());
+    for (size_t i = 0; i < vertexRemap.size(); ++i)
+    {
+        gpuVertices[i] = GpuVertexLayout::encode(_vertices[vertexRemap[i]], quantization);
+    }
+
+    // غ LOD õɣż vertexOffset ֱָ gpuVertices
+    std::vector<Vertex> decodedVertices(gpuVertices.size());
+    std::vector<glm::vec3> positions(gpuVertices.size());
+    for (size_t i = 0; i < gpuVertices.size(); ++i)
+    {
+        decodedVertices[i] = GpuVertexLayout::decode(gpuVertices[i], quantization);
+        positions[i] = decodedVertices[i].positionOS;
+    }
+    std::vector<size_t> lodTargets;
+    std::vector<std::vector<uint32_t>> lodIndices(MAX_LOD_COUNT - 1);
+    std::vector<std::vector<IndexRange>> lodRanges(MAX_LOD_COUNT - 1);
+    std::vector<float> lodErrors(MAX_LOD_COUNT - 1, 0.0f);
+    std::vector<SimplifiedMesh> simplifiedLevels;
+    MeshletData meshletData;
+    std::vector<uint32_t> rangeIndices;
+    for (size_t i = 0; i < indexRanges.size(); ++i)
+    {
+        const IndexRange& range = indexRanges[i];
+        rangeIndices.resize(range.indexCount);
+        for (uint32_t j = 0; j < range.indexCount; ++j)
+        {
+            rangeIndices[j] = useShortIndices ? shortIndices[range.firstIndex + j] + static_cast<uint32_t>(range.vertexOffset) : _vertexIndices[range.firstIndex + j];
+        }
+        buildMeshlets(rangeIndices.data(), rangeIndices.size(), positions, static_cast<uint32_t>(i), meshletData);
+
+        lodTargets.clear();
+        float targetTriangleCount = static_cast<float>(range.indexCount / 3);
+        for (uint32_t lod = 1; lod < MAX_LOD_COUNT; ++lod)
+        {
+            targetTriangleCount *= LOD_REDUCTION;
+            lodTargets.push_back(static_cast<size_t>(targetTriangleCount) * 3);
+        }
+        simplifyMeshChain(decodedVertices, rangeIndices.data(), rangeIndices.size(), lodTargets, LOD_TEXCOORD_WEIGHT, simplifiedLevels);
+        for (size_t lod = 0; lod + 1 < MAX_LOD_COUNT; ++lod)
+        {
+            SimplifiedMesh& level = simplifiedLevels[lod];
+            optimizeVertexCache(level.vertexIndices, decodedVertices.size());
+            // firstIndex ȼ¼ڱеλãƴʱټϱ
+            lodRanges[lod].push_back(IndexRange{ static_cast<uint32_t>(lodIndices[lod].size()), static_cast<uint32_t>(level.vertexIndices.size()), range.vertexOffset });
+            lodIndices[lod].insert(lodIndices[lod].end(), level.vertexIndices.begin(), level.vertexIndices.end());
+            lodErrors[lod] = std::max(lodErrors[lod], level.error);
+        }
+    }
+
+    std::vector<MeshLod> lods{ MeshLod{ 0, static_cast<uint32_t>(indexRanges.size()), static_cast<uint32_t>(_vertexIndices.size()), 0.0f } };
+    for (size_t lod = 0; lod + 1 < MAX_LOD_COUNT; ++lod)
+    {
+        if (lodIndices[lod].size() > lods.back().indexCount * LOD_MIN_REDUCTION)
+        {
+            break;
+        }
+        lods.push_back(MeshLod{ static_cast<uint32_t>(lods.size() * indexRanges.size()), static_cast<uint32_t>(indexRanges.size()),
+            static_cast<uint32_t>(lodIndices[lod].size()), std::max(lodErrors[lod], lods.back().error) });
+    }
+
+    // LOD ׷ڵ 0 ֮
+    std::vector<uint32_t> longIndices;
+    if (!useShortIndices)
+    {
+        longIndices = _vertexIndices;
+    }
+    size_t totalIndexCount = _vertexIndices.size();
+    for (size_t lod = 1; lod < lods.size(); ++lod)
+    {
+        for (const IndexRange& lodRange : lodRanges[lod - 1])
+        {
+            indexRanges.push_back(IndexRange{ static_cast<uint32_t>(totalIndexCount + lodRange.firstIndex), lodRange.indexCount, lodRange.vertexOffset });
+            const uint32_t* rangeBegin = lodIndices[lod - 1].data() + lodRange.firstIndex;
+            for (const uint32_t* vertexIndex = rangeBegin; vertexIndex < rangeBegin + lodRange.indexCount; ++vertexIndex)
+            {
+                if (useShortIndices)
+                {
+                    shortIndices.push_back(static_cast<uint16_t>(*vertexIndex - static_cast<uint32_t>(lodRange.vertexOffset)));
+                }
+                else
+                {
+                    longIndices.push_back(*vertexIndex);
+                }
+            }
+        }
+        totalIndexCount += lodIndices[lod - 1].size();
+    }
+
+    const void* vertexIndexData = useShortIndices ? static_cast<const void*>(shortIndices.data()) : static_cast<const void*>(longIndices.data());
+    const uint32_t vertexIndexSize = static_cast<uint32_t>(useShortIndices ? sizeof(uint16_t) : sizeof(uint32_t));
+
+    const uint32_t sectionCount = 11;
+    size_t offset = alignUp(sizeof(Header) + sizeof(Section) * sectionCount, SECTION_ALIGNMENT);
+
+    Section sections[sectionCount]
+    {
+        {
+            MeshCacheSectionType::Vertices,             // type
+            static_cast<uint32_t>(sizeof(GpuVertex)),   // elementSize
+            0,                                          // offset
+            gpuVertices.size()                          // count
+        },
+        {
+            MeshCacheSectionType::VertexIndices,        // type
+            vertexIndexSize,                            // elementSize
+            0,                                          // offset
+            totalIndexCount                             // count
+        },
+        {
+            MeshCacheSectionType::VertexQuantization,   // type
+            static_cast<uint32_t>(sizeof(VertexQuantization)), // elementSize
+            0,                                          // offset
+            1                                           // count
+        },
+        {
+            MeshCacheSectionType::IndexRanges,          // type
+            static_cast<uint32_t>(sizeof(IndexRange)),  // elementSize
+            0,                                          // offset
+            indexRanges.size()                          // count
+        },
+        {
+            MeshCacheSectionType::Submeshes,            // type
+            static_cast<uint32_t>(sizeof(Submesh)),     // elementSize
+            0,                                          // offset
+            _submeshes.size()                           // count
+        },
+        {
+            MeshCacheSectionType::Textures,             // type
+            1,                                          // elementSize
+            0,                                          // offset
+            textureNames.size()                         // count
+        },
+        {
+            MeshCacheSectionType::Materials,            // type
+            static_cast<uint32_t>(sizeof(MeshMaterial)), // elementSize
+            0,                                          // offset
+            _materials.size()                           // count
+        },
+        {
+            MeshCacheSectionType::Meshlets,             // type
+            static_cast<uint32_t>(sizeof(Meshlet)),     // elementSize
+            0,                                          // offset
+            meshletData.meshlets.size()                 // count
+        },
+        {
+            MeshCacheSectionType::MeshletVertices,      // type
+            static_cast<uint32_t>(sizeof(uint32_t)),    // elementSize
+            0,                                          // offset
+            meshletData.vertices.size()                 // count
+        },
+        {
+            MeshCacheSectionType::MeshletTriangles,     // type
+            1,                                          // elementSize
+            0,                                          // offset
+            meshletData.triangles.size()                // count
+        },
+        {
+            MeshCacheSectionType::Lods,                 // type
+            static_cast<uint32_t>(sizeof(MeshLod)),     // elementSize
+            0,                                          // offset
+            lods.size()                                 // count
+        }
+    };
+    for (Section& section : sections)
+    {
+        section.offset = offset;
+        offset = alignUp(offset + section.elementSize * section.count, SECTION_ALIGNMENT);
+    }
+
+    Header header
+    {
+        MAGIC,                                          // magic
+        VERSION,                                        // version
+        _sourceHash,                                    // sourceHash
+        sectionCount,                                   // sectionCount
+        GpuVertexLayout::TYPE                           // vertexLayout
+    };
+
+    m_storage.assign(offset, 0);
+    std::memcpy(m_storage.data(), &header, sizeof(header));
+    std::memcpy(m_storage.data() + sizeof(header), sections, sizeof(sections));
+    std::memcpy(m_storage.data() + sections[0].offset, gpuVertices.data(), sizeof(GpuVertex) * gpuVertices.size());
+    std::memcpy(m_storage.data() + sections[1].offset, vertexIndexData, vertexIndexSize * totalIndexCount);
+    std::memcpy(m_storage.data() + sections[2].offset, &quantization, sizeof(quantization));
+    std::memcpy(m_storage.data() + sections[3].offset, indexRanges.data(), sizeof(IndexRange) * indexRanges.size());
+    std::memcpy(m_storage.data() + sections[4].offset, _submeshes.data(), sizeof(Submesh) * _submeshes.size());
+    std::memcpy(m_storage.data() + sections[5].offset, textureNames.data(), textureNames.size());
+    std::memcpy(m_storage.data() + sections[6].offset, _materials.data(), sizeof(MeshMaterial) * _materials.size());
+    std::memcpy(m_storage.data() + sections[7].offset, meshletData.meshlets.data(), sizeof(Meshlet) * meshletData.meshlets.size());
+    std::memcpy(m_storage.data() + sections[8].offset, meshletData.vertices.data(), sizeof(uint32_t) * meshletData.vertices.size());
+    std::memcpy(m_storage.data() + sections[9].offset, meshletData.triangles.data(), meshletData.triangles.size());
+    std::memcpy(m_storage.data() + sections[10].offset, lods.data(), sizeof(MeshLod) * lods.size());
+
+    parse(m_storage.data(), m_storage.size(), _sourceHash);
+}
+
+bool MeshCache::save(const std::string& _filename) const
+{
+    if (!isValid())
+    {
+        return false;
+    }
+
+    // дʱļ滻;˳²Ļ
+    return writeFileAtomically(_filename, m_data, m_size);
+}
+
+void MeshCache::close()
+{
+    m_mappedFile.close();
+    m_storage.clear();
+    m_storage.shrink_to_fit();
+
+    m_data = nullptr;
+    m_size = 0;
+    m_vertices = nullptr;
+    m_vertexCount = 0;
+    m_vertexIndexData = nullptr;
+    m_vertexIndexSize = 0;
+    m_vertexIndexCount = 0;
+    m_indexRanges = nullptr;
+    m_lods = nullptr;
+    m_lodCount = 0;
+    m_submeshes = nullptr;
+    m_submeshCount = 0;
+    m_materials = nullptr;
+    m_materialCount = 0;
+    m_textures.clear();
+    m_vertexQuantization = VertexQuantization{ };
+    m_meshlets = nullptr;
+    m_meshletCount = 0;
+    m_meshletVertices = nullptr;
+    m_meshletVertexCount = 0;
+    m_meshletTriangles = nullptr;
+    m_meshletTriangleCount = 0;
+}
+
+bool MeshCache::parse(const char* _data, size_t _size, uint64_t _sourceHash)
+{
+    if (_data == nullptr || _size < sizeof(Header))
+    {
+        return false;
+    }
+
+    Header header;
+    std::memcpy(&header, _data, sizeof(header));
+    if (header.magic != MAGIC || header.version != VERSION || header.sourceHash != _sourceHash || header.vertexLayout != GpuVertexLayout::TYPE)
+    {
+        return false;
+    }
+    if (header.sectionCount > (_size - sizeof(Header)) / sizeof(Section))
+    {
+        return false;
+    }
+
+    // УÿζļΧڲԪشС뵱ǰṹһ
+    const Section* sections = reinterpret_cast<const Section*>(_data + sizeof(Header));
+    for (uint32_t i = 0; i < header.sectionCount; ++i)
+    {
+        const Section& section = sections[i];
+        if (section.elementSize == 0 || section.offset % SECTION_ALIGNMENT != 0 || section.offset > _size
+            || section.count > (_size - section.offset) / section.elementSize)
+        {
+            return false;
+        }
+    }
+
+    m_data = _data;
+    m_size = _size;
+
+    const Section* vertexSection = findSection(_data, MeshCacheSectionType::Vertices);
+    const Section* vertexIndexSection = findSection(_data, MeshCacheSectionType::VertexIndices);
+    const Section* quantizationSection = findSection(_data, MeshCacheSectionType::VertexQuantization);
+    const Section* indexRangeSection = findSection(_data, MeshCacheSectionType::IndexRanges);
+    const Section* submeshSection = findSection(_data, MeshCacheSectionType::Submeshes);
+    const Section* textureSection = findSection(_data, MeshCacheSectionType::Textures);
+    const Section* materialSection = findSection(_data, MeshCacheSectionType::Materials);
+    const Section* meshletSection = findSection(_data, MeshCacheSectionType::Meshlets);
+    const Section* meshletVertexSection = findSection(_data, MeshCacheSectionType::MeshletVertices);
+    const Section* meshletTriangleSection = findSection(_data, MeshCacheSectionType::MeshletTriangles);
+    const Section* lodSection = findSection(_data, MeshCacheSectionType::Lods);
+    if (vertexSection == nullptr || vertexSection->elementSize != sizeof(GpuVertex)
+        || vertexIndexSection == nullptr || (vertexIndexSection->elementSize != sizeof(uint16_t) && vertexIndexSection->elementSize != sizeof(uint32_t))
+        || quantizationSection == nullptr || quantizationSection->elementSize != sizeof(VertexQuantization) || quantizationSection->count != 1
+        || indexRangeSection == nullptr || indexRangeSection->elementSize != sizeof(IndexRange)
+        || submeshSection == nullptr || submeshSection->elementSize != sizeof(Submesh)
+        || textureSection == nullptr || textureSection->elementSize != 1
+        || materialSection == nullptr || materialSection->elementSize != sizeof(MeshMaterial)
+        || meshletSection == nullptr || meshletSection->elementSize != sizeof(Meshlet)
+        || meshletVertexSection == nullptr || meshletVertexSection->elementSize != sizeof(uint32_t)
+        || meshletTriangleSection == nullptr || meshletTriangleSection->elementSize != 1
+        || lodSection == nullptr || lodSection->elementSize != sizeof(MeshLod) || lodSection->count == 0)
+    {
+        m_data = nullptr;
+        m_size = 0;
+        return false;
+    }
+
+    // Խᵼ GPU ȡ֮
+    const IndexRange* indexRanges = reinterpret_cast<const IndexRange*>(_data + indexRangeSection->offset);
+    for (uint64_t i = 0; i < indexRangeSection->count; ++i)
+    {
+        if (static_cast<uint64_t>(indexRanges[i].firstIndex) + indexRanges[i].indexCount > vertexIndexSection->count)
+        {
+            m_data = nullptr;
+            m_size = 0;
+            return false;
+        }
+    }
+
+    // ÿ LOD  0 ͬ 0 ӵһ俪ʼ
+    const MeshLod* lods = reinterpret_cast<const MeshLod*>(_data + lodSection->offset);
+    for (uint64_t i = 0; i < lodSection->count; ++i)
+    {
+        if ((i == 0 && lods[i].firstIndexRange != 0) || lods[i].indexRangeCount != lods[0].indexRangeCount
+            || static_cast<uint64_t>(lods[i].firstIndexRange) + lods[i].indexRangeCount > indexRangeSection->count)
+        {
+            m_data = nullptr;
+            m_size = 0;
+            return false;
+        }
+    }
+
+    // صľֲͶŻᱻ޳ɫֱʹ
+    const Meshlet* meshlets = reinterpret_cast<const Meshlet*>(_data + meshletSection->offset);
+    const uint32_t* meshletVertices = reinterpret_cast<const uint32_t*>(_data + meshletVertexSection->offset);
+    for (uint64_t i = 0; i < meshletSection->count; ++i)
+    {
+        if (meshlets[i].vertexCount > MESHLET_MAX_VERTICES || meshlets[i].triangleCount > MESHLET_MAX_TRIANGLES
+            || static_cast<uint64_t>(meshlets[i].vertexOffset) + meshlets[i].vertexCount > meshletVertexSection->count
+            || (static_cast<uint64_t>(meshlets[i].triangleOffset) + meshlets[i].triangleCount) * 3 > meshletTriangleSection->count
+            || meshlets[i].indexRange >= lods[0].indexRangeCount)
+        {
+            m_data = nullptr;
+            m_size = 0;
+            return false;
+        }
+    }
+    for (uint64_t i = 0; i < meshletVertexSection->count; ++i)
+    {
+        if (meshletVertices[i] >= vertexSection->count)
+        {
+            m_data = nullptr;
+            m_size = 0;
+            return false;
+        }
+    }
+
+    const char* textureNames = _data + textureSection->offset;
+    const char* textureNamesEnd = textureNames + textureSection->count;
+    if (textureSection->count != 0 && textureNamesEnd[-1] != '\0')
+    {
+        m_data = nullptr;
+        m_size = 0;
+        return false;
+    }
+    m_textures.clear();
+    for (const char* name = textureNames; name < textureNamesEnd; name += std::strlen(name) + 1)
+    {
+        m_textures.emplace_back(name);
+    }
+
+    // ɫֱòʱźͼ飬ԽͬҪܾ
+    const MeshMaterial* materials = reinterpret_cast<const MeshMaterial*>(_data + materialSection->offset);
+    for (uint64_t i = 0; i < materialSection->count; ++i)
+    {
+        if (materials[i].textureIndex != Submesh::NO_TEXTURE && materials[i].textureIndex >= m_textures.size())
+        {
+            m_textures.clear();
+            m_data = nullptr;
+            m_size = 0;
+            return false;
+        }
+    }
+
+    const Submesh* submeshes = reinterpret_cast<const Submesh*>(_data + submeshSection->offset);
+    for (uint64_t i = 0; i < submeshSection->count; ++i)
+    {
+        if (static_cast<uint64_t>(submeshes[i].firstIndex) + submeshes[i].indexCount > vertexIndexSection->count
+            || (submeshes[i].textureIndex != Submesh::NO_TEXTURE && submeshes[i].textureIndex >= m_textures.size())
+            || submeshes[i].materialIndex >= materialSection->count
+            || materials[submeshes[i].materialIndex].textureIndex != submeshes[i].textureIndex)
+        {
+            m_textures.clear();
+            m_data = nullptr;
+            m_size = 0;
+            return false;
+        }
+    }
+
+    std::memcpy(&m_vertexQuantization, _data + quantizationSection->offset, sizeof(m_vertexQuantization));
+    m_vertices = reinterpret_cast<const GpuVertex*>(_data + vertexSection->offset);
+    m_vertexCount = static_cast<size_t>(vertexSection->count);
+    m_vertexIndexData = _data + vertexIndexSection->offset;
+    m_vertexIndexSize = vertexIndexSection->elementSize;
+    m_vertexIndexCount = static_cast<size_t>(vertexIndexSection->count);
+    m_indexRanges = indexRanges;
+    m_lods = lods;
+    m_lodCount = static_cast<size_t>(lodSection->count);
+    m_submeshes = submeshes;
+    m_submeshCount = static_cast<size_t>(submeshSection->count);
+    m_materials = materials;
+    m_materialCount = static_cast<size_t>(materialSection->count);
+    m_meshlets = meshlets;
+    m_meshletCount = static_cast<size_t>(meshletSection->count);
+    m_meshletVertices = meshletVertices;
+    m_meshletVertexCount = static_cast<size_t>(meshletVertexSection->count);
+    m_meshletTriangles = reinterpret_cast<const uint8_t*>(_data + meshletTriangleSection->offset);
+    m_meshletTriangleCount = static_cast<size_t>(meshletTriangleSection->count / 3);
+    return true;
+}
+
+const MeshCache::Section* MeshCache::findSection(const char* _data, MeshCacheSectionType _type) const
+{
+    Header header;
+    std::memcpy(&header, _data, sizeof(header));
+
+    const Section* sections = reinterpret_cast<const Section*>(_data + sizeof(Header));
+    for (uint32_t i = 0; i < header.sectionCount; ++i)
+    {
+        if (sections[i].type == _type)
+        {
+            return &sections[i];
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,146 @@
+#ifndef GQY_MESH_CACHE_H
+#define GQY_MESH_CACHE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "IndexRanges.h"
+#include "MappedFile.h"
+#include "MeshletBuilder.h"
+#include "Submesh.h"
+#include "VertexLayout.h"
+
+enum class MeshCacheSectionType : uint32_t
+{
+    Vertices = 1,
+    VertexIndices = 2,
+    VertexQuantization = 3,
+    IndexRanges = 4,
+    Submeshes = 5,
+    Textures = 6,
+    Materials = 7,
+    Meshlets = 8,
+    MeshletVertices = 9,
+    MeshletTriangles = 10,
+    Lods = 11
+};
+
+// һ LODgetIndexRanges() д firstIndexRange ʼ indexRangeCount 䣬 0 һһӦ
+// (׼Ͳͬ)error Ϊԭ֮ (ģͿռ)漶
+struct MeshLod
+{
+    uint32_t firstIndexRange;
+    uint32_t indexRangeCount;
+    uint32_t indexCount;
+    float error;
+};
+
+// ԤõĶ񻺴棺ļͷ + α +  16 ֽڶݶ
+// ļͷ¼Դ .obj/.mtl ĹϣԴļ仯ʽ汾仯ʱʧЧ
+class MeshCache
+{
+public:
+    static const uint32_t MAGIC = 0x4D595147;   // "GQYM"
+    static const uint32_t VERSION = 8;
+    static const uint32_t MAX_LOD_COUNT = 4;
+
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t sourceHash;
+        uint32_t sectionCount;
+        VertexLayoutType vertexLayout;
+    };
+
+    struct Section
+    {
+        MeshCacheSectionType type;
+        uint32_t elementSize;
+        uint64_t offset;
+        uint64_t count;
+    };
+
+    // Դļϣ.obj ݼ mtllib õ .mtl 
+    static uint64_t computeSourceHash(const std::string& _objFilename);
+    static std::string getCacheFilename(const std::string& _objFilename);
+
+    // ӳ仺ļУ飬ƥʱ false
+    bool open(const std::string& _filename, uint64_t _sourceHash);
+    // ڴаѶ GpuVertexLayout ʽɻݣٵ save д̡
+    // 㳬 65536 ʱɶ 16 λ (߽紦Ķᱻ)ƵĶȽʡʱ 32 λ
+    // 谴ͼ ( groupTrianglesByMaterial)䲻Խʼ¼ͬ
+    // ÿͬʱзֳɴ ( buildMeshlets)زԽ䡣
+    // ÿ𼶼򻯳 LOD ( simplifyMeshChain)ö㣬׷ڵ 0 ֮
+    void build(uint64_t _sourceHash, const std::vector<Vertex>& _vertices, const std::vector<uint32_t>& _vertexIndices,
+        const std::vector<Submesh>& _submeshes, const std::vector<MeshMaterial>& _materials, const std::vector<std::string>& _textures);
+    bool save(const std::string& _filename) const;
+    void close();
+
+    bool isValid() const { return m_data != nullptr; }
+    bool isMapped() const { return m_mappedFile.isOpen(); }
+    size_t size() const { return m_size; }
+
+    const GpuVertex* getVertices() const { return m_vertices; }
+    size_t getVertexCount() const { return m_vertexCount; }
+    // ݰ getVertexIndexSize() ֽ (2  4) ţʱ getIndexRanges() ύ
+    // getVertexIndexCount()  LOD getIndexRanges() / getIndexRangeCount() ֻ 0 
+    const void* getVertexIndexData() const { return m_vertexIndexData; }
+    uint32_t getVertexIndexSize() const { return m_vertexIndexSize; }
+    size_t getVertexIndexCount() const { return m_vertexIndexCount; }
+    const IndexRange* getIndexRanges() const { return m_indexRanges; }
+    size_t getIndexRangeCount() const { return m_lodCount == 0 ? 0 : m_lods[0].indexRangeCount; }
+    const MeshLod* getLods() const { return m_lods; }
+    size_t getLodCount() const { return m_lodCount; }
+    const IndexRange* getLodIndexRanges(size_t _lod) const { return m_indexRanges + m_lods[_lod].firstIndexRange; }
+    const Submesh* getSubmeshes() const { return m_submeshes; }
+    size_t getSubmeshCount() const { return m_submeshCount; }
+    //  materialIndex ָʼ¼ textureIndex ָ getTextures()
+    const MeshMaterial* getMaterials() const { return m_materials; }
+    size_t getMaterialCount() const { return m_materialCount; }
+    // ͼ· .obj Ŀ¼
+    const std::vector<std::string>& getTextures() const { return m_textures; }
+    const VertexQuantization& getVertexQuantization() const { return m_vertexQuantization; }
+    // ڶֱָ getVertices()Ѱ vertexOffset
+    const Meshlet* getMeshlets() const { return m_meshlets; }
+    size_t getMeshletCount() const { return m_meshletCount; }
+    const uint32_t* getMeshletVertices() const { return m_meshletVertices; }
+    size_t getMeshletVertexCount() const { return m_meshletVertexCount; }
+    const uint8_t* getMeshletTriangles() const { return m_meshletTriangles; }
+    size_t getMeshletTriangleCount() const { return m_meshletTriangleCount; }
+
+private:
+    bool parse(const char* _data, size_t _size, uint64_t _sourceHash);
+    const Section* findSection(const char* _data, MeshCacheSectionType _type) const;
+
+private:
+    MappedFile m_mappedFile;
+    std::vector<char> m_storage;
+
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+
+    const GpuVertex* m_vertices = nullptr;
+    size_t m_vertexCount = 0;
+    const void* m_vertexIndexData = nullptr;
+    uint32_t m_vertexIndexSize = 0;
+    size_t m_vertexIndexCount = 0;
+    const IndexRange* m_indexRanges = nullptr;
+    const MeshLod* m_lods = nullptr;
+    size_t m_lodCount = 0;
+    const Submesh* m_submeshes = nullptr;
+    size_t m_submeshCount = 0;
+    const MeshMaterial* m_materials = nullptr;
+    size_t m_materialCount = 0;
+    std::vector<std::string> m_textures;
+    VertexQuantization m_vertexQuantization;
+    const Meshlet* m_meshlets = nullptr;
+    size_t m_meshletCount = 0;
+    const uint32_t* m_meshletVertices = nullptr;
+    size_t m_meshletVertexCount = 0;
+    const uint8_t* m_meshletTriangles = nullptr;
+    size_t m_meshletTriangleCount = 0;
+};
+
+#endif
@@ -0,0 +1,378 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace
+{
+    const uint32_t FORSYTH_CACHE_SIZE = 32;
+    const uint32_t FORSYTH_MAX_VALENCE = 32;
+    const float FORSYTH_CACHE_DECAY_POWER = 1.5f;
+    const float FORSYTH_LAST_TRIANGLE_SCORE = 0.75f;
+    const float FORSYTH_VALENCE_BOOST_SCALE = 2.0f;
+    const float FORSYTH_VALENCE_BOOST_POWER = 0.5f;
+
+    const uint32_t OVERDRAW_CACHE_SIZE = 16;
+
+    struct ForsythScoreTable
+    {
+        float cache[FORSYTH_CACHE_SIZE + 3];
+        float valence[FORSYTH_MAX_VALENCE + 1];
+
+        ForsythScoreTable()
+        {
+            for (uint32_t i = 0; i < FORSYTH_CACHE_SIZE + 3; ++i)
+            {
+                if (i < 3)
+                {
+                    // ù÷̶ֹͬһϸ
+                    cache[i] = FORSYTH_LAST_TRIANGLE_SCORE;
+                }
+                else
+                {
+                    float scaler = 1.0f / static_cast<float>(FORSYTH_CACHE_SIZE - 3);
+                    cache[i] = std::pow(1.0f - static_cast<float>(i - 3) * scaler, FORSYTH_CACHE_DECAY_POWER);
+                }
+            }
+
+            valence[0] = 0.0f;
+            for (uint32_t i = 1; i <= FORSYTH_MAX_VALENCE; ++i)
+            {
+                valence[i] = FORSYTH_VALENCE_BOOST_SCALE * std::pow(static_cast<float>(i), -FORSYTH_VALENCE_BOOST_POWER);
+            }
+        }
+
+        float getScore(int32_t _cachePosition, uint32_t _valence) const
+        {
+            // ûʣεĶ㲻ٲ
+            if (_valence == 0)
+            {
+                return -1.0f;
+            }
+            float score = _cachePosition >= 0 ? cache[_cachePosition] : 0.0f;
+            return score + valence[std::min(_valence, FORSYTH_MAX_VALENCE)];
+        }
+    };
+
+    // ʱ FIFO 棺дʱ񲻳СΪ
+    uint32_t updateCache(uint32_t _a, uint32_t _b, uint32_t _c, uint32_t _cacheSize, std::vector<uint32_t>& _timestamps, uint32_t& _timestamp)
+    {
+        uint32_t misses = 0;
+        for (uint32_t vertex : { _a, _b, _c })
+        {
+            if (_timestamp - _timestamps[vertex] > _cacheSize)
+            {
+                _timestamps[vertex] = _timestamp++;
+                ++misses;
+            }
+        }
+        return misses;
+    }
+
+    void resetCache(uint32_t _cacheSize, uint32_t& _timestamp)
+    {
+        _timestamp += _cacheSize + 1;
+    }
+}
+
+VertexCacheStatistics analyzeVertexCache(const std::vector<uint32_t>& _vertexIndices, size_t _vertexCount, uint32_t _cacheSize)
+{
+    VertexCacheStatistics statistics{ };
+    statistics.cacheSize = _cacheSize;
+
+    std::vector<uint32_t> timestamps(_vertexCount, 0);
+    uint32_t timestamp = _cacheSize + 1;
+    for (size_t i = 0; i + 2 < _vertexIndices.size(); i += 3)
+    {
+        statistics.misses += updateCache(_vertexIndices[i], _vertexIndices[i + 1], _vertexIndices[i + 2], _cacheSize, timestamps, timestamp);
+    }
+
+    size_t triangleCount = _vertexIndices.size() / 3;
+    statistics.acmr = triangleCount == 0 ? 0.0f : static_cast<float>(statistics.misses) / static_cast<float>(triangleCount);
+    statistics.atvr = _vertexCount == 0 ? 0.0f : static_cast<float>(statistics.misses) / static_cast<float>(_vertexCount);
+    return statistics;
+}
+
+void optimizeVertexCache(std::vector<uint32_t>& _vertexIndices, size_t _vertexCount)
+{
+    static const ForsythScoreTable scoreTable;
+
+    const size_t triangleCount = _vertexIndices.size() / 3;
+    if (triangleCount == 0)
+    {
+        return;
+    }
+
+    // ÿڵб (CSR)ѡκбƳ
+    std::vector<uint32_t> valences(_vertexCount, 0);
+    for (size_t i = 0; i < triangleCount * 3; ++i)
+    {
+        ++valences[_vertexIndices[i]];
+    }
+    std::vector<uint32_t> adjacencyOffsets(_vertexCount + 1, 0);
+    for (size_t i = 0; i < _vertexCount; ++i)
+    {
+        adjacencyOffsets[i + 1] = adjacencyOffsets[i] + valences[i];
+    }
+    std::vector<uint32_t> adjacency(triangleCount * 3);
+    {
+        std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (size_t i = 0; i < triangleCount * 3; ++i)
+        {
+            adjacency[fill[_vertexIndices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+    }
+
+    std::vector<float> vertexScores(_vertexCount);
+    for (size_t i = 0; i < _vertexCount; ++i)
+    {
+        vertexScores[i] = scoreTable.getScore(-1, valences[i]);
+    }
+
+    std::vector<bool> emitted(triangleCount, false);
+
+    std::vector<uint32_t> result;
+    result.reserve(triangleCount * 3);
+
+    uint32_t cache[FORSYTH_CACHE_SIZE + 3];
+    uint32_t newCache[FORSYTH_CACHE_SIZE + 3];
+    uint32_t cacheCount = 0;
+
+    size_t bestTriangle = 0;
+    size_t nextCandidate = 0;
+    for (size_t emittedCount = 0; emittedCount < triangleCount; ++emittedCount)
+    {
+        // еĶ㶼ûʣʱ˳һδ
+        if (bestTriangle == std::numeric_limits<size_t>::max())
+        {
+            while (emitted[nextCandidate])
+            {
+                ++nextCandidate;
+            }
+            bestTriangle = nextCandidate;
+        }
+
+        const uint32_t* triangle = &_vertexIndices[bestTriangle * 3];
+        result.insert(result.end(), triangle, triangle + 3);
+        emitted[bestTriangle] = true;
+
+        for (uint32_t k = 0; k < 3; ++k)
+        {
+            uint32_t vertex = triangle[k];
+            uint32_t* begin = &adjacency[adjacencyOffsets[vertex]];
+            uint32_t* end = begin + valences[vertex];
+            uint32_t* found = std::find(begin, end, static_cast<uint32_t>(bestTriangle));
+            if (found != end)
+            {
+                *found = *(end - 1);
+                --valences[vertex];
+            }
+        }
+
+        // εĶŵǰ棬ඥκ
+        uint32_t newCacheCount = 0;
+        for (uint32_t k = 0; k < 3; ++k)
+        {
+            if (std::find(newCache, newCache + newCacheCount, triangle[k]) == newCache + newCacheCount)
+            {
+                newCache[newCacheCount++] = triangle[k];
+            }
+        }
+        for (uint32_t k = 0; k < cacheCount; ++k)
+        {
+            uint32_t vertex = cache[k];
+            if (vertex != triangle[0] && vertex != triangle[1] && vertex != triangle[2])
+            {
+                if (newCacheCount < FORSYTH_CACHE_SIZE)
+                {
+                    newCache[newCacheCount++] = vertex;
+                }
+                else
+                {
+                    vertexScores[vertex] = scoreTable.getScore(-1, valences[vertex]);
+                }
+            }
+        }
+        std::copy(newCache, newCache + newCacheCount, cache);
+        cacheCount = newCacheCount;
+
+        for (uint32_t k = 0; k < cacheCount; ++k)
+        {
+            uint32_t vertex = cache[k];
+            vertexScores[vertex] = scoreTable.getScore(static_cast<int32_t>(k), valences[vertex]);
+        }
+
+        // ֻҪ¼㻺жεĵ÷֣ѡһ
+        bestTriangle = std::numeric_limits<size_t>::max();
+        float bestScore = -1.0f;
+        for (uint32_t k = 0; k < cacheCount; ++k)
+        {
+            uint32_t vertex = cache[k];
+            const uint32_t* begin = &adjacency[adjacencyOffsets[vertex]];
+            for (uint32_t j = 0; j < valences[vertex]; ++j)
+            {
+                uint32_t candidate = begin[j];
+                float score = vertexScores[_vertexIndices[candidate * 3]] + vertexScores[_vertexIndices[candidate * 3 + 1]] + vertexScores[_vertexIndices[candidate * 3 + 2]];
+                if (score > bestScore)
+                {
+                    bestScore = score;
+                    bestTriangle = candidate;
+                }
+            }
+        }
+    }
+
+    std::copy(result.begin(), result.end(), _vertexIndices.begin());
+}
+
+void optimizeOverdraw(std::vector<uint32_t>& _vertexIndices, const std::vector<Vertex>& _vertices, float _threshold)
+{
+    const size_t triangleCount = _vertexIndices.size() / 3;
+    if (triangleCount == 0)
+    {
+        return;
+    }
+
+    std::vector<uint32_t> timestamps(_vertices.size(), 0);
+    uint32_t timestamp = OVERDRAW_CACHE_SIZE + 1;
+    auto triangleMisses = [&](size_t _triangle)
+    {
+        return updateCache(_vertexIndices[_triangle * 3], _vertexIndices[_triangle * 3 + 1], _vertexIndices[_triangle * 3 + 2], OVERDRAW_CACHE_SIZE, timestamps, timestamp);
+    };
+
+    // Ӳ߽磺㶼ڻУͨζſʼһ֮ǰ
+    std::vector<size_t> hardBoundaries;
+    for (size_t i = 0; i < triangleCount; ++i)
+    {
+        if (triangleMisses(i) == 3 || i == 0)
+        {
+            hardBoundaries.push_back(i);
+        }
+    }
+    hardBoundaries.push_back(triangleCount);
+
+    // ߽磺ۼ ACMR ѾӲ ACMR  _threshold ʱз
+    std::vector<size_t> clusters;
+    for (size_t h = 0; h + 1 < hardBoundaries.size(); ++h)
+    {
+        const size_t start = hardBoundaries[h];
+        const size_t end = hardBoundaries[h + 1];
+
+        resetCache(OVERDRAW_CACHE_SIZE, timestamp);
+        size_t clusterMisses = 0;
+        for (size_t i = start; i < end; ++i)
+        {
+            clusterMisses += triangleMisses(i);
+        }
+        const float clusterThreshold = _threshold * static_cast<float>(clusterMisses) / static_cast<float>(end - start);
+
+        clusters.push_back(start);
+        resetCache(OVERDRAW_CACHE_SIZE, timestamp);
+        size_t runningMisses = 0;
+        size_t runningTriangles = 0;
+        for (size_t i = start; i < end; ++i)
+        {
+            runningMisses += triangleMisses(i);
+            ++runningTriangles;
+            if (i + 1 < end && static_cast<float>(runningMisses) / static_cast<float>(runningTriangles) <= clusterThreshold)
+            {
+                clusters.push_back(i + 1);
+                resetCache(OVERDRAW_CACHE_SIZE, timestamp);
+                runningMisses = 0;
+                runningTriangles = 0;
+            }
+        }
+    }
+    clusters.push_back(triangleCount);
+
+    // صݣģĵƫڴƽϵͶӰԽĴԽȻ
+    const size_t clusterCount = clusters.size() - 1;
+    std::vector<glm::vec3> clusterCentroids(clusterCount, glm::vec3(0.0f));
+    std::vector<glm::vec3> clusterNormals(clusterCount, glm::vec3(0.0f));
+    glm::vec3 meshCentroid(0.0f);
+    float meshArea = 0.0f;
+    for (size_t c = 0; c < clusterCount; ++c)
+    {
+        float clusterArea = 0.0f;
+        for (size_t i = clusters[c]; i < clusters[c + 1]; ++i)
+        {
+            const glm::vec3& a = _vertices[_vertexIndices[i * 3]].positionOS;
+            const glm::vec3& b = _vertices[_vertexIndices[i * 3 + 1]].positionOS;
+            const glm::vec3& d = _vertices[_vertexIndices[i * 3 + 2]].positionOS;
+            glm::vec3 normal = glm::cross(b - a, d - a);
+            float area = glm::length(normal);
+            glm::vec3 centroid = (a + b + d) * (area / 3.0f);
+
+            clusterCentroids[c] += centroid;
+            clusterNormals[c] += normal;
+            clusterArea += area;
+            meshCentroid += centroid;
+            meshArea += area;
+        }
+        clusterCentroids[c] = clusterArea > 0.0f ? clusterCentroids[c] / clusterArea : clusterCentroids[c];
+    }
+    meshCentroid = meshArea > 0.0f ? meshCentroid / meshArea : meshCentroid;
+
+    std::vector<float> sortKeys(clusterCount);
+    for (size_t c = 0; c < clusterCount; ++c)
+    {
+        float normalLength = glm::length(clusterNormals[c]);
+        glm::vec3 normal = normalLength > 0.0f ? clusterNormals[c] / normalLength : glm::vec3(0.0f);
+        sortKeys[c] = glm::dot(clusterCentroids[c] - meshCentroid, normal);
+    }
+
+    std::vector<uint32_t> order(clusterCount);
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [&sortKeys](uint32_t _a, uint32_t _b) { return sortKeys[_a] > sortKeys[_b]; });
+
+    std::vector<uint32_t> result;
+    result.reserve(triangleCount * 3);
+    for (uint32_t c : order)
+    {
+        result.insert(result.end(), _vertexIndices.begin() + clusters[c] * 3, _vertexIndices.begin() + clusters[c + 1] * 3);
+    }
+    std::copy(result.begin(), result.end(), _vertexIndices.begin());
+}
+
+void optimizeVertexFetch(std::vector<Vertex>& _vertices, std::vector<uint32_t>& _vertexIndices)
+{
+    const uint32_t unused = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> remap(_vertices.size(), unused);
+    std::vector<Vertex> vertices;
+    vertices.reserve(_vertices.size());
+
+    for (uint32_t& index : _vertexIndices)
+    {
+        if (remap[index] == unused)
+        {
+            remap[index] = static_cast<uint32_t>(vertices.size());
+            vertices.push_back(_vertices[index]);
+        }
+        index = remap[index];
+    }
+
+    _vertices.swap(vertices);
+}
+
+void optimizeMesh(std::vector<Vertex>& _vertices, std::vector<uint32_t>& _vertexIndices)
+{
+    optimizeVertexCache(_vertexIndices, _vertices.size());
+    optimizeOverdraw(_vertexIndices, _vertices);
+    optimizeVertexFetch(_vertices, _vertexIndices);
+}
+
+void optimizeMesh(std::vector<Vertex>& _vertices, std::vector<uint32_t>& _vertexIndices, const std::vector<Submesh>& _submeshes)
+{
+    std::vector<uint32_t> submeshIndices;
+    for (const Submesh& submesh : _submeshes)
+    {
+        auto first = _vertexIndices.begin() + submesh.firstIndex;
+        submeshIndices.assign(first, first + submesh.indexCount);
+        optimizeVertexCache(submeshIndices, _vertices.size());
+        optimizeOverdraw(submeshIndices, _vertices);
+        std::copy(submeshIndices.begin(), submeshIndices.end(), first);
+    }
+    optimizeVertexFetch(_vertices, _vertexIndices);
+}
@@ -0,0 +1,37 @@
+#ifndef GQY_MESH_OPTIMIZER_H
+#define GQY_MESH_OPTIMIZER_H
+
+#include <cstdint>
+#include <vector>
+
+#include "Submesh.h"
+#include "Vertex.h"
+
+//  FIFO 㻺ģõͳ
+// ACMRƽÿεĻδдATVRδд붥֮ (ֵΪ 1)
+struct VertexCacheStatistics
+{
+    uint32_t cacheSize = 0;
+    size_t misses = 0;
+    float acmr = 0.0f;
+    float atvr = 0.0f;
+};
+
+VertexCacheStatistics analyzeVertexCache(const std::vector<uint32_t>& _vertexIndices, size_t _vertexCount, uint32_t _cacheSize = 16);
+
+// Tom Forsyth ʱ䶥㻺Ż̰ĵѡ÷ߵ
+void optimizeVertexCache(std::vector<uint32_t>& _vertexIndices, size_t _vertexCount);
+
+// ڱֶ㻺ʵǰ°зֳɴأٰصĳԼٹȻ
+// _threshold Ϊ ACMR Ŵ
+void optimizeOverdraw(std::vector<uint32_t>& _vertexIndices, const std::vector<Vertex>& _vertices, float _threshold = 1.05f);
+
+// һαʹõ˳ж㣬ƶȡľֲԣͬʱδõĶ
+void optimizeVertexFetch(std::vector<Vertex>& _vertices, std::vector<uint32_t>& _vertexIndices);
+
+// ִ񻺴ǰ
+void optimizeMesh(std::vector<Vertex>& _vertices, std::vector<uint32_t>& _vertexIndices);
+// 㻺͹ȻŻڸڲУβƳ
+void optimizeMesh(std::vector<Vertex>& _vertices, std::vector<uint32_t>& _vertexIndices, const std::vector<Submesh>& _submeshes);
+
+#endif
@@ -0,0 +1,415 @@
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    const int QUADRIC_DIMENSION = 5;
+
+    // Գƾ A ѹţΪ (v^T A v + 2 b^T v + c) / weightȨƽƽ
+    struct Quadric
+    {
+        double a[15];
+        double b[QUADRIC_DIMENSION];
+        double c;
+        double weight;
+    };
+
+    struct QuadricPoint
+    {
+        double v[QUADRIC_DIMENSION];
+    };
+
+    struct Collapse
+    {
+        double cost;
+        uint32_t from;
+        uint32_t to;
+    };
+
+    int packedIndex(int _row, int _column)
+    {
+        if (_row > _column)
+        {
+            std::swap(_row, _column);
+        }
+        return _row * QUADRIC_DIMENSION - _row * (_row - 1) / 2 + _column - _row;
+    }
+
+    double dot(const double* _a, const double* _b)
+    {
+        double result = 0.0;
+        for (int i = 0; i < QUADRIC_DIMENSION; ++i)
+        {
+            result += _a[i] * _b[i];
+        }
+        return result;
+    }
+
+    void addQuadric(Quadric& _target, const Quadric& _source)
+    {
+        for (int i = 0; i < 15; ++i)
+        {
+            _target.a[i] += _source.a[i];
+        }
+        for (int i = 0; i < QUADRIC_DIMENSION; ++i)
+        {
+            _target.b[i] += _source.b[i];
+        }
+        _target.c += _source.c;
+        _target.weight += _source.weight;
+    }
+
+    double evaluateQuadric(const Quadric& _quadric, const QuadricPoint& _point)
+    {
+        double result = _quadric.c;
+        for (int i = 0; i < QUADRIC_DIMENSION; ++i)
+        {
+            result += 2.0 * _quadric.b[i] * _point.v[i];
+            for (int j = i; j < QUADRIC_DIMENSION; ++j)
+            {
+                result += (i == j ? 1.0 : 2.0) * _quadric.a[packedIndex(i, j)] * _point.v[i] * _point.v[j];
+            }
+        }
+        return _quadric.weight > 0.0 ? std::max(result, 0.0) / _quadric.weight : 0.0;
+    }
+
+    // ڶάƽĶ (Hoppe 1999)e1e2 Ϊƽڵ
+    // A = I - e1 e1^T - e2 e2^Tb = (pe1) e1 + (pe2) e2 - pc = pp - (pe1)^2 - (pe2)^2
+    bool computeTriangleQuadric(const QuadricPoint& _p0, const QuadricPoint& _p1, const QuadricPoint& _p2, Quadric& _quadric)
+    {
+        double e1[QUADRIC_DIMENSION];
+        double e2[QUADRIC_DIMENSION];
+        for (int i = 0; i < QUADRIC_DIMENSION; ++i)
+        {
+            e1[i] = _p1.v[i] - _p0.v[i];
+            e2[i] = _p2.v[i] - _p0.v[i];
+        }
+        const double length1 = std::sqrt(dot(e1, e1));
+        if (length1 <= 1e-12)
+        {
+            return false;
+        }
+        for (double& value : e1)
+        {
+            value /= length1;
+        }
+        const double projection = dot(e2, e1);
+        for (int i = 0; i < QUADRIC_DIMENSION; ++i)
+        {
+            e2[i] -= projection * e1[i];
+        }
+        const double length2 = std::sqrt(dot(e2, e2));
+        if (length2 <= 1e-12)
+        {
+            return false;
+        }
+        for (double& value : e2)
+        {
+            value /= length2;
+        }
+
+        const double area = 0.5 * length1 * length2;
+        const double p0e1 = dot(_p0.v, e1);
+        const double p0e2 = dot(_p0.v, e2);
+        for (int i = 0; i < QUADRIC_DIMENSION; ++i)
+        {
+            for (int j = i; j < QUADRIC_DIMENSION; ++j)
+            {
+                _quadric.a[packedIndex(i, j)] = area * ((i == j ? 1.0 : 0.0) - e1[i] * e1[j] - e2[i] * e2[j]);
+            }
+            _quadric.b[i] = area * (p0e1 * e1[i] + p0e2 * e2[i] - _p0.v[i]);
+        }
+        _quadric.c = area * (dot(_p0.v, _p0.v) - p0e1 * p0e1 - p0e2 * p0e2);
+        _quadric.weight = area;
+        return true;
+    }
+
+    glm::vec3 computeNormal(const glm::vec3& _p0, const glm::vec3& _p1, const glm::vec3& _p2)
+    {
+        return glm::cross(_p1 - _p0, _p2 - _p0);
+    }
+
+    // ֻ߽һΣιõķαͬΪ߽
+    void lockBorderVertices(const std::vector<uint32_t>& _vertexIndices, std::vector<bool>& _locked)
+    {
+        std::vector<uint64_t> edges;
+        edges.reserve(_vertexIndices.size());
+        for (size_t i = 0; i < _vertexIndices.size(); i += 3)
+        {
+            for (int corner = 0; corner < 3; ++corner)
+            {
+                const uint64_t a = _vertexIndices[i + corner];
+                const uint64_t b = _vertexIndices[i + (corner + 1) % 3];
+                edges.push_back(a < b ? (a << 32) | b : (b << 32) | a);
+            }
+        }
+        std::sort(edges.begin(), edges.end());
+        for (size_t i = 0; i < edges.size(); )
+        {
+            size_t end = i + 1;
+            while (end < edges.size() && edges[end] == edges[i])
+            {
+                ++end;
+            }
+            if (end - i != 2)
+            {
+                _locked[static_cast<size_t>(edges[i] >> 32)] = true;
+                _locked[static_cast<size_t>(edges[i] & 0xffffffffu)] = true;
+            }
+            i = end;
+        }
+    }
+
+    // λͬĶ (UV ӷ졢߻ɫ) ۵ֿȫ
+    void lockSeamVertices(const std::vector<Vertex>& _vertices, const std::vector<uint32_t>& _usedVertices, std::vector<bool>& _locked)
+    {
+        std::vector<uint32_t> sorted(_usedVertices);
+        auto lessPosition = [&_vertices](uint32_t _a, uint32_t _b)
+        {
+            const glm::vec3& a = _vertices[_a].positionOS;
+            const glm::vec3& b = _vertices[_b].positionOS;
+            return a.x != b.x ? a.x < b.x : (a.y != b.y ? a.y < b.y : a.z < b.z);
+        };
+        std::sort(sorted.begin(), sorted.end(), lessPosition);
+        for (size_t i = 0; i < sorted.size(); )
+        {
+            size_t end = i + 1;
+            while (end < sorted.size() && _vertices[sorted[end]].positionOS == _vertices[sorted[i]].positionOS)
+            {
+                ++end;
+            }
+            if (end - i > 1)
+            {
+                for (size_t j = i; j < end; ++j)
+                {
+                    _locked[sorted[j]] = true;
+                }
+            }
+            i = end;
+        }
+    }
+
+    class EdgeCollapser
+    {
+    public:
+        EdgeCollapser(const std::vector<Vertex>& _vertices, const uint32_t* _vertexIndices, size_t _indexCount, float _texCoordWeight)
+            : m_vertices(_vertices), m_vertexIndices(_vertexIndices, _vertexIndices + _indexCount - _indexCount % 3)
+        {
+            const size_t vertexCount = _vertices.size();
+            std::vector<bool> used(vertexCount, false);
+            std::vector<uint32_t> usedVertices;
+            glm::vec3 minimum(0.0f);
+            glm::vec3 maximum(0.0f);
+            for (uint32_t vertex : m_vertexIndices)
+            {
+                if (!used[vertex])
+                {
+                    used[vertex] = true;
+                    minimum = usedVertices.empty() ? _vertices[vertex].positionOS : glm::min(minimum, _vertices[vertex].positionOS);
+                    maximum = usedVertices.empty() ? _vertices[vertex].positionOS : glm::max(maximum, _vertices[vertex].positionOS);
+                    usedVertices.push_back(vertex);
+                }
+            }
+            const glm::vec3 size = maximum - minimum;
+            m_scale = std::max(std::max(size.x, size.y), std::max(size.z, 1e-20f));
+
+            // λùһ [0, 1]ʹȨģͳߴ޹
+            m_points.resize(vertexCount);
+            for (uint32_t vertex : usedVertices)
+            {
+                const Vertex& source = _vertices[vertex];
+                const glm::vec3 position = (source.positionOS - minimum) / m_scale;
+                m_points[vertex] = QuadricPoint{ { position.x, position.y, position.z, source.texCoord.x * _texCoordWeight, source.texCoord.y * _texCoordWeight } };
+            }
+
+            m_quadrics.assign(vertexCount, Quadric{ });
+            for (size_t i = 0; i < m_vertexIndices.size(); i += 3)
+            {
+                Quadric quadric;
+                if (computeTriangleQuadric(m_points[m_vertexIndices[i]], m_points[m_vertexIndices[i + 1]], m_points[m_vertexIndices[i + 2]], quadric))
+                {
+                    for (int corner = 0; corner < 3; ++corner)
+                    {
+                        addQuadric(m_quadrics[m_vertexIndices[i + corner]], quadric);
+                    }
+                }
+            }
+
+            m_locked.assign(vertexCount, false);
+            lockBorderVertices(m_vertexIndices, m_locked);
+            lockSeamVertices(_vertices, usedVertices, m_locked);
+            m_passStamps.assign(vertexCount, 0);
+        }
+
+        // ۵ _targetIndexCount / 3 ûп۵ıΪֹ
+        void simplify(size_t _targetIndexCount)
+        {
+            while (m_vertexIndices.size() > _targetIndexCount && collapsePass(_targetIndexCount) > 0)
+            {
+            }
+        }
+
+        const std::vector<uint32_t>& getVertexIndices() const { return m_vertexIndices; }
+        float getError() const { return static_cast<float>(std::sqrt(m_maxCost) * m_scale); }
+
+    private:
+        // һа۴ӵ͵۵ڵıߣ۵Ķ㼰һڱڲٲ룬
+        // ÿμ鷭תʱʹõڽӹϵµġرֵ۵
+        size_t collapsePass(size_t _targetIndexCount)
+        {
+            const size_t vertexCount = m_vertices.size();
+            const size_t triangleCount = m_vertexIndices.size() / 3;
+
+            m_adjacencyOffsets.assign(vertexCount + 1, 0);
+            for (uint32_t vertex : m_vertexIndices)
+            {
+                ++m_adjacencyOffsets[vertex + 1];
+            }
+            for (size_t i = 0; i < vertexCount; ++i)
+            {
+                m_adjacencyOffsets[i + 1] += m_adjacencyOffsets[i];
+            }
+            m_adjacency.resize(m_vertexIndices.size());
+            std::vector<uint32_t> fillOffsets(m_adjacencyOffsets.begin(), m_adjacencyOffsets.end() - 1);
+            for (size_t i = 0; i < m_vertexIndices.size(); ++i)
+            {
+                m_adjacency[fillOffsets[m_vertexIndices[i]]++] = static_cast<uint32_t>(i / 3);
+            }
+
+            // ڲıз෴ֻ a < b һһΣȡ۵͵
+            std::vector<Collapse> collapses;
+            collapses.reserve(triangleCount * 3 / 2);
+            for (size_t i = 0; i < m_vertexIndices.size(); i += 3)
+            {
+                for (int corner = 0; corner < 3; ++corner)
+                {
+                    const uint32_t a = m_vertexIndices[i + corner];
+                    const uint32_t b = m_vertexIndices[i + (corner + 1) % 3];
+                    if (a >= b || (m_locked[a] && m_locked[b]))
+                    {
+                        continue;
+                    }
+                    Quadric quadric = m_quadrics[a];
+                    addQuadric(quadric, m_quadrics[b]);
+                    const double costToB = m_locked[a] ? INFINITY : evaluateQuadric(quadric, m_points[b]);
+                    const double costToA = m_locked[b] ? INFINITY : evaluateQuadric(quadric, m_points[a]);
+                    collapses.push_back(costToB <= costToA ? Collapse{ costToB, a, b } : Collapse{ costToA, b, a });
+                }
+            }
+            std::sort(collapses.begin(), collapses.end(), [](const Collapse& _a, const Collapse& _b) { return _a.cost < _b.cost; });
+
+            // ÿֻǴ͵֮һһΪ˴۵۸ߵıߣⲿȫתܾʱż
+            const size_t candidateCount = std::max<size_t>(1, collapses.size() / 3);
+            ++m_passStamp;
+            const size_t removeTarget = triangleCount - _targetIndexCount / 3;
+            size_t removedTriangleCount = 0;
+            size_t collapseCount = 0;
+            for (size_t i = 0; i < collapses.size(); ++i)
+            {
+                const Collapse& collapse = collapses[i];
+                if (removedTriangleCount >= removeTarget || collapse.cost == INFINITY || (i >= candidateCount && collapseCount > 0))
+                {
+                    break;
+                }
+                if (m_passStamps[collapse.from] == m_passStamp || m_passStamps[collapse.to] == m_passStamp || hasFlip(collapse.from, collapse.to))
+                {
+                    continue;
+                }
+
+                for (uint32_t a = m_adjacencyOffsets[collapse.from]; a < m_adjacencyOffsets[collapse.from + 1]; ++a)
+                {
+                    uint32_t* triangle = &m_vertexIndices[static_cast<size_t>(m_adjacency[a]) * 3];
+                    bool degenerate = false;
+                    for (int corner = 0; corner < 3; ++corner)
+                    {
+                        degenerate = degenerate || triangle[corner] == collapse.to;
+                    }
+                    removedTriangleCount += degenerate ? 1 : 0;
+                    for (int corner = 0; corner < 3; ++corner)
+                    {
+                        m_passStamps[triangle[corner]] = m_passStamp;
+                        triangle[corner] = triangle[corner] == collapse.from ? collapse.to : triangle[corner];
+                    }
+                }
+                addQuadric(m_quadrics[collapse.to], m_quadrics[collapse.from]);
+                m_maxCost = std::max(m_maxCost, collapse.cost);
+                ++collapseCount;
+            }
+
+            // ȥ۵˻
+            size_t writeIndex = 0;
+            for (size_t i = 0; i < m_vertexIndices.size(); i += 3)
+            {
+                const uint32_t v0 = m_vertexIndices[i];
+                const uint32_t v1 = m_vertexIndices[i + 1];
+                const uint32_t v2 = m_vertexIndices[i + 2];
+                if (v0 != v1 && v1 != v2 && v0 != v2)
+                {
+                    m_vertexIndices[writeIndex++] = v0;
+                    m_vertexIndices[writeIndex++] = v1;
+                    m_vertexIndices[writeIndex++] = v2;
+                }
+            }
+            m_vertexIndices.resize(writeIndex);
+            return collapseCount;
+        }
+
+        // _from ƶ _to _from Χ˻η߲ܷ
+        bool hasFlip(uint32_t _from, uint32_t _to) const
+        {
+            for (uint32_t a = m_adjacencyOffsets[_from]; a < m_adjacencyOffsets[_from + 1]; ++a)
+            {
+                const uint32_t* triangle = &m_vertexIndices[static_cast<size_t>(m_adjacency[a]) * 3];
+                if (triangle[0] == _to || triangle[1] == _to || triangle[2] == _to)
+                {
+                    continue;
+                }
+                glm::vec3 before[3];
+                glm::vec3 after[3];
+                for (int corner = 0; corner < 3; ++corner)
+                {
+                    before[corner] = m_vertices[triangle[corner]].positionOS;
+                    after[corner] = m_vertices[triangle[corner] == _from ? _to : triangle[corner]].positionOS;
+                }
+                if (glm::dot(computeNormal(before[0], before[1], before[2]), computeNormal(after[0], after[1], after[2])) <= 0.0f)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    private:
+        const std::vector<Vertex>& m_vertices;
+        std::vector<uint32_t> m_vertexIndices;
+        std::vector<QuadricPoint> m_points;
+        std::vector<Quadric> m_quadrics;
+        std::vector<bool> m_locked;
+        std::vector<uint32_t> m_adjacencyOffsets;
+        std::vector<uint32_t> m_adjacency;
+        std::vector<uint32_t> m_passStamps;
+        uint32_t m_passStamp = 0;
+        float m_scale = 1.0f;
+        double m_maxCost = 0.0;
+    };
+}
+
+void simplifyMeshChain(const std::vector<Vertex>& _vertices, const uint32_t* _vertexIndices, size_t _indexCount,
+    const std::vector<size_t>& _targetIndexCounts, float _texCoordWeight, std::vector<SimplifiedMesh>& _levels)
+{
+    _levels.clear();
+    if (_indexCount < 3)
+    {
+        _levels.resize(_targetIndexCounts.size());
+        return;
+    }
+
+    EdgeCollapser collapser(_vertices, _vertexIndices, _indexCount, _texCoordWeight);
+    for (size_t targetIndexCount : _targetIndexCounts)
+    {
+        collapser.simplify(targetIndexCount);
+        _levels.push_back(SimplifiedMesh{ collapser.getVertexIndices(), collapser.getError() });
+    }
+}
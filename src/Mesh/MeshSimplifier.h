@@ -0,0 +1,24 @@
+#ifndef GQY_MESH_SIMPLIFIER_H
+#define GQY_MESH_SIMPLIFIER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Vertex.h"
+
+struct SimplifiedMesh
+{
+    std::vector<uint32_t> vertexIndices;
+    // ԭ֮ (ģͿռ) LOD 
+    float error = 0.0f;
+};
+
+// ڶı۵򻯣ֻ۵ڵжϣ LOD ԭĶ顣
+//  (λ,  * _texCoordWeight) άռжλȰߴһ仯۵۸ߣ
+// ű߽ UV ӷ (λͬԲͬĶ) ϵĶ㱣ֲѷ졣
+// ԭʼ۵δﵽ _targetIndexCounts (ݼ) еÿĿʱһ޷۵ʱʣͣڵǰ
+void simplifyMeshChain(const std::vector<Vertex>& _vertices, const uint32_t* _vertexIndices, size_t _indexCount,
+    const std::vector<size_t>& _targetIndexCounts, float _texCoordWeight, std::vector<SimplifiedMesh>& _levels);
+
+#endif
@@ -0,0 +1,312 @@
+#include "MeshletBuilder.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <unordered_map>
+
+namespace
+{
+    const uint8_t NOT_IN_MESHLET = 0xff;
+
+    // ׶Снҵڸֵʱ (Լ 84 ) ׶̫޳ɹֱӱΪ޳
+    const float MIN_CONE_SPREAD = 0.1f;
+
+    // صİΧͷ׶д _meshlet
+    void computeMeshletBounds(Meshlet& _meshlet, const MeshletData& _data, const std::vector<glm::vec3>& _positions)
+    {
+        const uint32_t* vertices = &_data.vertices[_meshlet.vertexOffset];
+        const uint8_t* triangles = &_data.triangles[static_cast<size_t>(_meshlet.triangleOffset) * 3];
+
+        glm::vec3 minimum = _positions[vertices[0]];
+        glm::vec3 maximum = minimum;
+        for (uint32_t i = 1; i < _meshlet.vertexCount; ++i)
+        {
+            minimum = glm::min(minimum, _positions[vertices[i]]);
+            maximum = glm::max(maximum, _positions[vertices[i]]);
+        }
+        const glm::vec3 center = (minimum + maximum) * 0.5f;
+        float radius = 0.0f;
+        for (uint32_t i = 0; i < _meshlet.vertexCount; ++i)
+        {
+            radius = std::max(radius, glm::length(_positions[vertices[i]] - center));
+        }
+
+        std::vector<glm::vec3> normals;
+        normals.reserve(_meshlet.triangleCount);
+        glm::vec3 normalSum(0.0f);
+        for (uint32_t i = 0; i < _meshlet.triangleCount; ++i)
+        {
+            const glm::vec3& p0 = _positions[vertices[triangles[i * 3 + 0]]];
+            const glm::vec3& p1 = _positions[vertices[triangles[i * 3 + 1]]];
+            const glm::vec3& p2 = _positions[vertices[triangles[i * 3 + 2]]];
+            const glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+            const float length = glm::length(normal);
+            // ˻ûг򣬲Ӱ취׶
+            if (length > 0.0f)
+            {
+                normals.push_back(normal / length);
+                normalSum += normals.back();
+            }
+        }
+
+        glm::vec3 axis(0.0f);
+        float cutoff = 1.0f;
+        const float sumLength = glm::length(normalSum);
+        if (!normals.empty() && sumLength > 0.0f)
+        {
+            axis = normalSum / sumLength;
+            float minimumDot = 1.0f;
+            for (const glm::vec3& normal : normals)
+            {
+                minimumDot = std::min(minimumDot, glm::dot(normal, axis));
+            }
+            // ļнǲ 90 ȼȥ׶İʱζcutoff ΪýǶȵңǵ
+            if (minimumDot > MIN_CONE_SPREAD)
+            {
+                cutoff = std::sqrt(1.0f - minimumDot * minimumDot);
+            }
+        }
+
+        for (int i = 0; i < 3; ++i)
+        {
+            _meshlet.center[i] = center[i];
+            _meshlet.coneAxis[i] = axis[i];
+        }
+        _meshlet.radius = radius;
+        _meshlet.coneCutoff = cutoff;
+    }
+}
+
+void buildMeshlets(const uint32_t* _vertexIndices, size_t _indexCount, const std::vector<glm::vec3>& _positions, uint32_t _indexRange, MeshletData& _data)
+{
+    const size_t triangleCount = _indexCount / 3;
+    if (triangleCount == 0)
+    {
+        return;
+    }
+
+    // ѹڵţٽ  ->  ڽӱ
+    std::unordered_map<uint32_t, uint32_t> localVertices;
+    std::vector<uint32_t> triangleVertices(triangleCount * 3);
+    std::vector<uint32_t> sourceVertices;
+    for (size_t i = 0; i < triangleCount * 3; ++i)
+    {
+        auto result = localVertices.emplace(_vertexIndices[i], static_cast<uint32_t>(sourceVertices.size()));
+        if (result.second)
+        {
+            sourceVertices.push_back(_vertexIndices[i]);
+        }
+        triangleVertices[i] = result.first->second;
+    }
+    const size_t vertexCount = sourceVertices.size();
+
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+    for (uint32_t vertex : triangleVertices)
+    {
+        ++adjacencyOffsets[vertex + 1];
+    }
+    for (size_t i = 0; i < vertexCount; ++i)
+    {
+        adjacencyOffsets[i + 1] += adjacencyOffsets[i];
+    }
+    std::vector<uint32_t> adjacency(triangleVertices.size());
+    std::vector<uint32_t> fillOffsets(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+    for (size_t i = 0; i < triangleVertices.size(); ++i)
+    {
+        adjacency[fillOffsets[triangleVertices[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+
+    // liveTriangles Ϊ㻹ûзŽصѡʣٵĶ㣬ٴرԵµƬ
+    std::vector<uint32_t> liveTriangles(vertexCount);
+    for (size_t i = 0; i < vertexCount; ++i)
+    {
+        liveTriangles[i] = adjacencyOffsets[i + 1] - adjacencyOffsets[i];
+    }
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<uint8_t> meshletSlots(vertexCount, NOT_IN_MESHLET);
+    // ǰڶѹ
+    std::array<uint32_t, MESHLET_MAX_VERTICES> meshletVertices{ };
+
+    Meshlet meshlet{ };
+    meshlet.vertexOffset = static_cast<uint32_t>(_data.vertices.size());
+    meshlet.triangleOffset = static_cast<uint32_t>(_data.triangles.size() / 3);
+    meshlet.indexRange = _indexRange;
+
+    auto finishMeshlet = [&]()
+    {
+        for (uint32_t i = 0; i < meshlet.vertexCount; ++i)
+        {
+            meshletSlots[meshletVertices[i]] = NOT_IN_MESHLET;
+        }
+        computeMeshletBounds(meshlet, _data, _positions);
+        _data.meshlets.push_back(meshlet);
+
+        meshlet = Meshlet{ };
+        meshlet.vertexOffset = static_cast<uint32_t>(_data.vertices.size());
+        meshlet.triangleOffset = static_cast<uint32_t>(_data.triangles.size() / 3);
+        meshlet.indexRange = _indexRange;
+    };
+
+    size_t seedTriangle = 0;
+    size_t emittedCount = 0;
+    while (emittedCount < triangleCount)
+    {
+        // 뵱ǰڵѡٵģѡʣٵ
+        uint32_t bestTriangle = UINT32_MAX;
+        uint32_t bestNewVertices = 4;
+        uint32_t bestLive = UINT32_MAX;
+        for (uint32_t i = 0; i < meshlet.vertexCount; ++i)
+        {
+            const uint32_t vertex = meshletVertices[i];
+            for (uint32_t a = adjacencyOffsets[vertex]; a < adjacencyOffsets[vertex + 1]; ++a)
+            {
+                const uint32_t triangle = adjacency[a];
+                if (emitted[triangle])
+                {
+                    continue;
+                }
+                uint32_t newVertices = 0;
+                uint32_t live = 0;
+                for (int corner = 0; corner < 3; ++corner)
+                {
+                    const uint32_t cornerVertex = triangleVertices[triangle * 3 + corner];
+                    newVertices += meshletSlots[cornerVertex] == NOT_IN_MESHLET ? 1 : 0;
+                    live += liveTriangles[cornerVertex];
+                }
+                if (newVertices < bestNewVertices || (newVertices == bestNewVertices && live < bestLive))
+                {
+                    bestTriangle = triangle;
+                    bestNewVertices = newVertices;
+                    bestLive = live;
+                }
+            }
+        }
+
+        // ûڵʱ˳ȡһ㻺Ż˳оֲ
+        if (bestTriangle == UINT32_MAX)
+        {
+            while (emitted[seedTriangle])
+            {
+                ++seedTriangle;
+            }
+            bestTriangle = static_cast<uint32_t>(seedTriangle);
+            bestNewVertices = 0;
+            for (int corner = 0; corner < 3; ++corner)
+            {
+                bestNewVertices += meshletSlots[triangleVertices[bestTriangle * 3 + corner]] == NOT_IN_MESHLET ? 1 : 0;
+            }
+        }
+
+        if (meshlet.vertexCount + bestNewVertices > MESHLET_MAX_VERTICES || meshlet.triangleCount + 1 > MESHLET_MAX_TRIANGLES)
+        {
+            finishMeshlet();
+            continue;
+        }
+
+        for (int corner = 0; corner < 3; ++corner)
+        {
+            const uint32_t vertex = triangleVertices[bestTriangle * 3 + corner];
+            if (meshletSlots[vertex] == NOT_IN_MESHLET)
+            {
+                meshletVertices[meshlet.vertexCount] = vertex;
+                meshletSlots[vertex] = static_cast<uint8_t>(meshlet.vertexCount++);
+                _data.vertices.push_back(sourceVertices[vertex]);
+            }
+            _data.triangles.push_back(meshletSlots[vertex]);
+            --liveTriangles[vertex];
+        }
+        ++meshlet.triangleCount;
+        emitted[bestTriangle] = true;
+        ++emittedCount;
+    }
+    finishMeshlet();
+}
+
+MeshletStatistics analyzeMeshlets(const Meshlet* _meshlets, size_t _meshletCount)
+{
+    MeshletStatistics statistics;
+    statistics.meshletCount = _meshletCount;
+    if (_meshletCount == 0)
+    {
+        return statistics;
+    }
+
+    size_t vertexCount = 0;
+    for (size_t i = 0; i < _meshletCount; ++i)
+    {
+        vertexCount += _meshlets[i].vertexCount;
+        statistics.triangleCount += _meshlets[i].triangleCount;
+    }
+    statistics.averageVertexCount = static_cast<float>(vertexCount) / _meshletCount;
+    statistics.averageTriangleCount = static_cast<float>(statistics.triangleCount) / _meshletCount;
+    statistics.vertexFill = statistics.averageVertexCount / MESHLET_MAX_VERTICES;
+    statistics.triangleFill = statistics.averageTriangleCount / MESHLET_MAX_TRIANGLES;
+    return statistics;
+}
+
+bool isMeshletBackfacing(const Meshlet& _meshlet, const glm::vec3& _cameraPosition)
+{
+    // ðΧ׶㣬ؽϽʱȻ
+    const glm::vec3 center(_meshlet.center[0], _meshlet.center[1], _meshlet.center[2]);
+    const glm::vec3 axis(_meshlet.coneAxis[0], _meshlet.coneAxis[1], _meshlet.coneAxis[2]);
+    const glm::vec3 view = center - _cameraPosition;
+    return glm::dot(view, axis) >= _meshlet.coneCutoff * glm::length(view) + _meshlet.radius;
+}
+
+bool validateMeshlets(const MeshletData& _data, const uint32_t* _vertexIndices, size_t _indexCount, const std::vector<glm::vec3>& _positions, std::string& _error)
+{
+    std::vector<std::array<uint32_t, 3>> expected;
+    for (size_t i = 0; i + 2 < _indexCount; i += 3)
+    {
+        expected.push_back({ _vertexIndices[i], _vertexIndices[i + 1], _vertexIndices[i + 2] });
+    }
+
+    std::vector<std::array<uint32_t, 3>> actual;
+    for (size_t m = 0; m < _data.meshlets.size(); ++m)
+    {
+        const Meshlet& meshlet = _data.meshlets[m];
+        if (meshlet.vertexCount > MESHLET_MAX_VERTICES || meshlet.triangleCount > MESHLET_MAX_TRIANGLES || meshlet.triangleCount == 0
+            || static_cast<size_t>(meshlet.vertexOffset) + meshlet.vertexCount > _data.vertices.size()
+            || (static_cast<size_t>(meshlet.triangleOffset) + meshlet.triangleCount) * 3 > _data.triangles.size())
+        {
+            _error = "meshlet " + std::to_string(m) + " exceeds its limits";
+            return false;
+        }
+        for (uint32_t i = 0; i < meshlet.triangleCount * 3; i += 3)
+        {
+            std::array<uint32_t, 3> triangle{ };
+            for (uint32_t corner = 0; corner < 3; ++corner)
+            {
+                const uint8_t localIndex = _data.triangles[static_cast<size_t>(meshlet.triangleOffset) * 3 + i + corner];
+                if (localIndex >= meshlet.vertexCount)
+                {
+                    _error = "meshlet " + std::to_string(m) + " has a local index out of range";
+                    return false;
+                }
+                triangle[corner] = _data.vertices[meshlet.vertexOffset + localIndex];
+            }
+            actual.push_back(triangle);
+        }
+
+        // ΧҪڵж
+        const glm::vec3 center(meshlet.center[0], meshlet.center[1], meshlet.center[2]);
+        for (uint32_t i = 0; i < meshlet.vertexCount; ++i)
+        {
+            if (glm::length(_positions[_data.vertices[meshlet.vertexOffset + i]] - center) > meshlet.radius * 1.0001f + 1e-6f)
+            {
+                _error = "meshlet " + std::to_string(m) + " bounding sphere misses a vertex";
+                return false;
+            }
+        }
+    }
+
+    std::sort(expected.begin(), expected.end());
+    std::sort(actual.begin(), actual.end());
+    if (expected != actual)
+    {
+        _error = "meshlet triangles differ from the source triangles (" + std::to_string(actual.size()) + " vs " + std::to_string(expected.size()) + ")";
+        return false;
+    }
+    return true;
+}
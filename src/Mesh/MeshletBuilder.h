@@ -0,0 +1,63 @@
+#ifndef GQY_MESHLET_BUILDER_H
+#define GQY_MESHLET_BUILDER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// ÿصĶޣȡɫõ 64 / 124
+const uint32_t MESHLET_MAX_VERTICES = 64;
+const uint32_t MESHLET_MAX_TRIANGLES = 124;
+
+// һ (64 ֽڣstd430 )getMeshletVertices()[vertexOffset, vertexOffset + vertexCount) Ϊڶڶ㻺еıţ
+// getMeshletTriangles()  triangleOffset * 3 ʼ triangleCount * 3 ֽΪھֲ
+// Χͷ׶ģͿռ䣬indexRange Ϊ䣬ͬһڲʼ¼ͬ
+struct Meshlet
+{
+    uint32_t vertexOffset;
+    uint32_t triangleOffset;
+    uint32_t vertexCount;
+    uint32_t triangleCount;
+    float center[3];
+    float radius;
+    float coneAxis[3];
+    float coneCutoff;
+    uint32_t indexRange;
+    uint32_t padding[3];
+};
+
+struct MeshletData
+{
+    std::vector<Meshlet> meshlets;
+    std::vector<uint32_t> vertices;
+    std::vector<uint8_t> triangles;
+};
+
+struct MeshletStatistics
+{
+    size_t meshletCount = 0;
+    size_t triangleCount = 0;
+    float averageVertexCount = 0.0f;
+    float averageTriangleCount = 0.0f;
+    // ƽ֮
+    float vertexFill = 0.0f;
+    float triangleFill = 0.0f;
+};
+
+//  _indexCount  (Ѽϻ׼㣬ֱָ _positions) ɵ̰ĵзֳɴأ׷ӵ _data
+// ÿȼ뵱ǰعöΣڿռΧͷ׶Ž
+void buildMeshlets(const uint32_t* _vertexIndices, size_t _indexCount, const std::vector<glm::vec3>& _positions, uint32_t _indexRange, MeshletData& _data);
+
+MeshletStatistics analyzeMeshlets(const Meshlet* _meshlets, size_t _meshletCount);
+
+// ׶޳λ _cameraPosition (ģͿռ) ʱζ
+// coneCutoff Ϊ 1 Ĵط߷ֲ̫ɢԶᱻ޳
+bool isMeshletBackfacing(const Meshlet& _meshlet, const glm::vec3& _cameraPosition);
+
+// صޡֲԼǷ _vertexIndices еһһӦ (˳)ʧʱ _error ˵ԭ
+bool validateMeshlets(const MeshletData& _data, const uint32_t* _vertexIndices, size_t _indexCount, const std::vector<glm::vec3>& _positions, std::string& _error);
+
+#endif
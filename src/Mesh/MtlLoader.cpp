@@ -0,0 +1,96 @@
+#include "MtlLoader.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#include "MappedFile.h"
+
+namespace
+{
+    inline bool isSpace(char _c)
+    {
+        return _c == ' ' || _c == '\t' || _c == '\r';
+    }
+
+    bool startsWithKeyword(const char* _token, const char* _lineEnd, const char* _keyword)
+    {
+        const size_t length = std::strlen(_keyword);
+        return static_cast<size_t>(_lineEnd - _token) > length && std::strncmp(_token, _keyword, length) == 0 && isSpace(_token[length]);
+    }
+
+    // map_Kd ǰܴ -s/-o ѡȡһΪļ
+    std::string getLastToken(const char* _p, const char* _lineEnd)
+    {
+        while (_lineEnd > _p && isSpace(_lineEnd[-1]))
+        {
+            --_lineEnd;
+        }
+        const char* begin = _lineEnd;
+        while (begin > _p && !isSpace(begin[-1]))
+        {
+            --begin;
+        }
+        return std::string(begin, _lineEnd);
+    }
+}
+
+bool loadMtl(const std::string& _filename, std::vector<ObjMaterial>& _materials)
+{
+    MappedFile file;
+    if (!file.open(_filename))
+    {
+        return false;
+    }
+
+    const char* p = file.data();
+    const char* end = p + file.size();
+    ObjMaterial* material = nullptr;
+    while (p < end)
+    {
+        const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (lineEnd == nullptr)
+        {
+            lineEnd = end;
+        }
+
+        const char* token = p;
+        while (token < lineEnd && isSpace(*token))
+        {
+            ++token;
+        }
+        p = lineEnd + 1;
+
+        if (startsWithKeyword(token, lineEnd, "newmtl"))
+        {
+            _materials.push_back(ObjMaterial{ getLastToken(token + 6, lineEnd), std::string() });
+            material = &_materials.back();
+        }
+        else if (material != nullptr && startsWithKeyword(token, lineEnd, "map_Kd"))
+        {
+            material->diffuseTexture = getLastToken(token + 6, lineEnd);
+        }
+        else if (material != nullptr && startsWithKeyword(token, lineEnd, "Kd"))
+        {
+            // ֻһʱͬ
+            const std::string values(token + 3, lineEnd);
+            char* next = nullptr;
+            float r = std::strtof(values.c_str(), &next);
+            const char* current = next;
+            float g = std::strtof(current, &next);
+            if (next == current)
+            {
+                g = r;
+            }
+            current = next;
+            float b = std::strtof(current, &next);
+            if (next == current)
+            {
+                b = g;
+            }
+            material->diffuseColor[0] = r;
+            material->diffuseColor[1] = g;
+            material->diffuseColor[2] = b;
+        }
+    }
+    return true;
+}
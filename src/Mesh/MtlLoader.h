@@ -0,0 +1,20 @@
+#ifndef GQY_MTL_LOADER_H
+#define GQY_MTL_LOADER_H
+
+#include <string>
+#include <vector>
+
+// Ŀǰֻõɫͼͼ· .mtl Ŀ¼
+// û Kd ʱɫʹֻͼĲʱͼԭɫ
+struct ObjMaterial
+{
+    std::string name;
+    std::string diffuseTexture;
+    float diffuseColor[3]{ 1.0f, 1.0f, 1.0f };
+};
+
+//  .mtl ļе newmtlKd  map_Kd˳׷ӵ _materials ( tinyobjloader Ĳʱһ)
+// ļ޷ʱ false
+bool loadMtl(const std::string& _filename, std::vector<ObjMaterial>& _materials);
+
+#endif
@@ -0,0 +1,679 @@
+#include "ObjLoader.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "common.h"
+#include "MappedFile.h"
+#include "ParallelFor.h"
+#include "VertexWeldTable.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double elapsedMilliseconds(Clock::time_point _start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - _start).count();
+    }
+
+    inline bool isSpace(char _c)
+    {
+        return _c == ' ' || _c == '\t';
+    }
+
+    inline bool isLineEnd(char _c)
+    {
+        return _c == '\n' || _c == '\r';
+    }
+
+    inline bool isDigit(char _c)
+    {
+        return _c >= '0' && _c <= '9';
+    }
+
+    inline const char* skipSpace(const char* _p, const char* _end)
+    {
+        while (_p < _end && isSpace(*_p))
+        {
+            ++_p;
+        }
+        return _p;
+    }
+
+    inline const char* findTokenEnd(const char* _p, const char* _end)
+    {
+        while (_p < _end && !isSpace(*_p) && !isLineEnd(*_p))
+        {
+            ++_p;
+        }
+        return _p;
+    }
+
+    //  tinyobjloader  tryParseDouble ʹͬ˳򣬱֤ĸλһ
+    bool tryParseDouble(const char* _begin, const char* _end, double& _result)
+    {
+        static const double powLut[]{ 1.0, 0.1, 0.01, 0.001, 0.0001, 0.00001, 0.000001, 0.0000001 };
+        const int lutEntries = static_cast<int>(sizeof(powLut) / sizeof(powLut[0]));
+
+        double mantissa = 0.0;
+        int exponent = 0;
+        char sign = '+';
+        char exponentSign = '+';
+        const char* current = _begin;
+        int read = 0;
+        bool leadingDecimalDots = false;
+
+        if (current == _end)
+        {
+            return false;
+        }
+
+        if (*current == '+' || *current == '-')
+        {
+            sign = *current;
+            ++current;
+            if (current != _end && *current == '.')
+            {
+                leadingDecimalDots = true;
+            }
+        }
+        else if (*current == '.')
+        {
+            leadingDecimalDots = true;
+        }
+        else if (!isDigit(*current))
+        {
+            return false;
+        }
+
+        if (!leadingDecimalDots)
+        {
+            while (current != _end && isDigit(*current))
+            {
+                mantissa *= 10;
+                mantissa += static_cast<int>(*current - '0');
+                ++current;
+                ++read;
+            }
+            if (read == 0)
+            {
+                return false;
+            }
+        }
+
+        if (current != _end && *current == '.')
+        {
+            ++current;
+            read = 1;
+            while (current != _end && isDigit(*current))
+            {
+                mantissa += static_cast<int>(*current - '0') * (read < lutEntries ? powLut[read] : std::pow(10.0, -read));
+                ++read;
+                ++current;
+            }
+        }
+
+        if (current != _end && (*current == 'e' || *current == 'E'))
+        {
+            ++current;
+            if (current != _end && (*current == '+' || *current == '-'))
+            {
+                exponentSign = *current;
+                ++current;
+            }
+            else if (current == _end || !isDigit(*current))
+            {
+                return false;
+            }
+
+            read = 0;
+            while (current != _end && isDigit(*current))
+            {
+                if (exponent > std::numeric_limits<int>::max() / 10)
+                {
+                    return false;
+                }
+                exponent *= 10;
+                exponent += static_cast<int>(*current - '0');
+                ++current;
+                ++read;
+            }
+            exponent *= (exponentSign == '+' ? 1 : -1);
+            if (read == 0)
+            {
+                return false;
+            }
+        }
+
+        _result = (sign == '+' ? 1 : -1) * (exponent ? std::ldexp(mantissa * std::pow(5.0, exponent), exponent) : mantissa);
+        return true;
+    }
+
+    const char* parseReal(const char* _p, const char* _end, float& _value, float _defaultValue = 0.0f)
+    {
+        _p = skipSpace(_p, _end);
+        const char* tokenEnd = findTokenEnd(_p, _end);
+
+        double value = 0.0;
+        _value = tryParseDouble(_p, tokenEnd, value) ? static_cast<float>(value) : _defaultValue;
+
+        return tokenEnd;
+    }
+
+    const char* parseInt(const char* _p, const char* _end, int32_t& _value)
+    {
+        bool negative = false;
+        if (_p < _end && (*_p == '+' || *_p == '-'))
+        {
+            negative = *_p == '-';
+            ++_p;
+        }
+
+        int64_t value = 0;
+        while (_p < _end && isDigit(*_p))
+        {
+            value = value * 10 + (*_p - '0');
+            if (value > std::numeric_limits<int32_t>::max())
+            {
+                value = 0;
+                break;
+            }
+            ++_p;
+        }
+
+        _value = static_cast<int32_t>(negative ? -value : value);
+        return _p;
+    }
+
+    inline const char* skipToSeparator(const char* _p, const char* _end)
+    {
+        while (_p < _end && *_p != '/' && !isSpace(*_p) && !isLineEnd(*_p))
+        {
+            ++_p;
+        }
+        return _p;
+    }
+}
+
+ObjLoader::ObjLoader(uint32_t _threadCount)
+    : m_threadCount(_threadCount == 0 ? getDefaultThreadCount() : _threadCount)
+{
+}
+
+void ObjLoader::load(const std::string& _filename, std::vector<Vertex>& _vertices, std::vector<uint32_t>& _vertexIndices)
+{
+    m_statistics = ObjLoadStatistics{ };
+    m_statistics.threadCount = m_threadCount;
+
+    Clock::time_point start = Clock::now();
+    MappedFile file;
+    if (!file.open(_filename))
+    {
+        throw std::runtime_error(setFontColor("Failed to open obj file: " + _filename, FontColor::Red));
+    }
+    m_statistics.fileSize = file.size();
+    m_statistics.mapMilliseconds = elapsedMilliseconds(start);
+
+    // пн
+    start = Clock::now();
+    splitChunks(file.data(), file.size());
+    parallelFor(m_chunks.size(), m_threadCount, [this](size_t _begin, size_t _end, uint32_t)
+    {
+        for (size_t i = _begin; i < _end; ++i)
+        {
+            parseChunk(m_chunks[i]);
+        }
+    });
+
+    size_t positionCount = 0;
+    size_t texCoordCount = 0;
+    size_t triangleCount = 0;
+    for (Chunk& chunk : m_chunks)
+    {
+        chunk.positionBase = positionCount;
+        chunk.texCoordBase = texCoordCount;
+        chunk.triangleBase = triangleCount;
+        positionCount += chunk.positions.size() / 3;
+        texCoordCount += chunk.texCoords.size() / 2;
+        triangleCount += chunk.triangleCount;
+    }
+    m_statistics.positionCount = positionCount;
+    m_statistics.texCoordCount = texCoordCount;
+    m_statistics.triangleCount = triangleCount;
+
+    const size_t separator = _filename.find_last_of("/\\");
+    resolveMaterials(separator == std::string::npos ? std::string() : _filename.substr(0, separator + 1));
+    m_statistics.materialCount = m_materials.size();
+
+    m_positions.resize(positionCount * 3);
+    m_texCoords.resize(texCoordCount * 2);
+    parallelFor(m_chunks.size(), m_threadCount, [this](size_t _begin, size_t _end, uint32_t)
+    {
+        for (size_t i = _begin; i < _end; ++i)
+        {
+            const Chunk& chunk = m_chunks[i];
+            std::copy(chunk.positions.begin(), chunk.positions.end(), m_positions.begin() + chunk.positionBase * 3);
+            std::copy(chunk.texCoords.begin(), chunk.texCoords.end(), m_texCoords.begin() + chunk.texCoordBase * 2);
+        }
+    });
+    m_statistics.parseMilliseconds = elapsedMilliseconds(start);
+
+    // ǻıΰ϶̵ĶԽз ( tinyobjloader ͬ)
+    start = Clock::now();
+    m_trianglePositions.resize(triangleCount * 3);
+    m_triangleTexCoords.resize(triangleCount * 3);
+    m_triangleMaterials.resize(triangleCount);
+    parallelFor(m_chunks.size(), m_threadCount, [this](size_t _begin, size_t _end, uint32_t)
+    {
+        for (size_t i = _begin; i < _end; ++i)
+        {
+            triangulateChunk(m_chunks[i]);
+        }
+    });
+    m_chunks.clear();
+    m_statistics.triangulateMilliseconds = elapsedMilliseconds(start);
+
+    start = Clock::now();
+    weld(_vertices, _vertexIndices);
+    m_statistics.weldMilliseconds = elapsedMilliseconds(start);
+
+    m_positions.clear();
+    m_texCoords.clear();
+    m_trianglePositions.clear();
+    m_triangleTexCoords.clear();
+}
+
+void ObjLoader::splitChunks(const char* _data, size_t _size)
+{
+    const size_t minimumChunkSize = 64 * 1024;
+    size_t chunkCount = std::max<size_t>(1, std::min<size_t>(static_cast<size_t>(m_threadCount) * 4, _size / minimumChunkSize));
+
+    m_chunks.clear();
+    m_chunks.reserve(chunkCount);
+
+    const char* end = _data + _size;
+    const char* chunkBegin = _data;
+    for (size_t i = 1; i <= chunkCount && chunkBegin < end; ++i)
+    {
+        const char* chunkEnd = end;
+        if (i < chunkCount)
+        {
+            chunkEnd = std::max(chunkBegin, _data + _size * i / chunkCount);
+            const char* newline = static_cast<const char*>(std::memchr(chunkEnd, '\n', end - chunkEnd));
+            chunkEnd = newline == nullptr ? end : newline + 1;
+        }
+
+        Chunk chunk;
+        chunk.begin = chunkBegin;
+        chunk.end = chunkEnd;
+        m_chunks.push_back(std::move(chunk));
+
+        chunkBegin = chunkEnd;
+    }
+}
+
+void ObjLoader::resolveMaterials(const std::string& _directory)
+{
+    // ȼȫ mtllibٰ˳ usemtl ĲɱţÿĲʴһ
+    m_materials.clear();
+    for (const Chunk& chunk : m_chunks)
+    {
+        for (const std::string& library : chunk.materialLibraries)
+        {
+            loadMtl(_directory + library, m_materials);
+        }
+    }
+
+    std::unordered_map<std::string, int32_t> materialIds;
+    for (size_t i = 0; i < m_materials.size(); ++i)
+    {
+        materialIds[m_materials[i].name] = static_cast<int32_t>(i);
+    }
+
+    int32_t material = -1;
+    for (Chunk& chunk : m_chunks)
+    {
+        chunk.initialMaterial = material;
+        chunk.switchMaterials.clear();
+        for (const auto& materialSwitch : chunk.materialSwitches)
+        {
+            auto materialId = materialIds.find(materialSwitch.second);
+            material = materialId == materialIds.end() ? -1 : materialId->second;
+            chunk.switchMaterials.push_back(material);
+        }
+    }
+}
+
+void ObjLoader::parseChunk(Chunk& _chunk)
+{
+    const char* p = _chunk.begin;
+    const char* end = _chunk.end;
+
+    while (p < end)
+    {
+        const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (lineEnd == nullptr)
+        {
+            lineEnd = end;
+        }
+
+        const char* token = skipSpace(p, lineEnd);
+        p = lineEnd + 1;
+
+        if (lineEnd - token < 2 || token[0] == '#')
+        {
+            continue;
+        }
+
+        if (token[0] == 'v' && isSpace(token[1]))
+        {
+            float x, y, z;
+            token = parseReal(token + 2, lineEnd, x);
+            token = parseReal(token, lineEnd, y);
+            parseReal(token, lineEnd, z);
+            _chunk.positions.push_back(x);
+            _chunk.positions.push_back(y);
+            _chunk.positions.push_back(z);
+        }
+        else if (token[0] == 'v' && token[1] == 't' && lineEnd - token > 2 && isSpace(token[2]))
+        {
+            float u, v;
+            token = parseReal(token + 3, lineEnd, u);
+            parseReal(token, lineEnd, v);
+            _chunk.texCoords.push_back(u);
+            _chunk.texCoords.push_back(v);
+        }
+        else if (token[0] == 'f' && isSpace(token[1]))
+        {
+            const int32_t localPositionCount = static_cast<int32_t>(_chunk.positions.size() / 3);
+            const int32_t localTexCoordCount = static_cast<int32_t>(_chunk.texCoords.size() / 2);
+
+            uint32_t faceSize = 0;
+            token = skipSpace(token + 2, lineEnd);
+            while (token < lineEnd && !isLineEnd(*token))
+            {
+                int32_t positionIndex = 0;
+                int32_t texCoordIndex = 0;
+                bool hasTexCoord = false;
+
+                token = skipToSeparator(parseInt(token, lineEnd, positionIndex), lineEnd);
+                if (token < lineEnd && *token == '/')
+                {
+                    ++token;
+                    if (token < lineEnd && *token != '/')
+                    {
+                        int32_t rawTexCoordIndex = 0;
+                        token = parseInt(token, lineEnd, rawTexCoordIndex);
+                        if (rawTexCoordIndex == 0)
+                        {
+                            throw std::runtime_error(setFontColor("Failed to parse 'f' line: zero texcoord index", FontColor::Red));
+                        }
+                        texCoordIndex = rawTexCoordIndex;
+                        hasTexCoord = true;
+                    }
+                    token = skipToSeparator(token, lineEnd);
+                    if (token < lineEnd && *token == '/')
+                    {
+                        // Ŀǰʹ
+                        token = skipToSeparator(token + 1, lineEnd);
+                    }
+                }
+
+                if (positionIndex == 0)
+                {
+                    throw std::runtime_error(setFontColor("Failed to parse 'f' line: zero or missing vertex index", FontColor::Red));
+                }
+
+                const size_t corner = _chunk.cornerPositions.size();
+                if (positionIndex > 0)
+                {
+                    _chunk.cornerPositions.push_back(positionIndex - 1);
+                }
+                else
+                {
+                    _chunk.cornerPositions.push_back(localPositionCount + positionIndex);
+                    _chunk.relativePositionCorners.push_back(corner);
+                }
+
+                if (!hasTexCoord)
+                {
+                    _chunk.cornerTexCoords.push_back(-1);
+                }
+                else if (texCoordIndex > 0)
+                {
+                    _chunk.cornerTexCoords.push_back(texCoordIndex - 1);
+                }
+                else
+                {
+                    _chunk.cornerTexCoords.push_back(localTexCoordCount + texCoordIndex);
+                    _chunk.relativeTexCoordCorners.push_back(corner);
+                }
+
+                ++faceSize;
+                token = skipSpace(token, lineEnd);
+            }
+
+            _chunk.faceSizes.push_back(faceSize);
+            if (faceSize >= 3)
+            {
+                _chunk.triangleCount += faceSize - 2;
+            }
+        }
+        else if (lineEnd - token > 7 && std::strncmp(token, "usemtl", 6) == 0 && isSpace(token[6]))
+        {
+            const char* name = skipSpace(token + 7, lineEnd);
+            _chunk.materialSwitches.emplace_back(_chunk.faceSizes.size(), std::string(name, findTokenEnd(name, lineEnd)));
+        }
+        else if (lineEnd - token > 7 && std::strncmp(token, "mtllib", 6) == 0 && isSpace(token[6]))
+        {
+            token = skipSpace(token + 7, lineEnd);
+            while (token < lineEnd && !isLineEnd(*token))
+            {
+                const char* nameEnd = findTokenEnd(token, lineEnd);
+                _chunk.materialLibraries.emplace_back(token, nameEnd);
+                token = skipSpace(nameEnd, lineEnd);
+            }
+        }
+    }
+}
+
+void ObjLoader::triangulateChunk(const Chunk& _chunk)
+{
+    // ֻڿڿɼʱȼΪֵﲹϿ֮ǰļ
+    std::vector<int32_t> positions = _chunk.cornerPositions;
+    std::vector<int32_t> texCoords = _chunk.cornerTexCoords;
+    for (size_t corner : _chunk.relativePositionCorners)
+    {
+        positions[corner] += static_cast<int32_t>(_chunk.positionBase);
+    }
+    for (size_t corner : _chunk.relativeTexCoordCorners)
+    {
+        texCoords[corner] += static_cast<int32_t>(_chunk.texCoordBase);
+    }
+
+    const int32_t positionCount = static_cast<int32_t>(m_positions.size() / 3);
+    const int32_t texCoordCount = static_cast<int32_t>(m_texCoords.size() / 2);
+    for (size_t corner = 0; corner < positions.size(); ++corner)
+    {
+        if (positions[corner] < 0 || positions[corner] >= positionCount || texCoords[corner] < -1 || texCoords[corner] >= texCoordCount)
+        {
+            throw std::runtime_error(setFontColor("Face index out of range in obj file", FontColor::Red));
+        }
+    }
+
+    size_t triangle = _chunk.triangleBase;
+    int32_t material = _chunk.initialMaterial;
+    auto emitTriangle = [&](size_t _a, size_t _b, size_t _c)
+    {
+        m_triangleMaterials[triangle] = material;
+        m_trianglePositions[triangle * 3 + 0] = positions[_a];
+        m_trianglePositions[triangle * 3 + 1] = positions[_b];
+        m_trianglePositions[triangle * 3 + 2] = positions[_c];
+        m_triangleTexCoords[triangle * 3 + 0] = texCoords[_a];
+        m_triangleTexCoords[triangle * 3 + 1] = texCoords[_b];
+        m_triangleTexCoords[triangle * 3 + 2] = texCoords[_c];
+        ++triangle;
+    };
+    auto squaredDistance = [this, &positions](size_t _a, size_t _b)
+    {
+        const float* a = &m_positions[static_cast<size_t>(positions[_a]) * 3];
+        const float* b = &m_positions[static_cast<size_t>(positions[_b]) * 3];
+        float x = b[0] - a[0];
+        float y = b[1] - a[1];
+        float z = b[2] - a[2];
+        return x * x + y * y + z * z;
+    };
+
+    size_t first = 0;
+    size_t nextSwitch = 0;
+    for (size_t face = 0; face < _chunk.faceSizes.size(); ++face)
+    {
+        while (nextSwitch < _chunk.materialSwitches.size() && _chunk.materialSwitches[nextSwitch].first == face)
+        {
+            material = _chunk.switchMaterials[nextSwitch++];
+        }
+
+        const uint32_t faceSize = _chunk.faceSizes[face];
+        if (faceSize == 3)
+        {
+            emitTriangle(first, first + 1, first + 2);
+        }
+        else if (faceSize == 4)
+        {
+            if (squaredDistance(first, first + 2) < squaredDistance(first + 1, first + 3))
+            {
+                emitTriangle(first, first + 1, first + 2);
+                emitTriangle(first, first + 2, first + 3);
+            }
+            else
+            {
+                emitTriangle(first, first + 1, first + 3);
+                emitTriangle(first + 1, first + 2, first + 3);
+            }
+        }
+        else if (faceSize > 4)
+        {
+            for (uint32_t i = 1; i + 1 < faceSize; ++i)
+            {
+                emitTriangle(first, first + i, first + i + 1);
+            }
+        }
+        first += faceSize;
+    }
+}
+
+void ObjLoader::weld(std::vector<Vertex>& _vertices, std::vector<uint32_t>& _vertexIndices)
+{
+    const size_t cornerCount = m_trianglePositions.size();
+    if (cornerCount > std::numeric_limits<uint32_t>::max())
+    {
+        throw std::runtime_error(setFontColor("Too many vertex indices in obj file", FontColor::Red));
+    }
+
+    // ϣֵѶ㻮ָ̣߳ÿֻ߳ΪԼĶ¼״γֵλã
+    // ȥؽ뵥̰߳˳ unordered_map ȫͬ
+    std::vector<uint64_t> hashes(cornerCount);
+    parallelFor(cornerCount, m_threadCount, [&](size_t _begin, size_t _end, uint32_t)
+    {
+        for (size_t i = _begin; i < _end; ++i)
+        {
+            hashes[i] = VertexWeldTable::hashVertex(makeVertex(i));
+        }
+    });
+
+    std::vector<uint32_t> firstCorners(cornerCount);
+    const uint32_t partitionCount = m_threadCount;
+    parallelFor(partitionCount, partitionCount, [&](size_t _begin, size_t _end, uint32_t)
+    {
+        for (size_t partition = _begin; partition < _end; ++partition)
+        {
+            // ϣʹùϣֵĵλø 32 λ߳
+            VertexWeldTable uniqueVertices(cornerCount / partitionCount / 4);
+            for (size_t i = 0; i < cornerCount; ++i)
+            {
+                if (((hashes[i] >> 32) * partitionCount) >> 32 == partition)
+                {
+                    firstCorners[i] = uniqueVertices.findOrInsert(makeVertex(i), hashes[i], static_cast<uint32_t>(i));
+                }
+            }
+        }
+    });
+    hashes.clear();
+    hashes.shrink_to_fit();
+
+    // "״γ"ǰ׺͵õ
+    const uint32_t blockCount = m_threadCount;
+    std::vector<size_t> blockOffsets(static_cast<size_t>(blockCount) + 1, 0);
+    parallelFor(cornerCount, blockCount, [&](size_t _begin, size_t _end, uint32_t _block)
+    {
+        size_t count = 0;
+        for (size_t i = _begin; i < _end; ++i)
+        {
+            count += firstCorners[i] == i ? 1 : 0;
+        }
+        blockOffsets[_block + 1] = count;
+    });
+    for (size_t i = 1; i < blockOffsets.size(); ++i)
+    {
+        blockOffsets[i] += blockOffsets[i - 1];
+    }
+
+    _vertices.resize(blockOffsets.back());
+    std::vector<uint32_t> vertexIds(cornerCount);
+    parallelFor(cornerCount, blockCount, [&](size_t _begin, size_t _end, uint32_t _block)
+    {
+        size_t vertexId = blockOffsets[_block];
+        for (size_t i = _begin; i < _end; ++i)
+        {
+            if (firstCorners[i] == i)
+            {
+                vertexIds[i] = static_cast<uint32_t>(vertexId);
+                _vertices[vertexId] = makeVertex(i);
+                ++vertexId;
+            }
+        }
+    });
+
+    _vertexIndices.resize(cornerCount);
+    parallelFor(cornerCount, m_threadCount, [&](size_t _begin, size_t _end, uint32_t)
+    {
+        for (size_t i = _begin; i < _end; ++i)
+        {
+            _vertexIndices[i] = vertexIds[firstCorners[i]];
+        }
+    });
+}
+
+Vertex ObjLoader::makeVertex(size_t _corner) const
+{
+    const size_t positionIndex = static_cast<size_t>(m_trianglePositions[_corner]);
+    const int32_t texCoordIndex = m_triangleTexCoords[_corner];
+
+    Vertex vertex{ };
+    vertex.positionOS =
+    {
+        m_positions[3 * positionIndex + 0],
+        m_positions[3 * positionIndex + 1],
+        m_positions[3 * positionIndex + 2]
+    };
+    if (texCoordIndex >= 0)
+    {
+        vertex.texCoord =
+        {
+            m_texCoords[2 * static_cast<size_t>(texCoordIndex) + 0],
+            1.0f - m_texCoords[2 * static_cast<size_t>(texCoordIndex) + 1]
+        };
+    }
+    else
+    {
+        vertex.texCoord = { 0.0f, 1.0f };
+    }
+    vertex.color = { 1.0f, 1.0f, 1.0f };
+
+    return vertex;
+}
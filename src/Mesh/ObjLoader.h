@@ -0,0 +1,95 @@
+#ifndef GQY_OBJ_LOADER_H
+#define GQY_OBJ_LOADER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "MtlLoader.h"
+#include "Vertex.h"
+
+struct ObjLoadStatistics
+{
+    uint32_t threadCount = 0;
+    size_t fileSize = 0;
+    size_t positionCount = 0;
+    size_t texCoordCount = 0;
+    size_t triangleCount = 0;
+    size_t materialCount = 0;
+    double mapMilliseconds = 0.0;
+    double parseMilliseconds = 0.0;
+    double triangulateMilliseconds = 0.0;
+    double weldMilliseconds = 0.0;
+
+    double totalMilliseconds() const { return mapMilliseconds + parseMilliseconds + triangulateMilliseconds + weldMilliseconds; }
+};
+
+// ߳ OBJ ڴӳļзֳɿ鲢н v/vt/f
+// ٲкظ㡣 tinyobj::LoadObj + std::unordered_map ȥصĽһ
+// (㰴״γֵ˳ţʽ tinyobjloader ͬ)
+class ObjLoader
+{
+public:
+    explicit ObjLoader(uint32_t _threadCount = 0);
+
+    void load(const std::string& _filename, std::vector<Vertex>& _vertices, std::vector<uint32_t>& _vertexIndices);
+
+    const ObjLoadStatistics& getStatistics() const { return m_statistics; }
+    // mtllib õȫʣԼÿ usemtl ָĲʱ (-1 ʾûв)
+    const std::vector<ObjMaterial>& getMaterials() const { return m_materials; }
+    const std::vector<int32_t>& getTriangleMaterials() const { return m_triangleMaterials; }
+
+private:
+    struct Chunk
+    {
+        const char* begin = nullptr;
+        const char* end = nullptr;
+
+        std::vector<float> positions;
+        std::vector<float> texCoords;
+
+        // ÿεĶԼǵλ/
+        std::vector<uint32_t> faceSizes;
+        std::vector<int32_t> cornerPositions;
+        std::vector<int32_t> cornerTexCoords;
+
+        // ()ȽΪԱֵϲʱټϱ֮ǰļ
+        std::vector<size_t> relativePositionCorners;
+        std::vector<size_t> relativeTexCoordCorners;
+
+        // usemtl ǰеϲʱΪʱ
+        std::vector<std::pair<size_t, std::string>> materialSwitches;
+        std::vector<int32_t> switchMaterials;
+        std::vector<std::string> materialLibraries;
+        int32_t initialMaterial = -1;
+
+        size_t positionBase = 0;
+        size_t texCoordBase = 0;
+        size_t triangleCount = 0;
+        size_t triangleBase = 0;
+    };
+
+    void splitChunks(const char* _data, size_t _size);
+    void resolveMaterials(const std::string& _directory);
+    void parseChunk(Chunk& _chunk);
+    void triangulateChunk(const Chunk& _chunk);
+    void weld(std::vector<Vertex>& _vertices, std::vector<uint32_t>& _vertexIndices);
+
+    Vertex makeVertex(size_t _corner) const;
+
+private:
+    uint32_t m_threadCount = 1;
+    ObjLoadStatistics m_statistics;
+
+    std::vector<Chunk> m_chunks;
+
+    std::vector<float> m_positions;
+    std::vector<float> m_texCoords;
+    std::vector<int32_t> m_trianglePositions;
+    std::vector<int32_t> m_triangleTexCoords;
+
+    std::vector<ObjMaterial> m_materials;
+    std::vector<int32_t> m_triangleMaterials;
+};
+
+#endif
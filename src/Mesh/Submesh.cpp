@@ -0,0 +1,99 @@
+#include "Submesh.h"
+
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+
+std::vector<Submesh> groupTrianglesByMaterial(std::vector<uint32_t>& _vertexIndices, const std::vector<int32_t>& _triangleMaterials,
+    const std::vector<ObjMaterial>& _materials, std::vector<std::string>& _textures, std::vector<MeshMaterial>& _meshMaterials)
+{
+    // ͼ״αõ˳
+    _textures.clear();
+    std::unordered_map<std::string, uint32_t> textureIds;
+    std::vector<uint32_t> materialTextures(_materials.size(), Submesh::NO_TEXTURE);
+    for (size_t i = 0; i < _materials.size(); ++i)
+    {
+        const std::string& texture = _materials[i].diffuseTexture;
+        if (texture.empty())
+        {
+            continue;
+        }
+        auto textureId = textureIds.find(texture);
+        if (textureId == textureIds.end())
+        {
+            textureId = textureIds.emplace(texture, static_cast<uint32_t>(_textures.size())).first;
+            _textures.push_back(texture);
+        }
+        materialTextures[i] = textureId->second;
+    }
+
+    _meshMaterials.clear();
+    for (size_t i = 0; i < _materials.size(); ++i)
+    {
+        const float* color = _materials[i].diffuseColor;
+        _meshMaterials.push_back(MeshMaterial{ { color[0], color[1], color[2], 1.0f }, materialTextures[i], { 0, 0, 0 } });
+    }
+    _meshMaterials.push_back(MeshMaterial{ { 1.0f, 1.0f, 1.0f, 1.0f }, Submesh::NO_TEXTURE, { 0, 0, 0 } });
+
+    // һλûвʵΣλ (ͼ, ) 
+    const size_t slotCount = _materials.size() + 1;
+    auto getSlotTexture = [&](size_t _slot)
+    {
+        return _slot < _materials.size() ? materialTextures[_slot] : Submesh::NO_TEXTURE;
+    };
+    std::vector<uint32_t> slotOrder(slotCount);
+    std::iota(slotOrder.begin(), slotOrder.end(), 0u);
+    std::stable_sort(slotOrder.begin(), slotOrder.end(), [&](uint32_t _a, uint32_t _b)
+    {
+        return getSlotTexture(_a) < getSlotTexture(_b);
+    });
+    std::vector<uint32_t> slotRanks(slotCount);
+    for (uint32_t rank = 0; rank < slotCount; ++rank)
+    {
+        slotRanks[slotOrder[rank]] = rank;
+    }
+
+    const size_t triangleCount = _vertexIndices.size() / 3;
+    auto getTriangleRank = [&](size_t _triangle)
+    {
+        const int32_t material = _triangle < _triangleMaterials.size() ? _triangleMaterials[_triangle] : -1;
+        const size_t slot = material >= 0 && static_cast<size_t>(material) < _materials.size() ? static_cast<size_t>(material) : _materials.size();
+        return slotRanks[slot];
+    };
+
+    std::vector<size_t> rankOffsets(slotCount + 1, 0);
+    for (size_t triangle = 0; triangle < triangleCount; ++triangle)
+    {
+        ++rankOffsets[getTriangleRank(triangle) + 1];
+    }
+    for (size_t rank = 1; rank <= slotCount; ++rank)
+    {
+        rankOffsets[rank] += rankOffsets[rank - 1];
+    }
+
+    std::vector<Submesh> submeshes;
+    for (size_t rank = 0; rank < slotCount; ++rank)
+    {
+        if (rankOffsets[rank + 1] == rankOffsets[rank])
+        {
+            continue;
+        }
+        const size_t slot = slotOrder[rank];
+        submeshes.push_back(Submesh
+        {
+            static_cast<uint32_t>(rankOffsets[rank] * 3),                                   // firstIndex
+            static_cast<uint32_t>((rankOffsets[rank + 1] - rankOffsets[rank]) * 3),         // indexCount
+            static_cast<uint32_t>(slot),                                                    // materialIndex
+            getSlotTexture(slot)                                                            // textureIndex
+        });
+    }
+
+    std::vector<uint32_t> vertexIndices(triangleCount * 3);
+    for (size_t triangle = 0; triangle < triangleCount; ++triangle)
+    {
+        const size_t target = rankOffsets[getTriangleRank(triangle)]++;
+        std::copy_n(_vertexIndices.begin() + triangle * 3, 3, vertexIndices.begin() + target * 3);
+    }
+    _vertexIndices.swap(vertexIndices);
+    return submeshes;
+}
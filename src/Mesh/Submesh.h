@@ -0,0 +1,41 @@
+#ifndef GQY_SUBMESH_H
+#define GQY_SUBMESH_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "MtlLoader.h"
+
+// ϴʻĲʼ¼ɫ std430 ֵ Material һ
+struct MeshMaterial
+{
+    float baseColor[4];
+    uint32_t textureIndex;
+    uint32_t padding[3];
+};
+
+inline bool isSameMaterial(const MeshMaterial& _a, const MeshMaterial& _b)
+{
+    return std::memcmp(&_a, &_b, sizeof(MeshMaterial)) == 0;
+}
+
+// ʹͬһʵһmaterialIndex ָĲбtextureIndex ָͼб
+struct Submesh
+{
+    static constexpr uint32_t NO_TEXTURE = UINT32_MAX;
+
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    uint32_t materialIndex;
+    uint32_t textureIndex;
+};
+
+//  (ͼ, ) ȶļʹͬһʵͼĲڣ
+// ûвʻͼ_textures ȥغͼ· ( .mtl Ŀ¼)
+// _meshMaterials Ϊÿ .obj ɲʼ¼һû usemtl ʹ
+std::vector<Submesh> groupTrianglesByMaterial(std::vector<uint32_t>& _vertexIndices, const std::vector<int32_t>& _triangleMaterials,
+    const std::vector<ObjMaterial>& _materials, std::vector<std::string>& _textures, std::vector<MeshMaterial>& _meshMaterials);
+
+#endif
@@ -0,0 +1,6 @@
+#include "Vertex.h"
+
+bool Vertex::operator == (const Vertex& _vertex) const
+{
+    return positionOS == _vertex.positionOS && color == _vertex.color && texCoord == _vertex.texCoord;
+}
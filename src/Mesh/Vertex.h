@@ -0,0 +1,29 @@
+#ifndef GQY_VERTEX_H
+#define GQY_VERTEX_H
+
+#include <glm/glm.hpp>
+#include <glm/gtx/hash.hpp>
+
+#include <functional>
+
+struct Vertex
+{
+    glm::vec3 positionOS;
+    glm::vec3 color;
+    glm::vec2 texCoord;
+
+    bool operator == (const Vertex& _vertex) const;
+};
+
+namespace std
+{
+    template<> struct hash<Vertex>
+    {
+        size_t operator()(Vertex const& _vertex) const
+        {
+            return ((hash<glm::vec3>()(_vertex.positionOS) ^ (hash<glm::vec3>()(_vertex.color) << 1)) >> 1) ^ (hash<glm::vec2>()(_vertex.texCoord) << 1);
+        }
+    };
+}
+
+#endif
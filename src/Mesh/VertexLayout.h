@@ -0,0 +1,279 @@
+#ifndef GQY_VERTEX_LAYOUT_H
+#define GQY_VERTEX_LAYOUT_H
+
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Vertex.h"
+
+// ϴ GPU ĶʽءȥغŻ׶ʼʹȫȵ Vertex
+// 񻺴ʱٱɱѡĸʽ (CMake ѡ VERTEX_LAYOUT)
+enum class VertexLayoutType : uint32_t
+{
+    Full = 1,
+    Compact = 2,
+    Quantized = 3
+};
+
+struct VertexAttribute
+{
+    VkFormat format;
+    uint32_t offset;
+};
+
+// λpositionOS = positionOffset + unorm * positionScale
+struct VertexQuantization
+{
+    glm::vec3 positionOffset{ 0.0f };
+    glm::vec3 positionScale{ 1.0f };
+
+    static VertexQuantization fromBounds(const std::vector<Vertex>& _vertices)
+    {
+        VertexQuantization quantization{ };
+        if (_vertices.empty())
+        {
+            return quantization;
+        }
+
+        glm::vec3 minimum = _vertices[0].positionOS;
+        glm::vec3 maximum = _vertices[0].positionOS;
+        for (const Vertex& vertex : _vertices)
+        {
+            minimum = glm::min(minimum, vertex.positionOS);
+            maximum = glm::max(maximum, vertex.positionOS);
+        }
+
+        quantization.positionOffset = minimum;
+        quantization.positionScale = glm::max(maximum - minimum, glm::vec3(1e-20f));
+        return quantization;
+    }
+
+    // ɫ UNORM Զ [0, 1] ֵԸþԭģͿռλ
+    glm::mat4 getDequantizationMatrix() const
+    {
+        glm::mat4 matrix(1.0f);
+        matrix[0][0] = positionScale.x;
+        matrix[1][1] = positionScale.y;
+        matrix[2][2] = positionScale.z;
+        matrix[3] = glm::vec4(positionOffset, 1.0f);
+        return matrix;
+    }
+};
+
+// 32 ֽڣfloat λáɫ꣬ԭ Vertex ͬ
+struct FullVertexLayout
+{
+    struct Element
+    {
+        glm::vec3 positionOS;
+        glm::vec3 color;
+        glm::vec2 texCoord;
+    };
+
+    static constexpr VertexLayoutType TYPE = VertexLayoutType::Full;
+    static constexpr const char* NAME = "full";
+    static constexpr const char* SHADER_NAME = "shader.vert.spv";
+    static constexpr std::array<VertexAttribute, 3> ATTRIBUTES
+    {
+        {
+            { VK_FORMAT_R32G32B32_SFLOAT, static_cast<uint32_t>(offsetof(Element, positionOS)) },
+            { VK_FORMAT_R32G32B32_SFLOAT, static_cast<uint32_t>(offsetof(Element, color)) },
+            { VK_FORMAT_R32G32_SFLOAT, static_cast<uint32_t>(offsetof(Element, texCoord)) }
+        }
+    };
+
+    static VertexQuantization computeQuantization(const std::vector<Vertex>&)
+    {
+        return VertexQuantization{ };
+    }
+
+    static Element encode(const Vertex& _vertex, const VertexQuantization&)
+    {
+        return Element{ _vertex.positionOS, _vertex.color, _vertex.texCoord };
+    }
+
+    static Vertex decode(const Element& _element, const VertexQuantization&)
+    {
+        return Vertex{ _element.positionOS, _element.color, _element.texCoord };
+    }
+};
+
+// 16 ֽڣfloat λ + half ꣬ȥΪɫĶɫ
+struct CompactVertexLayout
+{
+    struct Element
+    {
+        glm::vec3 positionOS;
+        uint16_t texCoord[2];
+    };
+
+    static constexpr VertexLayoutType TYPE = VertexLayoutType::Compact;
+    static constexpr const char* NAME = "compact";
+    static constexpr const char* SHADER_NAME = "shader_compact.vert.spv";
+    static constexpr std::array<VertexAttribute, 2> ATTRIBUTES
+    {
+        {
+            { VK_FORMAT_R32G32B32_SFLOAT, static_cast<uint32_t>(offsetof(Element, positionOS)) },
+            { VK_FORMAT_R16G16_SFLOAT, static_cast<uint32_t>(offsetof(Element, texCoord)) }
+        }
+    };
+
+    static VertexQuantization computeQuantization(const std::vector<Vertex>&)
+    {
+        return VertexQuantization{ };
+    }
+
+    static Element encode(const Vertex& _vertex, const VertexQuantization&)
+    {
+        return Element
+        {
+            _vertex.positionOS,
+            { glm::packHalf1x16(_vertex.texCoord.x), glm::packHalf1x16(_vertex.texCoord.y) }
+        };
+    }
+
+    static Vertex decode(const Element& _element, const VertexQuantization&)
+    {
+        return Vertex
+        {
+            _element.positionOS,
+            glm::vec3(1.0f),
+            glm::vec2(glm::unpackHalf1x16(_element.texCoord[0]), glm::unpackHalf1x16(_element.texCoord[1]))
+        };
+    }
+};
+
+// 12 ֽڣΧ 16 λһλ (ĸڶ) + half 
+struct QuantizedVertexLayout
+{
+    struct Element
+    {
+        uint16_t positionOS[4];
+        uint16_t texCoord[2];
+    };
+
+    static constexpr VertexLayoutType TYPE = VertexLayoutType::Quantized;
+    static constexpr const char* NAME = "quantized";
+    static constexpr const char* SHADER_NAME = "shader_quantized.vert.spv";
+    static constexpr std::array<VertexAttribute, 2> ATTRIBUTES
+    {
+        {
+            { VK_FORMAT_R16G16B16A16_UNORM, static_cast<uint32_t>(offsetof(Element, positionOS)) },
+            { VK_FORMAT_R16G16_SFLOAT, static_cast<uint32_t>(offsetof(Element, texCoord)) }
+        }
+    };
+
+    static VertexQuantization computeQuantization(const std::vector<Vertex>& _vertices)
+    {
+        return VertexQuantization::fromBounds(_vertices);
+    }
+
+    static Element encode(const Vertex& _vertex, const VertexQuantization& _quantization)
+    {
+        glm::vec3 normalized = glm::clamp((_vertex.positionOS - _quantization.positionOffset) / _quantization.positionScale, glm::vec3(0.0f), glm::vec3(1.0f));
+        return Element
+        {
+            {
+                static_cast<uint16_t>(std::lround(normalized.x * 65535.0f)),
+                static_cast<uint16_t>(std::lround(normalized.y * 65535.0f)),
+                static_cast<uint16_t>(std::lround(normalized.z * 65535.0f)),
+                0
+            },
+            { glm::packHalf1x16(_vertex.texCoord.x), glm::packHalf1x16(_vertex.texCoord.y) }
+        };
+    }
+
+    static Vertex decode(const Element& _element, const VertexQuantization& _quantization)
+    {
+        glm::vec3 normalized(_element.positionOS[0] / 65535.0f, _element.positionOS[1] / 65535.0f, _element.positionOS[2] / 65535.0f);
+        return Vertex
+        {
+            _quantization.positionOffset + normalized * _quantization.positionScale,
+            glm::vec3(1.0f),
+            glm::vec2(glm::unpackHalf1x16(_element.texCoord[0]), glm::unpackHalf1x16(_element.texCoord[1]))
+        };
+    }
+};
+
+// ݲڱɶ
+template<typename Layout>
+struct VertexLayoutTraits
+{
+    static constexpr size_t ATTRIBUTE_COUNT = Layout::ATTRIBUTES.size();
+
+    static constexpr VkVertexInputBindingDescription getBindingDescription()
+    {
+        return VkVertexInputBindingDescription
+        {
+            0,                                                      // binding
+            static_cast<uint32_t>(sizeof(typename Layout::Element)),// stride
+            VK_VERTEX_INPUT_RATE_VERTEX                             // inputRate
+        };
+    }
+
+    static constexpr std::array<VkVertexInputAttributeDescription, ATTRIBUTE_COUNT> getAttributeDescriptions()
+    {
+        std::array<VkVertexInputAttributeDescription, ATTRIBUTE_COUNT> vertexInputAttributeDescriptions{ };
+        for (size_t i = 0; i < ATTRIBUTE_COUNT; ++i)
+        {
+            vertexInputAttributeDescriptions[i] = VkVertexInputAttributeDescription
+            {
+                static_cast<uint32_t>(i),                           // location
+                0,                                                  // binding
+                Layout::ATTRIBUTES[i].format,                       // format
+                Layout::ATTRIBUTES[i].offset                        // offset
+            };
+        }
+        return vertexInputAttributeDescriptions;
+    }
+};
+
+// ٽõԼʡԴ
+struct VertexLayoutReport
+{
+    float maxPositionError = 0.0f;
+    float maxTexCoordError = 0.0f;
+    size_t vertexCount = 0;
+    size_t fullBytes = 0;
+    size_t layoutBytes = 0;
+};
+
+template<typename Layout>
+VertexLayoutReport measureVertexLayout(const std::vector<Vertex>& _vertices)
+{
+    VertexLayoutReport report{ };
+    report.vertexCount = _vertices.size();
+    report.fullBytes = sizeof(Vertex) * _vertices.size();
+    report.layoutBytes = sizeof(typename Layout::Element) * _vertices.size();
+
+    const VertexQuantization quantization = Layout::computeQuantization(_vertices);
+    for (const Vertex& vertex : _vertices)
+    {
+        Vertex decoded = Layout::decode(Layout::encode(vertex, quantization), quantization);
+        glm::vec3 positionError = glm::abs(decoded.positionOS - vertex.positionOS);
+        glm::vec2 texCoordError = glm::abs(decoded.texCoord - vertex.texCoord);
+        report.maxPositionError = std::max({ report.maxPositionError, positionError.x, positionError.y, positionError.z });
+        report.maxTexCoordError = std::max({ report.maxTexCoordError, texCoordError.x, texCoordError.y });
+    }
+    return report;
+}
+
+#if defined(GQY_VERTEX_LAYOUT_QUANTIZED)
+    using GpuVertexLayout = QuantizedVertexLayout;
+#elif defined(GQY_VERTEX_LAYOUT_COMPACT)
+    using GpuVertexLayout = CompactVertexLayout;
+#else
+    using GpuVertexLayout = FullVertexLayout;
+#endif
+
+using GpuVertex = GpuVertexLayout::Element;
+
+#endif
@@ -0,0 +1,65 @@
+#include "VertexWeldTable.h"
+
+#include <algorithm>
+
+VertexWeldTable::VertexWeldTable(size_t _expectedCount)
+{
+    reserve(_expectedCount);
+}
+
+void VertexWeldTable::reserve(size_t _expectedCount)
+{
+    //  7/8
+    size_t capacity = GROUP_SIZE;
+    while (capacity / 8 * 7 < _expectedCount)
+    {
+        capacity *= 2;
+    }
+    if (capacity > m_controls.size())
+    {
+        rehash(capacity);
+    }
+}
+
+void VertexWeldTable::clear()
+{
+    std::fill(m_controls.begin(), m_controls.end(), EMPTY);
+    m_size = 0;
+    m_growthLeft = m_controls.size() / 8 * 7;
+}
+
+void VertexWeldTable::rehash(size_t _capacity)
+{
+    std::vector<int8_t> oldControls(_capacity, EMPTY);
+    std::vector<Slot> oldSlots(_capacity);
+    oldControls.swap(m_controls);
+    oldSlots.swap(m_slots);
+
+    m_groupMask = _capacity / GROUP_SIZE - 1;
+    m_growthLeft = _capacity / 8 * 7 - m_size;
+
+    for (size_t i = 0; i < oldControls.size(); ++i)
+    {
+        if (oldControls[i] != EMPTY)
+        {
+            insertUnique(oldSlots[i], hashVertex(oldSlots[i].vertex));
+        }
+    }
+}
+
+void VertexWeldTable::insertUnique(const Slot& _slot, uint64_t _hash)
+{
+    size_t group = static_cast<size_t>(_hash >> 7) & m_groupMask;
+    for (size_t step = 1; ; ++step)
+    {
+        uint32_t empty = matchByte(m_controls.data() + group * GROUP_SIZE, EMPTY);
+        if (empty != 0)
+        {
+            const size_t index = group * GROUP_SIZE + countTrailingZeros(empty);
+            m_controls[index] = static_cast<int8_t>(_hash & 0x7F);
+            m_slots[index] = _slot;
+            return;
+        }
+        group = (group + step) & m_groupMask;
+    }
+}
@@ -0,0 +1,146 @@
+#ifndef GQY_VERTEX_WELD_TABLE_H
+#define GQY_VERTEX_WELD_TABLE_H
+
+#include <cstdint>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define GQY_WELD_TABLE_SSE2
+    #include <emmintrin.h>
+#endif
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+#include "Hash.h"
+#include "Vertex.h"
+
+// ȥõĿѰַϣ (Swiss table ṹ)
+// ÿ 16 λһ飬ֽڱϣֵ 7 λ SSE2 һαȽ飬
+// λŶͱţֻ벻ɾ
+class VertexWeldTable
+{
+public:
+    static constexpr size_t GROUP_SIZE = 16;
+
+    explicit VertexWeldTable(size_t _expectedCount = 0);
+
+    // ԤƵĶռ䣬֤в
+    void reserve(size_t _expectedCount);
+    void clear();
+
+    // ѴȵĶʱţ _value  _value
+    uint32_t findOrInsert(const Vertex& _vertex, uint64_t _hash, uint32_t _value);
+    uint32_t findOrInsert(const Vertex& _vertex, uint32_t _value) { return findOrInsert(_vertex, hashVertex(_vertex), _value); }
+
+    size_t size() const { return m_size; }
+    size_t capacity() const { return m_controls.size(); }
+
+    //  Vertex ԭʼֽϣ-0.0  0.0 Ϊͬ ( operator == һ)
+    static uint64_t hashVertex(const Vertex& _vertex);
+
+private:
+    static constexpr int8_t EMPTY = -128;
+
+    struct Slot
+    {
+        Vertex vertex;
+        uint32_t value;
+    };
+
+    void rehash(size_t _capacity);
+    void insertUnique(const Slot& _slot, uint64_t _hash);
+
+    static uint32_t matchByte(const int8_t* _group, int8_t _value);
+    static uint32_t countTrailingZeros(uint32_t _mask);
+
+private:
+    std::vector<int8_t> m_controls;
+    std::vector<Slot> m_slots;
+    size_t m_groupMask = 0;
+    size_t m_size = 0;
+    size_t m_growthLeft = 0;
+};
+
+inline uint64_t VertexWeldTable::hashVertex(const Vertex& _vertex)
+{
+    static_assert(sizeof(Vertex) == 8 * sizeof(float), "Vertex must not contain padding");
+
+    float values[8]
+    {
+        _vertex.positionOS.x + 0.0f,
+        _vertex.positionOS.y + 0.0f,
+        _vertex.positionOS.z + 0.0f,
+        _vertex.color.x + 0.0f,
+        _vertex.color.y + 0.0f,
+        _vertex.color.z + 0.0f,
+        _vertex.texCoord.x + 0.0f,
+        _vertex.texCoord.y + 0.0f
+    };
+    return hash64(values, sizeof(values));
+}
+
+inline uint32_t VertexWeldTable::matchByte(const int8_t* _group, int8_t _value)
+{
+    #ifdef GQY_WELD_TABLE_SSE2
+        __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_group));
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(_value))));
+    #else
+        uint32_t mask = 0;
+        for (uint32_t i = 0; i < GROUP_SIZE; ++i)
+        {
+            mask |= static_cast<uint32_t>(_group[i] == _value) << i;
+        }
+        return mask;
+    #endif
+}
+
+inline uint32_t VertexWeldTable::countTrailingZeros(uint32_t _mask)
+{
+    #if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, _mask);
+        return static_cast<uint32_t>(index);
+    #else
+        return static_cast<uint32_t>(__builtin_ctz(_mask));
+    #endif
+}
+
+inline uint32_t VertexWeldTable::findOrInsert(const Vertex& _vertex, uint64_t _hash, uint32_t _value)
+{
+    if (m_growthLeft == 0)
+    {
+        rehash(m_controls.empty() ? GROUP_SIZE : m_controls.size() * 2);
+    }
+
+    const int8_t tag = static_cast<int8_t>(_hash & 0x7F);
+    size_t group = static_cast<size_t>(_hash >> 7) & m_groupMask;
+    for (size_t step = 1; ; ++step)
+    {
+        const int8_t* controls = m_controls.data() + group * GROUP_SIZE;
+        for (uint32_t match = matchByte(controls, tag); match != 0; match &= match - 1)
+        {
+            const Slot& slot = m_slots[group * GROUP_SIZE + countTrailingZeros(match)];
+            if (slot.vertex == _vertex)
+            {
+                return slot.value;
+            }
+        }
+
+        // ûɾڳֿλ˵ö㲻ڱ
+        uint32_t empty = matchByte(controls, EMPTY);
+        if (empty != 0)
+        {
+            const size_t index = group * GROUP_SIZE + countTrailingZeros(empty);
+            m_controls[index] = tag;
+            m_slots[index] = Slot{ _vertex, _value };
+            ++m_size;
+            --m_growthLeft;
+            return _value;
+        }
+
+        group = (group + step) & m_groupMask;
+    }
+}
+
+#endif
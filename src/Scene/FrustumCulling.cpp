@@ -0,0 +1,157 @@
+#include "FrustumCulling.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+FrustumPlanes extractFrustumPlanes(const float* _viewProjection)
+{
+    //  r Ϊ (m[r], m[4 + r], m[8 + r], m[12 + r])üռ -w <= x, y <= w0 <= z <= w
+    float rows[4][4];
+    for (int row = 0; row < 4; ++row)
+    {
+        for (int column = 0; column < 4; ++column)
+        {
+            rows[row][column] = _viewProjection[column * 4 + row];
+        }
+    }
+
+    FrustumPlanes frustum{ };
+    for (int i = 0; i < 4; ++i)
+    {
+        frustum.planes[0][i] = rows[3][i] + rows[0][i];
+        frustum.planes[1][i] = rows[3][i] - rows[0][i];
+        frustum.planes[2][i] = rows[3][i] + rows[1][i];
+        frustum.planes[3][i] = rows[3][i] - rows[1][i];
+        frustum.planes[4][i] = rows[2][i];
+        frustum.planes[5][i] = rows[3][i] - rows[2][i];
+    }
+    for (float* plane : frustum.planes)
+    {
+        const float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+        if (length > 0.0f)
+        {
+            for (int i = 0; i < 4; ++i)
+            {
+                plane[i] /= length;
+            }
+        }
+    }
+    return frustum;
+}
+
+void computeBoundingSphere(const float* _positions, size_t _positionCount, float _center[3], float& _radius)
+{
+    _center[0] = _center[1] = _center[2] = 0.0f;
+    _radius = 0.0f;
+    if (_positionCount == 0)
+    {
+        return;
+    }
+
+    float minimum[3]{ _positions[0], _positions[1], _positions[2] };
+    float maximum[3]{ _positions[0], _positions[1], _positions[2] };
+    for (size_t i = 1; i < _positionCount; ++i)
+    {
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            minimum[axis] = std::min(minimum[axis], _positions[i * 3 + axis]);
+            maximum[axis] = std::max(maximum[axis], _positions[i * 3 + axis]);
+        }
+    }
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        _center[axis] = 0.5f * (minimum[axis] + maximum[axis]);
+    }
+
+    float radiusSquared = 0.0f;
+    for (size_t i = 0; i < _positionCount; ++i)
+    {
+        const float x = _positions[i * 3 + 0] - _center[0];
+        const float y = _positions[i * 3 + 1] - _center[1];
+        const float z = _positions[i * 3 + 2] - _center[2];
+        radiusSquared = std::max(radiusSquared, x * x + y * y + z * z);
+    }
+    _radius = std::sqrt(radiusSquared);
+}
+
+bool isSphereInFrustum(const FrustumPlanes& _frustum, const float* _model, const float _center[3], float _radius)
+{
+    //  cull.comp ļ˳򱣳һ£߽ϵĽ GPU ͬ
+    float center[3];
+    for (int i = 0; i < 3; ++i)
+    {
+        center[i] = _model[i] * _center[0] + _model[4 + i] * _center[1] + _model[8 + i] * _center[2] + _model[12 + i];
+    }
+    float scaleSquared = 0.0f;
+    for (int column = 0; column < 3; ++column)
+    {
+        const float* axis = _model + column * 4;
+        scaleSquared = std::max(scaleSquared, axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+    }
+    const float radius = _radius * std::sqrt(scaleSquared);
+
+    for (const float* plane : _frustum.planes)
+    {
+        if (plane[0] * center[0] + plane[1] * center[1] + plane[2] * center[2] + plane[3] < -radius)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void initCullingCommands(const uint32_t* _instanceLods, uint32_t _instanceCount, uint32_t _instanceCapacity,
+    const CullingDrawItem* _drawItems, uint32_t _drawItemCount, uint32_t _lodCount, IndirectDrawCommand* _commands)
+{
+    // ѡ LOD ķʽ cull.comp ͬLOD ԽʱȡһͳƸʵǰ׺
+    std::vector<uint32_t> lodFirstInstances(_lodCount + 1, 0);
+    for (uint32_t instance = 0; instance < _instanceCount; ++instance)
+    {
+        const uint32_t lod = _instanceLods == nullptr ? 0 : std::min(_instanceLods[instance], _lodCount - 1);
+        ++lodFirstInstances[lod + 1];
+    }
+    for (uint32_t lod = 1; lod < _lodCount; ++lod)
+    {
+        lodFirstInstances[lod] += lodFirstInstances[lod - 1];
+    }
+
+    for (uint32_t drawItemIndex = 0; drawItemIndex < _drawItemCount; ++drawItemIndex)
+    {
+        for (uint32_t lod = 0; lod < _lodCount; ++lod)
+        {
+            const CullingDrawItem& drawItem = _drawItems[static_cast<size_t>(lod) * _drawItemCount + drawItemIndex];
+            _commands[static_cast<size_t>(drawItemIndex) * _lodCount + lod] = IndirectDrawCommand
+            {
+                drawItem.indexCount,
+                0,
+                drawItem.firstIndex,
+                drawItem.vertexOffset,
+                drawItemIndex * _instanceCapacity + lodFirstInstances[lod]
+            };
+        }
+    }
+}
+
+void cullDrawItems(const FrustumPlanes& _frustum, const float* _matrices, uint32_t _instanceCount, const uint32_t* _instanceLods,
+    const CullingDrawItem* _drawItems, uint32_t _drawItemCount, uint32_t _lodCount, IndirectDrawCommand* _commands, uint32_t* _visibleInstances)
+{
+    for (uint32_t drawItemIndex = 0; drawItemIndex < _drawItemCount; ++drawItemIndex)
+    {
+        for (uint32_t instance = 0; instance < _instanceCount; ++instance)
+        {
+            const uint32_t lod = _instanceLods == nullptr ? 0 : std::min(_instanceLods[instance], _lodCount - 1);
+            const CullingDrawItem& drawItem = _drawItems[static_cast<size_t>(lod) * _drawItemCount + drawItemIndex];
+            if (!isSphereInFrustum(_frustum, _matrices + static_cast<size_t>(instance) * 16, drawItem.center, drawItem.radius))
+            {
+                continue;
+            }
+            IndirectDrawCommand& command = _commands[static_cast<size_t>(drawItemIndex) * _lodCount + lod];
+            if (_visibleInstances != nullptr)
+            {
+                _visibleInstances[command.firstInstance + command.instanceCount] = instance;
+            }
+            ++command.instanceCount;
+        }
+    }
+}
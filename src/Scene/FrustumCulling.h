@@ -0,0 +1,57 @@
+#ifndef GQY_FRUSTUM_CULLING_H
+#define GQY_FRUSTUM_CULLING_H
+
+#include <cstddef>
+#include <cstdint>
+
+// ׶ 6 ƽ (ҡ¡ϡԶ)(a, b, c, d) зѹһָ׶ڲ
+struct FrustumPlanes
+{
+    float planes[6][4];
+};
+
+// һģͿռİΧͻƲ cull.comp е DrawItem һ (std43032 ֽ)
+// ж༶ LOD ʱ [LOD][] УİΧȡ 0 
+struct CullingDrawItem
+{
+    float center[3];
+    float radius;
+    uint32_t indexCount;
+    uint32_t firstIndex;
+    int32_t vertexOffset;
+    uint32_t padding;
+};
+
+//  VkDrawIndexedIndirectCommand һ
+struct IndirectDrawCommand
+{
+    uint32_t indexCount;
+    uint32_t instanceCount;
+    uint32_t firstIndex;
+    int32_t vertexOffset;
+    uint32_t firstInstance;
+};
+
+//  proj * view ȡ׶ƽ棬ȷΧΪ [0, 1]
+FrustumPlanes extractFrustumPlanes(const float* _viewProjection);
+
+// ΧȡΧģ뾶ȡԶľ룻_positions Ϊ xyz
+void computeBoundingSphere(const float* _positions, size_t _positionCount, float _center[3], float& _radius);
+
+// ģͿռİΧģ; _model 任Ƿ׶ཻ뾶ŷŴ
+bool isSphereInFrustum(const FrustumPlanes& _frustum, const float* _model, const float _center[3], float _radius);
+
+// Ϊÿ (, LOD) ׼һӻ [][LOD] й _drawItemCount * _lodCount instanceCount ޳ۼӡ
+// ɼʵбе d  d * _instanceCapacity ʼлʵͬ LOD ֣
+//  LOD l 䶼 LOD С l ʵʼΪ firstInstance
+// _drawItems  _lodCount * _drawItemCount ʵʹ _instanceLods еһ (Ϊʱõ 0 )
+void initCullingCommands(const uint32_t* _instanceLods, uint32_t _instanceCount, uint32_t _instanceCapacity,
+    const CullingDrawItem* _drawItems, uint32_t _drawItemCount, uint32_t _lodCount, IndirectDrawCommand* _commands);
+
+// cull.comp  CPU οʵ֣ÿÿʵ׶޳ɼʱۼӶӦ instanceCount
+// ʵд _visibleInstances[firstInstance + ]GPU ϵ˳ȷCPU ʵ˳д
+// _visibleInstances Ϊʱֻ_commands Ҫ initCullingCommands ʼ
+void cullDrawItems(const FrustumPlanes& _frustum, const float* _matrices, uint32_t _instanceCount, const uint32_t* _instanceLods,
+    const CullingDrawItem* _drawItems, uint32_t _drawItemCount, uint32_t _lodCount, IndirectDrawCommand* _commands, uint32_t* _visibleInstances);
+
+#endif
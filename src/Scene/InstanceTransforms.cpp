@@ -0,0 +1,176 @@
+#include "InstanceTransforms.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define GQY_INSTANCE_SSE2
+    #include <emmintrin.h>
+#endif
+
+namespace
+{
+    // ÿת 90 ȣ뵥ģʱתٶһ
+    const float ANGULAR_SPEED = 1.5707963f;
+}
+
+void InstanceTransforms::init(uint32_t _count, float _spacing)
+{
+    m_count = _count;
+    const size_t paddedCount = (static_cast<size_t>(_count) + 3) / 4 * 4;
+    m_positionX.assign(paddedCount, 0.0f);
+    m_positionY.assign(paddedCount, 0.0f);
+    m_positionZ.assign(paddedCount, 0.0f);
+    m_scale.assign(paddedCount, 1.0f);
+    m_cos.assign(paddedCount, 1.0f);
+    m_sin.assign(paddedCount, 0.0f);
+
+    // һʵλԭҲʼλֻһʵʱԭĵģͻͬ
+    const uint32_t side = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(_count))));
+    const float origin = -0.5f * _spacing * static_cast<float>(side - 1);
+    m_extent = _count == 1 ? 0.0f : 0.5f * _spacing * static_cast<float>(side);
+    for (uint32_t i = 0; i < _count; ++i)
+    {
+        const uint32_t row = i / side;
+        const uint32_t column = i % side;
+        m_positionX[i] = _count == 1 ? 0.0f : origin + _spacing * static_cast<float>(column);
+        m_positionZ[i] = _count == 1 ? 0.0f : origin + _spacing * static_cast<float>(row);
+
+        // ϣȷλţͬÿεõͬĻ
+        uint32_t hash = i * 2654435761u;
+        hash ^= hash >> 16;
+        const float phase = i == 0 ? 0.0f : static_cast<float>(hash & 0xffff) / 65535.0f * 6.2831853f;
+        m_cos[i] = std::cos(phase);
+        m_sin[i] = std::sin(phase);
+        m_scale[i] = i == 0 ? 1.0f : 0.8f + 0.4f * static_cast<float>((hash >> 16) & 0xff) / 255.0f;
+    }
+}
+
+void InstanceTransforms::update(float _deltaTime, float* _matrices)
+{
+    update(_deltaTime, _matrices, 0, m_count);
+}
+
+void InstanceTransforms::update(float _deltaTime, float* _matrices, uint32_t _begin, uint32_t _end)
+{
+    // һͬʵһ״̬
+    const uint32_t stateEnd = _end == m_count ? static_cast<uint32_t>(m_positionX.size()) : _end;
+    #if defined(GQY_INSTANCE_SSE2)
+        // ʵתͬתֻһΣʵֻʣ˼ӡ
+        // תۻÿ֡һţٵ (cos, sin) صλԲ
+        const float angle = ANGULAR_SPEED * _deltaTime;
+        const __m128 deltaCos = _mm_set1_ps(std::cos(angle));
+        const __m128 deltaSin = _mm_set1_ps(std::sin(angle));
+        const __m128 half = _mm_set1_ps(0.5f);
+        const __m128 three = _mm_set1_ps(3.0f);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+
+        const uint32_t fullCount = m_count / 4 * 4;
+        for (uint32_t i = _begin; i < stateEnd; i += 4)
+        {
+            __m128 c = _mm_loadu_ps(&m_cos[i]);
+            __m128 s = _mm_loadu_ps(&m_sin[i]);
+            __m128 rotatedCos = _mm_sub_ps(_mm_mul_ps(c, deltaCos), _mm_mul_ps(s, deltaSin));
+            __m128 rotatedSin = _mm_add_ps(_mm_mul_ps(s, deltaCos), _mm_mul_ps(c, deltaSin));
+            __m128 lengthSquared = _mm_add_ps(_mm_mul_ps(rotatedCos, rotatedCos), _mm_mul_ps(rotatedSin, rotatedSin));
+            __m128 correction = _mm_mul_ps(half, _mm_sub_ps(three, lengthSquared));
+            c = _mm_mul_ps(rotatedCos, correction);
+            s = _mm_mul_ps(rotatedSin, correction);
+            _mm_storeu_ps(&m_cos[i], c);
+            _mm_storeu_ps(&m_sin[i], s);
+
+            if (i >= fullCount)
+            {
+                break;
+            }
+
+            // 4 ʵͬһаų 4 תúÿһʵһ
+            __m128 scale = _mm_loadu_ps(&m_scale[i]);
+            __m128 scaledCos = _mm_mul_ps(c, scale);
+            __m128 scaledSin = _mm_mul_ps(s, scale);
+
+            __m128 column0[4]{ scaledCos, zero, _mm_sub_ps(zero, scaledSin), zero };
+            __m128 column1[4]{ zero, scale, zero, zero };
+            __m128 column2[4]{ scaledSin, zero, scaledCos, zero };
+            __m128 column3[4]{ _mm_loadu_ps(&m_positionX[i]), _mm_loadu_ps(&m_positionY[i]), _mm_loadu_ps(&m_positionZ[i]), one };
+            _MM_TRANSPOSE4_PS(column0[0], column0[1], column0[2], column0[3]);
+            _MM_TRANSPOSE4_PS(column1[0], column1[1], column1[2], column1[3]);
+            _MM_TRANSPOSE4_PS(column2[0], column2[1], column2[2], column2[3]);
+            _MM_TRANSPOSE4_PS(column3[0], column3[1], column3[2], column3[3]);
+
+            float* matrix = _matrices + static_cast<size_t>(i) * MATRIX_FLOAT_COUNT;
+            for (uint32_t j = 0; j < 4; ++j)
+            {
+                _mm_storeu_ps(matrix + 0, column0[j]);
+                _mm_storeu_ps(matrix + 4, column1[j]);
+                _mm_storeu_ps(matrix + 8, column2[j]);
+                _mm_storeu_ps(matrix + 12, column3[j]);
+                matrix += MATRIX_FLOAT_COUNT;
+            }
+        }
+
+        //  4 βʵ״̬Ѿ£ֻд
+        for (uint32_t i = std::max(fullCount, _begin); i < _end; ++i)
+        {
+            writeMatrixScalar(i, _matrices);
+        }
+    #else
+        updateScalar(_deltaTime, _matrices, _begin, stateEnd);
+    #endif
+}
+
+void InstanceTransforms::updateScalar(float _deltaTime, float* _matrices)
+{
+    updateScalar(_deltaTime, _matrices, 0, static_cast<uint32_t>(m_positionX.size()));
+}
+
+void InstanceTransforms::updateScalar(float _deltaTime, float* _matrices, uint32_t _begin, uint32_t _end)
+{
+    const float angle = ANGULAR_SPEED * _deltaTime;
+    const float deltaCos = std::cos(angle);
+    const float deltaSin = std::sin(angle);
+    for (uint32_t i = _begin; i < _end; ++i)
+    {
+        const float rotatedCos = m_cos[i] * deltaCos - m_sin[i] * deltaSin;
+        const float rotatedSin = m_sin[i] * deltaCos + m_cos[i] * deltaSin;
+        const float correction = 0.5f * (3.0f - (rotatedCos * rotatedCos + rotatedSin * rotatedSin));
+        m_cos[i] = rotatedCos * correction;
+        m_sin[i] = rotatedSin * correction;
+    }
+    for (uint32_t i = _begin; i < std::min(_end, m_count); ++i)
+    {
+        writeMatrixScalar(i, _matrices);
+    }
+}
+
+uint32_t InstanceTransforms::getCount() const
+{
+    return m_count;
+}
+
+float InstanceTransforms::getExtent() const
+{
+    return m_extent;
+}
+
+bool InstanceTransforms::isSimdEnabled()
+{
+    #if defined(GQY_INSTANCE_SSE2)
+        return true;
+    #else
+        return false;
+    #endif
+}
+
+void InstanceTransforms::writeMatrixScalar(uint32_t _instance, float* _matrices) const
+{
+    //  Y תźƽƣ
+    const float scaledCos = m_cos[_instance] * m_scale[_instance];
+    const float scaledSin = m_sin[_instance] * m_scale[_instance];
+    float* matrix = _matrices + static_cast<size_t>(_instance) * MATRIX_FLOAT_COUNT;
+    matrix[0] = scaledCos;              matrix[1] = 0.0f;                       matrix[2] = -scaledSin;             matrix[3] = 0.0f;
+    matrix[4] = 0.0f;                   matrix[5] = m_scale[_instance];         matrix[6] = 0.0f;                   matrix[7] = 0.0f;
+    matrix[8] = scaledSin;              matrix[9] = 0.0f;                       matrix[10] = scaledCos;             matrix[11] = 0.0f;
+    matrix[12] = m_positionX[_instance]; matrix[13] = m_positionY[_instance];   matrix[14] = m_positionZ[_instance]; matrix[15] = 1.0f;
+}
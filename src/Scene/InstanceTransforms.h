@@ -0,0 +1,46 @@
+#ifndef GQY_INSTANCE_TRANSFORMS_H
+#define GQY_INSTANCE_TRANSFORMS_H
+
+#include <cstdint>
+#include <vector>
+
+// ģ͸ı任ʵ XZ ƽųɷ󲢸 Y ת
+// ״ֱ̬洢 (SoA)ÿ֡ SIMD һθ 4 ʵд mat4
+class InstanceTransforms
+{
+public:
+    static const uint32_t MATRIX_FLOAT_COUNT = 16;
+
+    void init(uint32_t _count, float _spacing);
+
+    // ƽ _deltaTime 룬 getCount() д _matrices
+    void update(float _deltaTime, float* _matrices);
+    // ֻ [_begin, _end) ʵ԰ʵд _matrices_begin  _end  4 ı
+    //  _end  getCount()ཻڲͬ߳ͬʱ
+    void update(float _deltaTime, float* _matrices, uint32_t _begin, uint32_t _end);
+    // ʵĲοʵ֣УͲ
+    void updateScalar(float _deltaTime, float* _matrices);
+
+    uint32_t getCount() const;
+    //  XZ ƽϵİֻ߳һʵʱΪ 0
+    float getExtent() const;
+
+    static bool isSimdEnabled();
+
+private:
+    void updateScalar(float _deltaTime, float* _matrices, uint32_t _begin, uint32_t _end);
+    void writeMatrixScalar(uint32_t _instance, float* _matrices) const;
+
+private:
+    uint32_t m_count = 0;
+    float m_extent = 0.0f;
+    // Ȳ뵽 4 ıSIMD ѭҪβ
+    std::vector<float> m_positionX;
+    std::vector<float> m_positionY;
+    std::vector<float> m_positionZ;
+    std::vector<float> m_scale;
+    std::vector<float> m_cos;
+    std::vector<float> m_sin;
+};
+
+#endif
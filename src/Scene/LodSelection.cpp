@@ -0,0 +1,48 @@
+#include "LodSelection.h"
+
+#include <algorithm>
+#include <cmath>
+
+LodCamera makeLodCamera(const float* _view, const float* _projection, uint32_t _viewportHeight)
+{
+    LodCamera camera{ };
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        // R ĵ axis Ϊ (view[axis * 4], view[axis * 4 + 1], view[axis * 4 + 2])t Ϊ view[12..14]
+        camera.position[axis] = -(_view[axis * 4] * _view[12] + _view[axis * 4 + 1] * _view[13] + _view[axis * 4 + 2] * _view[14]);
+    }
+    // proj[1][1] Ϊ 1 / tan(fovy / 2)Vulkan ȡ˸
+    camera.pixelsPerUnit = std::fabs(_projection[5]) * 0.5f * static_cast<float>(_viewportHeight);
+    return camera;
+}
+
+void selectLods(const LodCamera& _camera, const float* _matrices, uint32_t _instanceCount, const float _center[3], float _radius,
+    const float* _lodErrors, uint32_t _lodCount, float _pixelThreshold, uint32_t* _lods)
+{
+    for (uint32_t instance = 0; instance < _instanceCount; ++instance)
+    {
+        const float* model = _matrices + static_cast<size_t>(instance) * 16;
+        float scaleSquared = 0.0f;
+        float offset[3];
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            scaleSquared = std::max(scaleSquared, model[axis * 4] * model[axis * 4] + model[axis * 4 + 1] * model[axis * 4 + 1] + model[axis * 4 + 2] * model[axis * 4 + 2]);
+            offset[axis] = model[axis] * _center[0] + model[4 + axis] * _center[1] + model[8 + axis] * _center[2] + model[12 + axis] - _camera.position[axis];
+        }
+        const float scale = std::sqrt(scaleSquared);
+        const float distance = std::sqrt(offset[0] * offset[0] + offset[1] * offset[1] + offset[2] * offset[2]) - _radius * scale;
+
+        //  e ھ d ͶӰΪ e * scale * pixelsPerUnit / d أȽʱͬ d 
+        uint32_t lod = 0;
+        if (distance > 0.0f)
+        {
+            const float maxError = _pixelThreshold * distance;
+            const float errorScale = scale * _camera.pixelsPerUnit;
+            while (lod + 1 < _lodCount && _lodErrors[lod + 1] * errorScale <= maxError)
+            {
+                ++lod;
+            }
+        }
+        _lods[instance] = lod;
+    }
+}
@@ -0,0 +1,23 @@
+#ifndef GQY_LOD_SELECTION_H
+#define GQY_LOD_SELECTION_H
+
+#include <cstdint>
+
+// ĻռռλãԼΪ 1 һλͶӰĻϵ
+struct LodCamera
+{
+    float position[3];
+    float pixelsPerUnit;
+};
+
+//  view / proj  ( updateUniformBuffer еͬ) ӿڸ߶ȵõ LOD ѡõ
+// view ֻתƽƣλΪ -R^T t
+LodCamera makeLodCamera(const float* _view, const float* _projection, uint32_t _viewportHeight);
+
+// ΪÿʵѡͶӰ _pixelThreshold صһ LODд _lods
+// _lodErrors ΪģͿռ ( 0 Ϊ 0)ģ;ŷŴ
+// ȡΧľ룬ڰΧڲʱѡ 0 
+void selectLods(const LodCamera& _camera, const float* _matrices, uint32_t _instanceCount, const float _center[3], float _radius,
+    const float* _lodErrors, uint32_t _lodCount, float _pixelThreshold, uint32_t* _lods);
+
+#endif
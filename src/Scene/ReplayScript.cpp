@@ -0,0 +1,148 @@
+#include "ReplayScript.h"
+
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+    float lerp(float _a, float _b, float _t)
+    {
+        return _a + (_b - _a) * _t;
+    }
+
+    // ȡһֵߺ滹жʱʽ
+    template<typename... Values>
+    bool readValues(std::istringstream& _stream, Values&... _values)
+    {
+        bool valid = true;
+        ((valid = valid && static_cast<bool>(_stream >> _values)), ...);
+        std::string rest;
+        return valid && !(_stream >> rest);
+    }
+}
+
+bool parseReplayScript(const std::string& _text, ReplayScript& _script, std::string& _error)
+{
+    _script = ReplayScript{ };
+    std::istringstream text(_text);
+    std::string line;
+    for (uint32_t lineNumber = 1; std::getline(text, line); ++lineNumber)
+    {
+        const size_t comment = line.find('#');
+        if (comment != std::string::npos)
+        {
+            line.resize(comment);
+        }
+        std::istringstream stream(line);
+        std::string command;
+        if (!(stream >> command))
+        {
+            continue;
+        }
+
+        bool valid = true;
+        if (command == "resolution")
+        {
+            valid = readValues(stream, _script.width, _script.height) && _script.width > 0 && _script.height > 0;
+        }
+        else if (command == "instances")
+        {
+            valid = readValues(stream, _script.instanceCount) && _script.instanceCount > 0;
+        }
+        else if (command == "warmup")
+        {
+            valid = readValues(stream, _script.warmupFrames);
+        }
+        else if (command == "frames")
+        {
+            valid = readValues(stream, _script.measuredFrames) && _script.measuredFrames > 0;
+        }
+        else if (command == "timestep")
+        {
+            valid = readValues(stream, _script.timeStep) && _script.timeStep >= 0.0f;
+        }
+        else if (command == "camera")
+        {
+            CameraKeyframe keyframe{ };
+            valid = readValues(stream, keyframe.time, keyframe.eye[0], keyframe.eye[1], keyframe.eye[2], keyframe.target[0], keyframe.target[1], keyframe.target[2], keyframe.fovDegrees)
+                && keyframe.fovDegrees > 0.0f && keyframe.fovDegrees < 180.0f
+                && (_script.cameraKeyframes.empty() || keyframe.time > _script.cameraKeyframes.back().time);
+            _script.cameraKeyframes.push_back(keyframe);
+        }
+        else if (command == "golden")
+        {
+            valid = readValues(stream, _script.goldenImagePath);
+        }
+        else if (command == "output")
+        {
+            valid = readValues(stream, _script.outputImagePath);
+        }
+        else if (command == "tolerance")
+        {
+            valid = readValues(stream, _script.channelTolerance, _script.differingPixelPercent) && _script.differingPixelPercent >= 0.0f;
+        }
+        else if (command == "report")
+        {
+            valid = readValues(stream, _script.reportPath);
+        }
+        else
+        {
+            _error = "line " + std::to_string(lineNumber) + ": unknown command " + command;
+            return false;
+        }
+
+        if (!valid)
+        {
+            _error = "line " + std::to_string(lineNumber) + ": invalid " + command;
+            return false;
+        }
+    }
+
+    if (_script.cameraKeyframes.empty())
+    {
+        _error = "no camera keyframes";
+        return false;
+    }
+    return true;
+}
+
+bool loadReplayScript(const std::string& _filename, ReplayScript& _script, std::string& _error)
+{
+    std::ifstream file(_filename);
+    if (!file)
+    {
+        _error = "failed to open " + _filename;
+        return false;
+    }
+    std::ostringstream text;
+    text << file.rdbuf();
+    return parseReplayScript(text.str(), _script, _error);
+}
+
+CameraKeyframe sampleCamera(const ReplayScript& _script, float _time)
+{
+    const std::vector<CameraKeyframe>& keyframes = _script.cameraKeyframes;
+    if (_time <= keyframes.front().time)
+    {
+        return keyframes.front();
+    }
+    for (size_t i = 1; i < keyframes.size(); ++i)
+    {
+        if (_time < keyframes[i].time)
+        {
+            const CameraKeyframe& from = keyframes[i - 1];
+            const CameraKeyframe& to = keyframes[i];
+            const float t = (_time - from.time) / (to.time - from.time);
+            CameraKeyframe keyframe{ };
+            keyframe.time = _time;
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                keyframe.eye[axis] = lerp(from.eye[axis], to.eye[axis], t);
+                keyframe.target[axis] = lerp(from.target[axis], to.target[axis], t);
+            }
+            keyframe.fovDegrees = lerp(from.fovDegrees, to.fovDegrees, t);
+            return keyframe;
+        }
+    }
+    return keyframes.back();
+}
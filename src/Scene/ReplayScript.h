@@ -0,0 +1,49 @@
+#ifndef GQY_REPLAY_SCRIPT_H
+#define GQY_REPLAY_SCRIPT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ؼ֡ʱ ()λáעӵʹֱӳ ()
+struct CameraKeyframe
+{
+    float time;
+    float eye[3];
+    float target[3];
+    float fovDegrees;
+};
+
+// ȷԻطŽűÿһָ# ֮Ϊעͣ
+//   resolution <width> <height>            ȾֱʣʡʱʹôڴС
+//   instances <count>                      ʵ
+//   warmup <frames> / frames <frames>      Ԥ֡ͼʱ֡
+//   timestep <seconds>                     ÿ֡ƽĹ̶ʱ
+//   camera <time> <eye xyz> <target xyz> <fov>   ؼ֡ʱϸ֮Բֵ
+//   golden <file.png> / output <file.png>  ԱõĻ׼ͼ / һ֡
+//   tolerance <channel> <percent>          ֵͨ channel ز percent% ʱͨ
+//   report <file.json>                     
+struct ReplayScript
+{
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t instanceCount = 1;
+    uint32_t warmupFrames = 30;
+    uint32_t measuredFrames = 120;
+    float timeStep = 1.0f / 60.0f;
+    std::vector<CameraKeyframe> cameraKeyframes;
+    std::string goldenImagePath;
+    std::string outputImagePath;
+    uint32_t channelTolerance = 8;
+    float differingPixelPercent = 0.5f;
+    std::string reportPath = "replay_report.json";
+};
+
+// ʧʱ false_error икźԭ
+bool parseReplayScript(const std::string& _text, ReplayScript& _script, std::string& _error);
+bool loadReplayScript(const std::string& _filename, ReplayScript& _script, std::string& _error);
+
+// ڹؼ֮֡ԲֵΧʱȡβؼ֡űһؼ֡
+CameraKeyframe sampleCamera(const ReplayScript& _script, float _time);
+
+#endif
@@ -0,0 +1,263 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "common.h"
+#include "FrustumCulling.h"
+#include "InstanceTransforms.h"
+#include "ToolCommands.h"
+
+namespace
+{
+    struct CullingCamera
+    {
+        const char* name;
+        float eye[3];
+        float target[3];
+        float farPlane;
+    };
+
+    //  4x4 m[column * 4 + row]
+    struct Matrix
+    {
+        float m[16];
+    };
+
+    Matrix multiply(const Matrix& _a, const Matrix& _b)
+    {
+        Matrix result{ };
+        for (int column = 0; column < 4; ++column)
+        {
+            for (int row = 0; row < 4; ++row)
+            {
+                for (int k = 0; k < 4; ++k)
+                {
+                    result.m[column * 4 + row] += _a.m[k * 4 + row] * _b.m[column * 4 + k];
+                }
+            }
+        }
+        return result;
+    }
+
+    void normalize(float _v[3])
+    {
+        const float length = std::sqrt(_v[0] * _v[0] + _v[1] * _v[1] + _v[2] * _v[2]);
+        for (int i = 0; i < 3; ++i)
+        {
+            _v[i] /= length;
+        }
+    }
+
+    //  Application::updateUniformBuffer ͬglm::lookAt60  glm::perspective ( [0, 1]) ת Y
+    Matrix makeViewProjection(const CullingCamera& _camera, float _aspect)
+    {
+        float forward[3]{ _camera.target[0] - _camera.eye[0], _camera.target[1] - _camera.eye[1], _camera.target[2] - _camera.eye[2] };
+        normalize(forward);
+        float side[3]{ -forward[2], 0.0f, forward[0] };
+        normalize(side);
+        const float up[3]{ side[1] * forward[2] - side[2] * forward[1], side[2] * forward[0] - side[0] * forward[2], side[0] * forward[1] - side[1] * forward[0] };
+
+        Matrix view{ };
+        for (int i = 0; i < 3; ++i)
+        {
+            view.m[i * 4 + 0] = side[i];
+            view.m[i * 4 + 1] = up[i];
+            view.m[i * 4 + 2] = -forward[i];
+        }
+        view.m[12] = -(side[0] * _camera.eye[0] + side[1] * _camera.eye[1] + side[2] * _camera.eye[2]);
+        view.m[13] = -(up[0] * _camera.eye[0] + up[1] * _camera.eye[1] + up[2] * _camera.eye[2]);
+        view.m[14] = forward[0] * _camera.eye[0] + forward[1] * _camera.eye[1] + forward[2] * _camera.eye[2];
+        view.m[15] = 1.0f;
+
+        const float nearPlane = 0.1f;
+        const float tanHalfFov = std::tan(0.5f * 1.0471976f);
+        Matrix projection{ };
+        projection.m[0] = 1.0f / (_aspect * tanHalfFov);
+        projection.m[5] = -1.0f / tanHalfFov;
+        projection.m[10] = _camera.farPlane / (nearPlane - _camera.farPlane);
+        projection.m[11] = -1.0f;
+        projection.m[14] = -(_camera.farPlane * nearPlane) / (_camera.farPlane - nearPlane);
+        return multiply(projection, view);
+    }
+
+    // ΧĵĲֻҪһڲüռڣϾһܱ޳
+    bool isSampleVisible(const Matrix& _viewProjection, const float* _model, const CullingDrawItem& _drawItem)
+    {
+        const float directions[15][3]
+        {
+            { 0.0f, 0.0f, 0.0f },
+            { 1.0f, 0.0f, 0.0f }, { -1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, -1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, -1.0f },
+            { 0.577f, 0.577f, 0.577f }, { 0.577f, 0.577f, -0.577f }, { 0.577f, -0.577f, 0.577f }, { 0.577f, -0.577f, -0.577f },
+            { -0.577f, 0.577f, 0.577f }, { -0.577f, 0.577f, -0.577f }, { -0.577f, -0.577f, 0.577f }, { -0.577f, -0.577f, -0.577f }
+        };
+        for (const float* direction : directions)
+        {
+            float point[4]{ 1.0f, 1.0f, 1.0f, 1.0f };
+            for (int i = 0; i < 3; ++i)
+            {
+                point[i] = _drawItem.center[i] + direction[i] * _drawItem.radius;
+            }
+            float world[4];
+            float clip[4];
+            for (int row = 0; row < 4; ++row)
+            {
+                world[row] = _model[row] * point[0] + _model[4 + row] * point[1] + _model[8 + row] * point[2] + _model[12 + row] * point[3];
+            }
+            for (int row = 0; row < 4; ++row)
+            {
+                clip[row] = _viewProjection.m[row] * world[0] + _viewProjection.m[4 + row] * world[1] + _viewProjection.m[8 + row] * world[2] + _viewProjection.m[12 + row] * world[3];
+            }
+            if (clip[3] > 0.0f && std::fabs(clip[0]) < clip[3] && std::fabs(clip[1]) < clip[3] && clip[2] > 0.0f && clip[2] < clip[3])
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // ÿ (, LOD) ΧͿɼʵбȷûаѲɼ޳ؿɼ
+    bool checkCulling(const Matrix& _viewProjection, const std::vector<float>& _matrices, uint32_t _instanceCount, const std::vector<uint32_t>& _instanceLods,
+        const std::vector<CullingDrawItem>& _drawItems, uint32_t _lodCount, const std::vector<IndirectDrawCommand>& _commands, const std::vector<uint32_t>& _visibleInstances,
+        uint64_t& _visibleCount, std::string& _error)
+    {
+        _visibleCount = 0;
+        const uint32_t drawItemCount = static_cast<uint32_t>(_drawItems.size() / _lodCount);
+        for (uint32_t drawItemIndex = 0; drawItemIndex < drawItemCount; ++drawItemIndex)
+        {
+            // ͬһ LOD ʵбУص
+            std::vector<bool> visible(_instanceCount, false);
+            uint32_t listEnd = drawItemIndex * _instanceCount;
+            for (uint32_t lod = 0; lod < _lodCount; ++lod)
+            {
+                const CullingDrawItem& drawItem = _drawItems[static_cast<size_t>(lod) * drawItemCount + drawItemIndex];
+                const IndirectDrawCommand& command = _commands[static_cast<size_t>(drawItemIndex) * _lodCount + lod];
+                if (command.indexCount != drawItem.indexCount || command.firstIndex != drawItem.firstIndex || command.vertexOffset != drawItem.vertexOffset
+                    || command.firstInstance < listEnd || command.firstInstance + command.instanceCount > (drawItemIndex + 1) * _instanceCount)
+                {
+                    _error = "draw item " + std::to_string(drawItemIndex) + " has an invalid command for LOD " + std::to_string(lod);
+                    return false;
+                }
+                listEnd = command.firstInstance + command.instanceCount;
+
+                for (uint32_t i = 0; i < command.instanceCount; ++i)
+                {
+                    const uint32_t instance = _visibleInstances[command.firstInstance + i];
+                    if (instance >= _instanceCount || visible[instance] || std::min(_instanceLods[instance], _lodCount - 1) != lod)
+                    {
+                        _error = "draw item " + std::to_string(drawItemIndex) + " has an invalid visible instance at " + std::to_string(command.firstInstance + i);
+                        return false;
+                    }
+                    visible[instance] = true;
+                }
+                _visibleCount += command.instanceCount;
+            }
+
+            for (uint32_t instance = 0; instance < _instanceCount; ++instance)
+            {
+                const uint32_t lod = std::min(_instanceLods[instance], _lodCount - 1);
+                const CullingDrawItem& drawItem = _drawItems[static_cast<size_t>(lod) * drawItemCount + drawItemIndex];
+                if (!visible[instance] && isSampleVisible(_viewProjection, &_matrices[static_cast<size_t>(instance) * 16], drawItem))
+                {
+                    _error = "draw item " + std::to_string(drawItemIndex) + " of instance " + std::to_string(instance) + " is culled but visible";
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+}
+
+int runCullTest(const ToolArguments& _arguments)
+{
+    const uint32_t instanceCount = _arguments.empty() ? 4096 : static_cast<uint32_t>(std::stoul(_arguments[0]));
+    const uint32_t iterations = 20;
+    if (instanceCount == 0)
+    {
+        std::cerr << setFontColor("Instance count must be positive", FontColor::Red) << std::endl;
+        return 1;
+    }
+
+    InstanceTransforms instanceTransforms;
+    instanceTransforms.init(instanceCount, 12.0f);
+    std::vector<float> matrices(static_cast<size_t>(instanceCount) * InstanceTransforms::MATRIX_FLOAT_COUNT);
+    instanceTransforms.update(0.25f, matrices.data());
+    const float extent = instanceTransforms.getExtent();
+
+    // СͬļΧģģ͵塢ͷ 1  LOD ðΧ벢ڵ 0 ֮
+    std::vector<CullingDrawItem> drawItems
+    {
+        { { 0.0f, 8.0f, 0.0f }, 8.0f, 3000, 0, 0, 0 },
+        { { 0.0f, 15.0f, 0.5f }, 2.5f, 600, 3000, 0, 0 },
+        { { 3.0f, 10.0f, 1.0f }, 0.5f, 90, 3600, 1200, 0 },
+        { { -2.0f, 1.0f, 0.0f }, 0.0f, 36, 3690, 1200, 0 }
+    };
+    const uint32_t drawItemCount = static_cast<uint32_t>(drawItems.size());
+    const uint32_t lodCount = 2;
+    for (uint32_t drawItemIndex = 0; drawItemIndex < drawItemCount; ++drawItemIndex)
+    {
+        CullingDrawItem lodDrawItem = drawItems[drawItemIndex];
+        lodDrawItem.firstIndex = 3726 + lodDrawItem.firstIndex / 2;
+        lodDrawItem.indexCount /= 2;
+        drawItems.push_back(lodDrawItem);
+    }
+    // ÿʵһõ 1 һ LOD Χ (һ)
+    std::vector<uint32_t> instanceLods(instanceCount);
+    for (uint32_t instance = 0; instance < instanceCount; ++instance)
+    {
+        instanceLods[instance] = instance % 3;
+    }
+
+    const CullingCamera cameras[]
+    {
+        { "overview", { 0.0f, 10.0f + extent, 20.0f + 1.5f * extent }, { 0.0f, 10.0f, 0.0f }, 100.0f + 4.0f * extent },
+        { "ground", { 0.0f, 2.0f, 0.0f }, { 1.0f, 2.0f, 0.3f }, 60.0f },
+        { "away", { 0.0f, 10.0f, 30.0f + 2.0f * extent }, { 0.0f, 10.0f, 60.0f + 4.0f * extent }, 20.0f }
+    };
+
+    bool passed = true;
+    std::vector<IndirectDrawCommand> commands(static_cast<size_t>(drawItemCount) * lodCount);
+    std::vector<uint32_t> visibleInstances(static_cast<size_t>(drawItemCount) * instanceCount);
+    for (const CullingCamera& camera : cameras)
+    {
+        const Matrix viewProjection = makeViewProjection(camera, 4.0f / 3.0f);
+        const FrustumPlanes frustum = extractFrustumPlanes(viewProjection.m);
+
+        std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < iterations; ++i)
+        {
+            initCullingCommands(instanceLods.data(), instanceCount, instanceCount, drawItems.data(), drawItemCount, lodCount, commands.data());
+            cullDrawItems(frustum, matrices.data(), instanceCount, instanceLods.data(), drawItems.data(), drawItemCount, lodCount, commands.data(), visibleInstances.data());
+        }
+        const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count() / iterations;
+
+        uint64_t visibleCount = 0;
+        std::string error;
+        bool cameraPassed = checkCulling(viewProjection, matrices, instanceCount, instanceLods, drawItems, lodCount, commands, visibleInstances, visibleCount, error);
+        // ʵʲôվʵмֻܿһ
+        const uint64_t totalCount = static_cast<uint64_t>(instanceCount) * drawItemCount;
+        if (cameraPassed && std::string(camera.name) == "away" && visibleCount != 0)
+        {
+            cameraPassed = false;
+            error = "camera facing away sees " + std::to_string(visibleCount) + " draws";
+        }
+        if (cameraPassed && std::string(camera.name) == "ground" && instanceCount >= 256 && visibleCount == totalCount)
+        {
+            cameraPassed = false;
+            error = "nothing is culled around the ground camera";
+        }
+        passed &= cameraPassed;
+
+        std::cout << camera.name << ": " << visibleCount << " / " << totalCount << " visible, " << milliseconds << " ms ("
+            << (milliseconds > 0.0 ? totalCount / milliseconds / 1000.0 : 0.0) << " M tests/s)" << (cameraPassed ? "  [ok]" : "  [FAILED] " + error) << std::endl;
+    }
+
+    if (!passed)
+    {
+        std::cerr << setFontColor("Culling check failed", FontColor::Red) << std::endl;
+        return 1;
+    }
+    return 0;
+}
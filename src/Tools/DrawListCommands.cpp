@@ -0,0 +1,112 @@
+#include <iostream>
+#include <stdexcept>
+
+#include "common.h"
+#include "DrawList.h"
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include "ObjLoader.h"
+#include "ToolCommands.h"
+
+namespace
+{
+    bool checkDrawList(const std::string& _name, const MeshCache& _meshCache, size_t _expectedDrawCount)
+    {
+        DrawList drawList;
+        drawList.build(_meshCache.getSubmeshes(), _meshCache.getSubmeshCount(), _meshCache.getMaterials(),
+            _meshCache.getIndexRanges(), _meshCache.getIndexRangeCount());
+
+        std::string error;
+        bool passed = drawList.validate(_meshCache.getSubmeshes(), _meshCache.getSubmeshCount(), _meshCache.getMaterials(),
+            _meshCache.getMaterialCount(), _meshCache.getVertexIndexCount(), error);
+        const DrawListStatistics& statistics = drawList.getStatistics();
+        if (passed && _expectedDrawCount != 0 && statistics.drawCount != _expectedDrawCount)
+        {
+            error = std::to_string(statistics.drawCount) + " draws, expected " + std::to_string(_expectedDrawCount);
+            passed = false;
+        }
+
+        std::cout << _name << ": " << statistics.submeshCount << " submeshes, " << statistics.indexRangeCount << " index ranges, "
+            << statistics.drawCount << " draws, " << statistics.textureBindCount << " texture binds (" << statistics.textureCount << " textures)"
+            << (passed ? "  [ok]" : "  [FAILED] " + error) << std::endl;
+        return passed;
+    }
+
+    // ֲʽУface  mouth Ĳʼ¼ͬӦϲһλƣ
+    // tinted  skin ͼɫͬҪƣҪ°ͼ
+    bool checkInterleavedMaterials()
+    {
+        const std::vector<ObjMaterial> materials
+        {
+            { "skin", "skin.png" },
+            { "face", "face.png" },
+            { "mouth", "face.png" },
+            { "plain", "" },
+            { "tinted", "skin.png", { 1.0f, 0.5f, 0.5f } }
+        };
+
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> vertexIndices;
+        std::vector<int32_t> triangleMaterials;
+        for (uint32_t triangle = 0; triangle < 64; ++triangle)
+        {
+            for (uint32_t corner = 0; corner < 3; ++corner)
+            {
+                Vertex vertex{ };
+                vertex.positionOS = { static_cast<float>(triangle), static_cast<float>(corner), 0.0f };
+                vertex.color = { 1.0f, 1.0f, 1.0f };
+                vertexIndices.push_back(static_cast<uint32_t>(vertices.size()));
+                vertices.push_back(vertex);
+            }
+            // 󼸸û usemtl
+            triangleMaterials.push_back(triangle < 60 ? static_cast<int32_t>(triangle % materials.size()) : -1);
+        }
+
+        std::vector<std::string> textures;
+        std::vector<MeshMaterial> meshMaterials;
+        std::vector<Submesh> submeshes = groupTrianglesByMaterial(vertexIndices, triangleMaterials, materials, textures, meshMaterials);
+        optimizeMesh(vertices, vertexIndices, submeshes);
+
+        MeshCache meshCache;
+        meshCache.build(0, vertices, vertexIndices, submeshes, meshMaterials, textures);
+        return checkDrawList("interleaved materials", meshCache, 4);
+    }
+}
+
+int runDrawList(const ToolArguments& _arguments)
+{
+    bool passed = checkInterleavedMaterials();
+
+    if (!_arguments.empty())
+    {
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> vertexIndices;
+        ObjLoader objLoader;
+        objLoader.load(_arguments[0], vertices, vertexIndices);
+
+        std::vector<std::string> textures;
+        std::vector<MeshMaterial> meshMaterials;
+        std::vector<Submesh> submeshes = groupTrianglesByMaterial(vertexIndices, objLoader.getTriangleMaterials(), objLoader.getMaterials(),
+            textures, meshMaterials);
+        optimizeMesh(vertices, vertexIndices, submeshes);
+
+        const std::vector<ObjMaterial>& materials = objLoader.getMaterials();
+        for (const Submesh& submesh : submeshes)
+        {
+            std::cout << "\t" << (submesh.materialIndex < materials.size() ? materials[submesh.materialIndex].name : std::string("(none)"))
+                << ": " << submesh.indexCount / 3 << " triangles, texture "
+                << (submesh.textureIndex == Submesh::NO_TEXTURE ? std::string("(none)") : textures[submesh.textureIndex]) << std::endl;
+        }
+
+        MeshCache meshCache;
+        meshCache.build(0, vertices, vertexIndices, submeshes, meshMaterials, textures);
+        passed &= checkDrawList(_arguments[0], meshCache, 0);
+    }
+
+    if (!passed)
+    {
+        std::cerr << setFontColor("Draw list check failed", FontColor::Red) << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+#include "common.h"
+#include "IndexRanges.h"
+#include "MeshOptimizer.h"
+#include "ObjLoader.h"
+#include "ToolCommands.h"
+
+namespace
+{
+    // side x side 񣬶㰴Уΰ
+    void generateGrid(size_t _side, std::vector<uint32_t>& _vertexIndices, size_t& _vertexCount)
+    {
+        _vertexCount = _side * _side;
+        _vertexIndices.clear();
+        for (size_t y = 0; y + 1 < _side; ++y)
+        {
+            for (size_t x = 0; x + 1 < _side; ++x)
+            {
+                const uint32_t v00 = static_cast<uint32_t>(y * _side + x);
+                const uint32_t v10 = v00 + 1;
+                const uint32_t v01 = static_cast<uint32_t>(v00 + _side);
+                const uint32_t v11 = v01 + 1;
+                _vertexIndices.insert(_vertexIndices.end(), { v00, v10, v11, v00, v11, v01 });
+            }
+        }
+    }
+
+    // ͨĻ׼ӳԭÿԭʼȽϣͬʱβӵظȫ
+    bool verifyIndexRanges(const std::vector<uint32_t>& _vertexIndices, const std::vector<uint32_t>& _vertexRemap,
+        const std::vector<uint16_t>& _shortIndices, const std::vector<IndexRange>& _ranges)
+    {
+        size_t nextIndex = 0;
+        for (const IndexRange& range : _ranges)
+        {
+            if (range.firstIndex != nextIndex || range.indexCount % 3 != 0 || range.vertexOffset < 0)
+            {
+                return false;
+            }
+            for (uint32_t i = range.firstIndex; i < range.firstIndex + range.indexCount; ++i)
+            {
+                const size_t vertex = static_cast<size_t>(range.vertexOffset) + _shortIndices[i];
+                if (vertex >= _vertexRemap.size() || _vertexRemap[vertex] != _vertexIndices[i])
+                {
+                    return false;
+                }
+            }
+            nextIndex += range.indexCount;
+        }
+        return nextIndex == _vertexIndices.size();
+    }
+
+    bool checkSplit(const std::string& _name, const std::vector<uint32_t>& _vertexIndices, size_t _vertexCount, size_t _expectedRangeCount)
+    {
+        std::vector<uint32_t> vertexRemap;
+        std::vector<uint16_t> shortIndices;
+        std::vector<IndexRange> ranges;
+        splitIndexRanges(_vertexIndices, 0, _vertexIndices.size(), _vertexCount, vertexRemap, shortIndices, ranges);
+        const bool passed = verifyIndexRanges(_vertexIndices, vertexRemap, shortIndices, ranges)
+            && (_expectedRangeCount == 0 || ranges.size() == _expectedRangeCount);
+
+        const size_t duplicatedVertexCount = vertexRemap.size() > _vertexCount ? vertexRemap.size() - _vertexCount : 0;
+        std::cout << _name << ": " << _vertexCount << " vertices, " << _vertexIndices.size() / 3 << " triangles, "
+            << ranges.size() << " ranges, " << duplicatedVertexCount << " duplicated vertices, index bytes "
+            << sizeof(uint32_t) * _vertexIndices.size() << " -> " << sizeof(uint16_t) * _vertexIndices.size()
+            << (passed ? "  [ok]" : "  [FAILED]") << std::endl;
+        return passed;
+    }
+}
+
+int runIndexSplit(const ToolArguments& _arguments)
+{
+    bool passed = true;
+
+    std::vector<uint32_t> vertexIndices;
+    size_t vertexCount = 0;
+
+    //  16 λΧҪ֡οȳ 16 λԼΪ 0 ʱ
+    generateGrid(256, vertexIndices, vertexCount);
+    passed &= checkSplit("grid 256", vertexIndices, vertexCount, 1);
+
+    generateGrid(1024, vertexIndices, vertexCount);
+    passed &= checkSplit("grid 1024", vertexIndices, vertexCount, 0);
+
+    vertexIndices = { 0, 1, 2, 3, 70000, 4 };
+    passed &= checkSplit("wide triangle", vertexIndices, 70001, 1);
+
+    vertexIndices.clear();
+    passed &= checkSplit("empty", vertexIndices, 0, 0);
+
+    if (!_arguments.empty())
+    {
+        std::vector<Vertex> vertices;
+        ObjLoader objLoader;
+        objLoader.load(_arguments[0], vertices, vertexIndices);
+        optimizeMesh(vertices, vertexIndices);
+        passed &= checkSplit(_arguments[0], vertexIndices, vertices.size(), 0);
+    }
+
+    if (!passed)
+    {
+        std::cerr << setFontColor("Index split check failed", FontColor::Red) << std::endl;
+        return 1;
+    }
+    return 0;
+}
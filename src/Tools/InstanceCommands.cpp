@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "common.h"
+#include "InstanceTransforms.h"
+#include "ToolCommands.h"
+
+namespace
+{
+    // ͬʵ״ֱ̬֡ÿ֡ƽʱ ()
+    double measureUpdate(InstanceTransforms& _instanceTransforms, std::vector<float>& _matrices, uint32_t _frames, bool _simd)
+    {
+        std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+        for (uint32_t frame = 0; frame < _frames; ++frame)
+        {
+            if (_simd)
+            {
+                _instanceTransforms.update(1.0f / 60.0f, _matrices.data());
+            }
+            else
+            {
+                _instanceTransforms.updateScalar(1.0f / 60.0f, _matrices.data());
+            }
+        }
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count() / _frames;
+    }
+}
+
+int runInstanceBench(const ToolArguments& _arguments)
+{
+    const uint32_t frames = _arguments.size() > 1 ? static_cast<uint32_t>(std::stoul(_arguments[1])) : 600;
+    std::vector<uint32_t> counts{ 1, 7, 1024, 16384, 65536 };
+    if (!_arguments.empty())
+    {
+        counts = { static_cast<uint32_t>(std::stoul(_arguments[0])) };
+    }
+
+    std::cout << "SIMD: " << (InstanceTransforms::isSimdEnabled() ? "SSE2" : "disabled (scalar fallback)") << std::endl;
+    bool passed = true;
+    for (uint32_t count : counts)
+    {
+        InstanceTransforms scalarTransforms;
+        InstanceTransforms simdTransforms;
+        scalarTransforms.init(count, 12.0f);
+        simdTransforms.init(count, 12.0f);
+        std::vector<float> scalarMatrices(static_cast<size_t>(count) * InstanceTransforms::MATRIX_FLOAT_COUNT);
+        std::vector<float> simdMatrices(scalarMatrices.size());
+
+        double scalarMilliseconds = measureUpdate(scalarTransforms, scalarMatrices, frames, false);
+        double simdMilliseconds = measureUpdate(simdTransforms, simdMatrices, frames, true);
+
+        //  4 θ£Ӧλͬ
+        InstanceTransforms rangeTransforms;
+        rangeTransforms.init(count, 12.0f);
+        std::vector<float> rangeMatrices(scalarMatrices.size());
+        const uint32_t groupCount = (count + 3) / 4;
+        for (uint32_t frame = 0; frame < frames; ++frame)
+        {
+            for (uint32_t range = 0; range < 3; ++range)
+            {
+                const uint32_t begin = groupCount * range / 3 * 4;
+                const uint32_t end = std::min(groupCount * (range + 1) / 3 * 4, count);
+                rangeTransforms.update(1.0f / 60.0f, rangeMatrices.data(), begin, end);
+            }
+        }
+
+        // ʵֵ˳ͬӦһ£תгӦΪֵ
+        float maxDifference = 0.0f;
+        float maxScaleError = 0.0f;
+        for (size_t i = 0; i < scalarMatrices.size(); ++i)
+        {
+            maxDifference = std::max(maxDifference, std::fabs(scalarMatrices[i] - simdMatrices[i]));
+        }
+        for (size_t i = 0; i < count; ++i)
+        {
+            const float* matrix = &simdMatrices[i * InstanceTransforms::MATRIX_FLOAT_COUNT];
+            float columnLength = std::sqrt(matrix[0] * matrix[0] + matrix[2] * matrix[2]);
+            maxScaleError = std::max(maxScaleError, std::fabs(columnLength - matrix[5]));
+        }
+        bool countPassed = maxDifference <= 1e-5f && maxScaleError <= 1e-4f && rangeMatrices == simdMatrices;
+        passed &= countPassed;
+
+        std::cout << count << " instances: scalar " << scalarMilliseconds << " ms, SIMD " << simdMilliseconds << " ms ("
+            << (simdMilliseconds > 0.0 ? scalarMilliseconds / simdMilliseconds : 0.0) << "x), max difference " << maxDifference
+            << ", max scale error " << maxScaleError << ", ranges " << (rangeMatrices == simdMatrices ? "match" : "differ") << (countPassed ? "  [ok]" : "  [FAILED]") << std::endl;
+    }
+
+    if (!passed)
+    {
+        std::cerr << setFontColor("Instance transform check failed", FontColor::Red) << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,267 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common.h"
+#include "JobSystem.h"
+#include "ToolCommands.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double getMilliseconds(Clock::time_point _startTime)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - _startTime).count();
+    }
+
+    // ύеÿǡִһ
+    bool checkExactlyOnce(JobSystem& _jobSystem, uint32_t _jobCount, std::string& _error)
+    {
+        const uint32_t childCount = 64;
+        const uint32_t parentCount = std::max(1u, _jobCount / childCount);
+        std::vector<std::atomic<uint32_t>> executions(static_cast<size_t>(parentCount) * childCount);
+        JobCounter counter;
+        for (uint32_t parent = 0; parent < parentCount; ++parent)
+        {
+            _jobSystem.spawn([&_jobSystem, &executions, &counter, parent, childCount]()
+            {
+                for (uint32_t child = 0; child < childCount; ++child)
+                {
+                    _jobSystem.spawn([&executions, parent, child, childCount]()
+                    {
+                        executions[static_cast<size_t>(parent) * childCount + child].fetch_add(1, std::memory_order_relaxed);
+                    }, &counter);
+                }
+            }, &counter);
+        }
+        _jobSystem.wait(counter);
+
+        for (size_t i = 0; i < executions.size(); ++i)
+        {
+            if (executions[i].load() != 1)
+            {
+                _error = "job " + std::to_string(i) + " executed " + std::to_string(executions[i].load()) + " times";
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // spawnAfter ļִУѾʱύ
+    bool checkDependencies(JobSystem& _jobSystem, std::string& _error)
+    {
+        const uint32_t jobCount = 256;
+        std::atomic<uint32_t> finishedCount{ 0 };
+        uint32_t observedCount = 0;
+        JobCounter first;
+        JobCounter second;
+        for (uint32_t i = 0; i < jobCount; ++i)
+        {
+            _jobSystem.spawn([&finishedCount]() { finishedCount.fetch_add(1); }, &first);
+        }
+        _jobSystem.spawnAfter(first, [&finishedCount, &observedCount]() { observedCount = finishedCount.load(); }, &second);
+        _jobSystem.wait(second);
+
+        bool lateRan = false;
+        JobCounter late;
+        _jobSystem.spawnAfter(first, [&lateRan]() { lateRan = true; }, &late);
+        _jobSystem.wait(late);
+
+        if (observedCount != jobCount || !lateRan)
+        {
+            _error = "dependent job ran before its dependency finished";
+            return false;
+        }
+        return true;
+    }
+
+    // Ƕ׵ parallelFor ڵȴʱִ񣬲Ϊ̶߳ڵȴ쳣صȴ֮ϵͳȻ
+    bool checkNestingAndExceptions(JobSystem& _jobSystem, std::string& _error)
+    {
+        const size_t outerCount = 64;
+        const size_t innerCount = 1000;
+        std::vector<uint64_t> sums(outerCount, 0);
+        _jobSystem.parallelFor(outerCount, 16, [&](size_t _begin, size_t _end, uint32_t)
+        {
+            for (size_t i = _begin; i < _end; ++i)
+            {
+                std::atomic<uint64_t> sum{ 0 };
+                _jobSystem.parallelFor(innerCount, 4, [&sum](size_t _innerBegin, size_t _innerEnd, uint32_t)
+                {
+                    uint64_t partial = 0;
+                    for (size_t j = _innerBegin; j < _innerEnd; ++j)
+                    {
+                        partial += j;
+                    }
+                    sum.fetch_add(partial);
+                });
+                sums[i] = sum.load();
+            }
+        });
+        for (uint64_t sum : sums)
+        {
+            if (sum != innerCount * (innerCount - 1) / 2)
+            {
+                _error = "nested parallel for produced a wrong sum";
+                return false;
+            }
+        }
+
+        bool thrown = false;
+        try
+        {
+            _jobSystem.parallelFor(64, 8, [](size_t, size_t, uint32_t _chunk)
+            {
+                if (_chunk == 5)
+                {
+                    throw std::runtime_error("expected failure");
+                }
+            });
+        }
+        catch (const std::runtime_error&)
+        {
+            thrown = true;
+        }
+
+        bool ranAfterFailure = false;
+        JobCounter counter;
+        _jobSystem.spawn([&ranAfterFailure]() { ranAfterFailure = true; }, &counter);
+        _jobSystem.wait(counter);
+        if (!thrown || !ranAfterFailure)
+        {
+            _error = "exception was not propagated";
+            return false;
+        }
+        return true;
+    }
+
+    // ߳ύ _jobCount 񲢰æִУÿƽ ()
+    double measureSpawn(JobSystem& _jobSystem, uint32_t _jobCount)
+    {
+        const Clock::time_point startTime = Clock::now();
+        JobCounter counter;
+        for (uint32_t i = 0; i < _jobCount; ++i)
+        {
+            _jobSystem.spawn([]() { }, &counter);
+        }
+        _jobSystem.wait(counter);
+        return getMilliseconds(startTime) * 1e6 / _jobCount;
+    }
+
+    // ֻ߳ύִУ߳ȡÿƽ ()
+    double measureSteal(JobSystem& _jobSystem, uint32_t _jobCount)
+    {
+        const Clock::time_point startTime = Clock::now();
+        JobCounter counter;
+        for (uint32_t i = 0; i < _jobCount; ++i)
+        {
+            _jobSystem.spawn([]() { }, &counter);
+        }
+        while (!counter.isDone())
+        {
+            std::this_thread::yield();
+        }
+        // ȡüȷû쳣֮
+        _jobSystem.wait(counter);
+        return getMilliseconds(startTime) * 1e6 / _jobCount;
+    }
+
+    // ÿԪһ±йصĸ㣬ȣڲ parallelFor չ
+    double measureParallelFor(JobSystem& _jobSystem, std::vector<float>& _results)
+    {
+        const Clock::time_point startTime = Clock::now();
+        _jobSystem.parallelFor(_results.size(), _jobSystem.getThreadCount() * 4, [&_results](size_t _begin, size_t _end, uint32_t)
+        {
+            for (size_t i = _begin; i < _end; ++i)
+            {
+                float value = static_cast<float>(i);
+                for (uint32_t j = 0; j < 256; ++j)
+                {
+                    value = std::sqrt(value * 0.5f + static_cast<float>(j));
+                }
+                _results[i] = value;
+            }
+        });
+        return getMilliseconds(startTime);
+    }
+}
+
+int runJobBench(const ToolArguments& _arguments)
+{
+    const uint32_t maxThreadCount = _arguments.size() > 0 ? std::max(1u, static_cast<uint32_t>(std::stoul(_arguments[0]))) : 64;
+    const uint32_t jobCount = _arguments.size() > 1 ? std::max(1u, static_cast<uint32_t>(std::stoul(_arguments[1]))) : 100000;
+    const size_t itemCount = 1 << 16;
+    const uint32_t repeatCount = 5;
+
+    std::cout << "Hardware threads: " << getDefaultThreadCount() << ", " << jobCount << " empty jobs per spawn measurement, "
+        << itemCount << " items per parallel for" << std::endl;
+
+    bool passed = true;
+    std::vector<float> expected;
+    double baseMilliseconds = 0.0;
+    std::vector<uint32_t> threadCounts;
+    for (uint32_t threadCount = 1; threadCount < maxThreadCount; threadCount *= 2)
+    {
+        threadCounts.push_back(threadCount);
+    }
+    threadCounts.push_back(maxThreadCount);
+
+    for (uint32_t threadCount : threadCounts)
+    {
+        JobSystem jobSystem(threadCount);
+
+        std::string error;
+        bool checksPassed = checkExactlyOnce(jobSystem, jobCount, error) && checkDependencies(jobSystem, error) && checkNestingAndExceptions(jobSystem, error);
+
+        jobSystem.resetStatistics();
+        double spawnNanoseconds = measureSpawn(jobSystem, jobCount);
+        const JobStatistics statistics = jobSystem.getStatistics();
+        double stealNanoseconds = threadCount > 1 ? measureSteal(jobSystem, jobCount) : 0.0;
+
+        // βȡС̵ֵĸ
+        std::vector<float> results(itemCount);
+        double parallelMilliseconds = measureParallelFor(jobSystem, results);
+        for (uint32_t i = 1; i < repeatCount; ++i)
+        {
+            parallelMilliseconds = std::min(parallelMilliseconds, measureParallelFor(jobSystem, results));
+        }
+        if (expected.empty())
+        {
+            expected = results;
+            baseMilliseconds = parallelMilliseconds;
+        }
+        else if (results != expected && checksPassed)
+        {
+            checksPassed = false;
+            error = "parallel for results differ from 1 thread";
+        }
+        passed &= checksPassed;
+
+        std::cout << threadCount << " threads: spawn " << spawnNanoseconds << " ns/job ("
+            << (statistics.executedCount > 0 ? 100.0 * statistics.stolenCount / statistics.executedCount : 0.0) << "% stolen), steal ";
+        if (threadCount > 1)
+        {
+            std::cout << stealNanoseconds << " ns/job";
+        }
+        else
+        {
+            std::cout << "n/a";
+        }
+        std::cout << ", parallel for " << parallelMilliseconds << " ms (" << (parallelMilliseconds > 0.0 ? baseMilliseconds / parallelMilliseconds : 0.0) << "x)  "
+            << (checksPassed ? "[ok]" : "[FAILED] " + error) << std::endl;
+    }
+
+    if (!passed)
+    {
+        std::cerr << setFontColor("Job system test failed", FontColor::Red) << std::endl;
+        return 1;
+    }
+    return 0;
+}
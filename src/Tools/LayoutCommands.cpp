@@ -0,0 +1,42 @@
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
+#include "common.h"
+#include "ObjLoader.h"
+#include "ToolCommands.h"
+#include "VertexLayout.h"
+
+namespace
+{
+    template<typename Layout>
+    void printVertexLayoutReport(const std::vector<Vertex>& _vertices)
+    {
+        const VertexLayoutReport report = measureVertexLayout<Layout>(_vertices);
+        const double savedPercent = report.fullBytes == 0 ? 0.0 : 100.0 * (report.fullBytes - report.layoutBytes) / report.fullBytes;
+        std::cout << std::left << std::setw(10) << Layout::NAME << std::right
+            << std::setw(4) << sizeof(typename Layout::Element) << " B/vertex  "
+            << std::setw(12) << report.layoutBytes << " bytes  saved " << std::fixed << std::setprecision(1) << savedPercent << "%  "
+            << std::scientific << std::setprecision(3) << "max position error " << report.maxPositionError
+            << "  max uv error " << report.maxTexCoordError << std::defaultfloat << std::endl;
+    }
+}
+
+int runLayoutReport(const ToolArguments& _arguments)
+{
+    if (_arguments.empty())
+    {
+        throw std::runtime_error(setFontColor("Usage: layout-report <file.obj>", FontColor::Red));
+    }
+
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> vertexIndices;
+    ObjLoader objLoader;
+    objLoader.load(_arguments[0], vertices, vertexIndices);
+
+    std::cout << vertices.size() << " vertices, current layout: " << GpuVertexLayout::NAME << std::endl;
+    printVertexLayoutReport<FullVertexLayout>(vertices);
+    printVertexLayoutReport<CompactVertexLayout>(vertices);
+    printVertexLayoutReport<QuantizedVertexLayout>(vertices);
+    return 0;
+}
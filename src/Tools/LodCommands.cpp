@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "common.h"
+#include "InstanceTransforms.h"
+#include "LodSelection.h"
+#include "ToolCommands.h"
+
+namespace
+{
+    //  ganyu ģʹ൱İΧ LOD  (ģͿռ)
+    const float BOUNDS_CENTER[3]{ 0.0f, 10.0f, 0.0f };
+    const float BOUNDS_RADIUS = 10.0f;
+    const float LOD_ERRORS[]{ 0.0f, 0.02f, 0.06f, 0.15f };
+    const uint32_t LOD_COUNT = sizeof(LOD_ERRORS) / sizeof(LOD_ERRORS[0]);
+    const float PIXEL_THRESHOLD = 1.0f;
+    const uint32_t VIEWPORT_WIDTH = 1920;
+    const uint32_t VIEWPORT_HEIGHT = 1080;
+
+    struct LodView
+    {
+        const char* name;
+        glm::vec3 eye;
+        glm::vec3 target;
+    };
+
+    // óֱӼͶӰѡеֵһ
+    bool checkSelection(const LodCamera& _camera, const float* _matrices, uint32_t _instanceCount, const uint32_t* _lods, std::string& _error)
+    {
+        for (uint32_t instance = 0; instance < _instanceCount; ++instance)
+        {
+            const float* model = _matrices + static_cast<size_t>(instance) * InstanceTransforms::MATRIX_FLOAT_COUNT;
+            const glm::vec3 center(model[0] * BOUNDS_CENTER[0] + model[4] * BOUNDS_CENTER[1] + model[8] * BOUNDS_CENTER[2] + model[12],
+                model[1] * BOUNDS_CENTER[0] + model[5] * BOUNDS_CENTER[1] + model[9] * BOUNDS_CENTER[2] + model[13],
+                model[2] * BOUNDS_CENTER[0] + model[6] * BOUNDS_CENTER[1] + model[10] * BOUNDS_CENTER[2] + model[14]);
+            const float scale = std::max(glm::length(glm::vec3(model[0], model[1], model[2])),
+                std::max(glm::length(glm::vec3(model[4], model[5], model[6])), glm::length(glm::vec3(model[8], model[9], model[10]))));
+            const float distance = glm::length(center - glm::vec3(_camera.position[0], _camera.position[1], _camera.position[2])) - BOUNDS_RADIUS * scale;
+
+            const uint32_t lod = _lods[instance];
+            auto projectedError = [&](uint32_t _lod) { return LOD_ERRORS[_lod] * scale * _camera.pixelsPerUnit / distance; };
+            // ɵı߽
+            const float tolerance = 1e-4f * PIXEL_THRESHOLD;
+            bool valid = lod < LOD_COUNT;
+            if (valid && distance <= 0.0f)
+            {
+                valid = lod == 0;
+            }
+            else if (valid)
+            {
+                valid = (lod == 0 || projectedError(lod) <= PIXEL_THRESHOLD + tolerance)
+                    && (lod + 1 == LOD_COUNT || projectedError(lod + 1) > PIXEL_THRESHOLD - tolerance);
+            }
+            if (!valid)
+            {
+                _error = "instance " + std::to_string(instance) + " selected LOD " + std::to_string(lod) + " at distance " + std::to_string(distance);
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+int runLodBench(const ToolArguments& _arguments)
+{
+    const uint32_t instanceCount = _arguments.size() > 0 ? static_cast<uint32_t>(std::stoul(_arguments[0])) : 100000;
+    const uint32_t frames = _arguments.size() > 1 ? std::max(1u, static_cast<uint32_t>(std::stoul(_arguments[1]))) : 100;
+
+    InstanceTransforms instanceTransforms;
+    instanceTransforms.init(instanceCount, 12.0f);
+    std::vector<float> matrices(static_cast<size_t>(instanceCount) * InstanceTransforms::MATRIX_FLOAT_COUNT);
+    instanceTransforms.update(0.0f, matrices.data());
+    const float extent = instanceTransforms.getExtent();
+
+    // һӽ Application::updateUniformBuffer ͬڶ濴Զʵ LOD 
+    const LodView views[]
+    {
+        { "overview", glm::vec3(0.0f, 10.0f + extent, 20.0f + 1.5f * extent), glm::vec3(0.0f, 10.0f, 0.0f) },
+        { "ground", glm::vec3(0.0f, 2.0f, extent + 20.0f), glm::vec3(0.0f, 2.0f, 0.0f) }
+    };
+
+    std::cout << instanceCount << " instances, " << LOD_COUNT << " LODs, threshold " << PIXEL_THRESHOLD << " px, " << VIEWPORT_WIDTH << "x" << VIEWPORT_HEIGHT << std::endl;
+    bool passed = true;
+    std::vector<uint32_t> lods(instanceCount);
+    for (const LodView& view : views)
+    {
+        const glm::mat4 viewMatrix = glm::lookAt(view.eye, view.target, glm::vec3(0.0f, 1.0f, 0.0f));
+        glm::mat4 projection = glm::perspective(glm::radians(60.0f), static_cast<float>(VIEWPORT_WIDTH) / VIEWPORT_HEIGHT, 0.1f, 100.0f + 4.0f * extent);
+        projection[1][1] *= -1.0f;
+
+        std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+        LodCamera camera{ };
+        for (uint32_t frame = 0; frame < frames; ++frame)
+        {
+            camera = makeLodCamera(&viewMatrix[0][0], &projection[0][0], VIEWPORT_HEIGHT);
+            selectLods(camera, matrices.data(), instanceCount, BOUNDS_CENTER, BOUNDS_RADIUS, LOD_ERRORS, LOD_COUNT, PIXEL_THRESHOLD, lods.data());
+        }
+        const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count() / frames;
+
+        std::string error;
+        bool viewPassed = glm::length(glm::vec3(camera.position[0], camera.position[1], camera.position[2]) - view.eye) <= 1e-3f * std::max(1.0f, glm::length(view.eye));
+        if (!viewPassed)
+        {
+            error = "camera position does not match the eye";
+        }
+        viewPassed = viewPassed && checkSelection(camera, matrices.data(), instanceCount, lods.data(), error);
+        passed = passed && viewPassed;
+
+        std::vector<uint32_t> histogram(LOD_COUNT, 0);
+        for (uint32_t lod : lods)
+        {
+            ++histogram[std::min(lod, LOD_COUNT - 1)];
+        }
+        std::cout << view.name << ": " << milliseconds << " ms per selection (" << milliseconds * 1e6 / std::max(1u, instanceCount) << " ns per instance), LODs";
+        for (uint32_t count : histogram)
+        {
+            std::cout << " " << count;
+        }
+        std::cout << (viewPassed ? "  [ok]" : "  [FAILED] " + error) << std::endl;
+    }
+
+    if (!passed)
+    {
+        std::cerr << setFontColor("LOD selection check failed", FontColor::Red) << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,330 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <random>
+#include <stdexcept>
+
+#include "common.h"
+#include "FrameRingAllocator.h"
+#include "GpuMemoryAllocator.h"
+#include "ToolCommands.h"
+
+namespace
+{
+    // ģ豸ڴ棺ɼͷʵڴ棬ڼӳָǷص
+    struct MockDeviceMemory
+    {
+        uint32_t memoryTypeIndex = 0;
+        VkDeviceSize size = 0;
+        std::vector<unsigned char> data;
+    };
+
+    struct MockDevice
+    {
+        std::map<VkDeviceMemory, std::unique_ptr<MockDeviceMemory>> memories;
+        uint32_t allocateCount = 0;
+        uint32_t maxMemoryAllocationCount = 4096;
+
+        GpuMemoryCallbacks getCallbacks()
+        {
+            GpuMemoryCallbacks callbacks;
+            callbacks.allocate = [this](uint32_t _memoryTypeIndex, VkDeviceSize _size) -> VkDeviceMemory
+            {
+                if (memories.size() >= maxMemoryAllocationCount)
+                {
+                    return nullptr;
+                }
+                std::unique_ptr<MockDeviceMemory> memory = std::make_unique<MockDeviceMemory>();
+                memory->memoryTypeIndex = _memoryTypeIndex;
+                memory->size = _size;
+                // ֻҪΨһöַ䵱
+                VkDeviceMemory handle = reinterpret_cast<VkDeviceMemory>(memory.get());
+                memories[handle] = std::move(memory);
+                ++allocateCount;
+                return handle;
+            };
+            callbacks.free = [this](VkDeviceMemory _memory)
+            {
+                memories.erase(_memory);
+            };
+            callbacks.map = [this](VkDeviceMemory _memory, VkDeviceSize _size) -> void*
+            {
+                MockDeviceMemory& memory = *memories.at(_memory);
+                memory.data.resize(static_cast<size_t>(_size));
+                return memory.data.data();
+            };
+            return callbacks;
+        }
+    };
+
+    // ԳڴͣԴ桢ڴ桢ӳԴ (ReBAR)
+    VkPhysicalDeviceMemoryProperties getMockMemoryProperties()
+    {
+        VkPhysicalDeviceMemoryProperties memoryProperties{ };
+        memoryProperties.memoryHeapCount = 3;
+        memoryProperties.memoryHeaps[0] = { 8ull * 1024 * 1024 * 1024, VK_MEMORY_HEAP_DEVICE_LOCAL_BIT };
+        memoryProperties.memoryHeaps[1] = { 16ull * 1024 * 1024 * 1024, 0 };
+        memoryProperties.memoryHeaps[2] = { 256ull * 1024 * 1024, VK_MEMORY_HEAP_DEVICE_LOCAL_BIT };
+        memoryProperties.memoryTypeCount = 3;
+        memoryProperties.memoryTypes[0] = { VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0 };
+        memoryProperties.memoryTypes[1] = { VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT, 1 };
+        memoryProperties.memoryTypes[2] = { VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, 2 };
+        return memoryProperties;
+    }
+
+    struct LiveAllocation
+    {
+        GpuAllocation allocation;
+        VkDeviceSize alignment = 1;
+        GpuResourceKind kind = GpuResourceKind::Linear;
+        unsigned char pattern = 0;
+    };
+
+    bool check(bool _condition, const std::string& _message, std::string& _error)
+    {
+        if (!_condition && _error.empty())
+        {
+            _error = _message;
+        }
+        return _condition;
+    }
+
+    // ʱڴͺʹСΧڣͬһ豸ڴеķ䲻صԴŲͼͬһ
+    bool checkLiveAllocations(const MockDevice& _device, const std::vector<LiveAllocation>& _allocations, std::string& _error)
+    {
+        std::vector<const LiveAllocation*> sorted;
+        for (const LiveAllocation& allocation : _allocations)
+        {
+            sorted.push_back(&allocation);
+            const GpuAllocation& gpuAllocation = allocation.allocation;
+            const auto memory = _device.memories.find(gpuAllocation.memory);
+            if (!check(memory != _device.memories.end(), "allocation in freed memory", _error)
+                || !check(memory->second->memoryTypeIndex == gpuAllocation.memoryTypeIndex, "memory type differs from the device memory", _error)
+                || !check(gpuAllocation.offset + gpuAllocation.size <= memory->second->size, "allocation past the end of the device memory", _error))
+            {
+                return false;
+            }
+            if (!check(gpuAllocation.offset % allocation.alignment == 0, "misaligned offset " + std::to_string(gpuAllocation.offset), _error))
+            {
+                return false;
+            }
+            if (gpuAllocation.mapped != nullptr && gpuAllocation.size > 0)
+            {
+                const unsigned char* data = static_cast<const unsigned char*>(gpuAllocation.mapped);
+                if (!check(data[0] == allocation.pattern && data[gpuAllocation.size - 1] == allocation.pattern, "mapped memory overwritten", _error))
+                {
+                    return false;
+                }
+            }
+        }
+
+        std::sort(sorted.begin(), sorted.end(), [](const LiveAllocation* _a, const LiveAllocation* _b)
+        {
+            return _a->allocation.memory != _b->allocation.memory ? _a->allocation.memory < _b->allocation.memory : _a->allocation.offset < _b->allocation.offset;
+        });
+        for (size_t i = 1; i < sorted.size(); ++i)
+        {
+            const LiveAllocation& previous = *sorted[i - 1];
+            const LiveAllocation& current = *sorted[i];
+            if (previous.allocation.memory != current.allocation.memory)
+            {
+                continue;
+            }
+            if (!check(previous.allocation.offset + previous.allocation.size <= current.allocation.offset, "overlapping allocations", _error)
+                || !check(previous.kind == current.kind, "linear and optimal resources share a block", _error))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool runStress(uint32_t _iterations)
+    {
+        MockDevice device;
+        GpuMemoryAllocator allocator;
+        allocator.init(getMockMemoryProperties(), 1024, device.getCallbacks(), 16 * 1024 * 1024);
+
+        std::string error;
+        check(allocator.findMemoryType(0x7, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) == 0, "device local type", error);
+        check(allocator.findMemoryType(0x6, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) == 2, "memoryTypeBits filter", error);
+        check(allocator.findMemoryType(0x7, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) == 1, "host visible type", error);
+
+        // ͷţСͶ븲ǳĻͼ
+        std::mt19937 random(12345);
+        std::vector<LiveAllocation> allocations;
+        uint32_t totalAllocations = 0;
+        uint32_t dedicatedAllocations = 0;
+        std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < _iterations && error.empty(); ++i)
+        {
+            if (!allocations.empty() && random() % 100 < 45)
+            {
+                size_t index = random() % allocations.size();
+                allocator.free(allocations[index].allocation);
+                allocations[index] = std::move(allocations.back());
+                allocations.pop_back();
+                continue;
+            }
+
+            LiveAllocation allocation;
+            allocation.kind = random() % 3 == 0 ? GpuResourceKind::Optimal : GpuResourceKind::Linear;
+            allocation.alignment = VkDeviceSize(1) << (random() % 17);
+            allocation.pattern = static_cast<unsigned char>(1 + random() % 255);
+            VkMemoryRequirements memoryRequirements
+            {
+                256 + random() % (random() % 50 == 0 ? 12 * 1024 * 1024 : 512 * 1024),     // size
+                allocation.alignment,                                                       // alignment
+                0x7                                                                         // memoryTypeBits
+            };
+            VkMemoryPropertyFlags properties = random() % 4 == 0 ? VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT : VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+            allocation.allocation = allocator.allocate(memoryRequirements, properties, allocation.kind);
+            if (allocation.allocation.mapped != nullptr)
+            {
+                std::memset(allocation.allocation.mapped, allocation.pattern, static_cast<size_t>(allocation.allocation.size));
+            }
+            dedicatedAllocations += allocation.allocation.dedicated ? 1 : 0;
+            ++totalAllocations;
+            allocations.push_back(allocation);
+
+            if (i % 256 == 0)
+            {
+                checkLiveAllocations(device, allocations, error) && allocator.validate(error);
+            }
+        }
+        double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+        if (error.empty())
+        {
+            checkLiveAllocations(device, allocations, error) && allocator.validate(error);
+        }
+
+        GpuMemoryStatistics peakStatistics = allocator.getStatistics();
+        std::cout << allocator.getStatisticsJson();
+
+        for (LiveAllocation& allocation : allocations)
+        {
+            allocator.free(allocation.allocation);
+        }
+        allocations.clear();
+
+        // ȫͷźÿ鶼Ӧϲһ
+        GpuMemoryStatistics statistics = allocator.getStatistics();
+        for (const GpuMemoryTypeStatistics& memoryType : statistics.memoryTypes)
+        {
+            check(memoryType.usedBytes == 0 && memoryType.freeRegionCount == memoryType.blockCount && memoryType.dedicatedCount == 0,
+                "blocks not coalesced after freeing everything", error);
+        }
+        if (error.empty())
+        {
+            allocator.validate(error);
+        }
+
+        std::cout << "stress: " << totalAllocations << " allocations (" << dedicatedAllocations << " dedicated), "
+            << device.allocateCount << " vkAllocateMemory calls, peak " << peakStatistics.peakDeviceMemoryCount << " live device memories, "
+            << milliseconds << " ms" << (error.empty() ? "  [ok]" : "  [FAILED] " + error) << std::endl;
+
+        allocator.destroy();
+        return error.empty() && device.memories.empty();
+    }
+
+    bool runExhaustion()
+    {
+        // maxMemoryAllocationCount СʱǧСֻռ豸ڴ
+        MockDevice device;
+        device.maxMemoryAllocationCount = 4;
+        GpuMemoryAllocator allocator;
+        allocator.init(getMockMemoryProperties(), 1, device.getCallbacks(), 4 * 1024 * 1024);
+
+        std::string error;
+        std::vector<GpuAllocation> allocations;
+        for (uint32_t i = 0; i < 4096; ++i)
+        {
+            allocations.push_back(allocator.allocate(VkMemoryRequirements{ 1024 + i % 7 * 256, 256, 0x7 }, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, GpuResourceKind::Linear));
+        }
+        check(allocator.getStatistics().deviceMemoryCount <= device.maxMemoryAllocationCount, "too many device memories", error);
+
+        // ʱӦ׳쳣Ƿؿյķ
+        bool threw = false;
+        try
+        {
+            for (uint32_t i = 0; i < 64; ++i)
+            {
+                allocations.push_back(allocator.allocate(VkMemoryRequirements{ 3 * 1024 * 1024, 256, 0x7 }, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, GpuResourceKind::Linear));
+            }
+        }
+        catch (const std::runtime_error&)
+        {
+            threw = true;
+        }
+        check(threw, "allocation beyond maxMemoryAllocationCount did not fail", error);
+
+        for (GpuAllocation& allocation : allocations)
+        {
+            allocator.free(allocation);
+        }
+        uint32_t deviceMemoryCount = allocator.getStatistics().deviceMemoryCount;
+        allocator.destroy();
+
+        std::cout << "exhaustion: 4096 allocations in " << deviceMemoryCount << " device memories"
+            << (error.empty() ? "  [ok]" : "  [FAILED] " + error) << std::endl;
+        return error.empty() && device.memories.empty();
+    }
+
+    bool runFrameRing()
+    {
+        // ֡ÿ֡ 1000 ֽ (뵽 1024)ҲԽ֡
+        const uint32_t frameCount = 3;
+        std::vector<unsigned char> buffer(static_cast<size_t>(FrameRingAllocator::getBufferSize(1000, frameCount, 256)));
+        FrameRingAllocator frameRingAllocator;
+        frameRingAllocator.init(buffer.data(), 1000, frameCount, 256);
+
+        std::string error;
+        check(buffer.size() == 3 * 1024 && frameRingAllocator.getFrameSize() == 1024, "frame size not aligned", error);
+        for (uint32_t frame = 0; frame < 2 * frameCount; ++frame)
+        {
+            frameRingAllocator.beginFrame(frame);
+            const uint64_t frameBegin = (frame % frameCount) * frameRingAllocator.getFrameSize();
+            for (uint32_t i = 0; i < 4; ++i)
+            {
+                FrameRingAllocation allocation = frameRingAllocator.allocate(192);
+                check(allocation.offset % 256 == 0, "misaligned slice", error);
+                check(allocation.offset == frameBegin + i * 256, "slice outside its frame", error);
+                check(allocation.mapped == buffer.data() + allocation.offset, "mapped pointer mismatch", error);
+            }
+
+            bool threw = false;
+            try
+            {
+                frameRingAllocator.allocate(1);
+            }
+            catch (const std::runtime_error&)
+            {
+                threw = true;
+            }
+            check(threw, "frame overflow not detected", error);
+        }
+        check(frameRingAllocator.getPeakFrameUsedBytes() == 4 * 256 - 64, "peak usage", error);
+
+        std::cout << "frame ring: " << frameCount << " x " << frameRingAllocator.getFrameSize() << " bytes"
+            << (error.empty() ? "  [ok]" : "  [FAILED] " + error) << std::endl;
+        return error.empty();
+    }
+}
+
+int runMemoryTest(const ToolArguments& _arguments)
+{
+    uint32_t iterations = _arguments.empty() ? 100000 : static_cast<uint32_t>(std::stoul(_arguments[0]));
+
+    bool passed = runStress(iterations);
+    passed &= runExhaustion();
+    passed &= runFrameRing();
+
+    if (!passed)
+    {
+        std::cerr << setFontColor("GPU memory allocator check failed", FontColor::Red) << std::endl;
+        return 1;
+    }
+    return 0;
+}
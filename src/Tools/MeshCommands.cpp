@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#include "common.h"
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include "ObjLoader.h"
+#include "ToolCommands.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double elapsedMilliseconds(Clock::time_point _start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - _start).count();
+    }
+
+    void bakeMeshCache(const std::string& _objFilename, const std::string& _cacheFilename, MeshCache& _meshCache)
+    {
+        const uint64_t sourceHash = MeshCache::computeSourceHash(_objFilename);
+
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> vertexIndices;
+        ObjLoader objLoader;
+        objLoader.load(_objFilename, vertices, vertexIndices);
+
+        std::vector<std::string> textures;
+        std::vector<MeshMaterial> materials;
+        std::vector<Submesh> submeshes = groupTrianglesByMaterial(vertexIndices, objLoader.getTriangleMaterials(), objLoader.getMaterials(),
+            textures, materials);
+        optimizeMesh(vertices, vertexIndices, submeshes);
+
+        _meshCache.build(sourceHash, vertices, vertexIndices, submeshes, materials, textures);
+        if (!_meshCache.save(_cacheFilename))
+        {
+            throw std::runtime_error(setFontColor("Failed to write mesh cache: " + _cacheFilename, FontColor::Red));
+        }
+    }
+}
+
+int runMeshBake(const ToolArguments& _arguments)
+{
+    if (_arguments.empty())
+    {
+        throw std::runtime_error(setFontColor("Usage: mesh-bake <file.obj> [out.meshcache]", FontColor::Red));
+    }
+
+    const std::string& objFilename = _arguments[0];
+    const std::string cacheFilename = _arguments.size() > 1 ? _arguments[1] : MeshCache::getCacheFilename(objFilename);
+
+    Clock::time_point start = Clock::now();
+    MeshCache meshCache;
+    bakeMeshCache(objFilename, cacheFilename, meshCache);
+
+    std::cout << setFontColor("Baked " + cacheFilename + ": " + std::to_string(meshCache.getVertexCount()) + " vertices, "
+        + std::to_string(meshCache.getLods()[0].indexCount / 3) + " triangles, " + std::to_string(meshCache.getVertexIndexSize() * 8) + " bit indices in "
+        + std::to_string(meshCache.getIndexRangeCount()) + " ranges, " + std::to_string(meshCache.getMeshletCount()) + " meshlets, " + std::to_string(meshCache.getSubmeshCount()) + " submeshes, "
+        + std::to_string(meshCache.getTextures().size()) + " textures, " + std::to_string(meshCache.size()) + " bytes, "
+        + std::to_string(elapsedMilliseconds(start)) + " ms", FontColor::Green) << std::endl;
+    for (size_t i = 0; i < meshCache.getLodCount(); ++i)
+    {
+        const MeshLod& lod = meshCache.getLods()[i];
+        std::cout << "LOD " << i << ": " << lod.indexCount / 3 << " triangles, error " << lod.error << std::endl;
+    }
+    return 0;
+}
+
+int runMeshBench(const ToolArguments& _arguments)
+{
+    if (_arguments.empty())
+    {
+        throw std::runtime_error(setFontColor("Usage: mesh-bench <file.obj> [iterations]", FontColor::Red));
+    }
+
+    const std::string& objFilename = _arguments[0];
+    const uint32_t iterations = _arguments.size() > 1 ? std::max(1u, static_cast<uint32_t>(std::stoul(_arguments[1]))) : 5u;
+    const std::string cacheFilename = MeshCache::getCacheFilename(objFilename) + ".bench";
+
+    // ûл棬Ҫ objӶ㡢Żд
+    Clock::time_point start = Clock::now();
+    {
+        MeshCache meshCache;
+        bakeMeshCache(objFilename, cacheFilename, meshCache);
+    }
+    const double coldMilliseconds = elapsedMilliseconds(start);
+
+    // УԴļϣӳ仺沢ݴڴ (ģ createVertexBuffer е memcpy)
+    std::vector<char> staging;
+    double warmTotalMilliseconds = 0.0;
+    double warmMinMilliseconds = 0.0;
+    for (uint32_t i = 0; i < iterations; ++i)
+    {
+        start = Clock::now();
+        MeshCache meshCache;
+        if (!meshCache.open(cacheFilename, MeshCache::computeSourceHash(objFilename)))
+        {
+            throw std::runtime_error(setFontColor("Failed to open mesh cache: " + cacheFilename, FontColor::Red));
+        }
+
+        const size_t vertexBytes = sizeof(GpuVertex) * meshCache.getVertexCount();
+        const size_t vertexIndexBytes = meshCache.getVertexIndexSize() * meshCache.getVertexIndexCount();
+        staging.resize(vertexBytes + vertexIndexBytes);
+        std::memcpy(staging.data(), meshCache.getVertices(), vertexBytes);
+        std::memcpy(staging.data() + vertexBytes, meshCache.getVertexIndexData(), vertexIndexBytes);
+
+        double milliseconds = elapsedMilliseconds(start);
+        warmTotalMilliseconds += milliseconds;
+        warmMinMilliseconds = i == 0 ? milliseconds : std::min(warmMinMilliseconds, milliseconds);
+    }
+    std::remove(cacheFilename.c_str());
+
+    std::cout << "cold (parse + weld + optimize + write cache): " << coldMilliseconds << " ms\n"
+        << "warm (hash + map + copy, " << iterations << " runs): min " << warmMinMilliseconds
+        << " ms, avg " << warmTotalMilliseconds / iterations << " ms\n"
+        << "speedup x" << coldMilliseconds / std::max(warmMinMilliseconds, 1e-6) << std::endl;
+    return 0;
+}
@@ -0,0 +1,166 @@
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+#include "common.h"
+#include "MeshletBuilder.h"
+#include "MeshOptimizer.h"
+#include "ObjLoader.h"
+#include "ToolCommands.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    const float PI = 3.14159265358979f;
+
+    // 棬_rings Ϊķֶ_sides ΪԲķֶγ
+    void generateTorus(uint32_t _rings, uint32_t _sides, std::vector<glm::vec3>& _positions, std::vector<uint32_t>& _vertexIndices)
+    {
+        const float majorRadius = 1.0f;
+        const float minorRadius = 0.35f;
+        _positions.clear();
+        _vertexIndices.clear();
+        for (uint32_t ring = 0; ring < _rings; ++ring)
+        {
+            const float u = 2.0f * PI * ring / _rings;
+            for (uint32_t side = 0; side < _sides; ++side)
+            {
+                const float v = 2.0f * PI * side / _sides;
+                const float distance = majorRadius + minorRadius * std::cos(v);
+                _positions.emplace_back(distance * std::cos(u), distance * std::sin(u), minorRadius * std::sin(v));
+            }
+        }
+        for (uint32_t ring = 0; ring < _rings; ++ring)
+        {
+            for (uint32_t side = 0; side < _sides; ++side)
+            {
+                const uint32_t v00 = ring * _sides + side;
+                const uint32_t v01 = ring * _sides + (side + 1) % _sides;
+                const uint32_t v10 = (ring + 1) % _rings * _sides + side;
+                const uint32_t v11 = (ring + 1) % _rings * _sides + (side + 1) % _sides;
+                _vertexIndices.insert(_vertexIndices.end(), { v00, v10, v11, v00, v11, v01 });
+            }
+        }
+    }
+
+    bool isTriangleBackfacing(const glm::vec3& _p0, const glm::vec3& _p1, const glm::vec3& _p2, const glm::vec3& _cameraPosition)
+    {
+        return glm::dot(glm::cross(_p1 - _p0, _p2 - _p0), _p0 - _cameraPosition) >= 0.0f;
+    }
+
+    //  6 ۲ģͣͳƷ׶޳αʵʱα
+    // ޳ĴֻҪһγ˵׶أ false
+    bool reportConeCulling(const MeshletData& _data, const std::vector<glm::vec3>& _positions)
+    {
+        glm::vec3 minimum = _positions[0];
+        glm::vec3 maximum = _positions[0];
+        for (const glm::vec3& position : _positions)
+        {
+            minimum = glm::min(minimum, position);
+            maximum = glm::max(maximum, position);
+        }
+        const glm::vec3 center = (minimum + maximum) * 0.5f;
+        const float distance = glm::length(maximum - minimum) * 1.5f + 1e-3f;
+
+        struct View
+        {
+            const char* name;
+            glm::vec3 direction;
+        };
+        const View views[]
+        {
+            { "+x", glm::vec3(1.0f, 0.0f, 0.0f) },
+            { "-x", glm::vec3(-1.0f, 0.0f, 0.0f) },
+            { "+y", glm::vec3(0.0f, 1.0f, 0.0f) },
+            { "-y", glm::vec3(0.0f, -1.0f, 0.0f) },
+            { "+z", glm::vec3(0.0f, 0.0f, 1.0f) },
+            { "-z", glm::vec3(0.0f, 0.0f, -1.0f) }
+        };
+
+        bool passed = true;
+        for (const View& view : views)
+        {
+            const glm::vec3 cameraPosition = center + view.direction * distance;
+            size_t triangleCount = 0;
+            size_t culledTriangleCount = 0;
+            size_t backfacingTriangleCount = 0;
+            size_t culledMeshletCount = 0;
+            size_t falseCullCount = 0;
+            for (const Meshlet& meshlet : _data.meshlets)
+            {
+                const bool culled = isMeshletBackfacing(meshlet, cameraPosition);
+                culledMeshletCount += culled ? 1 : 0;
+                for (uint32_t i = 0; i < meshlet.triangleCount; ++i)
+                {
+                    const uint8_t* triangle = &_data.triangles[(static_cast<size_t>(meshlet.triangleOffset) + i) * 3];
+                    const bool backfacing = isTriangleBackfacing(_positions[_data.vertices[meshlet.vertexOffset + triangle[0]]],
+                        _positions[_data.vertices[meshlet.vertexOffset + triangle[1]]], _positions[_data.vertices[meshlet.vertexOffset + triangle[2]]],
+                        cameraPosition);
+                    ++triangleCount;
+                    backfacingTriangleCount += backfacing ? 1 : 0;
+                    culledTriangleCount += culled ? 1 : 0;
+                    falseCullCount += culled && !backfacing ? 1 : 0;
+                }
+            }
+
+            const double culledRatio = triangleCount == 0 ? 0.0 : static_cast<double>(culledTriangleCount) / triangleCount;
+            const double backfacingRatio = triangleCount == 0 ? 0.0 : static_cast<double>(backfacingTriangleCount) / triangleCount;
+            std::cout << "view " << view.name << ": culled meshlets " << culledMeshletCount << "/" << _data.meshlets.size()
+                << ", culled triangles " << culledRatio * 100.0 << "%, backfacing triangles " << backfacingRatio * 100.0 << "%"
+                << (falseCullCount == 0 ? "  [ok]" : "  [FAILED] " + std::to_string(falseCullCount) + " front-facing triangles culled") << std::endl;
+            passed = passed && falseCullCount == 0;
+        }
+        return passed;
+    }
+}
+
+int runMeshletBench(const ToolArguments& _arguments)
+{
+    std::vector<glm::vec3> positions;
+    std::vector<uint32_t> vertexIndices;
+    if (_arguments.empty())
+    {
+        generateTorus(256, 96, positions, vertexIndices);
+        std::cout << "torus";
+    }
+    else
+    {
+        // ģʱͬ㻺ŻذŻ˳
+        std::vector<Vertex> vertices;
+        ObjLoader objLoader;
+        objLoader.load(_arguments[0], vertices, vertexIndices);
+        optimizeMesh(vertices, vertexIndices);
+        positions.reserve(vertices.size());
+        for (const Vertex& vertex : vertices)
+        {
+            positions.push_back(vertex.positionOS);
+        }
+        std::cout << _arguments[0];
+    }
+    std::cout << ": " << positions.size() << " vertices, " << vertexIndices.size() / 3 << " triangles" << std::endl;
+    if (vertexIndices.empty())
+    {
+        std::cerr << setFontColor("Mesh has no triangles", FontColor::Red) << std::endl;
+        return 1;
+    }
+
+    MeshletData data;
+    Clock::time_point start = Clock::now();
+    buildMeshlets(vertexIndices.data(), vertexIndices.size(), positions, 0, data);
+    const double buildMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    const MeshletStatistics statistics = analyzeMeshlets(data.meshlets.data(), data.meshlets.size());
+    std::cout << "build " << buildMilliseconds << " ms, " << statistics.meshletCount << " meshlets, average "
+        << statistics.averageVertexCount << " vertices (" << statistics.vertexFill * 100.0f << "%), "
+        << statistics.averageTriangleCount << " triangles (" << statistics.triangleFill * 100.0f << "%)" << std::endl;
+
+    std::string error;
+    if (!validateMeshlets(data, vertexIndices.data(), vertexIndices.size(), positions, error))
+    {
+        std::cerr << setFontColor("Invalid meshlets: " + error, FontColor::Red) << std::endl;
+        return 1;
+    }
+
+    return reportConeCulling(data, positions) ? 0 : 1;
+}
@@ -0,0 +1,235 @@
+#include <tiny_obj_loader.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "common.h"
+#include "ObjLoader.h"
+#include "ParallelFor.h"
+#include "ToolCommands.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double elapsedMilliseconds(Clock::time_point _start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - _start).count();
+    }
+
+    // ԭ Application::loadModel ʵ֣Ϊ
+    void loadReference(const std::string& _filename, std::vector<Vertex>& _vertices, std::vector<uint32_t>& _vertexIndices)
+    {
+        tinyobj::attrib_t attrib;
+        std::vector<tinyobj::shape_t> shapes;
+        std::vector<tinyobj::material_t> materials;
+        std::string warn, err;
+
+        if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, _filename.c_str()))
+        {
+            throw std::runtime_error(setFontColor(warn + err, FontColor::Red));
+        }
+
+        std::unordered_map<Vertex, uint32_t> uniqueVertices{ };
+        for (const tinyobj::shape_t& shape : shapes)
+        {
+            for (const tinyobj::index_t& index : shape.mesh.indices)
+            {
+                Vertex vertex{ };
+                vertex.positionOS =
+                {
+                    attrib.vertices[3 * index.vertex_index + 0],
+                    attrib.vertices[3 * index.vertex_index + 1],
+                    attrib.vertices[3 * index.vertex_index + 2]
+                };
+                if (index.texcoord_index >= 0)
+                {
+                    vertex.texCoord =
+                    {
+                        attrib.texcoords[2 * index.texcoord_index + 0],
+                        1.0f - attrib.texcoords[2 * index.texcoord_index + 1]
+                    };
+                }
+                else
+                {
+                    vertex.texCoord = { 0.0f, 1.0f };
+                }
+                vertex.color = { 1.0f, 1.0f, 1.0f };
+
+                if (uniqueVertices.count(vertex) == 0)
+                {
+                    uniqueVertices[vertex] = static_cast<uint32_t>(_vertices.size());
+                    _vertices.push_back(vertex);
+                }
+                _vertexIndices.push_back(uniqueVertices[vertex]);
+            }
+        }
+    }
+
+    bool compareResults(const std::vector<Vertex>& _expectedVertices, const std::vector<uint32_t>& _expectedIndices,
+                        const std::vector<Vertex>& _vertices, const std::vector<uint32_t>& _indices)
+    {
+        if (_expectedVertices.size() != _vertices.size() || _expectedIndices.size() != _indices.size())
+        {
+            std::cerr << setFontColor("Size mismatch: vertices " + std::to_string(_vertices.size()) + " (expected " + std::to_string(_expectedVertices.size())
+                + "), indices " + std::to_string(_indices.size()) + " (expected " + std::to_string(_expectedIndices.size()) + ")", FontColor::Red) << std::endl;
+            return false;
+        }
+
+        for (size_t i = 0; i < _vertices.size(); ++i)
+        {
+            if (!(_vertices[i] == _expectedVertices[i]))
+            {
+                std::cerr << setFontColor("Vertex mismatch at " + std::to_string(i), FontColor::Red) << std::endl;
+                return false;
+            }
+        }
+
+        for (size_t i = 0; i < _indices.size(); ++i)
+        {
+            if (_indices[i] != _expectedIndices[i])
+            {
+                std::cerr << setFontColor("Index mismatch at " + std::to_string(i), FontColor::Red) << std::endl;
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    std::string formatStatistics(const std::string& _name, const ObjLoadStatistics& _statistics)
+    {
+        return _name + " (" + std::to_string(_statistics.threadCount) + " threads): "
+            + std::to_string(_statistics.totalMilliseconds()) + " ms"
+            + " [map " + std::to_string(_statistics.mapMilliseconds)
+            + ", parse " + std::to_string(_statistics.parseMilliseconds)
+            + ", triangulate " + std::to_string(_statistics.triangulateMilliseconds)
+            + ", weld " + std::to_string(_statistics.weldMilliseconds) + "]";
+    }
+}
+
+int runObjBench(const ToolArguments& _arguments)
+{
+    if (_arguments.empty())
+    {
+        throw std::runtime_error(setFontColor("Usage: obj-bench <file.obj> [threads]", FontColor::Red));
+    }
+
+    const std::string& filename = _arguments[0];
+    const uint32_t threadCount = _arguments.size() > 1 ? static_cast<uint32_t>(std::stoul(_arguments[1])) : getDefaultThreadCount();
+
+    std::vector<Vertex> referenceVertices;
+    std::vector<uint32_t> referenceIndices;
+    Clock::time_point start = Clock::now();
+    loadReference(filename, referenceVertices, referenceIndices);
+    double referenceMilliseconds = elapsedMilliseconds(start);
+    std::cout << "tinyobjloader: " << referenceMilliseconds << " ms, "
+        << referenceIndices.size() / 3 << " triangles, " << referenceVertices.size() << " vertices" << std::endl;
+
+    bool identical = true;
+    for (uint32_t threads : { 1u, threadCount })
+    {
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;
+        ObjLoader objLoader(threads);
+        objLoader.load(filename, vertices, indices);
+
+        const ObjLoadStatistics& statistics = objLoader.getStatistics();
+        std::cout << formatStatistics("ObjLoader", statistics)
+            << ", speedup x" << referenceMilliseconds / std::max(statistics.totalMilliseconds(), 1e-6) << std::endl;
+
+        identical = compareResults(referenceVertices, referenceIndices, vertices, indices) && identical;
+    }
+
+    std::cout << setFontColor(identical ? "Results identical" : "Results differ", identical ? FontColor::Green : FontColor::Red) << std::endl;
+    return identical ? 0 : 1;
+}
+
+int runObjGen(const ToolArguments& _arguments)
+{
+    if (_arguments.size() < 2)
+    {
+        throw std::runtime_error(setFontColor("Usage: obj-gen <out.obj> <triangles>", FontColor::Red));
+    }
+
+    const std::string& filename = _arguments[0];
+    const size_t triangleCount = std::stoull(_arguments[1]);
+    const size_t side = std::max<size_t>(1, static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(triangleCount) / 2.0))));
+    const size_t columns = side + 1;
+    const size_t vertexCount = columns * columns;
+
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open())
+    {
+        throw std::runtime_error(setFontColor("Failed to create file: " + filename, FontColor::Red));
+    }
+
+    std::string buffer;
+    buffer.reserve(1 << 20);
+    char line[256];
+    auto flush = [&]()
+    {
+        if (buffer.size() > (1 << 20) - sizeof(line))
+        {
+            file.write(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+    };
+
+    for (size_t y = 0; y < columns; ++y)
+    {
+        for (size_t x = 0; x < columns; ++x)
+        {
+            float u = static_cast<float>(x) / side;
+            float v = static_cast<float>(y) / side;
+            std::snprintf(line, sizeof(line), "v %.6f %.6f %.6f\n", u * 2.0f - 1.0f, 0.1f * std::sin(u * 40.0f) * std::cos(v * 40.0f), v * 2.0f - 1.0f);
+            buffer += line;
+            flush();
+        }
+    }
+    for (size_t y = 0; y < columns; ++y)
+    {
+        for (size_t x = 0; x < columns; ++x)
+        {
+            std::snprintf(line, sizeof(line), "vt %.6f %.6f\n", static_cast<float>(x) / side, static_cast<float>(y) / side);
+            buffer += line;
+            flush();
+        }
+    }
+
+    // żʹıΣʹø()Σдܸǵ
+    size_t written = 0;
+    for (size_t y = 0; y < side && written < triangleCount; ++y)
+    {
+        for (size_t x = 0; x < side && written < triangleCount; ++x)
+        {
+            long long a = static_cast<long long>(y * columns + x + 1);
+            long long b = a + 1;
+            long long c = a + static_cast<long long>(columns) + 1;
+            long long d = a + static_cast<long long>(columns);
+            if (y % 2 == 0)
+            {
+                std::snprintf(line, sizeof(line), "f %lld/%lld %lld/%lld %lld/%lld %lld/%lld\n", a, a, b, b, c, c, d, d);
+                written += 2;
+            }
+            else
+            {
+                long long offset = static_cast<long long>(vertexCount) + 1;
+                std::snprintf(line, sizeof(line), "f %lld/%lld %lld/%lld %lld/%lld\nf %lld/%lld %lld/%lld %lld/%lld\n",
+                    a - offset, a - offset, b - offset, b - offset, c - offset, c - offset,
+                    a - offset, a - offset, c - offset, c - offset, d - offset, d - offset);
+                written += 2;
+            }
+            buffer += line;
+            flush();
+        }
+    }
+    file.write(buffer.data(), buffer.size());
+
+    std::cout << setFontColor("Generated " + filename + ": " + std::to_string(vertexCount) + " vertices, " + std::to_string(written) + " triangles", FontColor::Green) << std::endl;
+    return 0;
+}
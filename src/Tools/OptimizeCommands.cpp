@@ -0,0 +1,71 @@
+#include <chrono>
+#include <stdexcept>
+
+#include "common.h"
+#include "MeshOptimizer.h"
+#include "ObjLoader.h"
+#include "ToolCommands.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double elapsedMilliseconds(Clock::time_point _start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - _start).count();
+    }
+
+    void printVertexCacheStatistics(const std::string& _name, const std::vector<uint32_t>& _vertexIndices, size_t _vertexCount)
+    {
+        std::cout << _name << ":";
+        for (uint32_t cacheSize : { 16u, 32u })
+        {
+            VertexCacheStatistics statistics = analyzeVertexCache(_vertexIndices, _vertexCount, cacheSize);
+            std::cout << "  FIFO " << cacheSize << " ACMR " << statistics.acmr << " ATVR " << statistics.atvr;
+        }
+        std::cout << std::endl;
+    }
+}
+
+int runMeshOptimize(const ToolArguments& _arguments)
+{
+    if (_arguments.empty())
+    {
+        throw std::runtime_error(setFontColor("Usage: mesh-opt <file.obj>", FontColor::Red));
+    }
+
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> vertexIndices;
+    ObjLoader objLoader;
+    objLoader.load(_arguments[0], vertices, vertexIndices);
+
+    const VertexCacheStatistics before = analyzeVertexCache(vertexIndices, vertices.size());
+    printVertexCacheStatistics("before", vertexIndices, vertices.size());
+
+    Clock::time_point start = Clock::now();
+    optimizeVertexCache(vertexIndices, vertices.size());
+    const double vertexCacheMilliseconds = elapsedMilliseconds(start);
+    printVertexCacheStatistics("vertex cache", vertexIndices, vertices.size());
+
+    start = Clock::now();
+    optimizeOverdraw(vertexIndices, vertices);
+    const double overdrawMilliseconds = elapsedMilliseconds(start);
+    printVertexCacheStatistics("overdraw", vertexIndices, vertices.size());
+
+    start = Clock::now();
+    optimizeVertexFetch(vertices, vertexIndices);
+    const double vertexFetchMilliseconds = elapsedMilliseconds(start);
+    printVertexCacheStatistics("vertex fetch", vertexIndices, vertices.size());
+
+    std::cout << "time: vertex cache " << vertexCacheMilliseconds << " ms, overdraw " << overdrawMilliseconds
+        << " ms, vertex fetch " << vertexFetchMilliseconds << " ms" << std::endl;
+
+    // Ż ACMR Ϊʧܣû GPU  CI м
+    const VertexCacheStatistics after = analyzeVertexCache(vertexIndices, vertices.size());
+    if (after.acmr > before.acmr)
+    {
+        std::cerr << setFontColor("ACMR regressed: " + std::to_string(before.acmr) + " -> " + std::to_string(after.acmr), FontColor::Red) << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "common.h"
+#include "FramePacing.h"
+#include "FrameProfiler.h"
+#include "ToolCommands.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    bool checkPacingModes(std::string& _error)
+    {
+        const FramePacingMode modes[]{ FramePacingMode::Balanced, FramePacingMode::Throughput, FramePacingMode::Latency };
+        const uint32_t framesInFlight[]{ 2, 3, 1 };
+        for (size_t i = 0; i < 3; ++i)
+        {
+            FramePacingMode mode = FramePacingMode::Balanced;
+            if (!parseFramePacingMode(getFramePacingModeName(modes[i]), mode) || mode != modes[i])
+            {
+                _error = std::string("mode ") + getFramePacingModeName(modes[i]) + " did not round-trip";
+                return false;
+            }
+            if (getDefaultFramesInFlight(modes[i]) != framesInFlight[i])
+            {
+                _error = std::string("mode ") + getFramePacingModeName(modes[i]) + " should default to " + std::to_string(framesInFlight[i]) + " frames in flight";
+                return false;
+            }
+        }
+        FramePacingMode mode = FramePacingMode::Balanced;
+        if (parseFramePacingMode("fast", mode))
+        {
+            _error = "unknown mode was accepted";
+            return false;
+        }
+        return true;
+    }
+
+    // ׼㣬{ 1, 2, 3, 4 } ľֵΪ 2.5׼Ϊ sqrt(1.25)
+    bool checkHistogramMoments(std::string& _error)
+    {
+        RollingHistogram histogram(4);
+        for (double value : { 100.0, 1.0, 2.0, 3.0, 4.0 })
+        {
+            histogram.add(value);
+        }
+        if (std::abs(histogram.getMean() - 2.5) > 1e-9 || std::abs(histogram.getStandardDeviation() - std::sqrt(1.25)) > 1e-9)
+        {
+            _error = "mean " + std::to_string(histogram.getMean()) + ", standard deviation " + std::to_string(histogram.getStandardDeviation());
+            return false;
+        }
+        return true;
+    }
+
+    void printIntervals(const char* _name, const RollingHistogram& _intervals, double _targetMilliseconds)
+    {
+        std::cout << "\t" << _name << ": " << 1000.0 / _intervals.getMean() << " fps, interval p50 " << _intervals.getPercentile(50.0)
+            << " ms, p99 " << _intervals.getPercentile(99.0) << " ms, jitter (std dev) " << _intervals.getStandardDeviation()
+            << " ms, mean error " << _intervals.getMean() - _targetMilliseconds << " ms" << std::endl;
+    }
+
+    // ÿֱ֡ sleep_for һ֡Ԥʱ̣ۻ֡
+    RollingHistogram runNaiveSleep(uint32_t _frameCount, Clock::duration _interval)
+    {
+        RollingHistogram intervals(_frameCount);
+        Clock::time_point lastTime = Clock::now();
+        Clock::time_point nextTime = lastTime;
+        for (uint32_t frame = 0; frame < _frameCount; ++frame)
+        {
+            nextTime += _interval;
+            std::this_thread::sleep_for(nextTime - Clock::now());
+            const Clock::time_point now = Clock::now();
+            intervals.add(std::chrono::duration<double, std::milli>(now - lastTime).count());
+            lastTime = now;
+        }
+        return intervals;
+    }
+
+    RollingHistogram runFrameRateLimiter(uint32_t _frameCount, FrameRateLimiter& _limiter)
+    {
+        RollingHistogram intervals(_frameCount);
+        _limiter.wait();
+        Clock::time_point lastTime = Clock::now();
+        for (uint32_t frame = 0; frame < _frameCount; ++frame)
+        {
+            _limiter.wait();
+            const Clock::time_point now = Clock::now();
+            intervals.add(std::chrono::duration<double, std::milli>(now - lastTime).count());
+            lastTime = now;
+        }
+        return intervals;
+    }
+}
+
+int runFramePacingTest(const ToolArguments& _arguments)
+{
+    const double framesPerSecond = _arguments.size() > 0 ? std::stod(_arguments[0]) : 120.0;
+    const uint32_t frameCount = _arguments.size() > 1 ? std::max(1u, static_cast<uint32_t>(std::stoul(_arguments[1]))) : 240;
+    if (!(framesPerSecond > 0.0))
+    {
+        std::cerr << setFontColor("Frame rate must be positive", FontColor::Red) << std::endl;
+        return 1;
+    }
+
+    std::string error;
+    const bool modesValid = checkPacingModes(error);
+    std::cout << "Pacing modes: " << (modesValid ? "[ok]" : "[FAILED] " + error) << std::endl;
+    const bool momentsValid = checkHistogramMoments(error);
+    std::cout << "Histogram mean and standard deviation: " << (momentsValid ? "[ok]" : "[FAILED] " + error) << std::endl;
+
+    const double targetMilliseconds = 1000.0 / framesPerSecond;
+    const Clock::duration interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(targetMilliseconds));
+    std::cout << "Frame rate cap " << framesPerSecond << " fps (" << targetMilliseconds << " ms), " << frameCount << " frames" << std::endl;
+    printIntervals("sleep_for", runNaiveSleep(frameCount, interval), targetMilliseconds);
+    FrameRateLimiter limiter(framesPerSecond);
+    const RollingHistogram intervals = runFrameRateLimiter(frameCount, limiter);
+    printIntervals("frame rate limiter", intervals, targetMilliseconds);
+    std::cout << "\tsleep estimate " << limiter.getSleeper().getSleepEstimateMilliseconds() << " ms" << std::endl;
+
+    // ׷󳬹һ֡ʱ䣬ƽֻ֡Եޣֻƽйأж
+    const bool rateValid = std::abs(intervals.getMean() - targetMilliseconds) <= 0.02 * targetMilliseconds;
+    std::cout << "Frame rate limiter holds the cap within 2%: " << (rateValid ? "[ok]" : "[FAILED]") << std::endl;
+
+    if (!modesValid || !momentsValid || !rateValid)
+    {
+        std::cerr << setFontColor("Frame pacing test failed", FontColor::Red) << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,139 @@
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "common.h"
+#include "PipelineCacheFile.h"
+#include "ToolCommands.h"
+
+namespace
+{
+    const uint32_t TEST_VENDOR_ID = 0x10005;
+    const uint32_t TEST_DEVICE_ID = 0x0000;
+
+    // ģĻ棺һļͷһβ͸
+    std::vector<char> makeCacheData(const PipelineCacheHeader& _header, size_t _payloadSize)
+    {
+        std::vector<char> data(PIPELINE_CACHE_HEADER_SIZE + _payloadSize);
+        writePipelineCacheHeader(_header, data);
+        for (size_t i = PIPELINE_CACHE_HEADER_SIZE; i < data.size(); ++i)
+        {
+            data[i] = static_cast<char>(i * 31);
+        }
+        return data;
+    }
+
+    PipelineCacheHeader makeHeader()
+    {
+        PipelineCacheHeader header;
+        header.headerSize = static_cast<uint32_t>(PIPELINE_CACHE_HEADER_SIZE);
+        header.headerVersion = PIPELINE_CACHE_HEADER_VERSION_ONE;
+        header.vendorId = TEST_VENDOR_ID;
+        header.deviceId = TEST_DEVICE_ID;
+        for (size_t i = 0; i < PIPELINE_CACHE_UUID_SIZE; ++i)
+        {
+            header.pipelineCacheUuid[i] = static_cast<uint8_t>(0xA0 + i);
+        }
+        return header;
+    }
+
+    // ЧݱͨÿָĶ뱻ܾ
+    bool checkValidation(std::string& _error)
+    {
+        const PipelineCacheHeader header = makeHeader();
+        std::string reason;
+        if (!validatePipelineCacheData(makeCacheData(header, 1024), TEST_VENDOR_ID, TEST_DEVICE_ID, header.pipelineCacheUuid, reason))
+        {
+            _error = "valid cache was rejected: " + reason;
+            return false;
+        }
+
+        // ļͷСֽţֽ޹
+        const std::vector<char> data = makeCacheData(header, 0);
+        if (static_cast<unsigned char>(data[0]) != PIPELINE_CACHE_HEADER_SIZE || data[1] != 0 || static_cast<unsigned char>(data[8]) != 0x05 || data[10] != 0x01)
+        {
+            _error = "header is not little-endian";
+            return false;
+        }
+
+        const std::vector<std::pair<const char*, std::function<void(PipelineCacheHeader&, std::vector<char>&)>>> corruptions
+        {
+            { "truncated", [](PipelineCacheHeader&, std::vector<char>& _data) { _data.resize(PIPELINE_CACHE_HEADER_SIZE - 1); } },
+            { "short header size", [](PipelineCacheHeader& _header, std::vector<char>&) { _header.headerSize = 16; } },
+            { "header size beyond data", [](PipelineCacheHeader& _header, std::vector<char>&) { _header.headerSize = 4096; } },
+            { "header version", [](PipelineCacheHeader& _header, std::vector<char>&) { _header.headerVersion = 2; } },
+            { "vendor", [](PipelineCacheHeader& _header, std::vector<char>&) { _header.vendorId = 0x10DE; } },
+            { "device", [](PipelineCacheHeader& _header, std::vector<char>&) { _header.deviceId = 1; } },
+            { "uuid", [](PipelineCacheHeader& _header, std::vector<char>&) { _header.pipelineCacheUuid[15] ^= 1; } }
+        };
+        for (const auto& corruption : corruptions)
+        {
+            PipelineCacheHeader corruptedHeader = header;
+            std::vector<char> corruptedData(PIPELINE_CACHE_HEADER_SIZE + 1024);
+            corruption.second(corruptedHeader, corruptedData);
+            if (corruptedData.size() >= PIPELINE_CACHE_HEADER_SIZE)
+            {
+                writePipelineCacheHeader(corruptedHeader, corruptedData);
+            }
+            if (validatePipelineCacheData(corruptedData, TEST_VENDOR_ID, TEST_DEVICE_ID, header.pipelineCacheUuid, reason))
+            {
+                _error = std::string("cache with changed ") + corruption.first + " was accepted";
+                return false;
+            }
+            std::cout << "\t" << corruption.first << ": rejected (" << reason << ")" << std::endl;
+        }
+        return true;
+    }
+
+    bool checkRoundTrip(const std::string& _filename, std::string& _error)
+    {
+        const std::vector<char> data = makeCacheData(makeHeader(), 65536);
+        std::vector<char> loaded;
+        bool valid = true;
+        if (!savePipelineCacheFile(_filename, data))
+        {
+            _error = "failed to write " + _filename;
+            valid = false;
+        }
+        else if (!loadPipelineCacheFile(_filename, loaded) || loaded != data)
+        {
+            _error = "data read back from " + _filename + " differs";
+            valid = false;
+        }
+        // еļ
+        else if (!savePipelineCacheFile(_filename, std::vector<char>(data.begin(), data.begin() + 100)) || !loadPipelineCacheFile(_filename, loaded) || loaded.size() != 100)
+        {
+            _error = "failed to replace " + _filename;
+            valid = false;
+        }
+        std::remove(_filename.c_str());
+
+        if (valid && loadPipelineCacheFile(_filename, loaded))
+        {
+            _error = "missing file was loaded";
+            valid = false;
+        }
+        return valid;
+    }
+}
+
+int runPipelineCacheTest(const ToolArguments& _arguments)
+{
+    const std::string filename = _arguments.size() > 0 ? _arguments[0] : "pipeline_cache_test.bin";
+
+    std::string error;
+    std::cout << "Header validation:" << std::endl;
+    const bool validationValid = checkValidation(error);
+    std::cout << "Header validation: " << (validationValid ? "[ok]" : "[FAILED] " + error) << std::endl;
+    const bool roundTripValid = checkRoundTrip(filename, error);
+    std::cout << "Save and load: " << (roundTripValid ? "[ok]" : "[FAILED] " + error) << std::endl;
+
+    if (!validationValid || !roundTripValid)
+    {
+        std::cerr << setFontColor("Pipeline cache test failed", FontColor::Red) << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,200 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common.h"
+#include "JobSystem.h"
+#include "ToolCommands.h"
+#include "TripleBuffer.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct TestPacket
+    {
+        uint64_t index = 0;
+        std::vector<uint64_t> payload;
+    };
+
+    double getMilliseconds(Clock::time_point _startTime)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - _startTime).count();
+    }
+
+    // ̶ĸ㣬ʱģ¼
+    void burnCpu(uint64_t _iterations)
+    {
+        volatile float value = 1.0f;
+        for (uint64_t i = 0; i < _iterations; ++i)
+        {
+            value = std::sqrt(value + 1.0f);
+        }
+    }
+
+    // 궨ÿĵǰǽӿת̱߳ռʱ䲻ᱻɵĹ
+    uint64_t calibrateIterationsPerMillisecond()
+    {
+        uint64_t iterations = 1024;
+        while (true)
+        {
+            const Clock::time_point startTime = Clock::now();
+            burnCpu(iterations);
+            const double milliseconds = getMilliseconds(startTime);
+            if (milliseconds >= 20.0)
+            {
+                return std::max<uint64_t>(1, static_cast<uint64_t>(iterations / milliseconds));
+            }
+            iterations *= 2;
+        }
+    }
+
+    // ߲ͣ߶ÿݰģֻһȡ󷢲ݰ
+    bool checkTripleBuffer(uint64_t _packetCount, std::string& _error)
+    {
+        TripleBuffer<TestPacket> packets;
+        std::atomic<bool> finished{ false };
+        std::thread producer([&]()
+        {
+            for (uint64_t index = 1; index <= _packetCount; ++index)
+            {
+                TestPacket& packet = packets.getWriteBuffer();
+                packet.index = index;
+                packet.payload.assign(1 + index % 61, index);
+                packets.publish();
+            }
+            finished.store(true);
+        });
+
+        uint64_t lastIndex = 0;
+        uint64_t receivedCount = 0;
+        bool valid = true;
+        while (valid)
+        {
+            const bool producerFinished = finished.load();
+            if (packets.acquire())
+            {
+                const TestPacket& packet = packets.getReadBuffer();
+                ++receivedCount;
+                if (packet.index <= lastIndex || packet.payload.size() != 1 + packet.index % 61
+                    || std::any_of(packet.payload.begin(), packet.payload.end(), [&packet](uint64_t _value) { return _value != packet.index; }))
+                {
+                    _error = "packet " + std::to_string(packet.index) + " was torn or out of order after " + std::to_string(lastIndex);
+                    valid = false;
+                }
+                lastIndex = packet.index;
+            }
+            else if (producerFinished)
+            {
+                break;
+            }
+        }
+        producer.join();
+
+        if (valid && lastIndex != _packetCount)
+        {
+            _error = "last packet " + std::to_string(_packetCount) + " was never received";
+            valid = false;
+        }
+        std::cout << "\t" << receivedCount << " of " << _packetCount << " packets received, the rest were replaced by newer ones" << std::endl;
+        return valid;
+    }
+
+    //  Application ˳ģʽͬͬһ߳ģ¼
+    double runSerial(uint32_t _frameCount, uint64_t _simulateIterations, uint64_t _renderIterations)
+    {
+        const Clock::time_point startTime = Clock::now();
+        for (uint32_t frame = 0; frame < _frameCount; ++frame)
+        {
+            burnCpu(_simulateIterations);
+            burnCpu(_renderIterations);
+        }
+        return getMilliseconds(startTime);
+    }
+
+    //  Application ˮģʽͬģ߳һݰȡߺģһ֡Ⱦֻ߳Ⱦµݰ
+    // ÿģǡȾһΣȴԷʱϡ_inOrder ȾݰǷε
+    double runPipelined(uint32_t _frameCount, uint64_t _simulateIterations, uint64_t _renderIterations, bool& _inOrder)
+    {
+        TripleBuffer<TestPacket> packets;
+        std::mutex mutex;
+        std::condition_variable condition;
+        auto notify = [&]()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+            }
+            condition.notify_all();
+        };
+        _inOrder = true;
+        const Clock::time_point startTime = Clock::now();
+        std::thread renderThread([&]()
+        {
+            for (uint32_t frame = 0; frame < _frameCount; ++frame)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    condition.wait(lock, [&packets]() { return packets.hasPending(); });
+                }
+                packets.acquire();
+                notify();
+                _inOrder &= packets.getReadBuffer().index == frame + 1;
+                burnCpu(_renderIterations);
+            }
+        });
+
+        for (uint64_t index = 1; index <= _frameCount; ++index)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [&packets]() { return !packets.hasPending(); });
+            }
+            burnCpu(_simulateIterations);
+            packets.getWriteBuffer().index = index;
+            packets.publish();
+            notify();
+        }
+        renderThread.join();
+        return getMilliseconds(startTime);
+    }
+}
+
+int runFramePipelineBench(const ToolArguments& _arguments)
+{
+    const uint32_t frameCount = _arguments.size() > 0 ? std::max(1u, static_cast<uint32_t>(std::stoul(_arguments[0]))) : 200;
+    const double simulateMilliseconds = _arguments.size() > 1 ? std::stod(_arguments[1]) : 4.0;
+    const double renderMilliseconds = _arguments.size() > 2 ? std::stod(_arguments[2]) : 4.0;
+
+    std::string error;
+    bool tripleBufferValid = checkTripleBuffer(1000000, error);
+    std::cout << "Triple buffer handoff: " << (tripleBufferValid ? "[ok]" : "[FAILED] " + error) << std::endl;
+
+    // ߳ͬʱʱɽһ߾ٱΪ (ģ + ¼) / max(ģ, ¼)
+    const uint64_t iterationsPerMillisecond = calibrateIterationsPerMillisecond();
+    const uint64_t simulateIterations = static_cast<uint64_t>(simulateMilliseconds * iterationsPerMillisecond);
+    const uint64_t renderIterations = static_cast<uint64_t>(renderMilliseconds * iterationsPerMillisecond);
+    const double serialMilliseconds = runSerial(frameCount, simulateIterations, renderIterations);
+    bool inOrder = false;
+    const double pipelinedMilliseconds = runPipelined(frameCount, simulateIterations, renderIterations, inOrder);
+    const double idealSpeedup = (simulateMilliseconds + renderMilliseconds) / std::max(1e-6, std::max(simulateMilliseconds, renderMilliseconds));
+    std::cout << "Hardware threads: " << getDefaultThreadCount() << ", " << frameCount << " frames, simulate " << simulateMilliseconds << " ms, render "
+        << renderMilliseconds << " ms" << std::endl;
+    std::cout << "\tserial: " << frameCount * 1000.0 / serialMilliseconds << " fps" << std::endl;
+    std::cout << "\tpipelined: " << frameCount * 1000.0 / pipelinedMilliseconds << " fps (" << serialMilliseconds / pipelinedMilliseconds
+        << "x, ideal " << idealSpeedup << "x), one frame of latency" << std::endl;
+    std::cout << "Pipelined frames rendered once each in order: " << (inOrder ? "[ok]" : "[FAILED]") << std::endl;
+
+    if (!tripleBufferValid || !inOrder)
+    {
+        std::cerr << setFontColor("Frame pipeline test failed", FontColor::Red) << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common.h"
+#include "FrameProfiler.h"
+#include "ToolCommands.h"
+
+namespace
+{
+    const char* const GPU_SCOPE_NAMES[]{ "culling", "render pass" };
+    // ģ GPU ʱ (΢)޳ 100Ⱦͨ 1000ģύ GPU βص
+    const double GPU_OFFSETS[]{ 0.0, 100.0, 1100.0 };
+    const double SUBMIT_INTERVAL_MICROSECONDS = 1000.0;
+
+    // ֱͼķλ
+    bool checkHistogram(std::string& _error)
+    {
+        const size_t window = 1024;
+        RollingHistogram histogram(window);
+        std::vector<double> samples;
+        std::mt19937 random(7);
+        std::uniform_real_distribution<double> distribution(0.0, 100.0);
+        for (size_t i = 0; i < 5000; ++i)
+        {
+            samples.push_back(distribution(random));
+            histogram.add(samples.back());
+        }
+
+        std::vector<double> recent(samples.end() - window, samples.end());
+        std::sort(recent.begin(), recent.end());
+        const double percentiles[]{ 0.0, 50.0, 95.0, 99.0, 100.0 };
+        for (double percentile : percentiles)
+        {
+            const size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * window));
+            const double expected = recent[rank == 0 ? 0 : rank - 1];
+            if (histogram.getPercentile(percentile) != expected)
+            {
+                _error = "p" + std::to_string(percentile) + " is " + std::to_string(histogram.getPercentile(percentile)) + ", expected " + std::to_string(expected);
+                return false;
+            }
+        }
+        return histogram.getCount() == window;
+    }
+
+    bool checkGpuEvents(const FrameProfiler& _profiler, std::string& _error)
+    {
+        const RollingHistogram* renderPass = _profiler.findHistogram(ProfileTrack::Gpu, "render pass");
+        if (renderPass == nullptr || renderPass->getPercentile(50.0) != GPU_OFFSETS[2] - GPU_OFFSETS[1])
+        {
+            _error = "render pass histogram is missing or wrong";
+            return false;
+        }
+
+        double gpuEnd = 0.0;
+        for (const ProfileEvent& event : _profiler.getEvents())
+        {
+            if (event.track != ProfileTrack::Gpu || std::string(event.name) != "frame")
+            {
+                continue;
+            }
+            if (event.startMicroseconds < gpuEnd)
+            {
+                _error = "GPU frame " + std::to_string(event.frame) + " overlaps the previous frame";
+                return false;
+            }
+            gpuEnd = event.startMicroseconds + event.durationMicroseconds;
+        }
+        return true;
+    }
+
+    // صļṹ¼
+    bool checkTrace(const std::string& _filename, size_t _eventCount, std::string& _error)
+    {
+        std::ifstream file(_filename);
+        const std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        if (content.compare(0, 1, "{") != 0 || content.find("\n]}") == std::string::npos)
+        {
+            _error = "malformed trace file";
+            return false;
+        }
+
+        size_t completeEvents = 0;
+        for (size_t position = content.find("\"ph\":\"X\""); position != std::string::npos; position = content.find("\"ph\":\"X\"", position + 1))
+        {
+            ++completeEvents;
+        }
+        if (completeEvents != _eventCount)
+        {
+            _error = "trace has " + std::to_string(completeEvents) + " events, expected " + std::to_string(_eventCount);
+            return false;
+        }
+        return true;
+    }
+}
+
+int runProfilerTest(const ToolArguments& _arguments)
+{
+    const uint32_t frames = _arguments.size() > 0 ? std::max(1u, static_cast<uint32_t>(std::stoul(_arguments[0]))) : 1000;
+    const std::string tracePath = _arguments.size() > 1 ? _arguments[1] : "profiler_trace.json";
+
+    std::string error;
+    bool histogramValid = checkHistogram(error);
+    std::cout << "Rolling histogram percentiles: " << (histogramValid ? "[ok]" : "[FAILED] " + error) << std::endl;
+
+    // ¼¼ʱһʱεĿҲÿ֡פĳɱ
+    FrameProfiler overheadProfiler;
+    const uint32_t scopeCount = 1000000;
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < scopeCount; ++i)
+    {
+        ProfileScope scope(overheadProfiler, (i & 1) != 0 ? "odd" : "even");
+    }
+    const double scopeNanoseconds = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - startTime).count() / scopeCount;
+    std::cout << "Profile scope overhead: " << scopeNanoseconds << " ns" << std::endl;
+
+    FrameProfiler profiler;
+    profiler.setTraceEnabled(true);
+    const FrameProfiler::Clock::time_point baseTime = FrameProfiler::Clock::now();
+    for (uint32_t frame = 0; frame < frames; ++frame)
+    {
+        profiler.beginFrame();
+        {
+            ProfileScope recordScope(profiler, "record command buffer");
+        }
+        const FrameProfiler::Clock::time_point submitTime = baseTime
+            + std::chrono::duration_cast<FrameProfiler::Clock::duration>(std::chrono::duration<double, std::micro>(SUBMIT_INTERVAL_MICROSECONDS * frame));
+        profiler.addGpuFrame(profiler.getFrameIndex(), submitTime, GPU_SCOPE_NAMES, GPU_OFFSETS, 3);
+        profiler.endFrame();
+    }
+
+    bool gpuValid = checkGpuEvents(profiler, error);
+    std::cout << "GPU timestamp scopes: " << (gpuValid ? "[ok]" : "[FAILED] " + error) << std::endl;
+
+    bool traceValid = profiler.writeChromeTrace(tracePath);
+    if (!traceValid)
+    {
+        error = "failed to write " + tracePath;
+    }
+    traceValid = traceValid && checkTrace(tracePath, profiler.getEvents().size(), error);
+    std::cout << "Chrome trace (" << profiler.getEvents().size() << " events, " << tracePath << "): " << (traceValid ? "[ok]" : "[FAILED] " + error) << std::endl;
+
+    for (const std::string& line : profiler.getReport())
+    {
+        std::cout << "\t" << line << "\n";
+    }
+    std::cout << std::flush;
+
+    if (!histogramValid || !gpuValid || !traceValid)
+    {
+        std::cerr << setFontColor("Profiler test failed", FontColor::Red) << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,143 @@
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "common.h"
+#include "ImageCompare.h"
+#include "ReplayScript.h"
+#include "ToolCommands.h"
+
+namespace
+{
+    // ûָűʱʹõʾؼ֮֡ƶ
+    const char* const BUILTIN_SCRIPT =
+        "# built-in replay script\n"
+        "resolution 320 240\n"
+        "instances 64\n"
+        "warmup 4\n"
+        "frames 16\n"
+        "timestep 0.02\n"
+        "camera 0 0 10 20 0 10 0 60\n"
+        "camera 2 20 10 0 0 10 0 40  # quarter orbit\n"
+        "tolerance 4 0.25\n";
+
+    // βؼ֮֡ȡ˵㣬е㴦Ϊߵƽ
+    bool checkCamera(const ReplayScript& _script, std::string& _error)
+    {
+        const std::vector<CameraKeyframe>& keyframes = _script.cameraKeyframes;
+        const CameraKeyframe& first = keyframes.front();
+        const CameraKeyframe& last = keyframes.back();
+        const CameraKeyframe before = sampleCamera(_script, first.time - 1.0f);
+        const CameraKeyframe after = sampleCamera(_script, last.time + 1.0f);
+        if (before.eye[0] != first.eye[0] || before.fovDegrees != first.fovDegrees || after.eye[2] != last.eye[2] || after.fovDegrees != last.fovDegrees)
+        {
+            _error = "samples outside the keyframes are not clamped";
+            return false;
+        }
+        if (keyframes.size() < 2)
+        {
+            return true;
+        }
+
+        const CameraKeyframe& next = keyframes[1];
+        const CameraKeyframe middle = sampleCamera(_script, 0.5f * (first.time + next.time));
+        for (int i = 0; i < 3; ++i)
+        {
+            if (std::fabs(middle.eye[i] - 0.5f * (first.eye[i] + next.eye[i])) > 1e-4f || std::fabs(middle.target[i] - 0.5f * (first.target[i] + next.target[i])) > 1e-4f)
+            {
+                _error = "midpoint sample is not interpolated";
+                return false;
+            }
+        }
+        if (std::fabs(middle.fovDegrees - 0.5f * (first.fovDegrees + next.fovDegrees)) > 1e-4f)
+        {
+            _error = "midpoint field of view is not interpolated";
+            return false;
+        }
+        return true;
+    }
+
+    // ͬͼûв죬Ķһغֻ⵽һֵĸĶ
+    bool checkImageCompare(std::string& _error)
+    {
+        const size_t pixelCount = 64 * 64;
+        std::vector<unsigned char> a(pixelCount * 4);
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            a[i] = static_cast<unsigned char>(i * 31 % 251);
+        }
+        std::vector<unsigned char> b = a;
+
+        ImageDifference difference = compareImages(a.data(), b.data(), pixelCount, 0);
+        if (difference.differingPixelCount != 0 || difference.maxChannelDifference != 0 || difference.pixelCount != pixelCount)
+        {
+            _error = "identical images differ";
+            return false;
+        }
+
+        b[100 * 4 + 1] = static_cast<unsigned char>(b[100 * 4 + 1] ^ 0x40);
+        b[200 * 4 + 2] = static_cast<unsigned char>(b[200 * 4 + 2] < 128 ? b[200 * 4 + 2] + 2 : b[200 * 4 + 2] - 2);
+        difference = compareImages(a.data(), b.data(), pixelCount, 8);
+        if (difference.differingPixelCount != 1 || difference.maxChannelDifference != 0x40)
+        {
+            _error = std::to_string(difference.differingPixelCount) + " differing pixels, max channel difference " + std::to_string(difference.maxChannelDifference);
+            return false;
+        }
+        return true;
+    }
+
+    // ʽ󡢹ؼ֡ʱ䲻ûйؼ֡ĽűӦܾ
+    bool checkInvalidScripts(std::string& _error)
+    {
+        const char* const scripts[]
+        {
+            "camera 0 0 0 1 0 0 0 60\nframes x\n",
+            "camera 0 0 0 1 0 0 0 60\nzoom 2\n",
+            "camera 1 0 0 1 0 0 0 60\ncamera 1 0 0 2 0 0 0 60\n",
+            "camera 0 0 0 1 0 0 0\n",
+            "frames 10\n",
+            "camera 0 0 0 1 0 0 0 60\nresolution 0 240\n"
+        };
+        for (const char* text : scripts)
+        {
+            ReplayScript script;
+            std::string error;
+            if (parseReplayScript(text, script, error))
+            {
+                _error = "accepted invalid script: " + std::string(text);
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+int runReplayTest(const ToolArguments& _arguments)
+{
+    ReplayScript script;
+    std::string error;
+    const bool scriptValid = _arguments.size() > 0 ? loadReplayScript(_arguments[0], script, error) : parseReplayScript(BUILTIN_SCRIPT, script, error);
+    std::cout << "Replay script (" << (_arguments.size() > 0 ? _arguments[0] : "built-in") << "): " << (scriptValid ? "[ok]" : "[FAILED] " + error) << std::endl;
+    if (scriptValid)
+    {
+        std::cout << "\tresolution " << script.width << "x" << script.height << ", " << script.instanceCount << " instances, " << script.warmupFrames << " warmup + "
+            << script.measuredFrames << " frames, timestep " << script.timeStep << " s, " << script.cameraKeyframes.size() << " camera keyframes" << std::endl;
+    }
+
+    bool cameraValid = scriptValid && checkCamera(script, error);
+    std::cout << "Camera interpolation: " << (cameraValid ? "[ok]" : "[FAILED] " + error) << std::endl;
+
+    bool compareValid = checkImageCompare(error);
+    std::cout << "Image comparison: " << (compareValid ? "[ok]" : "[FAILED] " + error) << std::endl;
+
+    bool rejectValid = checkInvalidScripts(error);
+    std::cout << "Invalid scripts rejected: " << (rejectValid ? "[ok]" : "[FAILED] " + error) << std::endl;
+
+    if (!scriptValid || !cameraValid || !compareValid || !rejectValid)
+    {
+        std::cerr << setFontColor("Replay test failed", FontColor::Red) << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common.h"
+#include "JobSystem.h"
+#include "TaskGraph.h"
+#include "ToolCommands.h"
+
+namespace
+{
+    void sleepMilliseconds(uint32_t _milliseconds)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(_milliseconds));
+    }
+
+    // ɵ޻ͼÿ֮ſʼ
+    bool checkDependencies(uint32_t _taskCount, JobSystem& _jobSystem, TaskGraph& _graph, std::string& _error)
+    {
+        std::mt19937 random(11);
+        for (uint32_t i = 0; i < _taskCount; ++i)
+        {
+            std::vector<TaskGraph::TaskId> dependencies;
+            for (uint32_t j = 0; i > 0 && j < random() % 4; ++j)
+            {
+                dependencies.push_back(random() % i);
+            }
+            std::sort(dependencies.begin(), dependencies.end());
+            dependencies.erase(std::unique(dependencies.begin(), dependencies.end()), dependencies.end());
+            const uint32_t milliseconds = 1 + random() % 4;
+            _graph.addTask("task " + std::to_string(i), [milliseconds]() { sleepMilliseconds(milliseconds); }, dependencies);
+        }
+        _graph.run(_jobSystem);
+
+        for (TaskGraph::TaskId task = 0; task < _graph.getTaskCount(); ++task)
+        {
+            const TaskTiming& timing = _graph.getTiming(task);
+            if (!timing.executed)
+            {
+                _error = _graph.getName(task) + " was not executed";
+                return false;
+            }
+            for (TaskGraph::TaskId dependency : _graph.getDependencies(task))
+            {
+                if (timing.startMilliseconds < _graph.getTiming(dependency).endMilliseconds)
+                {
+                    _error = _graph.getName(task) + " started before " + _graph.getName(dependency) + " finished";
+                    return false;
+                }
+            }
+        }
+
+        // ؼ·ڵϵܳǽʱ䣬Ҳκһ
+        const std::vector<TaskGraph::TaskId> path = _graph.getCriticalPath();
+        double pathMilliseconds = path.empty() ? 0.0 : _graph.getTiming(path.front()).getDuration();
+        for (size_t i = 1; i < path.size(); ++i)
+        {
+            const std::vector<TaskGraph::TaskId>& dependencies = _graph.getDependencies(path[i]);
+            if (std::find(dependencies.begin(), dependencies.end(), path[i - 1]) == dependencies.end())
+            {
+                _error = "critical path is not a dependency chain";
+                return false;
+            }
+            pathMilliseconds += _graph.getTiming(path[i]).getDuration();
+        }
+        if (pathMilliseconds > _graph.getWallMilliseconds())
+        {
+            _error = "critical path is longer than the wall time";
+            return false;
+        }
+        for (TaskGraph::TaskId task = 0; task < _graph.getTaskCount(); ++task)
+        {
+            if (_graph.getTiming(task).getDuration() > pathMilliseconds)
+            {
+                _error = "critical path is shorter than " + _graph.getName(task);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // ֧ʱִ˳򣬹ؼ·һ֧
+    bool checkCriticalPath(JobSystem& _jobSystem, std::string& _error)
+    {
+        TaskGraph graph;
+        const TaskGraph::TaskId slow = graph.addTask("slow", []() { sleepMilliseconds(30); });
+        const TaskGraph::TaskId fast = graph.addTask("fast", []() { sleepMilliseconds(2); });
+        const TaskGraph::TaskId join = graph.addTask("join", []() { sleepMilliseconds(2); }, { fast, slow });
+        graph.run(_jobSystem);
+
+        const std::vector<TaskGraph::TaskId> expected{ slow, join };
+        if (graph.getCriticalPath() != expected)
+        {
+            _error = "critical path does not go through the slow branch";
+            return false;
+        }
+        return true;
+    }
+
+    // ʧβִУ쳣 run ʱ׳MainThread ڵִ߳
+    bool checkFailureAndAffinity(JobSystem& _jobSystem, std::string& _error)
+    {
+        TaskGraph graph;
+        const std::thread::id callerThread = std::this_thread::get_id();
+        std::thread::id mainTaskThread;
+        const TaskGraph::TaskId mainTask = graph.addTask("main thread", [&mainTaskThread]() { mainTaskThread = std::this_thread::get_id(); }, { }, TaskAffinity::MainThread);
+        const TaskGraph::TaskId failing = graph.addTask("failing", []() { throw std::runtime_error("expected failure"); }, { mainTask });
+        const TaskGraph::TaskId downstream = graph.addTask("downstream", []() { }, { failing });
+
+        bool thrown = false;
+        try
+        {
+            graph.run(_jobSystem);
+        }
+        catch (const std::runtime_error&)
+        {
+            thrown = true;
+        }
+        if (!thrown || graph.getTiming(downstream).executed)
+        {
+            _error = "failure was not propagated";
+            return false;
+        }
+        if (mainTaskThread != callerThread || graph.getTiming(mainTask).threadIndex != 0)
+        {
+            _error = "main thread task ran on a worker";
+            return false;
+        }
+
+        try
+        {
+            graph.addTask("forward", []() { }, { static_cast<TaskGraph::TaskId>(graph.getTaskCount()) });
+            _error = "forward dependency was accepted";
+            return false;
+        }
+        catch (const std::runtime_error&)
+        {
+            return true;
+        }
+    }
+}
+
+int runTaskGraphTest(const ToolArguments& _arguments)
+{
+    const uint32_t taskCount = _arguments.size() > 0 ? std::max(1u, static_cast<uint32_t>(std::stoul(_arguments[0]))) : 64;
+    const uint32_t threadCount = _arguments.size() > 1 ? std::max(1u, static_cast<uint32_t>(std::stoul(_arguments[1]))) : getDefaultThreadCount();
+
+    std::string error;
+    JobSystem jobSystem(threadCount);
+    TaskGraph graph;
+    bool dependenciesValid = checkDependencies(taskCount, jobSystem, graph, error);
+    std::cout << "Dependencies (" << taskCount << " tasks, " << threadCount << " threads): " << (dependenciesValid ? "[ok]" : "[FAILED] " + error) << std::endl;
+    const std::vector<std::string> report = graph.getReport();
+    std::cout << "\t" << report.front() << std::endl;
+
+    bool criticalPathValid = checkCriticalPath(jobSystem, error);
+    std::cout << "Critical path: " << (criticalPathValid ? "[ok]" : "[FAILED] " + error) << std::endl;
+
+    bool failureValid = checkFailureAndAffinity(jobSystem, error);
+    std::cout << "Failure and main thread affinity: " << (failureValid ? "[ok]" : "[FAILED] " + error) << std::endl;
+
+    if (!dependenciesValid || !criticalPathValid || !failureValid)
+    {
+        std::cerr << setFontColor("Task graph test failed", FontColor::Red) << std::endl;
+        return 1;
+    }
+    return 0;
+}
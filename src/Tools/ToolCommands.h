@@ -0,0 +1,52 @@
+#ifndef GQY_TOOL_COMMANDS_H
+#define GQY_TOOL_COMMANDS_H
+
+#include <string>
+#include <vector>
+
+using ToolArguments = std::vector<std::string>;
+
+// obj-bench <file.obj> [threads]Ա tinyobjloader  ObjLoader ļغʱУһ
+int runObjBench(const ToolArguments& _arguments);
+// obj-gen <out.obj> <triangles>ָģͣڲ
+int runObjGen(const ToolArguments& _arguments);
+// mesh-bake <file.obj> [out.meshcache]ɶ񻺴
+int runMeshBake(const ToolArguments& _arguments);
+// mesh-bench <file.obj> [iterations]Ա޻ () л () ʱģͼغʱ
+int runMeshBench(const ToolArguments& _arguments);
+// weld-bench [file.obj] [indexCount]Ա std::unordered_map  VertexWeldTable Ķȥغʱ
+int runWeldBench(const ToolArguments& _arguments);
+// mesh-opt <file.obj>ŻŻǰ ACMR/ATVRACMR ʱط
+int runMeshOptimize(const ToolArguments& _arguments);
+// layout-report <file.obj>ʽԴռ
+int runLayoutReport(const ToolArguments& _arguments);
+// index-split [file.obj]У 32 λΪ 16 λĽʧʱط
+int runIndexSplit(const ToolArguments& _arguments);
+// draw-list [file.obj]ʷ鲢ɻбͼлʧʱط
+int runDrawList(const ToolArguments& _arguments);
+// memory-test [iterations]ģڴͱͷţ GPU ڴĶ롢صͺϲʧʱط
+int runMemoryTest(const ToolArguments& _arguments);
+// instance-bench [count] [frames]Աʵ SIMD µĺʱһʱط
+int runInstanceBench(const ToolArguments& _arguments);
+// cull-test [instances]ü׶޳ CPU οʵ֣Ϳɼʵбȷû޳ɼϣʧʱط
+int runCullTest(const ToolArguments& _arguments);
+// meshlet-bench [file.obj]зִزʱʺ͸ӽ·׶޳αЧ޳ʱط
+int runMeshletBench(const ToolArguments& _arguments);
+// lod-bench [instances] [frames]ΪÿʵĻռѡ LOD  CPU ʱ (Ĭ 100000 ʵ)ѡȷʱط
+int runLodBench(const ToolArguments& _arguments);
+// profiler-test [frames] [trace.json]ֱͼķλGPU ʱεк͵ Chrome traceʱεĿʧʱط
+int runProfilerTest(const ToolArguments& _arguments);
+// replay-test [script]طŽű (Ĭʹʾ)ֵͼȽϺͶЧűľܾʧʱط
+int runReplayTest(const ToolArguments& _arguments);
+// task-graph-test [tasks] [threads]ͼϼ˳򡢹ؼ·쳣ݺ߳ʧʱط
+int runTaskGraphTest(const ToolArguments& _arguments);
+// job-bench [max threads] [jobs] 1  max threads (Ĭ 64) ߳ϼϵͳύȡĿ parallelFor ļٱȣʧʱط
+int runJobBench(const ToolArguments& _arguments);
+// frame-pipeline-bench [frames] [simulate ms] [render ms]ػ彻ӵݰ򣬲ԱģȾ˳ִкˮִе֡ʣʧʱط
+int runFramePipelineBench(const ToolArguments& _arguments);
+// frame-pacing-test [fps] [frames]֡ģʽĽֱͼĶͳƣԱֱ sleep_for ֡֡Ͷʧʱط
+int runFramePacingTest(const ToolArguments& _arguments);
+// pipeline-cache-test [file]߻ļͷУܾܾضϡ汾̡豸 UUID һµݣ黺ļдͶȡʧʱط
+int runPipelineCacheTest(const ToolArguments& _arguments);
+
+#endif
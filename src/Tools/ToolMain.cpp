@@ -0,0 +1,76 @@
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <map>
+
+#include "common.h"
+#include "ToolCommands.h"
+
+struct ToolCommand
+{
+    std::function<int(const ToolArguments&)> function;
+    std::string usage;
+};
+
+static const std::map<std::string, ToolCommand> toolCommands
+{
+    { "obj-bench", { runObjBench, "obj-bench <file.obj> [threads]" } },
+    { "obj-gen", { runObjGen, "obj-gen <out.obj> <triangles>" } },
+    { "mesh-bake", { runMeshBake, "mesh-bake <file.obj> [out.meshcache]" } },
+    { "mesh-bench", { runMeshBench, "mesh-bench <file.obj> [iterations]" } },
+    { "weld-bench", { runWeldBench, "weld-bench [file.obj] [indexCount]" } },
+    { "mesh-opt", { runMeshOptimize, "mesh-opt <file.obj>" } },
+    { "layout-report", { runLayoutReport, "layout-report <file.obj>" } },
+    { "index-split", { runIndexSplit, "index-split [file.obj]" } },
+    { "draw-list", { runDrawList, "draw-list [file.obj]" } },
+    { "memory-test", { runMemoryTest, "memory-test [iterations]" } },
+    { "instance-bench", { runInstanceBench, "instance-bench [count] [frames]" } },
+    { "cull-test", { runCullTest, "cull-test [instances]" } },
+    { "meshlet-bench", { runMeshletBench, "meshlet-bench [file.obj]" } },
+    { "lod-bench", { runLodBench, "lod-bench [instances] [frames]" } },
+    { "profiler-test", { runProfilerTest, "profiler-test [frames] [trace.json]" } },
+    { "replay-test", { runReplayTest, "replay-test [script]" } },
+    { "task-graph-test", { runTaskGraphTest, "task-graph-test [tasks] [threads]" } },
+    { "job-bench", { runJobBench, "job-bench [max threads] [jobs]" } },
+    { "frame-pipeline-bench", { runFramePipelineBench, "frame-pipeline-bench [frames] [simulate ms] [render ms]" } },
+    { "frame-pacing-test", { runFramePacingTest, "frame-pacing-test [fps] [frames]" } },
+    { "pipeline-cache-test", { runPipelineCacheTest, "pipeline-cache-test [file]" } }
+};
+
+static void printUsage()
+{
+    std::cout << "Usage: VulkanDemoTool <command> [arguments]\n";
+    for (const auto& command : toolCommands)
+    {
+        std::cout << "\t" << command.second.usage << "\n";
+    }
+    std::cout << std::flush;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        printUsage();
+        return 1;
+    }
+
+    auto command = toolCommands.find(argv[1]);
+    if (command == toolCommands.end())
+    {
+        std::cerr << setFontColor("Unknown command: " + std::string(argv[1]), FontColor::Red) << std::endl;
+        printUsage();
+        return 1;
+    }
+
+    try
+    {
+        return command->second.function(ToolArguments(argv + 2, argv + argc));
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+    }
+
+    return 1;
+}
@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "common.h"
+#include "ObjLoader.h"
+#include "ToolCommands.h"
+#include "VertexWeldTable.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double elapsedMilliseconds(Clock::time_point _start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - _start).count();
+    }
+
+    // ϵĶ㰴 8x8 ֿչ߽ϵĶλͬ겻ͬ
+    std::vector<Vertex> generateCorners(size_t _indexCount)
+    {
+        const size_t quadCount = std::max<size_t>(1, _indexCount / 6);
+        size_t side = 1;
+        while (side * side < quadCount)
+        {
+            ++side;
+        }
+
+        auto makeVertex = [](size_t _x, size_t _y, size_t _chartX, size_t _chartY)
+        {
+            Vertex vertex{ };
+            vertex.positionOS = { static_cast<float>(_x), 0.0f, static_cast<float>(_y) };
+            vertex.color = { 1.0f, 1.0f, 1.0f };
+            vertex.texCoord =
+            {
+                static_cast<float>(_x - _chartX * 8) / 8.0f + static_cast<float>(_chartX % 4 * 2),
+                static_cast<float>(_y - _chartY * 8) / 8.0f + static_cast<float>(_chartY % 4 * 2)
+            };
+            return vertex;
+        };
+
+        std::vector<Vertex> corners;
+        corners.reserve(quadCount * 6);
+        for (size_t quad = 0; quad < quadCount; ++quad)
+        {
+            size_t x = quad % side;
+            size_t y = quad / side;
+            size_t chartX = x / 8;
+            size_t chartY = y / 8;
+            Vertex v00 = makeVertex(x, y, chartX, chartY);
+            Vertex v10 = makeVertex(x + 1, y, chartX, chartY);
+            Vertex v11 = makeVertex(x + 1, y + 1, chartX, chartY);
+            Vertex v01 = makeVertex(x, y + 1, chartX, chartY);
+            corners.insert(corners.end(), { v00, v10, v11, v00, v11, v01 });
+        }
+        return corners;
+    }
+
+    // ԭ loadModel едcount + operator[] + push_back
+    double weldWithUnorderedMap(const std::vector<Vertex>& _corners, std::vector<Vertex>& _vertices, std::vector<uint32_t>& _vertexIndices)
+    {
+        Clock::time_point start = Clock::now();
+        std::unordered_map<Vertex, uint32_t> uniqueVertices{ };
+        for (const Vertex& vertex : _corners)
+        {
+            if (uniqueVertices.count(vertex) == 0)
+            {
+                uniqueVertices[vertex] = static_cast<uint32_t>(_vertices.size());
+                _vertices.push_back(vertex);
+            }
+            _vertexIndices.push_back(uniqueVertices[vertex]);
+        }
+        return elapsedMilliseconds(start);
+    }
+
+    double weldWithTable(const std::vector<Vertex>& _corners, std::vector<Vertex>& _vertices, std::vector<uint32_t>& _vertexIndices)
+    {
+        Clock::time_point start = Clock::now();
+        VertexWeldTable uniqueVertices(_corners.size() / 4);
+        _vertexIndices.reserve(_corners.size());
+        for (const Vertex& vertex : _corners)
+        {
+            uint32_t index = uniqueVertices.findOrInsert(vertex, static_cast<uint32_t>(_vertices.size()));
+            if (index == _vertices.size())
+            {
+                _vertices.push_back(vertex);
+            }
+            _vertexIndices.push_back(index);
+        }
+        return elapsedMilliseconds(start);
+    }
+
+    template<typename Hasher>
+    size_t countDistinctHashes(const std::vector<Vertex>& _vertices, Hasher _hasher)
+    {
+        std::vector<uint64_t> hashes;
+        hashes.reserve(_vertices.size());
+        for (const Vertex& vertex : _vertices)
+        {
+            hashes.push_back(static_cast<uint64_t>(_hasher(vertex)));
+        }
+        std::sort(hashes.begin(), hashes.end());
+        return static_cast<size_t>(std::unique(hashes.begin(), hashes.end()) - hashes.begin());
+    }
+
+    bool benchmarkWeld(const std::string& _name, const std::vector<Vertex>& _corners)
+    {
+        std::vector<Vertex> referenceVertices;
+        std::vector<uint32_t> referenceIndices;
+        double referenceMilliseconds = weldWithUnorderedMap(_corners, referenceVertices, referenceIndices);
+
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> vertexIndices;
+        double milliseconds = weldWithTable(_corners, vertices, vertexIndices);
+
+        bool identical = vertices.size() == referenceVertices.size() && vertexIndices == referenceIndices
+            && std::equal(vertices.begin(), vertices.end(), referenceVertices.begin());
+
+        size_t weakHashes = countDistinctHashes(referenceVertices, std::hash<Vertex>());
+        size_t strongHashes = countDistinctHashes(referenceVertices, VertexWeldTable::hashVertex);
+
+        std::cout << _name << ": " << _corners.size() << " indices, " << referenceVertices.size() << " unique vertices\n"
+            << "\tstd::unordered_map: " << referenceMilliseconds << " ms, " << weakHashes << " distinct hashes\n"
+            << "\tVertexWeldTable:    " << milliseconds << " ms, " << strongHashes << " distinct hashes\n"
+            << "\tspeedup x" << referenceMilliseconds / std::max(milliseconds, 1e-6) << "\n"
+            << setFontColor(identical ? "\tResults identical" : "\tResults differ", identical ? FontColor::Green : FontColor::Red) << std::endl;
+        return identical;
+    }
+}
+
+int runWeldBench(const ToolArguments& _arguments)
+{
+    const size_t indexCount = _arguments.size() > 1 ? std::stoull(_arguments[1]) : 10000000;
+
+    bool identical = benchmarkWeld("synthetic", generateCorners(indexCount));
+
+    if (!_arguments.empty())
+    {
+        //  ObjLoader ԭδȥصĶ
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> vertexIndices;
+        ObjLoader objLoader;
+        objLoader.load(_arguments[0], vertices, vertexIndices);
+
+        std::vector<Vertex> corners;
+        corners.reserve(vertexIndices.size());
+        for (uint32_t index : vertexIndices)
+        {
+            corners.push_back(vertices[index]);
+        }
+        identical = benchmarkWeld(_arguments[0], corners) && identical;
+    }
+
+    return identical ? 0 : 1;
+}
@@ -0,0 +1,33 @@
+#include "AtomicFile.h"
+
+#include <cstdio>
+#include <fstream>
+
+bool writeFileAtomically(const std::string& _filename, const char* _data, size_t _size)
+{
+    const std::string temporaryFilename = _filename + ".tmp";
+    {
+        std::ofstream file(temporaryFilename, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            return false;
+        }
+        file.write(_data, static_cast<std::streamsize>(_size));
+        if (!file.good())
+        {
+            file.close();
+            std::remove(temporaryFilename.c_str());
+            return false;
+        }
+    }
+
+    #ifdef _WIN32
+        std::remove(_filename.c_str());
+    #endif
+    if (std::rename(temporaryFilename.c_str(), _filename.c_str()) != 0)
+    {
+        std::remove(temporaryFilename.c_str());
+        return false;
+    }
+    return true;
+}
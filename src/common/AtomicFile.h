@@ -0,0 +1,11 @@
+#ifndef GQY_ATOMIC_FILE_H
+#define GQY_ATOMIC_FILE_H
+
+#include <cstddef>
+#include <string>
+
+// д _filename.tmp ٸ滻 _filename;˳²ļ
+// POSIX  rename ԭӵ滻ļWindows  rename ܸǣֻɾļ
+bool writeFileAtomically(const std::string& _filename, const char* _data, size_t _size);
+
+#endif
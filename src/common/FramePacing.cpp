@@ -0,0 +1,112 @@
+#include "FramePacing.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+const char* getFramePacingModeName(FramePacingMode _mode)
+{
+    switch (_mode)
+    {
+    case FramePacingMode::Throughput:
+        return "throughput";
+    case FramePacingMode::Latency:
+        return "latency";
+    default:
+        return "balanced";
+    }
+}
+
+bool parseFramePacingMode(const std::string& _name, FramePacingMode& _mode)
+{
+    for (FramePacingMode mode : { FramePacingMode::Balanced, FramePacingMode::Throughput, FramePacingMode::Latency })
+    {
+        if (_name == getFramePacingModeName(mode))
+        {
+            _mode = mode;
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t getDefaultFramesInFlight(FramePacingMode _mode)
+{
+    switch (_mode)
+    {
+    case FramePacingMode::Throughput:
+        return 3;
+    case FramePacingMode::Latency:
+        return 1;
+    default:
+        return 2;
+    }
+}
+
+void PreciseSleeper::sleepUntil(Clock::time_point _time)
+{
+    while (std::chrono::duration<double, std::milli>(_time - Clock::now()).count() > getSleepEstimateMilliseconds())
+    {
+        const Clock::time_point startTime = Clock::now();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        const double milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - startTime).count();
+
+        // Welford 㷨¾ֵƽ֮ͣﵽ޺󰴱˥ƽ֮ͣ൱ֻ
+        if (m_sampleCount < MAX_SAMPLE_COUNT)
+        {
+            ++m_sampleCount;
+        }
+        else
+        {
+            m_squaredDeviationSum *= (MAX_SAMPLE_COUNT - 1.0) / MAX_SAMPLE_COUNT;
+        }
+        const double delta = milliseconds - m_meanMilliseconds;
+        m_meanMilliseconds += delta / m_sampleCount;
+        m_squaredDeviationSum = std::max(0.0, m_squaredDeviationSum + delta * (milliseconds - m_meanMilliseconds));
+    }
+
+    while (Clock::now() < _time)
+    {
+        std::this_thread::yield();
+    }
+}
+
+double PreciseSleeper::getSleepEstimateMilliseconds() const
+{
+    const double variance = m_sampleCount > 1 ? m_squaredDeviationSum / (m_sampleCount - 1) : 0.0;
+    return m_meanMilliseconds + std::sqrt(variance);
+}
+
+FrameRateLimiter::FrameRateLimiter(double _framesPerSecond)
+{
+    setFramesPerSecond(_framesPerSecond);
+}
+
+void FrameRateLimiter::setFramesPerSecond(double _framesPerSecond)
+{
+    m_framesPerSecond = std::max(0.0, _framesPerSecond);
+    m_interval = isEnabled()
+        ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_framesPerSecond))
+        : Clock::duration(0);
+    m_started = false;
+}
+
+void FrameRateLimiter::wait()
+{
+    if (!isEnabled())
+    {
+        return;
+    }
+
+    const Clock::time_point now = Clock::now();
+    if (!m_started || now - m_nextFrameTime > m_interval)
+    {
+        m_nextFrameTime = now;
+        m_started = true;
+    }
+    else
+    {
+        m_sleeper.sleepUntil(m_nextFrameTime);
+    }
+    m_nextFrameTime += m_interval;
+}
@@ -0,0 +1,68 @@
+#ifndef GQY_FRAME_PACING_H
+#define GQY_FRAME_PACING_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// ֡ԣ֡ģʽƫúͲǰǷȴһ֡
+// Balanced   2 ֡ MAILBOX
+// Throughput 3 ֡ MAILBOXο˺ѵ IMMEDIATECPU  GPU ȴ
+// Latency    1 ֡ǰȴһ֡ɣ뵽ֵӳ
+enum class FramePacingMode : uint32_t
+{
+    Balanced,
+    Throughput,
+    Latency
+};
+
+const char* getFramePacingModeName(FramePacingMode _mode);
+//  balancedthroughput  latency޷ʶʱ false
+bool parseFramePacingMode(const std::string& _name, FramePacingMode& _mode);
+uint32_t getDefaultFramesInFlight(FramePacingMode _mode);
+
+// ߾˯ߣsleep_for Ļͨ 1 ms ϡ 1 ms ֶ˯ߣʵ˯ʱľֵһ׼һεĺʱ
+// ʣʱ䲻˯һʱóʱƬתĿʱ
+class PreciseSleeper
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    void sleepUntil(Clock::time_point _time);
+    double getSleepEstimateMilliseconds() const;
+
+private:
+    // ޺ӣֵܸϵͳصı仯
+    static const uint32_t MAX_SAMPLE_COUNT = 64;
+
+    double m_meanMilliseconds = 1.0;
+    double m_squaredDeviationSum = 0.0;
+    uint32_t m_sampleCount = 1;
+};
+
+// ֡ޣÿ֡ʼǰȵһ֡Ԥʼʱ̼һ֡󳬹һ֡ʱ׷ϣӵǰʱ¼ʱ
+class FrameRateLimiter
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // 0 ʾ֡
+    explicit FrameRateLimiter(double _framesPerSecond = 0.0);
+
+    void setFramesPerSecond(double _framesPerSecond);
+    double getFramesPerSecond() const { return m_framesPerSecond; }
+    bool isEnabled() const { return m_framesPerSecond > 0.0; }
+    const PreciseSleeper& getSleeper() const { return m_sleeper; }
+
+    // ûʱ
+    void wait();
+
+private:
+    PreciseSleeper m_sleeper;
+    double m_framesPerSecond = 0.0;
+    Clock::duration m_interval{ 0 };
+    Clock::time_point m_nextFrameTime;
+    bool m_started = false;
+};
+
+#endif
@@ -0,0 +1,252 @@
+#include "FrameProfiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace
+{
+    // ԴеֻתšбܺͿַ
+    void writeJsonString(std::ostream& _stream, const char* _string)
+    {
+        _stream << '"';
+        for (const char* c = _string; *c != '\0'; ++c)
+        {
+            if (*c == '"' || *c == '\\')
+            {
+                _stream << '\\' << *c;
+            }
+            else if (static_cast<unsigned char>(*c) < 0x20)
+            {
+                _stream << ' ';
+            }
+            else
+            {
+                _stream << *c;
+            }
+        }
+        _stream << '"';
+    }
+}
+
+const char* getProfileTrackName(ProfileTrack _track)
+{
+    return _track == ProfileTrack::Gpu ? "gpu" : "cpu";
+}
+
+RollingHistogram::RollingHistogram(size_t _capacity)
+    : m_capacity(std::max<size_t>(1, _capacity))
+{
+    m_samples.reserve(m_capacity);
+}
+
+void RollingHistogram::add(double _value)
+{
+    if (m_samples.size() < m_capacity)
+    {
+        m_samples.push_back(_value);
+        return;
+    }
+    m_samples[m_next] = _value;
+    m_next = (m_next + 1) % m_capacity;
+}
+
+double RollingHistogram::getPercentile(double _percentile) const
+{
+    if (m_samples.empty())
+    {
+        return 0.0;
+    }
+
+    const double fraction = std::min(100.0, std::max(0.0, _percentile)) / 100.0;
+    const size_t rank = static_cast<size_t>(std::ceil(fraction * m_samples.size()));
+    const size_t index = rank == 0 ? 0 : rank - 1;
+    std::vector<double> samples = m_samples;
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+
+double RollingHistogram::getMean() const
+{
+    if (m_samples.empty())
+    {
+        return 0.0;
+    }
+
+    double sum = 0.0;
+    for (double sample : m_samples)
+    {
+        sum += sample;
+    }
+    return sum / m_samples.size();
+}
+
+double RollingHistogram::getStandardDeviation() const
+{
+    if (m_samples.empty())
+    {
+        return 0.0;
+    }
+
+    const double mean = getMean();
+    double squaredDeviationSum = 0.0;
+    for (double sample : m_samples)
+    {
+        squaredDeviationSum += (sample - mean) * (sample - mean);
+    }
+    return std::sqrt(squaredDeviationSum / m_samples.size());
+}
+
+FrameProfiler::FrameProfiler()
+    : m_startTime(Clock::now()),
+      m_frameStartTime(m_startTime)
+{
+}
+
+void FrameProfiler::beginFrame()
+{
+    ++m_frameIndex;
+    m_frameStartTime = Clock::now();
+}
+
+void FrameProfiler::endFrame()
+{
+    addCpuScope("frame", m_frameStartTime, Clock::now());
+}
+
+void FrameProfiler::addCpuScope(const char* _name, Clock::time_point _start, Clock::time_point _end)
+{
+    addScope(_name, ProfileTrack::Cpu, m_frameIndex, toMicroseconds(_start), std::chrono::duration<double, std::micro>(_end - _start).count());
+}
+
+void FrameProfiler::addGpuFrame(uint64_t _frame, Clock::time_point _submitTime, const char* const* _names, const double* _offsets, uint32_t _timestampCount)
+{
+    if (_timestampCount < 2)
+    {
+        return;
+    }
+
+    const double base = std::max(toMicroseconds(_submitTime), m_gpuEndMicroseconds);
+    for (uint32_t i = 0; i + 1 < _timestampCount; ++i)
+    {
+        addScope(_names[i], ProfileTrack::Gpu, _frame, base + _offsets[i], _offsets[i + 1] - _offsets[i]);
+    }
+    addScope("frame", ProfileTrack::Gpu, _frame, base, _offsets[_timestampCount - 1]);
+    m_gpuEndMicroseconds = base + _offsets[_timestampCount - 1];
+}
+
+const RollingHistogram* FrameProfiler::findHistogram(ProfileTrack _track, const char* _name) const
+{
+    for (const ScopeStatistics& statistics : m_statistics)
+    {
+        if (statistics.track == _track && (statistics.name == _name || std::strcmp(statistics.name, _name) == 0))
+        {
+            return &statistics.histogram;
+        }
+    }
+    return nullptr;
+}
+
+std::vector<ProfileScopeSummary> FrameProfiler::getSummaries() const
+{
+    std::vector<ProfileScopeSummary> summaries;
+    for (const ScopeStatistics& statistics : m_statistics)
+    {
+        summaries.push_back(ProfileScopeSummary{ statistics.name, statistics.track, statistics.histogram.getPercentile(50.0) / 1000.0,
+            statistics.histogram.getPercentile(95.0) / 1000.0, statistics.histogram.getPercentile(99.0) / 1000.0, statistics.histogram.getCount() });
+    }
+    return summaries;
+}
+
+std::vector<std::string> FrameProfiler::getReport() const
+{
+    std::vector<std::string> lines;
+    for (const ProfileScopeSummary& summary : getSummaries())
+    {
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(3) << getProfileTrackName(summary.track) << " " << summary.name
+            << ": p50 " << summary.p50Milliseconds << " ms, p95 " << summary.p95Milliseconds << " ms, p99 " << summary.p99Milliseconds
+            << " ms (" << summary.sampleCount << " samples)";
+        lines.push_back(line.str());
+    }
+    return lines;
+}
+
+void FrameProfiler::resetStatistics()
+{
+    m_statistics.clear();
+}
+
+bool FrameProfiler::writeChromeTrace(const std::string& _filename) const
+{
+    std::ofstream file(_filename);
+    if (!file)
+    {
+        return false;
+    }
+
+    // ʱ䵥λΪ΢룬CPU  GPU ռһ̹߳
+    file << std::fixed << std::setprecision(3);
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"VulkanDemo\"}},\n";
+    file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << static_cast<uint32_t>(ProfileTrack::Cpu) << ",\"args\":{\"name\":\"CPU\"}},\n";
+    file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << static_cast<uint32_t>(ProfileTrack::Gpu) << ",\"args\":{\"name\":\"GPU\"}}";
+    for (const ProfileEvent& event : m_events)
+    {
+        file << ",\n{\"name\":";
+        writeJsonString(file, event.name);
+        file << ",\"cat\":\"" << getProfileTrackName(event.track) << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << static_cast<uint32_t>(event.track)
+            << ",\"ts\":" << event.startMicroseconds << ",\"dur\":" << event.durationMicroseconds << ",\"args\":{\"frame\":" << event.frame << "}}";
+    }
+    file << "\n]}\n";
+    return static_cast<bool>(file);
+}
+
+double FrameProfiler::toMicroseconds(Clock::time_point _time) const
+{
+    return std::chrono::duration<double, std::micro>(_time - m_startTime).count();
+}
+
+void FrameProfiler::addScope(const char* _name, ProfileTrack _track, uint64_t _frame, double _startMicroseconds, double _durationMicroseconds)
+{
+    getStatistics(_track, _name).histogram.add(_durationMicroseconds);
+
+    if (!m_traceEnabled)
+    {
+        return;
+    }
+    if (m_events.size() >= MAX_TRACE_EVENTS)
+    {
+        ++m_droppedEventCount;
+        return;
+    }
+    m_events.push_back(ProfileEvent{ _name, _track, _frame, _startMicroseconds, _durationMicroseconds });
+}
+
+FrameProfiler::ScopeStatistics& FrameProfiler::getStatistics(ProfileTrack _track, const char* _name)
+{
+    for (ScopeStatistics& statistics : m_statistics)
+    {
+        if (statistics.track == _track && (statistics.name == _name || std::strcmp(statistics.name, _name) == 0))
+        {
+            return statistics;
+        }
+    }
+    m_statistics.push_back(ScopeStatistics{ _name, _track, RollingHistogram(HISTOGRAM_WINDOW) });
+    return m_statistics.back();
+}
+
+ProfileScope::ProfileScope(FrameProfiler& _profiler, const char* _name)
+    : m_profiler(_profiler),
+      m_name(_name),
+      m_startTime(FrameProfiler::Clock::now())
+{
+}
+
+ProfileScope::~ProfileScope()
+{
+    m_profiler.addCpuScope(m_name, m_startTime, FrameProfiler::Clock::now());
+}
@@ -0,0 +1,141 @@
+#ifndef GQY_FRAME_PROFILER_H
+#define GQY_FRAME_PROFILER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//  _capacity Ĺڣλ
+class RollingHistogram
+{
+public:
+    explicit RollingHistogram(size_t _capacity = 1024);
+
+    void add(double _value);
+    // ȷλ_percentile ȡ 0~100ûʱ 0
+    double getPercentile(double _percentile) const;
+    // ľֵ׼ûʱ 0
+    double getMean() const;
+    double getStandardDeviation() const;
+    size_t getCount() const { return m_samples.size(); }
+
+private:
+    std::vector<double> m_samples;
+    size_t m_capacity = 0;
+    size_t m_next = 0;
+};
+
+enum class ProfileTrack : uint32_t
+{
+    Cpu = 1,
+    Gpu = 2
+};
+
+const char* getProfileTrackName(ProfileTrack _track);
+
+struct ProfileScopeSummary
+{
+    const char* name;
+    ProfileTrack track;
+    double p50Milliseconds;
+    double p95Milliseconds;
+    double p99Milliseconds;
+    size_t sampleCount;
+};
+
+struct ProfileEvent
+{
+    const char* name;
+    ProfileTrack track;
+    uint64_t frame;
+    double startMicroseconds;
+    double durationMicroseconds;
+};
+
+// ֡¼ CPU ʱκ GPU ʱΣÿεĺʱֱͼ¼ʱͬʱΪ¼
+// ɵΪ Chrome trace JSON (chrome://tracing  Perfetto д)
+// ַ㹻ַֻ߳ʹ
+class FrameProfiler
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // ÿʱεֱͼڴСͼ¼¼ޣ޵¼ֻ
+    static const size_t HISTOGRAM_WINDOW = 1024;
+    static const size_t MAX_TRACE_EVENTS = 262144;
+
+    FrameProfiler();
+    FrameProfiler(const FrameProfiler& _frameProfiler) = delete;
+
+    FrameProfiler& operator = (const FrameProfiler& _frameProfiler) = delete;
+
+    void setTraceEnabled(bool _enabled) { m_traceEnabled = _enabled; }
+    bool isTraceEnabled() const { return m_traceEnabled; }
+
+    // ֡ʱΪΪ "frame"  CPU 
+    void beginFrame();
+    void endFrame();
+    uint64_t getFrameIndex() const { return m_frameIndex; }
+
+    void addCpuScope(const char* _name, Clock::time_point _start, Clock::time_point _end);
+    // GPU ʱ CPU ʱӲͬһʱÿ֡ĵһʱ뵽֡ύʱ (Ҳһ֡ GPU ν)ֻ֡ڵʱ䡣
+    // _offsets Եһʱ΢_names[i]  [_offsets[i], _offsets[i + 1]] ε֣¼һȫʱ "frame" 
+    void addGpuFrame(uint64_t _frame, Clock::time_point _submitTime, const char* const* _names, const double* _offsets, uint32_t _timestampCount);
+
+    const RollingHistogram* findHistogram(ProfileTrack _track, const char* _name) const;
+    // ״γֵ˳гʱεķλ
+    std::vector<ProfileScopeSummary> getSummaries() const;
+    // ÿʱһУp50/p95/p99 
+    std::vector<std::string> getReport() const;
+    // ֱͼ (ԤȽ)Ѽ¼¼
+    void resetStatistics();
+
+    const std::vector<ProfileEvent>& getEvents() const { return m_events; }
+    size_t getDroppedEventCount() const { return m_droppedEventCount; }
+    bool writeChromeTrace(const std::string& _filename) const;
+
+private:
+    struct ScopeStatistics
+    {
+        const char* name;
+        ProfileTrack track;
+        RollingHistogram histogram;
+    };
+
+    double toMicroseconds(Clock::time_point _time) const;
+    void addScope(const char* _name, ProfileTrack _track, uint64_t _frame, double _startMicroseconds, double _durationMicroseconds);
+    ScopeStatistics& getStatistics(ProfileTrack _track, const char* _name);
+
+private:
+    Clock::time_point m_startTime;
+    Clock::time_point m_frameStartTime;
+    uint64_t m_frameIndex = 0;
+    double m_gpuEndMicroseconds = 0.0;
+
+    // ʱֻʮԲҼ
+    std::vector<ScopeStatistics> m_statistics;
+
+    bool m_traceEnabled = false;
+    std::vector<ProfileEvent> m_events;
+    size_t m_droppedEventCount = 0;
+};
+
+// 쵽֮Ϊһ CPU 
+class ProfileScope
+{
+public:
+    ProfileScope(FrameProfiler& _profiler, const char* _name);
+    ProfileScope(const ProfileScope& _profileScope) = delete;
+    ~ProfileScope();
+
+    ProfileScope& operator = (const ProfileScope& _profileScope) = delete;
+
+private:
+    FrameProfiler& m_profiler;
+    const char* m_name;
+    FrameProfiler::Clock::time_point m_startTime;
+};
+
+#endif
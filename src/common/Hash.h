@@ -0,0 +1,114 @@
+#ifndef GQY_HASH_H
+#define GQY_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// 64 λǼܹϣ (XXH64 㷨)У黺ļӦԴļǷ仯
+namespace hash64_detail
+{
+    constexpr uint64_t PRIME1 = 0x9E3779B185EBCA87ull;
+    constexpr uint64_t PRIME2 = 0xC2B2AE3D27D4EB4Full;
+    constexpr uint64_t PRIME3 = 0x165667B19E3779F9ull;
+    constexpr uint64_t PRIME4 = 0x85EBCA77C2B2AE63ull;
+    constexpr uint64_t PRIME5 = 0x27D4EB2F165667C5ull;
+
+    inline uint64_t rotateLeft(uint64_t _value, int _bits)
+    {
+        return (_value << _bits) | (_value >> (64 - _bits));
+    }
+
+    inline uint64_t read64(const unsigned char* _p)
+    {
+        uint64_t value;
+        std::memcpy(&value, _p, sizeof(value));
+        return value;
+    }
+
+    inline uint32_t read32(const unsigned char* _p)
+    {
+        uint32_t value;
+        std::memcpy(&value, _p, sizeof(value));
+        return value;
+    }
+
+    inline uint64_t accumulate(uint64_t _accumulator, uint64_t _input)
+    {
+        _accumulator += _input * PRIME2;
+        _accumulator = rotateLeft(_accumulator, 31);
+        return _accumulator * PRIME1;
+    }
+
+    inline uint64_t mergeRound(uint64_t _accumulator, uint64_t _value)
+    {
+        _accumulator ^= accumulate(0, _value);
+        return _accumulator * PRIME1 + PRIME4;
+    }
+}
+
+inline uint64_t hash64(const void* _data, size_t _size, uint64_t _seed = 0)
+{
+    using namespace hash64_detail;
+
+    const unsigned char* p = static_cast<const unsigned char*>(_data);
+    const unsigned char* end = p + _size;
+    uint64_t hash;
+
+    if (_size >= 32)
+    {
+        uint64_t v1 = _seed + PRIME1 + PRIME2;
+        uint64_t v2 = _seed + PRIME2;
+        uint64_t v3 = _seed;
+        uint64_t v4 = _seed - PRIME1;
+        const unsigned char* limit = end - 32;
+        do
+        {
+            v1 = accumulate(v1, read64(p));
+            v2 = accumulate(v2, read64(p + 8));
+            v3 = accumulate(v3, read64(p + 16));
+            v4 = accumulate(v4, read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+
+        hash = rotateLeft(v1, 1) + rotateLeft(v2, 7) + rotateLeft(v3, 12) + rotateLeft(v4, 18);
+        hash = mergeRound(hash, v1);
+        hash = mergeRound(hash, v2);
+        hash = mergeRound(hash, v3);
+        hash = mergeRound(hash, v4);
+    }
+    else
+    {
+        hash = _seed + PRIME5;
+    }
+
+    hash += static_cast<uint64_t>(_size);
+
+    while (p + 8 <= end)
+    {
+        hash ^= accumulate(0, read64(p));
+        hash = rotateLeft(hash, 27) * PRIME1 + PRIME4;
+        p += 8;
+    }
+    if (p + 4 <= end)
+    {
+        hash ^= static_cast<uint64_t>(read32(p)) * PRIME1;
+        hash = rotateLeft(hash, 23) * PRIME2 + PRIME3;
+        p += 4;
+    }
+    while (p < end)
+    {
+        hash ^= (*p) * PRIME5;
+        hash = rotateLeft(hash, 11) * PRIME1;
+        ++p;
+    }
+
+    hash ^= hash >> 33;
+    hash *= PRIME2;
+    hash ^= hash >> 29;
+    hash *= PRIME3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+#endif
@@ -0,0 +1,28 @@
+#include "ImageCompare.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+ImageDifference compareImages(const unsigned char* _a, const unsigned char* _b, size_t _pixelCount, uint32_t _channelThreshold)
+{
+    ImageDifference difference;
+    difference.pixelCount = _pixelCount;
+    uint64_t differenceSum = 0;
+    for (size_t i = 0; i < _pixelCount; ++i)
+    {
+        uint32_t pixelDifference = 0;
+        for (size_t channel = 0; channel < 4; ++channel)
+        {
+            const uint32_t channelDifference = static_cast<uint32_t>(std::abs(static_cast<int>(_a[i * 4 + channel]) - static_cast<int>(_b[i * 4 + channel])));
+            pixelDifference = std::max(pixelDifference, channelDifference);
+            differenceSum += channelDifference;
+        }
+        difference.maxChannelDifference = std::max(difference.maxChannelDifference, pixelDifference);
+        if (pixelDifference > _channelThreshold)
+        {
+            ++difference.differingPixelCount;
+        }
+    }
+    difference.meanChannelDifference = _pixelCount == 0 ? 0.0 : static_cast<double>(differenceSum) / (_pixelCount * 4);
+    return difference;
+}
@@ -0,0 +1,19 @@
+#ifndef GQY_IMAGE_COMPARE_H
+#define GQY_IMAGE_COMPARE_H
+
+#include <cstddef>
+#include <cstdint>
+
+struct ImageDifference
+{
+    uint32_t maxChannelDifference = 0;
+    double meanChannelDifference = 0.0;
+    // ĳֵֵͨ
+    size_t differingPixelCount = 0;
+    size_t pixelCount = 0;
+};
+
+// رȽͬС RGBA8 ͼ
+ImageDifference compareImages(const unsigned char* _a, const unsigned char* _b, size_t _pixelCount, uint32_t _channelThreshold);
+
+#endif
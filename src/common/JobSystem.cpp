@@ -0,0 +1,342 @@
+#include "JobSystem.h"
+
+struct Job
+{
+    std::function<void()> function;
+    JobCounter* counter;
+};
+
+namespace
+{
+    // ߳ϵͳͱţϵͳ߳ͨ߳ id ʶ
+    thread_local const JobSystem* t_jobSystem = nullptr;
+    thread_local uint32_t t_threadIndex = 0;
+
+    // ҲʱóɴʱƬߣƵ߻
+    const uint32_t IDLE_SPIN_COUNT = 64;
+}
+
+bool JobDeque::push(Job* _job)
+{
+    const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+    const int64_t top = m_top.load(std::memory_order_acquire);
+    if (bottom - top >= static_cast<int64_t>(CAPACITY))
+    {
+        return false;
+    }
+    m_jobs[bottom & (CAPACITY - 1)].store(_job, std::memory_order_relaxed);
+    m_bottom.store(bottom + 1, std::memory_order_release);
+    return true;
+}
+
+Job* JobDeque::pop()
+{
+    const int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+    m_bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = m_top.load(std::memory_order_relaxed);
+    if (top > bottom)
+    {
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Job* job = m_jobs[bottom & (CAPACITY - 1)].load(std::memory_order_relaxed);
+    if (top == bottom)
+    {
+        // ֻʣһʱȡ߾
+        if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            job = nullptr;
+        }
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return job;
+}
+
+Job* JobDeque::steal()
+{
+    int64_t top = m_top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t bottom = m_bottom.load(std::memory_order_acquire);
+    if (top >= bottom)
+    {
+        return nullptr;
+    }
+
+    Job* job = m_jobs[top & (CAPACITY - 1)].load(std::memory_order_relaxed);
+    if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+    {
+        return nullptr;
+    }
+    return job;
+}
+
+JobSystem::JobSystem(uint32_t _threadCount)
+    : m_ownerThread(std::this_thread::get_id())
+{
+    const uint32_t threadCount = std::max(1u, _threadCount);
+    for (uint32_t i = 0; i < threadCount; ++i)
+    {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    for (uint32_t i = 1; i < threadCount; ++i)
+    {
+        m_threads.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stopping.store(true);
+    }
+    m_sleepCondition.notify_all();
+    for (std::thread& thread : m_threads)
+    {
+        thread.join();
+    }
+
+    for (std::unique_ptr<Worker>& worker : m_workers)
+    {
+        while (Job* job = worker->deque.steal())
+        {
+            delete job;
+        }
+    }
+    for (Job* job : m_injectionQueue)
+    {
+        delete job;
+    }
+}
+
+uint32_t JobSystem::getCurrentThreadIndex() const
+{
+    if (t_jobSystem == this)
+    {
+        return t_threadIndex;
+    }
+    return std::this_thread::get_id() == m_ownerThread ? 0 : getThreadCount();
+}
+
+void JobSystem::spawn(std::function<void()> _function, JobCounter* _counter)
+{
+    if (_counter != nullptr)
+    {
+        _counter->m_count.fetch_add(1, std::memory_order_relaxed);
+    }
+    push(new Job{ std::move(_function), _counter });
+}
+
+void JobSystem::spawnAfter(JobCounter& _dependency, std::function<void()> _function, JobCounter* _counter)
+{
+    if (_counter != nullptr)
+    {
+        _counter->m_count.fetch_add(1, std::memory_order_relaxed);
+    }
+    Job* job = new Job{ std::move(_function), _counter };
+    {
+        std::lock_guard<std::mutex> lock(_dependency.m_mutex);
+        if (!_dependency.isDone())
+        {
+            _dependency.m_continuations.push_back(job);
+            return;
+        }
+    }
+    push(job);
+}
+
+void JobSystem::wait(JobCounter& _counter)
+{
+    while (!_counter.isDone())
+    {
+        if (!runPendingJob())
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    // ߳Ĳȡܱ֮
+    std::lock_guard<std::mutex> lock(_counter.m_mutex);
+    if (_counter.m_exception)
+    {
+        std::exception_ptr exception = _counter.m_exception;
+        _counter.m_exception = nullptr;
+        std::rethrow_exception(exception);
+    }
+}
+
+bool JobSystem::runPendingJob()
+{
+    const uint32_t threadIndex = getCurrentThreadIndex();
+    Job* job = findJob(threadIndex);
+    if (job == nullptr)
+    {
+        return false;
+    }
+    execute(job, threadIndex);
+    return true;
+}
+
+JobStatistics JobSystem::getStatistics() const
+{
+    JobStatistics statistics;
+    for (const std::unique_ptr<Worker>& worker : m_workers)
+    {
+        statistics.executedCount += worker->executedCount.load(std::memory_order_relaxed);
+        statistics.stolenCount += worker->stolenCount.load(std::memory_order_relaxed);
+    }
+    return statistics;
+}
+
+void JobSystem::resetStatistics()
+{
+    for (std::unique_ptr<Worker>& worker : m_workers)
+    {
+        worker->executedCount.store(0, std::memory_order_relaxed);
+        worker->stolenCount.store(0, std::memory_order_relaxed);
+    }
+}
+
+void JobSystem::workerLoop(uint32_t _threadIndex)
+{
+    t_jobSystem = this;
+    t_threadIndex = _threadIndex;
+
+    uint32_t idleCount = 0;
+    while (!m_stopping.load(std::memory_order_relaxed))
+    {
+        if (Job* job = findJob(_threadIndex))
+        {
+            execute(job, _threadIndex);
+            idleCount = 0;
+            continue;
+        }
+        if (++idleCount < IDLE_SPIN_COUNT)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // ȵǼټУ push ټԣ
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_sleepingCount.fetch_add(1);
+        m_sleepCondition.wait(lock, [this]()
+        {
+            return m_stopping.load() || m_queuedJobCount.load() > 0;
+        });
+        m_sleepingCount.fetch_sub(1);
+        idleCount = 0;
+    }
+}
+
+void JobSystem::push(Job* _job)
+{
+    const uint32_t threadIndex = getCurrentThreadIndex();
+    if (threadIndex >= m_workers.size() || !m_workers[threadIndex]->deque.push(_job))
+    {
+        std::lock_guard<std::mutex> lock(m_injectionMutex);
+        m_injectionQueue.push_back(_job);
+    }
+
+    m_queuedJobCount.fetch_add(1);
+    if (m_sleepingCount.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_sleepCondition.notify_one();
+    }
+}
+
+Job* JobSystem::findJob(uint32_t _threadIndex)
+{
+    // ȡԼеײύٿעУ̵߳Ķжȡ
+    Job* job = nullptr;
+    const uint32_t threadCount = getThreadCount();
+    if (_threadIndex < threadCount)
+    {
+        job = m_workers[_threadIndex]->deque.pop();
+    }
+    if (job == nullptr && m_queuedJobCount.load(std::memory_order_relaxed) > 0)
+    {
+        std::lock_guard<std::mutex> lock(m_injectionMutex);
+        if (!m_injectionQueue.empty())
+        {
+            job = m_injectionQueue.front();
+            m_injectionQueue.pop_front();
+        }
+    }
+    for (uint32_t i = 1; job == nullptr && i <= threadCount; ++i)
+    {
+        const uint32_t victim = (_threadIndex + i) % threadCount;
+        if (victim != _threadIndex)
+        {
+            job = m_workers[victim]->deque.steal();
+            if (job != nullptr && _threadIndex < threadCount)
+            {
+                m_workers[_threadIndex]->stolenCount.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    if (job != nullptr)
+    {
+        m_queuedJobCount.fetch_sub(1);
+    }
+    return job;
+}
+
+void JobSystem::execute(Job* _job, uint32_t _threadIndex)
+{
+    std::exception_ptr exception;
+    try
+    {
+        _job->function();
+    }
+    catch (...)
+    {
+        exception = std::current_exception();
+    }
+    if (_threadIndex < m_workers.size())
+    {
+        m_workers[_threadIndex]->executedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    JobCounter* counter = _job->counter;
+    delete _job;
+    if (counter != nullptr)
+    {
+        finish(*counter, exception);
+    }
+    else if (exception)
+    {
+        // ûм޴쳣
+        std::terminate();
+    }
+}
+
+void JobSystem::finish(JobCounter& _counter, std::exception_ptr _exception)
+{
+    std::vector<Job*> continuations;
+    {
+        std::lock_guard<std::mutex> lock(_counter.m_mutex);
+        if (_exception && !_counter.m_exception)
+        {
+            _counter.m_exception = _exception;
+        }
+        if (_counter.m_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            continuations.swap(_counter.m_continuations);
+        }
+    }
+    for (Job* job : continuations)
+    {
+        push(job);
+    }
+}
+
+JobSystem& getJobSystem()
+{
+    static JobSystem jobSystem;
+    return jobSystem;
+}
@@ -0,0 +1,187 @@
+#ifndef GQY_JOB_SYSTEM_H
+#define GQY_JOB_SYSTEM_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+inline uint32_t getDefaultThreadCount()
+{
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+struct Job;
+
+// һļύʱһʱһŻύ
+// ׳ĵһ쳣ڼУ JobSystem::wait ׳
+class JobCounter
+{
+public:
+    JobCounter() = default;
+    JobCounter(const JobCounter& _jobCounter) = delete;
+
+    JobCounter& operator = (const JobCounter& _jobCounter) = delete;
+
+    bool isDone() const { return m_count.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+
+    std::atomic<uint32_t> m_count{ 0 };
+    std::mutex m_mutex;
+    std::vector<Job*> m_continuations;
+    std::exception_ptr m_exception;
+};
+
+// ߡȡߵ˫˶ (Chase-Lev)ڵײѹ͵̴߳Ӷȡ
+// ̶ʱ push  false
+class JobDeque
+{
+public:
+    static const size_t CAPACITY = 4096;
+
+    bool push(Job* _job);
+    Job* pop();
+    // Ϊջ߳̾ʧʱؿ
+    Job* steal();
+
+private:
+    alignas(64) std::atomic<int64_t> m_top{ 0 };
+    alignas(64) std::atomic<int64_t> m_bottom{ 0 };
+    std::array<std::atomic<Job*>, CAPACITY> m_jobs{ };
+};
+
+struct JobStatistics
+{
+    uint64_t executedCount = 0;
+    uint64_t stolenCount = 0;
+};
+
+// ȡϵͳ߳ 0 ̣߳ _threadCount - 1 ̣߳ÿ߳Լ˫˶У
+// ύǰ̵߳ĶУе̴߳ȡ߳ύ빲עС
+// ȴ̲߳ǼִпǶύ͵ȴ
+class JobSystem
+{
+public:
+    explicit JobSystem(uint32_t _threadCount = getDefaultThreadCount());
+    JobSystem(const JobSystem& _jobSystem) = delete;
+    // δִе񱻶ǰӦȴм
+    ~JobSystem();
+
+    JobSystem& operator = (const JobSystem& _jobSystem) = delete;
+
+    uint32_t getThreadCount() const { return static_cast<uint32_t>(m_workers.size()); }
+    // ǰ߳ڱϵͳеıţڱϵͳ̷߳ getThreadCount()
+    uint32_t getCurrentThreadIndex() const;
+
+    void spawn(std::function<void()> _function, JobCounter* _counter = nullptr);
+    // _dependency ύ
+    void spawnAfter(JobCounter& _dependency, std::function<void()> _function, JobCounter* _counter = nullptr);
+    // ֱִ㣬Ȼ׳б쳣
+    void wait(JobCounter& _counter);
+    // ȡһڵǰִ߳Уûпִеʱ false
+    bool runPendingJob();
+
+    //  [0, _count) ֳ _chunkCount Σ_function(begin, end, chunkIndex) 0 ڵִ߳С
+    // һ쳣жν׳
+    template<typename Function>
+    void parallelFor(size_t _count, uint32_t _chunkCount, Function&& _function);
+
+    JobStatistics getStatistics() const;
+    void resetStatistics();
+
+private:
+    struct alignas(64) Worker
+    {
+        JobDeque deque;
+        std::atomic<uint64_t> executedCount{ 0 };
+        std::atomic<uint64_t> stolenCount{ 0 };
+    };
+
+    void workerLoop(uint32_t _threadIndex);
+    void push(Job* _job);
+    Job* findJob(uint32_t _threadIndex);
+    void execute(Job* _job, uint32_t _threadIndex);
+    void finish(JobCounter& _counter, std::exception_ptr _exception);
+
+private:
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::vector<std::thread> m_threads;
+    std::thread::id m_ownerThread;
+
+    std::mutex m_injectionMutex;
+    std::deque<Job*> m_injectionQueue;
+
+    // еߵ߳ύʱݴ˾Ƿ
+    std::atomic<int64_t> m_queuedJobCount{ 0 };
+    std::atomic<uint32_t> m_sleepingCount{ 0 };
+    std::mutex m_sleepMutex;
+    std::condition_variable m_sleepCondition;
+    std::atomic<bool> m_stopping{ false };
+};
+
+// ڹϵͳһεʱӲ̳߳߳Ϊ 0 ߳
+JobSystem& getJobSystem();
+
+template<typename Function>
+void JobSystem::parallelFor(size_t _count, uint32_t _chunkCount, Function&& _function)
+{
+    if (_count == 0)
+    {
+        return;
+    }
+
+    _chunkCount = static_cast<uint32_t>(std::min<size_t>(std::max(1u, _chunkCount), _count));
+    if (_chunkCount == 1)
+    {
+        _function(size_t(0), _count, 0u);
+        return;
+    }
+
+    JobCounter counter;
+    for (uint32_t i = 1; i < _chunkCount; ++i)
+    {
+        spawn([&_function, _count, _chunkCount, i]()
+        {
+            _function(_count * i / _chunkCount, _count * (i + 1) / _chunkCount, i);
+        }, &counter);
+    }
+
+    std::exception_ptr exception;
+    try
+    {
+        _function(size_t(0), _count / _chunkCount, 0u);
+    }
+    catch (...)
+    {
+        exception = std::current_exception();
+    }
+    try
+    {
+        wait(counter);
+    }
+    catch (...)
+    {
+        if (!exception)
+        {
+            exception = std::current_exception();
+        }
+    }
+    if (exception)
+    {
+        std::rethrow_exception(exception);
+    }
+}
+
+#endif
@@ -0,0 +1,162 @@
+#include "MappedFile.h"
+
+#include <utility>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string& _filename)
+{
+    open(_filename);
+}
+
+MappedFile::MappedFile(MappedFile&& _mappedFile) noexcept
+{
+    *this = std::move(_mappedFile);
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+MappedFile& MappedFile::operator = (MappedFile&& _mappedFile) noexcept
+{
+    if (this != &_mappedFile)
+    {
+        close();
+
+        m_data = _mappedFile.m_data;
+        m_size = _mappedFile.m_size;
+        m_opened = _mappedFile.m_opened;
+        #ifdef _WIN32
+            m_fileHandle = _mappedFile.m_fileHandle;
+            m_mappingHandle = _mappedFile.m_mappingHandle;
+            _mappedFile.m_fileHandle = nullptr;
+            _mappedFile.m_mappingHandle = nullptr;
+        #endif
+
+        _mappedFile.m_data = nullptr;
+        _mappedFile.m_size = 0;
+        _mappedFile.m_opened = false;
+    }
+    return *this;
+}
+
+bool MappedFile::open(const std::string& _filename)
+{
+    close();
+
+    #ifdef _WIN32
+        HANDLE fileHandle = CreateFileA(_filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (fileHandle == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        LARGE_INTEGER fileSize{ };
+        if (!GetFileSizeEx(fileHandle, &fileSize))
+        {
+            CloseHandle(fileHandle);
+            return false;
+        }
+
+        m_fileHandle = fileHandle;
+        m_size = static_cast<size_t>(fileSize.QuadPart);
+        m_opened = true;
+        if (m_size == 0)
+        {
+            return true;
+        }
+
+        HANDLE mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mappingHandle == nullptr)
+        {
+            close();
+            return false;
+        }
+        m_mappingHandle = mappingHandle;
+
+        m_data = static_cast<const char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+        if (m_data == nullptr)
+        {
+            close();
+            return false;
+        }
+    #else
+        int fileDescriptor = ::open(_filename.c_str(), O_RDONLY);
+        if (fileDescriptor < 0)
+        {
+            return false;
+        }
+
+        struct stat fileStat{ };
+        if (fstat(fileDescriptor, &fileStat) != 0)
+        {
+            ::close(fileDescriptor);
+            return false;
+        }
+
+        m_size = static_cast<size_t>(fileStat.st_size);
+        m_opened = true;
+        if (m_size != 0)
+        {
+            void* mapped = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+            if (mapped == MAP_FAILED)
+            {
+                ::close(fileDescriptor);
+                m_size = 0;
+                m_opened = false;
+                return false;
+            }
+            madvise(mapped, m_size, MADV_SEQUENTIAL);
+            m_data = static_cast<const char*>(mapped);
+        }
+
+        // ӳ佨󼴿ɹرļ
+        ::close(fileDescriptor);
+    #endif
+
+    return true;
+}
+
+void MappedFile::close()
+{
+    #ifdef _WIN32
+        if (m_data != nullptr)
+        {
+            UnmapViewOfFile(m_data);
+        }
+        if (m_mappingHandle != nullptr)
+        {
+            CloseHandle(static_cast<HANDLE>(m_mappingHandle));
+            m_mappingHandle = nullptr;
+        }
+        if (m_fileHandle != nullptr)
+        {
+            CloseHandle(static_cast<HANDLE>(m_fileHandle));
+            m_fileHandle = nullptr;
+        }
+    #else
+        if (m_data != nullptr)
+        {
+            munmap(const_cast<char*>(m_data), m_size);
+        }
+    #endif
+
+    m_data = nullptr;
+    m_size = 0;
+    m_opened = false;
+}
@@ -0,0 +1,38 @@
+#ifndef GQY_MAPPED_FILE_H
+#define GQY_MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+// ֻڴӳļʱԶӳ
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& _filename);
+    MappedFile(const MappedFile& _mappedFile) = delete;
+    MappedFile(MappedFile&& _mappedFile) noexcept;
+    ~MappedFile();
+
+    MappedFile& operator = (const MappedFile& _mappedFile) = delete;
+    MappedFile& operator = (MappedFile&& _mappedFile) noexcept;
+
+    bool open(const std::string& _filename);
+    void close();
+
+    bool isOpen() const { return m_opened; }
+    const char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_opened = false;
+
+    #ifdef _WIN32
+        void* m_fileHandle = nullptr;
+        void* m_mappingHandle = nullptr;
+    #endif
+};
+
+#endif
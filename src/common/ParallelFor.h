@@ -0,0 +1,18 @@
+#ifndef GQY_PARALLEL_FOR_H
+#define GQY_PARALLEL_FOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "JobSystem.h"
+
+//  [0, _count) ֳ _taskCount ΣڹϵͳϲִУ_function(begin, end, taskIndex)
+// ׳ĵһ쳣жν׳
+template<typename Function>
+void parallelFor(size_t _count, uint32_t _taskCount, Function&& _function)
+{
+    getJobSystem().parallelFor(_count, _taskCount, std::forward<Function>(_function));
+}
+
+#endif
@@ -0,0 +1,101 @@
+#include "PipelineCacheFile.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include "AtomicFile.h"
+
+namespace
+{
+    uint32_t readLittleEndian32(const char* _data)
+    {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(_data);
+        return static_cast<uint32_t>(bytes[0]) | static_cast<uint32_t>(bytes[1]) << 8 | static_cast<uint32_t>(bytes[2]) << 16 | static_cast<uint32_t>(bytes[3]) << 24;
+    }
+
+    void writeLittleEndian32(uint32_t _value, char* _data)
+    {
+        for (uint32_t i = 0; i < 4; ++i)
+        {
+            _data[i] = static_cast<char>((_value >> (8 * i)) & 0xFF);
+        }
+    }
+}
+
+bool readPipelineCacheHeader(const std::vector<char>& _data, PipelineCacheHeader& _header)
+{
+    if (_data.size() < PIPELINE_CACHE_HEADER_SIZE)
+    {
+        return false;
+    }
+
+    _header.headerSize = readLittleEndian32(_data.data());
+    _header.headerVersion = readLittleEndian32(_data.data() + 4);
+    _header.vendorId = readLittleEndian32(_data.data() + 8);
+    _header.deviceId = readLittleEndian32(_data.data() + 12);
+    std::memcpy(_header.pipelineCacheUuid, _data.data() + 16, PIPELINE_CACHE_UUID_SIZE);
+    return true;
+}
+
+void writePipelineCacheHeader(const PipelineCacheHeader& _header, std::vector<char>& _data)
+{
+    if (_data.size() < PIPELINE_CACHE_HEADER_SIZE)
+    {
+        _data.resize(PIPELINE_CACHE_HEADER_SIZE);
+    }
+
+    writeLittleEndian32(_header.headerSize, _data.data());
+    writeLittleEndian32(_header.headerVersion, _data.data() + 4);
+    writeLittleEndian32(_header.vendorId, _data.data() + 8);
+    writeLittleEndian32(_header.deviceId, _data.data() + 12);
+    std::memcpy(_data.data() + 16, _header.pipelineCacheUuid, PIPELINE_CACHE_UUID_SIZE);
+}
+
+bool validatePipelineCacheData(const std::vector<char>& _data, uint32_t _vendorId, uint32_t _deviceId, const uint8_t* _pipelineCacheUuid, std::string& _error)
+{
+    PipelineCacheHeader header;
+    if (!readPipelineCacheHeader(_data, header))
+    {
+        _error = "only " + std::to_string(_data.size()) + " bytes";
+        return false;
+    }
+    // Ժİ汾ļͷĩβ׷ֶΣֻҪ󲻶ڵһ沢Ҳ
+    if (header.headerSize < PIPELINE_CACHE_HEADER_SIZE || header.headerSize > _data.size())
+    {
+        _error = "invalid header size " + std::to_string(header.headerSize);
+        return false;
+    }
+    if (header.headerVersion != PIPELINE_CACHE_HEADER_VERSION_ONE)
+    {
+        _error = "unsupported header version " + std::to_string(header.headerVersion);
+        return false;
+    }
+    if (header.vendorId != _vendorId || header.deviceId != _deviceId)
+    {
+        _error = "created for vendor " + std::to_string(header.vendorId) + " device " + std::to_string(header.deviceId);
+        return false;
+    }
+    if (std::memcmp(header.pipelineCacheUuid, _pipelineCacheUuid, PIPELINE_CACHE_UUID_SIZE) != 0)
+    {
+        _error = "pipeline cache UUID differs, the driver has changed";
+        return false;
+    }
+    return true;
+}
+
+bool loadPipelineCacheFile(const std::string& _filename, std::vector<char>& _data)
+{
+    std::ifstream file(_filename, std::ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+    _data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return !file.bad();
+}
+
+bool savePipelineCacheFile(const std::string& _filename, const std::vector<char>& _data)
+{
+    return writeFileAtomically(_filename, _data.data(), _data.size());
+}
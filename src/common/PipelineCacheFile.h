@@ -0,0 +1,37 @@
+#ifndef GQY_PIPELINE_CACHE_FILE_H
+#define GQY_PIPELINE_CACHE_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//  VK_PIPELINE_CACHE_HEADER_VERSION_ONE  VK_UUID_SIZE һ£ﲻ Vulkan ͷļ߳Ҳʹ
+const uint32_t PIPELINE_CACHE_HEADER_VERSION_ONE = 1;
+const size_t PIPELINE_CACHE_UUID_SIZE = 16;
+
+// VkPipelineCacheHeaderVersionOneĻͷֶΰСֽ
+struct PipelineCacheHeader
+{
+    uint32_t headerSize = 0;
+    uint32_t headerVersion = 0;
+    uint32_t vendorId = 0;
+    uint32_t deviceId = 0;
+    uint8_t pipelineCacheUuid[PIPELINE_CACHE_UUID_SIZE]{ };
+};
+
+const size_t PIPELINE_CACHE_HEADER_SIZE = 32;
+
+// Сֽдļͷݲ PIPELINE_CACHE_HEADER_SIZE ֽʱ false
+bool readPipelineCacheHeader(const std::vector<char>& _data, PipelineCacheHeader& _header);
+void writePipelineCacheHeader(const PipelineCacheHeader& _header, std::vector<char>& _data);
+// У黺ͬһ豸汾̡豸ź pipelineCacheUUID Ҫһ¡
+//  UUID 仯ݽܱܾ±һʱ _error ˵ԭ
+bool validatePipelineCacheData(const std::vector<char>& _data, uint32_t _vendorId, uint32_t _deviceId, const uint8_t* _pipelineCacheUuid, std::string& _error);
+
+// ȡļļڻȡʧʱ false
+bool loadPipelineCacheFile(const std::string& _filename, std::vector<char>& _data);
+// дʱļ滻;˳²Ļ
+bool savePipelineCacheFile(const std::string& _filename, const std::vector<char>& _data);
+
+#endif
@@ -0,0 +1,252 @@
+#include "TaskGraph.h"
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <exception>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include "common.h"
+
+TaskGraph::TaskId TaskGraph::addTask(const std::string& _name, std::function<void()> _function, const std::vector<TaskId>& _dependencies, TaskAffinity _affinity)
+{
+    const TaskId task = static_cast<TaskId>(m_tasks.size());
+    for (TaskId dependency : _dependencies)
+    {
+        if (dependency >= task)
+        {
+            throw std::runtime_error(setFontColor("Task " + _name + " depends on a task that is not added yet", FontColor::Red));
+        }
+    }
+    m_tasks.push_back(Task{ _name, std::move(_function), _dependencies, _affinity, TaskTiming{ } });
+    return task;
+}
+
+void TaskGraph::run(JobSystem& _jobSystem)
+{
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point startTime = Clock::now();
+    auto getMilliseconds = [startTime]()
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - startTime).count();
+    };
+
+    const size_t taskCount = m_tasks.size();
+    m_threadCount = _jobSystem.getThreadCount();
+    std::vector<uint32_t> remainingDependencies(taskCount);
+    std::vector<std::vector<TaskId>> dependents(taskCount);
+    for (TaskId task = 0; task < taskCount; ++task)
+    {
+        m_tasks[task].timing = TaskTiming{ };
+        remainingDependencies[task] = static_cast<uint32_t>(m_tasks[task].dependencies.size());
+        for (TaskId dependency : m_tasks[task].dependencies)
+        {
+            dependents[dependency].push_back(task);
+        }
+    }
+
+    // ʧ״̬ mutex scheduledCount Ѿû
+    // ʱִеѽ
+    std::mutex mutex;
+    std::deque<TaskId> mainThreadTasks;
+    size_t scheduledCount = 0;
+    std::exception_ptr exception;
+    JobCounter counter;
+    std::function<void(TaskId)> runTask;
+    auto schedule = [&](TaskId _task)
+    {
+        ++scheduledCount;
+        if (m_tasks[_task].affinity == TaskAffinity::MainThread)
+        {
+            mainThreadTasks.push_back(_task);
+        }
+        else
+        {
+            _jobSystem.spawn([&runTask, _task]() { runTask(_task); }, &counter);
+        }
+    };
+
+    runTask = [&](TaskId _task)
+    {
+        Task& current = m_tasks[_task];
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (exception)
+            {
+                --scheduledCount;
+                return;
+            }
+            current.timing.threadIndex = _jobSystem.getCurrentThreadIndex();
+            current.timing.startMilliseconds = getMilliseconds();
+        }
+
+        std::exception_ptr taskException;
+        try
+        {
+            current.function();
+        }
+        catch (...)
+        {
+            taskException = std::current_exception();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        current.timing.endMilliseconds = getMilliseconds();
+        current.timing.executed = true;
+        --scheduledCount;
+        if (taskException)
+        {
+            if (!exception)
+            {
+                exception = taskException;
+            }
+            return;
+        }
+        for (TaskId dependent : dependents[_task])
+        {
+            if (--remainingDependencies[dependent] == 0)
+            {
+                m_tasks[dependent].timing.readyMilliseconds = current.timing.endMilliseconds;
+                schedule(dependent);
+            }
+        }
+    };
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (TaskId task = 0; task < taskCount; ++task)
+        {
+            if (remainingDependencies[task] == 0)
+            {
+                schedule(task);
+            }
+        }
+    }
+
+    // ִ߳ MainThread ʱִϵͳе
+    while (true)
+    {
+        TaskId task = static_cast<TaskId>(taskCount);
+        bool finished = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!mainThreadTasks.empty())
+            {
+                task = mainThreadTasks.front();
+                mainThreadTasks.pop_front();
+            }
+            finished = scheduledCount == 0;
+        }
+
+        if (task < taskCount)
+        {
+            runTask(task);
+        }
+        else if (finished)
+        {
+            break;
+        }
+        else if (!_jobSystem.runPendingJob())
+        {
+            std::this_thread::yield();
+        }
+    }
+    _jobSystem.wait(counter);
+    m_wallMilliseconds = getMilliseconds();
+
+    if (exception)
+    {
+        std::rethrow_exception(exception);
+    }
+}
+
+double TaskGraph::getWorkMilliseconds() const
+{
+    double milliseconds = 0.0;
+    for (const Task& task : m_tasks)
+    {
+        milliseconds += task.timing.getDuration();
+    }
+    return milliseconds;
+}
+
+std::vector<TaskGraph::TaskId> TaskGraph::getCriticalPath() const
+{
+    // ǱŸС񣬰˳ƵÿΪֹ·
+    const TaskId none = static_cast<TaskId>(m_tasks.size());
+    std::vector<double> pathMilliseconds(m_tasks.size(), 0.0);
+    std::vector<TaskId> predecessors(m_tasks.size(), none);
+    TaskId last = none;
+    for (TaskId task = 0; task < m_tasks.size(); ++task)
+    {
+        if (!m_tasks[task].timing.executed)
+        {
+            continue;
+        }
+        for (TaskId dependency : m_tasks[task].dependencies)
+        {
+            if (predecessors[task] == none || pathMilliseconds[dependency] > pathMilliseconds[predecessors[task]])
+            {
+                predecessors[task] = dependency;
+            }
+        }
+        pathMilliseconds[task] = m_tasks[task].timing.getDuration() + (predecessors[task] == none ? 0.0 : pathMilliseconds[predecessors[task]]);
+        if (last == none || pathMilliseconds[task] > pathMilliseconds[last])
+        {
+            last = task;
+        }
+    }
+
+    std::vector<TaskId> path;
+    for (TaskId task = last; task != none; task = predecessors[task])
+    {
+        path.push_back(task);
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+std::vector<std::string> TaskGraph::getReport() const
+{
+    const std::vector<TaskId> criticalPath = getCriticalPath();
+    double criticalMilliseconds = 0.0;
+    for (TaskId task : criticalPath)
+    {
+        criticalMilliseconds += m_tasks[task].timing.getDuration();
+    }
+
+    std::vector<std::string> lines;
+    const double workMilliseconds = getWorkMilliseconds();
+    std::ostringstream summary;
+    summary << std::fixed << std::setprecision(2) << m_wallMilliseconds << " ms on " << m_threadCount << " threads, " << workMilliseconds << " ms of work ("
+        << (m_wallMilliseconds > 0.0 ? workMilliseconds / m_wallMilliseconds : 0.0) << "x), critical path " << criticalMilliseconds << " ms";
+    lines.push_back(summary.str());
+
+    // ȴʱɵʼִ֮ļϴʱ˵̲߳
+    std::vector<TaskId> order;
+    for (TaskId task = 0; task < m_tasks.size(); ++task)
+    {
+        if (m_tasks[task].timing.executed)
+        {
+            order.push_back(task);
+        }
+    }
+    std::stable_sort(order.begin(), order.end(), [this](TaskId _a, TaskId _b)
+    {
+        return m_tasks[_a].timing.startMilliseconds < m_tasks[_b].timing.startMilliseconds;
+    });
+    for (TaskId task : order)
+    {
+        const TaskTiming& timing = m_tasks[task].timing;
+        const bool critical = std::find(criticalPath.begin(), criticalPath.end(), task) != criticalPath.end();
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(2) << (critical ? "* " : "  ") << m_tasks[task].name << ": " << timing.getDuration() << " ms (start "
+            << timing.startMilliseconds << ", waited " << timing.startMilliseconds - timing.readyMilliseconds << ", thread " << timing.threadIndex << ")";
+        lines.push_back(line.str());
+    }
+    return lines;
+}
@@ -0,0 +1,71 @@
+#ifndef GQY_TASK_GRAPH_H
+#define GQY_TASK_GRAPH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "JobSystem.h"
+
+enum class TaskAffinity
+{
+    Any,
+    // ֻڵ run ִ߳У̵ֻ߳õĴϵͳ
+    MainThread
+};
+
+// һִм¼ʱ run ʼĺ
+struct TaskTiming
+{
+    double readyMilliseconds = 0.0;
+    double startMilliseconds = 0.0;
+    double endMilliseconds = 0.0;
+    uint32_t threadIndex = 0;
+    bool executed = false;
+
+    double getDuration() const { return endMilliseconds - startMilliseconds; }
+};
+
+// ʽһͼȫɵΪϵͳύMainThread 񽻸ִ߳С
+// ֻѾӵͼ޻ġ
+// ĳ׳쳣ٿʼµ񣬵ִе׳һ쳣
+class TaskGraph
+{
+public:
+    using TaskId = uint32_t;
+
+    TaskId addTask(const std::string& _name, std::function<void()> _function, const std::vector<TaskId>& _dependencies = { }, TaskAffinity _affinity = TaskAffinity::Any);
+    // ߳ҲִУȴʱִϵͳе
+    void run(JobSystem& _jobSystem = getJobSystem());
+
+    size_t getTaskCount() const { return m_tasks.size(); }
+    const std::string& getName(TaskId _task) const { return m_tasks[_task].name; }
+    const std::vector<TaskId>& getDependencies(TaskId _task) const { return m_tasks[_task].dependencies; }
+    const TaskTiming& getTiming(TaskId _task) const { return m_tasks[_task].timing; }
+    double getWallMilliseconds() const { return m_wallMilliseconds; }
+    // ʱ֮ͣǽʱ֮Ⱦǲж
+    double getWorkMilliseconds() const;
+
+    // ʵʱ߳㹻ʱܺʱޣǽʱԶʱ˵̲߳
+    std::vector<TaskId> getCriticalPath() const;
+    // һܺʱ֮󰴿ʼʱÿһУؼ·ϵ * 
+    std::vector<std::string> getReport() const;
+
+private:
+    struct Task
+    {
+        std::string name;
+        std::function<void()> function;
+        std::vector<TaskId> dependencies;
+        TaskAffinity affinity;
+        TaskTiming timing;
+    };
+
+    std::vector<Task> m_tasks;
+    uint32_t m_threadCount = 0;
+    double m_wallMilliseconds = 0.0;
+};
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef GQY_TRIPLE_BUFFER_H
+#define GQY_TRIPLE_BUFFER_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// ߡߵػ塣ߺ߸Զռһ壬ݣ
+// ȡֻһԭӱеĻţ߶ѷûȡߵݻᱻһη
+template<typename T>
+class TripleBuffer
+{
+public:
+    // д壬д publishб֮ǰĳηľ
+    T& getWriteBuffer() { return m_buffers[m_writeIndex]; }
+    // дõĻ壬 true ʾһηûȡ߾ͱ
+    bool publish();
+
+    // ·ʱ벢 true֮ getReadBuffer ûʱǰ
+    bool acquire();
+    const T& getReadBuffer() const { return m_buffers[m_readIndex]; }
+    // Ƿѷû acquire ȡߵݣ߶Ե
+    bool hasPending() const { return (m_pending.load(std::memory_order_acquire) & PENDING_BIT) != 0; }
+
+private:
+    static const uint32_t INDEX_MASK = 3;
+    static const uint32_t PENDING_BIT = 4;
+
+    std::array<T, 3> m_buffers{ };
+    uint32_t m_writeIndex = 0;
+    uint32_t m_readIndex = 1;
+    // ıţ PENDING_BIT ʱǻûȡߵ
+    std::atomic<uint32_t> m_pending{ 2 };
+};
+
+template<typename T>
+bool TripleBuffer<T>::publish()
+{
+    // release ֤߻뻺ܿдݣacquire ֤صĻѾٱ߶ȡ
+    const uint32_t previous = m_pending.exchange(m_writeIndex | PENDING_BIT, std::memory_order_acq_rel);
+    m_writeIndex = previous & INDEX_MASK;
+    return (previous & PENDING_BIT) != 0;
+}
+
+template<typename T>
+bool TripleBuffer<T>::acquire()
+{
+    // ֻ߻ PENDING_BITֻܻ֮µ
+    if (!hasPending())
+    {
+        return false;
+    }
+    const uint32_t previous = m_pending.exchange(m_readIndex, std::memory_order_acq_rel);
+    m_readIndex = previous & INDEX_MASK;
+    return true;
+}
+
+#endif
@@ -1,16 +1,143 @@
 #include "Application.h"
 
-int main()
+void printUsage()
 {
+    std::cerr << "Usage: VulkanDemo [--instances N] [--benchmark] [--verify-culling] [--trace file.json] [--headless] [--frames N] [--dump-frames directory] [--replay script] [--record-threads N] [--record-benchmark] [--pipelined] [--sim-load-ms N] [--pacing balanced|throughput|latency] [--frames-in-flight N] [--fps-cap N] [--no-pipeline-cache]" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    ApplicationOptions options;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string argument = argv[i];
+        if (argument == "--instances" && i + 1 < argc)
+        {
+            char* end = nullptr;
+            const unsigned long instanceCount = std::strtoul(argv[++i], &end, 10);
+            if (*end != '\0' || instanceCount == 0 || instanceCount > UINT32_MAX)
+            {
+                printUsage();
+                return 1;
+            }
+            options.instanceCount = static_cast<uint32_t>(instanceCount);
+        }
+        else if (argument == "--benchmark")
+        {
+            options.benchmark = true;
+        }
+        else if (argument == "--verify-culling")
+        {
+            options.verifyCulling = true;
+        }
+        else if (argument == "--trace" && i + 1 < argc)
+        {
+            options.tracePath = argv[++i];
+        }
+        else if (argument == "--headless")
+        {
+            options.headless = true;
+        }
+        else if (argument == "--frames" && i + 1 < argc)
+        {
+            char* end = nullptr;
+            const unsigned long frameCount = std::strtoul(argv[++i], &end, 10);
+            if (*end != '\0' || frameCount == 0 || frameCount > UINT32_MAX)
+            {
+                printUsage();
+                return 1;
+            }
+            options.frameCount = static_cast<uint32_t>(frameCount);
+        }
+        else if (argument == "--dump-frames" && i + 1 < argc)
+        {
+            options.frameDumpDirectory = argv[++i];
+        }
+        else if (argument == "--replay" && i + 1 < argc)
+        {
+            options.replayScriptPath = argv[++i];
+        }
+        else if (argument == "--record-threads" && i + 1 < argc)
+        {
+            char* end = nullptr;
+            const unsigned long recordThreadCount = std::strtoul(argv[++i], &end, 10);
+            if (*end != '\0' || recordThreadCount == 0 || recordThreadCount > UINT32_MAX)
+            {
+                printUsage();
+                return 1;
+            }
+            options.recordThreadCount = static_cast<uint32_t>(recordThreadCount);
+        }
+        else if (argument == "--record-benchmark")
+        {
+            options.recordBenchmark = true;
+        }
+        else if (argument == "--pipelined")
+        {
+            options.pipelined = true;
+        }
+        else if (argument == "--sim-load-ms" && i + 1 < argc)
+        {
+            char* end = nullptr;
+            const double simulationLoadMilliseconds = std::strtod(argv[++i], &end);
+            if (*end != '\0' || !(simulationLoadMilliseconds >= 0.0))
+            {
+                printUsage();
+                return 1;
+            }
+            options.simulationLoadMilliseconds = simulationLoadMilliseconds;
+        }
+        else if (argument == "--pacing" && i + 1 < argc)
+        {
+            if (!parseFramePacingMode(argv[++i], options.pacing))
+            {
+                printUsage();
+                return 1;
+            }
+        }
+        else if (argument == "--frames-in-flight" && i + 1 < argc)
+        {
+            char* end = nullptr;
+            const unsigned long framesInFlight = std::strtoul(argv[++i], &end, 10);
+            if (*end != '\0' || framesInFlight == 0 || framesInFlight > UINT32_MAX)
+            {
+                printUsage();
+                return 1;
+            }
+            options.framesInFlight = static_cast<uint32_t>(framesInFlight);
+        }
+        else if (argument == "--fps-cap" && i + 1 < argc)
+        {
+            char* end = nullptr;
+            const double frameRateCap = std::strtod(argv[++i], &end);
+            if (*end != '\0' || !(frameRateCap > 0.0))
+            {
+                printUsage();
+                return 1;
+            }
+            options.frameRateCap = frameRateCap;
+        }
+        else if (argument == "--no-pipeline-cache")
+        {
+            options.pipelineCache = false;
+        }
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    int exitCode = 1;
     try
     {
-        Application app(800, 600, "Vulkan Demo");
-        app.run();
+        Application app(800, 600, "Vulkan Demo", options);
+        exitCode = app.run();
     }
     catch (const std::exception& e)
     {
         std::cerr << e.what() << std::endl;
     }
 
-    return 0;
+    return exitCode;
 }
\ No newline at end of file